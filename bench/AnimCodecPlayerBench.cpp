@@ -0,0 +1,79 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/codec/SkCodec.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkString.h"
+#include "modules/skresources/src/SkAnimCodecPlayer.h"
+#include "tools/Resources.h"
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Shows one frame of a long GIF per sample, so nanobench's max and stddev are the frame-time
+// jitter of playing it back. The cache only holds a few frames, as for an animation too large to
+// keep decoded, and each sample waits out the frame's duration first, as a display would.
+class AnimCodecPlayerBench : public Benchmark {
+public:
+    AnimCodecPlayerBench(const char* name, const char* path, bool decodeAhead)
+            : fPath(path), fDecodeAhead(decodeAhead) {
+        fName.printf("anim_player_%s_%s", name, decodeAhead ? "decode_ahead" : "sync");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    bool shouldLoop() const override { return false; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(GetResourceAsData(fPath));
+        SkASSERT(codec);
+        for (const SkCodec::FrameInfo& info : codec->getFrameInfo()) {
+            fFrameDurations.push_back(info.fDuration);
+        }
+        SkAnimCodecPlayer::Options options;
+        options.fCacheBudget = 4 * codec->getInfo().computeMinByteSize();
+        if (fDecodeAhead) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(1);
+            options.fExecutor = fExecutor.get();
+        }
+        fPlayer = std::make_unique<SkAnimCodecPlayer>(std::move(codec), options);
+    }
+
+    void onPreDraw(SkCanvas*) override {
+        // Show the previous frame for its duration, then move on to the next one.
+        std::this_thread::sleep_for(std::chrono::milliseconds(fFrameDurations[fFrame]));
+        fTime += fFrameDurations[fFrame];
+        fFrame = (fFrame + 1) % fFrameDurations.size();
+        fPlayer->seek(fTime);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            SkAssertResult(fPlayer->getFrame());
+        }
+    }
+
+private:
+    const char*                        fPath;
+    const bool                         fDecodeAhead;
+    SkString                           fName;
+    std::unique_ptr<SkExecutor>        fExecutor;
+    std::unique_ptr<SkAnimCodecPlayer> fPlayer;
+    std::vector<int>                   fFrameDurations;
+    size_t                             fFrame = 0;
+    uint32_t                           fTime = 0;
+};
+
+DEF_BENCH(return new AnimCodecPlayerBench("flight", "images/flightAnim.gif", false));
+DEF_BENCH(return new AnimCodecPlayerBench("flight", "images/flightAnim.gif", true));
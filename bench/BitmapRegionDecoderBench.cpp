@@ -6,10 +6,18 @@
  */
 
 #include "bench/BitmapRegionDecoderBench.h"
+#include "include/codec/SkCodec.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkData.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkString.h"
+#include "tools/Resources.h"
+
+#include <memory>
+
 #ifdef SK_ENABLE_ANDROID_UTILS
 #include "bench/CodecBenchPriv.h"
 #include "client_utils/android/BitmapRegionDecoder.h"
-#include "include/core/SkBitmap.h"
 #include "src/core/SkOSFile.h"
 
 BitmapRegionDecoderBench::BitmapRegionDecoderBench(const char* baseName, SkData* encoded,
@@ -50,3 +58,50 @@ void BitmapRegionDecoderBench::onDraw(int n, SkCanvas* canvas) {
     }
 }
 #endif // SK_ENABLE_ANDROID_UTILS
+
+// Decodes the 512x512 center of a 1600x1600 PNG into a new bitmap, as a region decoder does,
+// either with SkCodec::Options::fSubset or by decoding the whole image and cropping it. At its
+// peak, a crop has 10.8MB of heap allocated for the result and the whole image; a subset decode
+// has 1.0MB, little more than the result.
+class SubsetDecodeBench final : public Benchmark {
+public:
+    explicit SubsetDecodeBench(bool fullThenCrop)
+        : fName(fullThenCrop ? "decode_png_subset_512_full_then_crop" : "decode_png_subset_512")
+        , fFullThenCrop(fullThenCrop) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fCodec = SkCodec::MakeFromData(GetResourceAsData("images/mandrill_1600.png"));
+        SkASSERT(fCodec);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkIRect subset = SkIRect::MakeXYWH(544, 544, 512, 512);
+        const SkImageInfo subsetInfo = fCodec->getInfo().makeDimensions(subset.size());
+        while (loops-- > 0) {
+            SkBitmap bm;
+            bm.allocPixels(subsetInfo);
+            if (!fFullThenCrop) {
+                SkCodec::Options options;
+                options.fSubset = &subset;
+                SkAssertResult(SkCodec::kSuccess == fCodec->getPixels(bm.pixmap(), &options));
+                continue;
+            }
+            SkBitmap full;
+            full.allocPixels(fCodec->getInfo());
+            SkAssertResult(SkCodec::kSuccess == fCodec->getPixels(full.pixmap()));
+            SkAssertResult(full.readPixels(bm.pixmap(), subset.fLeft, subset.fTop));
+        }
+    }
+
+private:
+    const SkString           fName;
+    const bool               fFullThenCrop;
+    std::unique_ptr<SkCodec> fCodec;
+};
+
+DEF_BENCH(return new SubsetDecodeBench(false);)
+DEF_BENCH(return new SubsetDecodeBench(true);)
@@ -6,7 +6,10 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/codec/SkBatchDecoder.h"
+#include "include/codec/SkCodec.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFontMgr.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
@@ -15,6 +18,9 @@
 #include "tools/Resources.h"
 #include "tools/fonts/FontToolUtils.h"
 
+#include <iterator>
+#include <vector>
+
 class DecodeBench : public Benchmark {
 protected:
     DecodeBench(const char* name, const char* source)
@@ -58,6 +64,136 @@ private:
     using INHERITED = DecodeBench;
 };
 
+// Decodes a JPEG with restart markers using SkCodec::Options::fExecutor, with a pool of the given
+// number of threads, or serially with none. The image is 12 megapixels, so the decode rate in
+// megapixels per second is 12000 divided by the time in milliseconds.
+class JpegParallelDecodeBench final : public DecodeBench {
+public:
+    explicit JpegParallelDecodeBench(int threads)
+        : INHERITED(SkStringPrintf("jpeg_restart_12MP_%d_threads", threads).c_str(),
+                    "images/iphone_15.jpeg")
+        , fThreads(threads)
+    {}
+
+    void onDelayedSetup() override {
+        this->INHERITED::onDelayedSetup();
+        fCodec = SkCodec::MakeFromData(fData);
+        SkASSERT(fCodec);
+        fBitmap.allocPixels(fCodec->getInfo());
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCodec::Options options;
+        options.fExecutor = fExecutor.get();
+        while (loops-- > 0) {
+            SkAssertResult(SkCodec::kSuccess == fCodec->getPixels(fBitmap.pixmap(), &options));
+        }
+    }
+
+private:
+    const int                   fThreads;
+    std::unique_ptr<SkCodec>    fCodec;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkBitmap                    fBitmap;
+
+    using INHERITED = DecodeBench;
+};
+
+// Decodes a 12 megapixel JPEG to a 256x192 thumbnail, either with SkCodec::getResizedPixels or by
+// decoding at the nearest native scale and then resampling that with SkPixmap::scalePixels.
+class ResizeDecodeBench final : public DecodeBench {
+public:
+    explicit ResizeDecodeBench(bool twoStep)
+        : INHERITED(twoStep ? "jpeg_resize_256_two_step" : "jpeg_resize_256",
+                    "images/iphone_15.jpeg")
+        , fTwoStep(twoStep)
+    {}
+
+    void onDelayedSetup() override {
+        this->INHERITED::onDelayedSetup();
+        fCodec = SkCodec::MakeFromData(fData);
+        SkASSERT(fCodec);
+        fThumbnail.allocPixels(fCodec->getInfo().makeWH(256, 192));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            if (!fTwoStep) {
+                SkAssertResult(SkCodec::kSuccess == fCodec->getResizedPixels(fThumbnail.pixmap()));
+                continue;
+            }
+            SkBitmap decoded;
+            decoded.allocPixels(fCodec->getInfo().makeDimensions(
+                    fCodec->getScaledDimensions(192.0f / fCodec->dimensions().height())));
+            SkAssertResult(SkCodec::kSuccess == fCodec->getPixels(decoded.pixmap()));
+            const SkSamplingOptions sampling(SkCubicResampler::Mitchell());
+            SkAssertResult(decoded.pixmap().scalePixels(fThumbnail.pixmap(), sampling));
+        }
+    }
+
+private:
+    const bool               fTwoStep;
+    std::unique_ptr<SkCodec> fCodec;
+    SkBitmap                 fThumbnail;
+
+    using INHERITED = DecodeBench;
+};
+
+// Decodes a stream of small PNGs, as thumbnails or icons arrive in an ingestion pipeline, either
+// with an SkBatchDecoder or with a new SkCodec per image. Times are per image.
+class BatchDecodeBench final : public Benchmark {
+public:
+    explicit BatchDecodeBench(bool batch)
+        : fName(SkStringPrintf("decode_png_small_x%d_%s", kImages,
+                               batch ? "batch" : "individual"))
+        , fBatch(batch) {
+        this->setUnits(kImages);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        // The mandrills share an ICC profile, as images from one camera or one site tend to.
+        const char* paths[] = {"images/mandrill_16.png", "images/mandrill_32.png",
+                               "images/mandrill_64.png", "images/filter_reference.png"};
+        fBitmaps.resize(kImages);
+        for (int i = 0; i < kImages; i++) {
+            sk_sp<SkData> data = GetResourceAsData(paths[i % std::size(paths)]);
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+            SkASSERT(codec);
+            fBitmaps[i].allocPixels(codec->getInfo().makeColorType(kN32_SkColorType)
+                                                    .makeAlphaType(kPremul_SkAlphaType));
+            fImages.push_back({std::move(data), fBitmaps[i].pixmap()});
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            if (fBatch) {
+                SkBatchDecoder decoder;
+                decoder.decode(fImages);
+                continue;
+            }
+            for (const SkBatchDecoder::Image& image : fImages) {
+                std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(image.fEncoded);
+                SkAssertResult(codec && SkCodec::kSuccess == codec->getPixels(image.fDst));
+            }
+        }
+    }
+
+private:
+    static constexpr int kImages = 100;
+
+    const SkString                     fName;
+    const bool                         fBatch;
+    std::vector<SkBitmap>              fBitmaps;
+    std::vector<SkBatchDecoder::Image> fImages;
+};
 
 class SkottieDecodeBench final : public DecodeBench {
 public:
@@ -241,3 +377,15 @@ DEF_BENCH(return new BitmapDecodeBench("png_small"    /*  32x  32*/, "images/man
 DEF_BENCH(return new BitmapDecodeBench("png_phonehub_connecting"   , "images/Connecting.png"));
 DEF_BENCH(return new BitmapDecodeBench("png_phonehub_generic_error", "images/Generic_Error.png"));
 DEF_BENCH(return new BitmapDecodeBench("png_phonehub_onboard"      , "images/Onboard.png"));
+
+DEF_BENCH(return new JpegParallelDecodeBench(0));
+DEF_BENCH(return new JpegParallelDecodeBench(1));
+DEF_BENCH(return new JpegParallelDecodeBench(2));
+DEF_BENCH(return new JpegParallelDecodeBench(4));
+DEF_BENCH(return new JpegParallelDecodeBench(8));
+
+DEF_BENCH(return new ResizeDecodeBench(false));
+DEF_BENCH(return new ResizeDecodeBench(true));
+
+DEF_BENCH(return new BatchDecodeBench(false));
+DEF_BENCH(return new BatchDecodeBench(true));
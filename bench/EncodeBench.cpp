@@ -7,12 +7,24 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkSize.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkTileMode.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
 #include "include/encode/SkWebpEncoder.h"
 #include "tools/DecodeUtils.h"
 
+#include <memory>
+#include <vector>
+
 // Like other Benchmark subclasses, Encoder benchmarks are run by:
 // nanobench --match ^Encode_
 //
@@ -123,3 +135,146 @@ DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 3), "PNG_3n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 1), "PNG_1n"));
 
 #undef PNG
+
+// Encodes a 20MP image (the mandrill, tiled) as a PNG with SkPngEncoder::Options::fExecutor set
+// to a pool of |threads| threads. threads == 0 encodes serially for reference.
+class ParallelPngEncodeBench : public Benchmark {
+public:
+    ParallelPngEncodeBench(int threads) : fThreads(threads) {
+        if (fThreads == 0) {
+            fName = "Encode_PNG_parallel_baseline";
+        } else {
+            fName.printf("Encode_PNG_parallel_%d_threads", fThreads);
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkBitmap tile;
+        SkAssertResult(ToolUtils::GetResourceAsBitmap(srcs[0], &tile));
+        fBitmap.allocN32Pixels(5472, 3648, /*isOpaque=*/true);
+        SkPaint paint;
+        paint.setShader(tile.asImage()->makeShader(SkTileMode::kMirror, SkTileMode::kMirror, {}));
+        SkCanvas(fBitmap).drawPaint(paint);
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads, /*allowBorrowing=*/false);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPngEncoder::Options opts;
+        opts.fExecutor = fExecutor.get();
+        while (loops-- > 0) {
+            SkNullWStream dst;
+            SkAssertResult(SkPngEncoder::Encode(&dst, fBitmap.pixmap(), opts));
+        }
+    }
+
+private:
+    const int                   fThreads;
+    SkString                    fName;
+    SkBitmap                    fBitmap;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH(return new ParallelPngEncodeBench(0));
+DEF_BENCH(return new ParallelPngEncodeBench(1));
+DEF_BENCH(return new ParallelPngEncodeBench(2));
+DEF_BENCH(return new ParallelPngEncodeBench(4));
+DEF_BENCH(return new ParallelPngEncodeBench(8));
+DEF_BENCH(return new ParallelPngEncodeBench(16));
+
+// Encodes a 2048x2048 image as 64 tiles of 256x256 with EncodeTiles() on a pool of |threads|
+// threads, as a map-tile server would. threads == 0 instead encodes each tile with Encode() in
+// turn, for reference. Times are per tile.
+class TiledEncodeBench : public Benchmark {
+public:
+    using Encoder = EncodeBench::Encoder;
+    using EncodeTiles = std::vector<sk_sp<SkData>> (*)(const SkPixmap&, SkISize, SkExecutor*);
+
+    TiledEncodeBench(const char* format, Encoder encoder, EncodeTiles encodeTiles, int threads)
+            : fEncoder(encoder), fEncodeTiles(encodeTiles), fThreads(threads) {
+        if (fThreads == 0) {
+            fName.printf("Encode_%s_tiles_256_baseline", format);
+        } else {
+            fName.printf("Encode_%s_tiles_256_%d_threads", format, fThreads);
+        }
+        this->setUnits(kTiles * kTiles);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkBitmap tile;
+        SkAssertResult(ToolUtils::GetResourceAsBitmap(srcs[0], &tile));
+        fBitmap.allocN32Pixels(kTiles * kTileSize, kTiles * kTileSize, /*isOpaque=*/true);
+        SkPaint paint;
+        paint.setShader(tile.asImage()->makeShader(SkTileMode::kMirror, SkTileMode::kMirror, {}));
+        SkCanvas(fBitmap).drawPaint(paint);
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads, /*allowBorrowing=*/false);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            if (fThreads > 0) {
+                SkAssertResult(fEncodeTiles(fBitmap.pixmap(), {kTileSize, kTileSize},
+                                            fExecutor.get()).size() == kTiles * kTiles);
+                continue;
+            }
+            std::vector<sk_sp<SkData>> tiles;
+            for (int y = 0; y < kTiles; y++) {
+                for (int x = 0; x < kTiles; x++) {
+                    SkPixmap tile;
+                    SkAssertResult(fBitmap.pixmap().extractSubset(
+                            &tile, SkIRect::MakeXYWH(x * kTileSize, y * kTileSize,
+                                                     kTileSize, kTileSize)));
+                    SkDynamicMemoryWStream dst;
+                    SkAssertResult(fEncoder(&dst, tile));
+                    tiles.push_back(dst.detachAsData());
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr int kTiles = 8;
+    static constexpr int kTileSize = 256;
+
+    const Encoder               fEncoder;
+    const EncodeTiles           fEncodeTiles;
+    const int                   fThreads;
+    SkString                    fName;
+    SkBitmap                    fBitmap;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+static std::vector<sk_sp<SkData>> encode_jpeg_tiles(const SkPixmap& src, SkISize tileSize,
+                                                    SkExecutor* executor) {
+    SkJpegEncoder::Options opts;
+    opts.fQuality = 90;
+    return SkJpegEncoder::EncodeTiles(src, tileSize, opts, executor);
+}
+
+static std::vector<sk_sp<SkData>> encode_webp_lossy_tiles(const SkPixmap& src, SkISize tileSize,
+                                                          SkExecutor* executor) {
+    SkWebpEncoder::Options opts;
+    opts.fCompression = SkWebpEncoder::Compression::kLossy;
+    opts.fQuality = 90;
+    return SkWebpEncoder::EncodeTiles(src, tileSize, opts, executor);
+}
+
+DEF_BENCH(return new TiledEncodeBench("JPEG", encode_jpeg, encode_jpeg_tiles, 0));
+DEF_BENCH(return new TiledEncodeBench("JPEG", encode_jpeg, encode_jpeg_tiles, 1));
+DEF_BENCH(return new TiledEncodeBench("JPEG", encode_jpeg, encode_jpeg_tiles, 4));
+DEF_BENCH(return new TiledEncodeBench("JPEG", encode_jpeg, encode_jpeg_tiles, 8));
+DEF_BENCH(return new TiledEncodeBench("WEBP", encode_webp_lossy, encode_webp_lossy_tiles, 0));
+DEF_BENCH(return new TiledEncodeBench("WEBP", encode_webp_lossy, encode_webp_lossy_tiles, 1));
+DEF_BENCH(return new TiledEncodeBench("WEBP", encode_webp_lossy, encode_webp_lossy_tiles, 4));
+DEF_BENCH(return new TiledEncodeBench("WEBP", encode_webp_lossy, encode_webp_lossy_tiles, 8));
@@ -7,16 +7,20 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkString.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/core/SkChecksum.h"
+#include "src/core/SkTaskGroup.h"
 #include "tools/fonts/FontToolUtils.h"
 
 #include "bench/gUniqueGlyphIDs.h"
 
+#include <memory>
+
 #define gUniqueGlyphIDs_Sentinel    0xFFFF
 
 static int count_glyphs(const uint16_t start[]) {
@@ -143,6 +147,54 @@ private:
 };
 DEF_BENCH( return new FontCacheBench(); )
 
+// Runs the FontCacheBench workload on several threads at once, all using the same strike. Each
+// thread does the same amount of work, so with no contention the time stays flat as threads are
+// added.
+class FontCacheMultiThreadBench : public Benchmark {
+public:
+    FontCacheMultiThreadBench(int threads) : fThreads(threads) {
+        fName.printf("fontcache_mt_%d", threads);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads, /*allowBorrowing=*/false);
+        fFont = ToolUtils::DefaultFont();
+        fFont.setEdging(SkFont::Edging::kAntiAlias);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkTaskGroup(*fExecutor).batch(fThreads, [&](int) {
+            const uint16_t* array = gUniqueGlyphIDs;
+            while (*array != gUniqueGlyphIDs_Sentinel) {
+                int count = count_glyphs(array);
+                for (int i = 0; i < loops; ++i) {
+                    (void)fFont.measureText(array, count * sizeof(uint16_t),
+                                            SkTextEncoding::kGlyphID);
+                }
+                array += count + 1;    // skip the sentinel
+            }
+        });
+    }
+
+private:
+    const int                   fThreads;
+    SkString                    fName;
+    SkFont                      fFont;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+DEF_BENCH( return new FontCacheMultiThreadBench(1); )
+DEF_BENCH( return new FontCacheMultiThreadBench(4); )
+DEF_BENCH( return new FontCacheMultiThreadBench(16); )
+
 // undefine this to run the efficiency test
 //DEF_BENCH( return new FontCacheEfficiency(); )
 
@@ -6,7 +6,12 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkString.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <memory>
 
 namespace {
 static void* gGlobalAddress;
@@ -75,3 +80,59 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ImageCacheBench(); )
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Hammers the global (sharded) cache from several threads at once, the way many raster threads
+// decoding and mipmapping images do. Mostly hits, with an occasional re-add to keep the LRUs moving.
+class ImageCacheContentionBench : public Benchmark {
+    enum {
+        KEY_COUNT = 1024,
+        LOOKUPS_PER_THREAD = 256,
+    };
+public:
+    ImageCacheContentionBench(int threads) : fThreads(threads) {
+        fName.printf("imagecache_contention_%d_threads", threads);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads, /*allowBorrowing=*/false);
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        for (int i = 0; i < KEY_COUNT; ++i) {
+            SkResourceCache::Add(new TestRec(TestKey(i), i));
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override { SkResourceCache::PurgeAll(); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkTaskGroup(*fExecutor).batch(fThreads, [](int threadIndex) {
+                uint32_t key = threadIndex * 7919;
+                for (int j = 0; j < LOOKUPS_PER_THREAD; ++j) {
+                    key = (key * 1103515245 + 12345) % KEY_COUNT;
+                    if (!SkResourceCache::Find(TestKey(key), TestRec::Visitor, nullptr) ||
+                        (j & 63) == 0) {
+                        SkResourceCache::Add(new TestRec(TestKey(key), key));
+                    }
+                }
+            });
+        }
+    }
+
+private:
+    const int                   fThreads;
+    SkString                    fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH( return new ImageCacheContentionBench(1); )
+DEF_BENCH( return new ImageCacheContentionBench(4); )
+DEF_BENCH( return new ImageCacheContentionBench(16); )
@@ -8,12 +8,17 @@
 #include "bench/Benchmark.h"
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
 #include "include/core/SkExecutor.h"
+#include "include/core/SkFont.h"
 #include "include/core/SkImage.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkString.h"
+#include "include/core/SkSurface.h"
 #include "include/effects/SkGradientShader.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkRandom.h"
@@ -21,9 +26,14 @@
 #include "src/pdf/SkPDFUnion.h"
 #include "src/utils/SkFloatToDecimal.h"
 #include "tools/DecodeUtils.h"
+#include "tools/ProcStats.h"
 #include "tools/Resources.h"
 #include "tools/fonts/FontToolUtils.h"
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 namespace {
 struct WStreamWriteTextBenchmark : public Benchmark {
     std::unique_ptr<SkWStream> fWStream;
@@ -306,6 +316,114 @@ struct PDFClipPathBenchmark : public Benchmark {
     }
 };
 
+// Writes a document with many small pages, with and without SkPDF::Metadata::fStreamPages, and
+// reports how much the resident set grew while writing it.
+struct PDFManyPagesBench : public Benchmark {
+    PDFManyPagesBench(bool streamPages) : fStreamPages(streamPages) {
+        fName.printf("PDFManyPages%s", streamPages ? "_stream" : "");
+    }
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        SkFont font = ToolUtils::DefaultFont();
+        SkPaint paint;
+        SkRandom rand;
+        while (loops-- > 0) {
+            const int64_t startBytes = sk_tools::getCurrResidentSetSizeBytes();
+            int64_t peakBytes = startBytes;
+            SkNullWStream wStream;
+            SkPDF::Metadata metadata;
+            metadata.fStreamPages = fStreamPages;
+            auto doc = SkPDF::MakeDocument(&wStream, metadata);
+            for (int page = 0; page < kPageCount; ++page) {
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                for (int i = 0; i < 8; ++i) {
+                    paint.setColor(rand.nextU());
+                    canvas->drawRect(SkRect::MakeXYWH(rand.nextRangeF(0, 500),
+                                                      rand.nextRangeF(0, 700), 100, 80), paint);
+                }
+                paint.setColor(SK_ColorBLACK);
+                canvas->drawString(SkStringPrintf("Page %d", page), 36, 36, font, paint);
+                doc->endPage();
+                peakBytes = std::max(peakBytes, sk_tools::getCurrResidentSetSizeBytes());
+            }
+            doc->close();
+            fPeakGrowthMB = (double)(peakBytes - startBytes) / (1 << 20);
+        }
+    }
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        SkDebugf("%s: resident set grew by %.1f MB over %d pages\n",
+                 fName.c_str(), fPeakGrowthMB, kPageCount);
+    }
+
+private:
+    inline static constexpr int kPageCount = 5000;
+
+    const bool fStreamPages;
+    SkString fName;
+    double fPeakGrowthMB = 0;
+};
+
+// Writes a document of a few large raster images, so most of the time goes to deflating their
+// pixels, with and without an executor to deflate large streams in parallel.
+class PDFImageDocBench : public Benchmark {
+public:
+    PDFImageDocBench(SkPDF::Metadata::CompressionLevel level, bool parallel)
+            : fLevel(level), fParallel(parallel) {
+        fName.printf("PDFImageDoc_%s%s",
+                     level == SkPDF::Metadata::CompressionLevel::Balanced ? "balanced" : "default",
+                     parallel ? "_parallel" : "");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+    void onDelayedSetup() override {
+        for (const char* path : {"images/mandrill_512.png", "images/color_wheel.png",
+                                 "images/dog.jpg", "images/yellow_rose.png"}) {
+            sk_sp<SkImage> img = ToolUtils::GetResourceAsImage(path);
+            if (!img) {
+                continue;
+            }
+            // Draw each one into a raster surface, so it is embedded as pixels rather than as
+            // its encoded data.
+            sk_sp<SkSurface> surface = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(1536, 1536));
+            surface->getCanvas()->drawImageRect(img, SkRect::MakeWH(1536, 1536),
+                                                SkSamplingOptions(SkFilterMode::kLinear));
+            fImages.push_back(surface->makeImageSnapshot());
+        }
+        if (fParallel) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            SkNullWStream wStream;
+            SkPDF::Metadata metadata;
+            metadata.fCompressionLevel = fLevel;
+            metadata.fExecutor = fExecutor.get();
+            auto doc = SkPDF::MakeDocument(&wStream, metadata);
+            for (const sk_sp<SkImage>& image : fImages) {
+                SkCanvas* canvas = doc->beginPage(image->width(), image->height());
+                canvas->drawImage(image, 0, 0);
+                doc->endPage();
+            }
+            doc->close();
+        }
+    }
+
+private:
+    const SkPDF::Metadata::CompressionLevel fLevel;
+    const bool fParallel;
+    SkString fName;
+    std::vector<sk_sp<SkImage>> fImages;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
 }  // namespace
 DEF_BENCH(return new PDFImageBench;)
 DEF_BENCH(return new PDFJpegImageBench;)
@@ -314,6 +432,12 @@ DEF_BENCH(return new PDFColorComponentBench;)
 DEF_BENCH(return new PDFShaderBench;)
 DEF_BENCH(return new WritePDFTextBenchmark;)
 DEF_BENCH(return new PDFClipPathBenchmark;)
+DEF_BENCH(return new PDFManyPagesBench(false);)
+DEF_BENCH(return new PDFManyPagesBench(true);)
+DEF_BENCH(return new PDFImageDocBench(SkPDF::Metadata::CompressionLevel::Default, false);)
+DEF_BENCH(return new PDFImageDocBench(SkPDF::Metadata::CompressionLevel::Default, true);)
+DEF_BENCH(return new PDFImageDocBench(SkPDF::Metadata::CompressionLevel::Balanced, false);)
+DEF_BENCH(return new PDFImageDocBench(SkPDF::Metadata::CompressionLevel::Balanced, true);)
 
 #ifdef SK_PDF_ENABLE_SLOW_TESTS
 #include "include/core/SkExecutor.h"
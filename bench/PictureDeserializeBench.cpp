@@ -0,0 +1,91 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkSerialProcs.h"
+#include "include/core/SkString.h"
+#include "src/base/SkRandom.h"
+
+// Loads a serialized, SKP-like picture with many ops, paths and encoded images, either copying it
+// into heap structures (MakeFromData) or keeping views into the serialized data
+// (MakeFromDataWithoutCopy).
+class PictureDeserializeBench : public Benchmark {
+public:
+    PictureDeserializeBench(bool withoutCopy) : fWithoutCopy(withoutCopy) {
+        fName.printf("picture_deserialize_%s", withoutCopy ? "nocopy" : "copy");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(kSize, kSize));
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 50000; i++) {
+            paint.setColor(rand.nextU() | 0xff000000);
+            SkRect r = SkRect::MakeXYWH(rand.nextRangeScalar(0, kSize),
+                                        rand.nextRangeScalar(0, kSize),
+                                        rand.nextRangeScalar(4, 100),
+                                        rand.nextRangeScalar(4, 100));
+            if (i % 10 == 0) {
+                SkPath path;
+                path.moveTo(r.fLeft, r.fTop);
+                path.cubicTo(r.fRight, r.fTop, r.fLeft, r.fBottom, r.fRight, r.fBottom);
+                path.close();
+                canvas->drawPath(path, paint);
+            } else {
+                canvas->drawRect(r, paint);
+            }
+        }
+        for (int i = 0; i < 8; i++) {
+            SkBitmap bitmap;
+            bitmap.allocN32Pixels(256, 256);
+            for (int y = 0; y < 256; y++) {
+                for (int x = 0; x < 256; x++) {
+                    *bitmap.getAddr32(x, y) = rand.nextU() | 0xff000000;
+                }
+            }
+            canvas->drawImage(bitmap.asImage(), i * 256, 0);
+        }
+        SkSerialProcs procs;
+        procs.fAlignPictureSections = true;
+        fData = recorder.finishRecordingAsPicture()->serialize(&procs);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            sk_sp<SkPicture> picture = fWithoutCopy ? SkPicture::MakeFromDataWithoutCopy(fData)
+                                                    : SkPicture::MakeFromData(fData.get());
+            SkASSERT(picture);
+        }
+    }
+
+private:
+    inline static constexpr int kSize = 2048;
+
+    const bool    fWithoutCopy;
+    SkString      fName;
+    sk_sp<SkData> fData;
+};
+
+DEF_BENCH(return new PictureDeserializeBench(false);)
+DEF_BENCH(return new PictureDeserializeBench(true);)
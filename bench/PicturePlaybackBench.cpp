@@ -10,12 +10,16 @@
 #include "include/core/SkBBHFactory.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkString.h"
+#include "include/core/SkSurface.h"
+#include "include/core/SkTiledPictureUtils.h"
 #include "src/base/SkRandom.h"
 
 // This is designed to emulate about 4 screens of textual content
@@ -98,3 +102,68 @@ DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
+
+// Rasterizes a whole 2048x2048 picture into a grid of tiles with
+// SkTiledPictureUtils::RasterizeTiles, on a pool of 8 threads or (for "serial") on this thread.
+class ParallelTiledPlaybackBench : public Benchmark {
+public:
+    ParallelTiledPlaybackBench(int tilesPerSide, bool parallel)
+            : fTilesPerSide(tilesPerSide), fParallel(parallel) {
+        fName.printf("parallel_tiled_playback_%dx%d%s",
+                     tilesPerSide, tilesPerSide, parallel ? "" : "_serial");
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    void onDelayedSetup() override {
+        SkRTreeFactory factory;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(kSize, kSize, &factory);
+            SkRandom rand;
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            for (int i = 0; i < 40000; i++) {
+                paint.setColor(rand.nextU() | 0xFF000000);
+                SkRect r = SkRect::MakeXYWH(rand.nextRangeScalar(0, kSize),
+                                            rand.nextRangeScalar(0, kSize),
+                                            rand.nextRangeScalar(0, 128),
+                                            rand.nextRangeScalar(0, 128));
+                if (i % 2) {
+                    canvas->drawOval(r, paint);
+                } else {
+                    canvas->drawRect(r, paint);
+                }
+            }
+        fPic = recorder.finishRecordingAsPicture();
+        if (fParallel) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(8, /*allowBorrowing=*/false);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const int tileSize = kSize / fTilesPerSide;
+        const SkImageInfo tileInfo = SkImageInfo::MakeN32Premul(tileSize, tileSize);
+        for (int i = 0; i < loops; i++) {
+            SkTiledPictureUtils::RasterizeTiles(fPic.get(), SkIRect::MakeWH(kSize, kSize),
+                                                tileInfo, fExecutor.get());
+        }
+    }
+
+private:
+    inline static constexpr int kSize = 2048;
+
+    const int                   fTilesPerSide;
+    const bool                  fParallel;
+    SkString                    fName;
+    sk_sp<SkPicture>            fPic;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH( return new ParallelTiledPlaybackBench( 8, false); )
+DEF_BENCH( return new ParallelTiledPlaybackBench( 1, true ); )
+DEF_BENCH( return new ParallelTiledPlaybackBench( 2, true ); )
+DEF_BENCH( return new ParallelTiledPlaybackBench( 4, true ); )
+DEF_BENCH( return new ParallelTiledPlaybackBench( 8, true ); )
+DEF_BENCH( return new ParallelTiledPlaybackBench(16, true ); )
+DEF_BENCH( return new ParallelTiledPlaybackBench(32, true ); )
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkString.h"
+#include "include/core/SkTileMode.h"
+#include "include/encode/SkPngEncoder.h"
+#include "tools/DecodeUtils.h"
+
+#include <csetjmp>
+
+#include <png.h>
+
+// Measures the throughput of a single PNG filter (or of choosing between all of them), by
+// encoding a 4K image with zlib level 0 so that compression costs little more than a copy.
+// The "skia" variants filter with SkOpts::png_filter_row in SkPngEncoder; the "libpng" variants
+// write the same rows with libpng's own filters.
+class PngFilterBench : public Benchmark {
+public:
+    PngFilterBench(SkPngEncoder::FilterFlag filters, const char* filterName, bool useLibpng)
+            : fFilters(filters), fUseLibpng(useLibpng) {
+        fName.printf("PngFilter_%s_%s", filterName, useLibpng ? "libpng" : "skia");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkBitmap tile;
+        SkAssertResult(ToolUtils::GetResourceAsBitmap("images/mandrill_512.png", &tile));
+        // Unpremul RGBA rows are written to the PNG as they are, so both variants filter the
+        // same bytes.
+        fBitmap.allocPixels(SkImageInfo::Make(3840, 2160, kRGBA_8888_SkColorType,
+                                              kUnpremul_SkAlphaType));
+        SkPaint paint;
+        paint.setShader(tile.asImage()->makeShader(SkTileMode::kMirror, SkTileMode::kMirror, {}));
+        SkCanvas(fBitmap).drawPaint(paint);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            SkNullWStream dst;
+            SkAssertResult(fUseLibpng ? this->encodeWithLibpng(&dst) : this->encodeWithSkia(&dst));
+        }
+    }
+
+private:
+    bool encodeWithSkia(SkWStream* dst) {
+        SkPngEncoder::Options options;
+        options.fFilterFlags = fFilters;
+        options.fZLibLevel = 0;
+        return SkPngEncoder::Encode(dst, fBitmap.pixmap(), options);
+    }
+
+    bool encodeWithLibpng(SkWStream* dst) {
+        png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr,
+                                                  nullptr);
+        png_infop info = png ? png_create_info_struct(png) : nullptr;
+        if (!info) {
+            png_destroy_write_struct(&png, nullptr);
+            return false;
+        }
+        if (setjmp(png_jmpbuf(png))) {
+            png_destroy_write_struct(&png, &info);
+            return false;
+        }
+        png_set_write_fn(png, dst, [](png_structp png, png_bytep data, png_size_t size) {
+            static_cast<SkWStream*>(png_get_io_ptr(png))->write(data, size);
+        }, nullptr);
+        png_set_IHDR(png, info, fBitmap.width(), fBitmap.height(), 8, PNG_COLOR_TYPE_RGB_ALPHA,
+                     PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
+        png_set_filter(png, PNG_FILTER_TYPE_BASE, (int)fFilters);
+        png_set_compression_level(png, 0);
+        png_write_info(png, info);
+        for (int y = 0; y < fBitmap.height(); y++) {
+            png_write_row(png, (png_const_bytep)fBitmap.getAddr(0, y));
+        }
+        png_write_end(png, info);
+        png_destroy_write_struct(&png, &info);
+        return true;
+    }
+
+    const SkPngEncoder::FilterFlag fFilters;
+    const bool                     fUseLibpng;
+    SkString                       fName;
+    SkBitmap                       fBitmap;
+};
+
+#define PNG_FILTER_BENCH(FLAG, NAME)                                                   \
+    DEF_BENCH(return new PngFilterBench(SkPngEncoder::FilterFlag::FLAG, NAME, false)); \
+    DEF_BENCH(return new PngFilterBench(SkPngEncoder::FilterFlag::FLAG, NAME, true));
+
+PNG_FILTER_BENCH(kNone,  "none")
+PNG_FILTER_BENCH(kSub,   "sub")
+PNG_FILTER_BENCH(kUp,    "up")
+PNG_FILTER_BENCH(kAvg,   "avg")
+PNG_FILTER_BENCH(kPaeth, "paeth")
+PNG_FILTER_BENCH(kAll,   "all")
+
+#undef PNG_FILTER_BENCH
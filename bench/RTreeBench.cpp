@@ -10,8 +10,11 @@
 #include "include/core/SkString.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/base/SkRandom.h"
+#include "src/core/SkFlatRTree.h"
 #include "src/core/SkRTree.h"
 
+#include <vector>
+
 using namespace skia_private;
 
 // confine rectangles to a smallish area, so queries generally hit something, and overlap occurs:
@@ -22,11 +25,34 @@ static const int GRID_WIDTH = 100;
 
 typedef SkRect (*MakeRectProc)(SkRandom&, int, int);
 
+enum class Tree { kRTree, kFlat };
+
+static sk_sp<SkBBoxHierarchy> make_tree(Tree tree) {
+    if (tree == Tree::kFlat) {
+        return sk_make_sp<SkFlatRTree>();
+    }
+    return sk_make_sp<SkRTree>();
+}
+
+static const char* tree_prefix(Tree tree) {
+    return tree == Tree::kFlat ? "flat_rtree" : "rtree";
+}
+
+static SkRect make_query(SkRandom& rand) {
+    SkRect query;
+    query.fLeft   = rand.nextRangeF(0, GENERATE_EXTENTS);
+    query.fTop    = rand.nextRangeF(0, GENERATE_EXTENTS);
+    query.fRight  = query.fLeft + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/2);
+    query.fBottom = query.fTop  + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/2);
+    return query;
+}
+
 // Time how long it takes to build an R-Tree.
 class RTreeBuildBench : public Benchmark {
 public:
-    RTreeBuildBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_build", name);
+    RTreeBuildBench(const char* name, MakeRectProc proc, Tree tree = Tree::kRTree)
+            : fProc(proc), fTree(tree) {
+        fName.printf("%s_%s_build", tree_prefix(tree), name);
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -45,12 +71,12 @@ protected:
         }
 
         for (int i = 0; i < loops; ++i) {
-            SkRTree tree;
-            tree.insert(rects.data(), NUM_BUILD_RECTS);
+            make_tree(fTree)->insert(rects.data(), NUM_BUILD_RECTS);
         }
     }
 private:
     MakeRectProc fProc;
+    Tree fTree;
     SkString fName;
     using INHERITED = Benchmark;
 };
@@ -58,8 +84,10 @@ private:
 // Time how long it takes to perform queries on an R-Tree.
 class RTreeQueryBench : public Benchmark {
 public:
-    RTreeQueryBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_query", name);
+    RTreeQueryBench(const char* name, MakeRectProc proc, Tree tree = Tree::kRTree,
+                    bool batched = false)
+            : fProc(proc), fTree(make_tree(tree)), fBatched(batched) {
+        fName.printf("%s_%s_%squery", tree_prefix(tree), name, batched ? "batch_" : "");
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -75,24 +103,33 @@ protected:
         for (int i = 0; i < NUM_QUERY_RECTS; ++i) {
             rects[i] = fProc(rand, i, NUM_QUERY_RECTS);
         }
-        fTree.insert(rects.data(), NUM_QUERY_RECTS);
+        fTree->insert(rects.data(), NUM_QUERY_RECTS);
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
         SkRandom rand;
+        if (fBatched) {
+            // The same number of queries, kBatch at a time.
+            static constexpr int kBatch = 16;
+            SkRect queries[kBatch];
+            for (int i = 0; i < loops; i += kBatch) {
+                std::vector<int> hits[kBatch];
+                for (SkRect& query : queries) {
+                    query = make_query(rand);
+                }
+                fTree->searchBatch(queries, hits);
+            }
+            return;
+        }
         for (int i = 0; i < loops; ++i) {
             std::vector<int> hits;
-            SkRect query;
-            query.fLeft   = rand.nextRangeF(0, GENERATE_EXTENTS);
-            query.fTop    = rand.nextRangeF(0, GENERATE_EXTENTS);
-            query.fRight  = query.fLeft + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/2);
-            query.fBottom = query.fTop  + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/2);
-            fTree.search(query, &hits);
+            fTree->search(make_query(rand), &hits);
         }
     }
 private:
-    SkRTree fTree;
     MakeRectProc fProc;
+    sk_sp<SkBBoxHierarchy> fTree;
+    const bool fBatched;
     SkString fName;
     using INHERITED = Benchmark;
 };
@@ -138,3 +175,15 @@ DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects));
 DEF_BENCH(return new RTreeQueryBench("YX", &make_YXordered_rects));
 DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects));
 DEF_BENCH(return new RTreeQueryBench("concentric", &make_concentric_rects));
+
+DEF_BENCH(return new RTreeBuildBench("XY", &make_XYordered_rects, Tree::kFlat));
+DEF_BENCH(return new RTreeBuildBench("random", &make_random_rects, Tree::kFlat));
+
+DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects, Tree::kFlat));
+DEF_BENCH(return new RTreeQueryBench("YX", &make_YXordered_rects, Tree::kFlat));
+DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects, Tree::kFlat));
+DEF_BENCH(return new RTreeQueryBench("concentric", &make_concentric_rects, Tree::kFlat));
+
+DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects, Tree::kRTree, true));
+DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects, Tree::kFlat, true));
+
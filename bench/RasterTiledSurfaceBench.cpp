@@ -0,0 +1,105 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkString.h"
+#include "include/core/SkSurface.h"
+#include "src/base/SkRandom.h"
+
+#include <memory>
+
+// Measures how SkSurfaces::RasterTiled scales with thread count when rasterizing a large,
+// SKP-like picture. threads == 0 draws into a plain SkSurfaces::Raster for reference. Like an SKP,
+// the picture has an R-tree, so each tile only plays back the ops that touch it.
+class RasterTiledSurfaceBench : public Benchmark {
+public:
+    RasterTiledSurfaceBench(int threads) : fThreads(threads) {
+        if (fThreads == 0) {
+            fName = "raster_tiled_surface_baseline";
+        } else {
+            fName.printf("raster_tiled_surface_%d_threads", fThreads);
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkPictureRecorder recorder;
+        SkRTreeFactory factory;
+        SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(kSize, kSize), &factory);
+        SkRandom rand;
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 20000; i++) {
+            paint.setColor(rand.nextU() | 0x80000000);
+            SkRect r = SkRect::MakeXYWH(rand.nextRangeScalar(0, kSize),
+                                        rand.nextRangeScalar(0, kSize),
+                                        rand.nextRangeScalar(4, 160),
+                                        rand.nextRangeScalar(4, 160));
+            if (i % 3 == 0) {
+                SkPath path;
+                path.moveTo(r.fLeft, r.fTop);
+                path.cubicTo(r.fRight, r.fTop, r.fLeft, r.fBottom, r.fRight, r.fBottom);
+                path.close();
+                canvas->drawPath(path, paint);
+            } else if (i % 3 == 1) {
+                canvas->drawOval(r, paint);
+            } else {
+                canvas->drawRect(r, paint);
+            }
+        }
+        fPicture = recorder.finishRecordingAsPicture();
+
+        const SkImageInfo info = SkImageInfo::MakeN32Premul(kSize, kSize);
+        if (fThreads == 0) {
+            fSurface = SkSurfaces::Raster(info);
+        } else {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads, /*allowBorrowing=*/false);
+            fSurface = SkSurfaces::RasterTiled(info, fExecutor.get());
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            fSurface->getCanvas()->drawPicture(fPicture);
+            // Forces the pending tiles to be rasterized.
+            SkPixmap pixmap;
+            fSurface->peekPixels(&pixmap);
+        }
+    }
+
+private:
+    inline static constexpr int kSize = 4096;
+
+    const int                   fThreads;
+    SkString                    fName;
+    sk_sp<SkPicture>            fPicture;
+    std::unique_ptr<SkExecutor> fExecutor;
+    sk_sp<SkSurface>            fSurface;
+};
+
+DEF_BENCH(return new RasterTiledSurfaceBench(0);)
+DEF_BENCH(return new RasterTiledSurfaceBench(1);)
+DEF_BENCH(return new RasterTiledSurfaceBench(2);)
+DEF_BENCH(return new RasterTiledSurfaceBench(4);)
+DEF_BENCH(return new RasterTiledSurfaceBench(8);)
+DEF_BENCH(return new RasterTiledSurfaceBench(16);)
+DEF_BENCH(return new RasterTiledSurfaceBench(32);)
+DEF_BENCH(return new RasterTiledSurfaceBench(64);)
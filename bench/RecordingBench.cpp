@@ -51,10 +51,16 @@ void RecordingBench::onDraw(int loops, SkCanvas*) {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 #include "include/core/SkSerialProcs.h"
 
-DeserializePictureBench::DeserializePictureBench(const char* name, sk_sp<SkData> data)
+DeserializePictureBench::DeserializePictureBench(const char* name, sk_sp<SkData> data,
+                                                 bool withoutCopy)
     : fName(name)
     , fEncodedPicture(std::move(data))
-{}
+    , fWithoutCopy(withoutCopy)
+{
+    if (fWithoutCopy) {
+        fName.append("_nocopy");
+    }
+}
 
 const char* DeserializePictureBench::onGetName() {
     return fName.c_str();
@@ -70,6 +76,10 @@ SkISize DeserializePictureBench::onGetSize() {
 
 void DeserializePictureBench::onDraw(int loops, SkCanvas*) {
     for (int i = 0; i < loops; ++i) {
-        SkPicture::MakeFromData(fEncodedPicture.get());
+        if (fWithoutCopy) {
+            SkPicture::MakeFromDataWithoutCopy(fEncodedPicture);
+        } else {
+            SkPicture::MakeFromData(fEncodedPicture.get());
+        }
     }
 }
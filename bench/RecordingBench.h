@@ -42,7 +42,8 @@ private:
 
 class DeserializePictureBench : public Benchmark {
 public:
-    DeserializePictureBench(const char* name, sk_sp<SkData> encodedPicture);
+    DeserializePictureBench(const char* name, sk_sp<SkData> encodedPicture,
+                            bool withoutCopy = false);
 
 protected:
     const char* onGetName() override;
@@ -53,6 +54,7 @@ protected:
 private:
     SkString      fName;
     sk_sp<SkData> fEncodedPicture;
+    const bool    fWithoutCopy;
 
     using INHERITED = Benchmark;
 };
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkString.h"
+#include "include/core/SkSurface.h"
+#include "include/effects/SkRuntimeEffect.h"
+#include "include/private/base/SkTArray.h"
+
+#include <utility>
+
+namespace {
+class MemoryPersistentCache : public SkRuntimeEffect::PersistentCache {
+public:
+    sk_sp<SkData> load(const SkData& key) override {
+        for (const auto& [k, v] : fEntries) {
+            if (k->equals(&key)) {
+                return v;
+            }
+        }
+        return nullptr;
+    }
+    void store(const SkData& key, const SkData& data) override {
+        fEntries.push_back({SkData::MakeWithCopy(key.data(), key.size()),
+                            SkData::MakeWithCopy(data.data(), data.size())});
+    }
+
+private:
+    skia_private::TArray<std::pair<sk_sp<SkData>, sk_sp<SkData>>> fEntries;
+};
+
+// Big enough that inlining and code generation are a noticeable share of an effect's first draw.
+static constexpr char kSkSL[] = R"(
+    uniform float4 params;
+
+    float hash(float2 p) {
+        return fract(sin(dot(p, float2(12.9898, 78.233))) * 43758.5453);
+    }
+    float noise(float2 p) {
+        float2 i = floor(p), f = fract(p);
+        float2 u = f * f * (3 - 2 * f);
+        return mix(mix(hash(i), hash(i + float2(1, 0)), u.x),
+                   mix(hash(i + float2(0, 1)), hash(i + float2(1, 1)), u.x), u.y);
+    }
+    float fbm(float2 p) {
+        float v = 0, a = 0.5;
+        for (int i = 0; i < 6; i++) {
+            v += a * noise(p);
+            p = p * 2 + params.xy;
+            a *= 0.5;
+        }
+        return v;
+    }
+    half4 main(float2 xy) {
+        float n = fbm(xy * params.z);
+        float3 c = mix(float3(0.1, 0.2, 0.5), float3(1, 0.8, 0.3), n);
+        c = pow(c, float3(params.w));
+        return half4(half3(c), 1);
+    }
+)";
+}  // namespace
+
+// Measures creating a runtime effect and drawing with it for the first time on the CPU, which is
+// when its raster-pipeline program is built. "warm" loads that program from a persistent cache.
+// runtime_effect_make only creates the effect, without a cache, which is mostly parsing the SkSL.
+// A warm first draw skips that too.
+class RuntimeEffectPersistentCacheBench : public Benchmark {
+public:
+    enum class Mode { kMakeOnly, kCold, kWarm };
+
+    RuntimeEffectPersistentCacheBench(Mode mode) : fMode(mode) {
+        switch (mode) {
+            case Mode::kMakeOnly: fName = "runtime_effect_make";                break;
+            case Mode::kCold:     fName = "runtime_effect_first_draw_cold";     break;
+            case Mode::kWarm:     fName = "runtime_effect_first_draw_warm";     break;
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fSurface = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(1, 1));
+        const float params[] = {0.5f, 0.25f, 0.01f, 2.2f};
+        fUniforms = SkData::MakeWithCopy(params, sizeof(params));
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        if (fMode == Mode::kWarm) {
+            SkRuntimeEffect::SetPersistentCache(&fCache);
+            this->drawOnce();  // Populates the cache.
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override { SkRuntimeEffect::SetPersistentCache(nullptr); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            if (fMode == Mode::kMakeOnly) {
+                SkRuntimeEffect::MakeForShader(SkString(kSkSL));
+            } else {
+                this->drawOnce();
+            }
+        }
+    }
+
+private:
+    void drawOnce() {
+        sk_sp<SkRuntimeEffect> effect = SkRuntimeEffect::MakeForShader(SkString(kSkSL)).effect;
+        SkPaint paint;
+        paint.setShader(effect->makeShader(fUniforms, {}));
+        fSurface->getCanvas()->drawPaint(paint);
+    }
+
+    const Mode            fMode;
+    SkString              fName;
+    MemoryPersistentCache fCache;
+    sk_sp<SkSurface>      fSurface;
+    sk_sp<SkData>         fUniforms;
+};
+
+using Mode = RuntimeEffectPersistentCacheBench::Mode;
+DEF_BENCH(return new RuntimeEffectPersistentCacheBench(Mode::kMakeOnly);)
+DEF_BENCH(return new RuntimeEffectPersistentCacheBench(Mode::kCold);)
+DEF_BENCH(return new RuntimeEffectPersistentCacheBench(Mode::kWarm);)
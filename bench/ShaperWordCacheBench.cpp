@@ -0,0 +1,108 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkData.h"
+#include "include/core/SkFont.h"
+#include "include/core/SkFontMgr.h"
+#include "include/core/SkString.h"
+#include "tools/Resources.h"
+#include "tools/fonts/FontToolUtils.h"
+
+#if defined(SK_SHAPER_HARFBUZZ_AVAILABLE) && defined(SK_SHAPER_UNICODE_AVAILABLE)
+
+#include "modules/skshaper/include/SkShaper.h"
+#include "modules/skshaper/include/SkShaper_harfbuzz.h"
+#include "modules/skshaper/include/SkShaper_skunicode.h"
+#include "modules/skshaper/utils/FactoryHelpers.h"
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Shapes a corpus of short lines, like the messages of a chat log, one line at a time. The
+// corpus is a resource repeated many times, so most words have been seen before, as they would
+// be in a long log. Words are only cached for fonts whose space is shaped without context (see
+// SkShapers::HB::SpaceIsContextFree); the portable test font is not one of them, so with
+// --nonativeFonts both variants shape every line whole.
+class ShaperWordCacheBench : public Benchmark {
+public:
+    ShaperWordCacheBench(const char* name, const char* resource, bool useCache)
+            : fResource(resource), fUseCache(useCache) {
+        fName.printf("shaper_words_%s_%s", name, useCache ? "cache" : "nocache");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        sk_sp<SkData> data = GetResourceAsData(fResource);
+        if (!data) {
+            return;
+        }
+        constexpr int kRepeats = 20;
+        for (int i = 0; i < kRepeats; ++i) {
+            fCorpus.append((const char*)data->data(), data->size());
+        }
+
+        std::string_view corpus(fCorpus.c_str(), fCorpus.size());
+        while (!corpus.empty()) {
+            size_t end = corpus.find('\n');
+            std::string_view line = corpus.substr(0, end);
+            if (!line.empty()) {
+                fLines.push_back(line);
+            }
+            corpus.remove_prefix(end == std::string_view::npos ? corpus.size() : end + 1);
+        }
+
+        fUnicode = sk_ref_sp(SkShapers::HarfbuzzFactory().getUnicode());
+        fFontMgr = ToolUtils::TestFontMgr();
+        fShaper = SkShapers::HB::ShapeThenWrap(fUnicode, fFontMgr,
+                                               fUseCache ? SkShapers::HB::WordCache::Make()
+                                                         : nullptr);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fShaper) {
+            return;
+        }
+        constexpr float kWidth = 400;
+        const SkFont font = ToolUtils::DefaultFont();
+        while (loops-- > 0) {
+            for (std::string_view line : fLines) {
+                const char* utf8 = line.data();
+                const size_t utf8Bytes = line.size();
+                auto fontRuns = SkShaper::MakeFontMgrRunIterator(utf8, utf8Bytes, font, fFontMgr);
+                auto bidi = SkShapers::unicode::BidiRunIterator(fUnicode, utf8, utf8Bytes, 0);
+                auto script = SkShapers::HB::ScriptRunIterator(utf8, utf8Bytes);
+                auto language = SkShaper::MakeStdLanguageRunIterator(utf8, utf8Bytes);
+                SkTextBlobBuilderRunHandler rh(utf8, {0, 0});
+                fShaper->shape(utf8, utf8Bytes, *fontRuns, *bidi, *script, *language,
+                               nullptr, 0, kWidth, &rh);
+                (void)rh.makeBlob();
+            }
+        }
+    }
+
+private:
+    const char*                   fResource;
+    const bool                    fUseCache;
+    SkString                      fName;
+    SkString                      fCorpus;
+    std::vector<std::string_view> fLines;
+    sk_sp<SkUnicode>              fUnicode;
+    sk_sp<SkFontMgr>              fFontMgr;
+    std::unique_ptr<SkShaper>     fShaper;
+};
+
+DEF_BENCH(return new ShaperWordCacheBench("english", "text/english.txt", false));
+DEF_BENCH(return new ShaperWordCacheBench("english", "text/english.txt", true));
+DEF_BENCH(return new ShaperWordCacheBench("han_simplified", "text/han_simplified.txt", false));
+DEF_BENCH(return new ShaperWordCacheBench("han_simplified", "text/han_simplified.txt", true));
+
+#endif  // defined(SK_SHAPER_HARFBUZZ_AVAILABLE) && defined(SK_SHAPER_UNICODE_AVAILABLE)
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkData.h"
+#include "include/core/SkString.h"
+#include "tools/Resources.h"
+
+#if defined(SK_UNICODE_ICU_IMPLEMENTATION)
+
+#include "modules/skunicode/include/SkUnicode.h"
+#include "modules/skunicode/include/SkUnicode_icu.h"
+
+#include <memory>
+#include <vector>
+
+// Breaks the paragraphs of a corpus in several scripts, as laying them out again after a style
+// change would. There are fewer paragraphs than SkUnicode_icu keeps the flags of.
+class SkUnicodeBench : public Benchmark {
+public:
+    enum class Mode {
+        kComputeFlags,  // SkUnicode::computeCodeUnitFlags, which breaks the text every time
+        kGetFlags,      // SkUnicode::getCodeUnitFlags, which may find the flags it found before
+        kLineBreaks,    // A line break iterator per paragraph, as SkShaper makes them
+    };
+
+    explicit SkUnicodeBench(Mode mode) : fMode(mode) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    const char* onGetName() override {
+        switch (fMode) {
+            case Mode::kComputeFlags: return "unicode_multilingual_compute_flags";
+            case Mode::kGetFlags:     return "unicode_multilingual_get_flags";
+            case Mode::kLineBreaks:   return "unicode_multilingual_line_breaks";
+        }
+        SkUNREACHABLE;
+    }
+
+    void onDelayedSetup() override {
+        const char* resources[] = {
+            "text/english.txt", "text/arabic.txt", "text/hebrew.txt",
+            "text/cyrillic.txt", "text/devanagari.txt", "text/thai.txt",
+            "text/han_simplified.txt", "text/hangul.txt", "text/kana.txt",
+        };
+        for (const char* resource : resources) {
+            sk_sp<SkData> data = GetResourceAsData(resource);
+            if (!data) {
+                continue;
+            }
+            const char* text = (const char*)data->data();
+            const char* end = text + data->size();
+            while (text < end) {
+                const char* line = text;
+                while (text < end && *text != '\n') {
+                    ++text;
+                }
+                if (text > line) {
+                    fParagraphs.emplace_back(line, text - line);
+                }
+                ++text;
+            }
+        }
+        fUnicode = SkUnicodes::ICU::Make();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fUnicode) {
+            return;
+        }
+        skia_private::TArray<SkUnicode::CodeUnitFlags, true> flags;
+        while (loops-- > 0) {
+            for (const SkString& paragraph : fParagraphs) {
+                // The flags are found for a copy, as skparagraph does, since tabs may be replaced
+                SkString text(paragraph);
+                switch (fMode) {
+                    case Mode::kComputeFlags:
+                        fUnicode->computeCodeUnitFlags(text.data(), text.size(), true, &flags);
+                        break;
+                    case Mode::kGetFlags:
+                        fUnicode->getCodeUnitFlags(text.data(), text.size(), true, &flags);
+                        break;
+                    case Mode::kLineBreaks: {
+                        auto iter = fUnicode->makeBreakIterator("en",
+                                                                SkUnicode::BreakType::kLines);
+                        if (iter && iter->setText(text.c_str(), text.size())) {
+                            while (!iter->isDone()) {
+                                iter->next();
+                            }
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    const Mode            fMode;
+    std::vector<SkString> fParagraphs;
+    sk_sp<SkUnicode>      fUnicode;
+};
+
+DEF_BENCH(return new SkUnicodeBench(SkUnicodeBench::Mode::kComputeFlags));
+DEF_BENCH(return new SkUnicodeBench(SkUnicodeBench::Mode::kGetFlags));
+DEF_BENCH(return new SkUnicodeBench(SkUnicodeBench::Mode::kLineBreaks));
+
+#endif  // defined(SK_UNICODE_ICU_IMPLEMENTATION)
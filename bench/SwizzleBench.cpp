@@ -6,29 +6,45 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/codec/SkCodec.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkString.h"
+#include "include/private/SkEncodedInfo.h"
+#include "src/base/SkRandom.h"
 #include "src/codec/SkSwizzler.h"
 #include "src/core/SkSwizzlePriv.h"
 
+#include <memory>
+#include <vector>
+
 class SwizzleBench : public Benchmark {
 public:
 
     SwizzleBench(const char* name, SkOpts::Swizzle_8888_u32 fn) : fName(name), fFn_u32(fn) {}
     SwizzleBench(const char* name, SkOpts::Swizzle_8888_u8  fn) : fName(name), fFn_u8 (fn) {}
+    SwizzleBench(const char* name, SkOpts::Swizzle_8888_index fn)
+            : fName(name), fFn_index(fn) {}
 
     bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
     const char* onGetName() override { return fName; }
     void onDraw(int loops, SkCanvas*) override {
         static const int K = 1023; // Arbitrary, but nice to be a non-power-of-two to trip up SIMD.
-        uint32_t dst[K], src[K];
+        // Big enough for K 16-bit RGBA pixels.
+        uint32_t dst[K], src[2*K], table[256];
+        for (int i = 0; i < 256; i++) {
+            table[i] = 0xFF000000 | i;  // Opaque, so index_to_8888_skipZ stores every pixel.
+        }
         while (loops --> 0) {
-            if (fFn_u32) { fFn_u32(dst,                 src, K); }
-            if (fFn_u8)  { fFn_u8 (dst, (const uint8_t*)src, K); }
+            if (fFn_u32)   { fFn_u32  (dst,                 src,        K); }
+            if (fFn_u8)    { fFn_u8   (dst, (const uint8_t*)src,        K); }
+            if (fFn_index) { fFn_index(dst, (const uint8_t*)src, table, K); }
         }
     }
 private:
     const char* fName;
     SkOpts::Swizzle_8888_u32 fFn_u32 = nullptr;
     SkOpts::Swizzle_8888_u8  fFn_u8  = nullptr;
+    SkOpts::Swizzle_8888_index fFn_index = nullptr;
 };
 
 
@@ -42,3 +58,103 @@ DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_RGBA", SkOpts::grayA_to_RGBA
 DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_rgbA", SkOpts::grayA_to_rgbA));
 DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_RGB1", SkOpts::inverted_CMYK_to_RGB1));
 DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_BGR1", SkOpts::inverted_CMYK_to_BGR1));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGB16_to_RGB1", SkOpts::RGB16_to_RGB1));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGB16_to_BGR1", SkOpts::RGB16_to_BGR1));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_RGBA", SkOpts::RGBA16_to_RGBA));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_BGRA", SkOpts::RGBA16_to_BGRA));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_rgbA", SkOpts::RGBA16_to_rgbA));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_bgrA", SkOpts::RGBA16_to_bgrA));
+DEF_BENCH(return new SwizzleBench("SkOpts::index_to_8888", SkOpts::index_to_8888));
+DEF_BENCH(return new SwizzleBench("SkOpts::index_to_8888_skipZ", SkOpts::index_to_8888_skipZ));
+
+// Swizzles rows the way a codec does, through SkSwizzler, for each source format the codecs
+// hand it. This covers the formats without SkOpts procs too, and the per-row overhead.
+class CodecSwizzleBench : public Benchmark {
+public:
+    CodecSwizzleBench(const char* name, SkEncodedInfo::Color color, SkEncodedInfo::Alpha alpha,
+                      int bitsPerComponent, SkColorType dstColorType, SkAlphaType dstAlphaType)
+            : fColor(color)
+            , fAlpha(alpha)
+            , fBitsPerComponent(bitsPerComponent)
+            , fDstInfo(SkImageInfo::Make(kWidth, 1, dstColorType, dstAlphaType)) {
+        const char* dstName = dstColorType == kRGB_565_SkColorType ? "565"
+                            : dstColorType == kAlpha_8_SkColorType ? "a8"
+                            : dstColorType == kGray_8_SkColorType  ? "gray8"
+                            : dstAlphaType == kPremul_SkAlphaType  ? "n32_premul"
+                            : dstAlphaType == kUnpremul_SkAlphaType ? "n32_unpremul"
+                                                                    : "n32";
+        fName.printf("swizzle_%s_to_%s", name, dstName);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkEncodedInfo info = SkEncodedInfo::Make(kWidth, 1, fColor, fAlpha, fBitsPerComponent);
+        SkRandom rand;
+        fSrc.resize((kWidth * info.bitsPerPixel() + 7) / 8);
+        for (uint8_t& byte : fSrc) {
+            byte = rand.nextU() & 0xFF;
+        }
+        for (SkPMColor& color : fColorTable) {
+            color = rand.nextU();
+        }
+        fDst.resize(fDstInfo.minRowBytes());
+        fSwizzler = SkSwizzler::Make(info, fColorTable, fDstInfo, SkCodec::Options());
+        SkASSERT(fSwizzler);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops --> 0) {
+            fSwizzler->swizzle(fDst.data(), fSrc.data());
+        }
+    }
+
+private:
+    // Arbitrary, but a non-power-of-two to trip up SIMD, as above.
+    static constexpr int kWidth = 1023;
+
+    const SkEncodedInfo::Color  fColor;
+    const SkEncodedInfo::Alpha  fAlpha;
+    const int                   fBitsPerComponent;
+    const SkImageInfo           fDstInfo;
+    SkString                    fName;
+    SkPMColor                   fColorTable[256];
+    std::vector<uint8_t>        fSrc;
+    std::vector<uint8_t>        fDst;
+    std::unique_ptr<SkSwizzler> fSwizzler;
+};
+
+#define DEF_CODEC_SWIZZLE_BENCH(name, color, alpha, bits, dstColorType, dstAlphaType)        \
+    DEF_BENCH(return new CodecSwizzleBench(name, SkEncodedInfo::k##color##_Color,           \
+                                           SkEncodedInfo::k##alpha##_Alpha, bits,           \
+                                           k##dstColorType##_SkColorType,                   \
+                                           k##dstAlphaType##_SkAlphaType));
+
+DEF_CODEC_SWIZZLE_BENCH("gray1",   Gray,         Opaque,    1, N32,     Opaque)
+DEF_CODEC_SWIZZLE_BENCH("gray8",   Gray,         Opaque,    8, N32,     Opaque)
+DEF_CODEC_SWIZZLE_BENCH("gray8",   Gray,         Opaque,    8, RGB_565, Opaque)
+DEF_CODEC_SWIZZLE_BENCH("gray8",   Gray,         Opaque,    8, Gray_8,  Opaque)
+DEF_CODEC_SWIZZLE_BENCH("grayA8",  GrayAlpha,    Unpremul,  8, N32,     Premul)
+DEF_CODEC_SWIZZLE_BENCH("grayA8",  GrayAlpha,    Unpremul,  8, N32,     Unpremul)
+DEF_CODEC_SWIZZLE_BENCH("xalpha8", XAlpha,       Unpremul,  8, Alpha_8, Premul)
+DEF_CODEC_SWIZZLE_BENCH("index1",  Palette,      Unpremul,  1, N32,     Premul)
+DEF_CODEC_SWIZZLE_BENCH("index2",  Palette,      Unpremul,  2, N32,     Premul)
+DEF_CODEC_SWIZZLE_BENCH("index4",  Palette,      Unpremul,  4, N32,     Premul)
+DEF_CODEC_SWIZZLE_BENCH("index8",  Palette,      Unpremul,  8, N32,     Premul)
+DEF_CODEC_SWIZZLE_BENCH("index8",  Palette,      Unpremul,  8, RGB_565, Opaque)
+DEF_CODEC_SWIZZLE_BENCH("rgb8",    RGB,          Opaque,    8, N32,     Opaque)
+DEF_CODEC_SWIZZLE_BENCH("rgb8",    RGB,          Opaque,    8, RGB_565, Opaque)
+DEF_CODEC_SWIZZLE_BENCH("rgb16",   RGB,          Opaque,   16, N32,     Opaque)
+DEF_CODEC_SWIZZLE_BENCH("rgb16",   RGB,          Opaque,   16, RGB_565, Opaque)
+DEF_CODEC_SWIZZLE_BENCH("rgba8",   RGBA,         Unpremul,  8, N32,     Premul)
+DEF_CODEC_SWIZZLE_BENCH("rgba8",   RGBA,         Unpremul,  8, N32,     Unpremul)
+DEF_CODEC_SWIZZLE_BENCH("rgba16",  RGBA,         Unpremul, 16, N32,     Premul)
+DEF_CODEC_SWIZZLE_BENCH("rgba16",  RGBA,         Unpremul, 16, N32,     Unpremul)
+DEF_CODEC_SWIZZLE_BENCH("bgr8",    BGR,          Opaque,    8, N32,     Opaque)
+DEF_CODEC_SWIZZLE_BENCH("bgrx8",   BGRX,         Opaque,    8, N32,     Opaque)
+DEF_CODEC_SWIZZLE_BENCH("bgra8",   BGRA,         Unpremul,  8, N32,     Premul)
+DEF_CODEC_SWIZZLE_BENCH("bgra8",   BGRA,         Unpremul,  8, N32,     Unpremul)
+DEF_CODEC_SWIZZLE_BENCH("cmyk8",   InvertedCMYK, Opaque,    8, N32,     Opaque)
+
+#undef DEF_CODEC_SWIZZLE_BENCH
@@ -985,6 +985,22 @@ public:
             return new DeserializePictureBench(name.c_str(), std::move(data));
         }
 
+        // And again, loading them without copying out of the mapped file.
+        while (fCurrentDeserialPictureWithoutCopy < fSKPs.size()) {
+            const SkString& path = fSKPs[fCurrentDeserialPictureWithoutCopy++];
+            sk_sp<SkData> data = SkData::MakeFromFileName(path.c_str());
+            if (!data) {
+                continue;
+            }
+            SkString name = SkOSPath::Basename(path.c_str());
+            fSourceType = "skp";
+            fBenchType  = "deserial_nocopy";
+            fSKPBytes = static_cast<double>(data->size());
+            fSKPOps   = 0;
+            return new DeserializePictureBench(name.c_str(), std::move(data),
+                                               /*withoutCopy=*/true);
+        }
+
         // Then once each for each scale as SKPBenches (playback).
         while (fCurrentScale < fScales.size()) {
             while (fCurrentSKP < fSKPs.size()) {
@@ -1307,6 +1323,7 @@ private:
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
     int fCurrentRecording = 0;
     int fCurrentDeserialPicture = 0;
+    int fCurrentDeserialPictureWithoutCopy = 0;
     int fCurrentMSKP = 0;
     int fCurrentScale = 0;
     int fCurrentSKP = 0;
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBatchDecoder_DEFINED
+#define SkBatchDecoder_DEFINED
+
+#include "include/codec/SkCodec.h"
+#include "include/core/SkData.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSpan.h"
+#include "include/private/base/SkAPI.h"
+
+#include <memory>
+#include <vector>
+
+class SkExecutor;
+
+/**
+ *  Decodes many encoded images into caller-provided pixels, keeping per-format decoder state
+ *  between images rather than starting each one from scratch as SkCodec::MakeFromData does.
+ *  This is worth it for streams of small images, where setting up a decoder costs about as
+ *  much as decoding. For now that state is:
+ *    - for PNG, the ICC profiles already seen (a whole batch embedding the same profile only
+ *      inflates it once) and the zlib stream used to inflate new ones.
+ *
+ *  Images in formats without reusable state are decoded with SkCodec::MakeFromData.
+ *
+ *  An SkBatchDecoder may be reused for any number of batches, but only by one thread at a time.
+ */
+class SK_API SkBatchDecoder {
+public:
+    struct Options {
+        /**
+         *  If set, the images of a batch are decoded by up to fMaxParallelDecodes tasks on this
+         *  executor, each with its own decoder state. decode() still blocks until they finish.
+         */
+        SkExecutor* fExecutor = nullptr;
+        int         fMaxParallelDecodes = 4;
+    };
+
+    struct Image {
+        sk_sp<SkData> fEncoded;
+        /**
+         *  Where to decode the image. It is resized to fDst's dimensions, as with
+         *  SkCodec::getResizedPixels(), and converted to fDst's color type and color space.
+         */
+        SkPixmap fDst;
+        /** Set by decode(). kSuccess or kIncompleteInput if fDst holds the image. */
+        SkCodec::Result fResult = SkCodec::kUnimplemented;
+    };
+
+    SkBatchDecoder();
+    explicit SkBatchDecoder(const Options&);
+    ~SkBatchDecoder();
+
+    /**
+     *  Decodes each of images into its fDst and sets its fResult. An image no codec can be
+     *  made for gets the Result SkCodec::MakeFromStream() reports (e.g. kUnimplemented for an
+     *  unknown format), and one that fails to decode keeps whatever was written to fDst.
+     */
+    void decode(SkSpan<Image> images);
+
+private:
+    class Context;
+
+    const Options                         fOptions;
+    std::vector<std::unique_ptr<Context>> fContexts;
+};
+
+#endif  // SkBatchDecoder_DEFINED
@@ -13,6 +13,7 @@
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkSpan.h"
 #include "include/core/SkTypes.h"
@@ -30,6 +31,7 @@
 #include <vector>
 
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkImage;
 class SkPngChunkReader;
@@ -324,14 +326,16 @@ public:
             , fSubset(nullptr)
             , fFrameIndex(0)
             , fPriorFrame(kNoFrame)
+            , fExecutor(nullptr)
         {}
 
         ZeroInitialized            fZeroInitialized;
         /**
          *  If not NULL, represents a subset of the original image to decode.
          *  Must be within the bounds returned by getInfo().
-         *  If the EncodedFormat is SkEncodedImageFormat::kWEBP (the only one which
-         *  currently supports subsets), the top and left values must be even.
+         *  Only kPNG and kWEBP currently support subsets. For kWEBP, the top and
+         *  left values must be even. For kPNG, rows above the subset are still
+         *  decompressed, but only the subset's pixels are converted and written.
          *
          *  In getPixels and incremental decode, we will attempt to decode the
          *  exact rectangular subset specified by fSubset.
@@ -367,6 +371,15 @@ public:
          *  If set to kNoFrame, the codec will decode any necessary required frame(s) first.
          */
         int                        fPriorFrame;
+
+        /**
+         *  If not NULL, getPixels() may decode parts of the image in parallel on this executor,
+         *  returning once they are all done. The pixels are the same as a serial decode's.
+         *
+         *  Currently only used by JPEG images with restart markers, when they are decoded
+         *  from memory. Ignored by incremental and scanline decodes.
+         */
+        SkExecutor*                fExecutor;
     };
 
     /**
@@ -417,6 +430,19 @@ public:
         return this->getPixels(pm.info(), pm.writable_addr(), pm.rowBytes(), opts);
     }
 
+    /**
+     *  Decode into pm, resizing the image to pm's dimensions with a high quality cubic filter.
+     *  Unlike getPixels(), any size is allowed.
+     *
+     *  The image is decoded at the smallest size the codec supports (see getScaledDimensions())
+     *  that still covers pm, and resampled a few rows at a time as they are decoded. Only codecs
+     *  that decode scanlines from the top down avoid holding the whole image at that size.
+     *
+     *  Like getPixels(), this ignores the origin.
+     */
+    Result getResizedPixels(const SkPixmap& pm,
+                            const SkCubicResampler& cubic = SkCubicResampler::Mitchell());
+
     /**
      *  Return an image containing the pixels. If the codec's origin is not "upper left",
      *  This will rotate the output image accordingly.
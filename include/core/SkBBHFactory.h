@@ -9,6 +9,7 @@
 #define SkBBHFactory_DEFINED
 
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSpan.h"
 #include "include/core/SkTypes.h"
 
 // TODO(kjlubick) fix client users and then make this a forward declare
@@ -34,6 +35,13 @@ public:
      */
     virtual void search(const SkRect& query, std::vector<int>* results) const = 0;
 
+    /**
+     * Populate results[i] with the indices of bounding boxes intersecting queries[i], for each
+     * of the queries. The default calls search() once per query; subclasses may override this
+     * to share one traversal between all of the queries.
+     */
+    virtual void searchBatch(SkSpan<const SkRect> queries, std::vector<int> results[]) const;
+
     /**
      * Return approximate size in memory of *this.
      */
@@ -64,4 +72,13 @@ public:
     sk_sp<SkBBoxHierarchy> operator()() const override;
 };
 
+/**
+ *  Makes R-Trees that are packed into flat arrays and searched with SIMD. They use less memory
+ *  and are faster to search than SkRTreeFactory's, which helps pictures with many ops.
+ */
+class SK_API SkFlatRTreeFactory : public SkBBHFactory {
+public:
+    sk_sp<SkBBoxHierarchy> operator()() const override;
+};
+
 #endif
@@ -82,6 +82,19 @@ public:
      */
     static int SetTypefaceCacheCountLimit(int count);
 
+    /**
+     *  Return the current limit to the number of entries in the cache of runtime effects that
+     *  Skia compiles for itself (e.g. when deserializing SkRuntimeEffect-based shaders).
+     */
+    static int GetRuntimeEffectCacheCountLimit();
+
+    /**
+     *  Set the limit to the number of entries in the runtime effect cache, and return the
+     *  previous value. If this new value is lower than the previous, the least recently used
+     *  entries are purged to meet the new limit.
+     */
+    static int SetRuntimeEffectCacheCountLimit(int count);
+
     /**
      *  For debugging purposes, this will attempt to purge the font cache. It
      *  does not change the limit, but will cause subsequent font measures and
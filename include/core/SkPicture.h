@@ -87,6 +87,23 @@ public:
     static sk_sp<SkPicture> MakeFromData(const void* data, size_t size,
                                          const SkDeserialProcs* procs = nullptr);
 
+    /** Like MakeFromData(), but the returned SkPicture refers to data instead of copying out of
+        it, and keeps data alive for as long as it needs it. Drawing commands are replayed
+        directly from data each time the picture is drawn, and encoded images stay as subsets of
+        data until they are first decoded.
+
+        This is intended for large SKPs mapped into memory with SkData::MakeFromFD() or
+        SkData::MakeFromFileName(): loading them touches little more than the paints and paths,
+        and the mapped pages can be shared and reclaimed by the system. Drawing the returned
+        picture is somewhat slower than drawing one from MakeFromData().
+
+        @param data   container for serial data
+        @param procs  custom serial data decoders; may be nullptr
+        @return       SkPicture constructed from data
+    */
+    static sk_sp<SkPicture> MakeFromDataWithoutCopy(sk_sp<SkData> data,
+                                                    const SkDeserialProcs* procs = nullptr);
+
     /** \class SkPicture::AbortCallback
         AbortCallback is an abstract class. An implementation of AbortCallback may
         passed as a parameter to SkPicture::playback, to stop it before all drawing
@@ -252,13 +269,15 @@ private:
     SkPicture();
     friend class SkBigPicture;
     friend class SkEmptyPicture;
+    friend class SkMappedPicture;
     friend class SkPicturePriv;
 
     void serialize(SkWStream*, const SkSerialProcs*, class SkRefCntSet* typefaces,
         bool textBlobsOnly=false) const;
     static sk_sp<SkPicture> MakeFromStreamPriv(SkStream*, const SkDeserialProcs*,
                                                class SkTypefacePlayback*,
-                                               int recursionLimit);
+                                               int recursionLimit,
+                                               const sk_sp<SkData>& backingData = nullptr);
     friend class SkPictureData;
 
     /** Return true if the SkStream/Buffer represents a serialized picture, and
@@ -109,6 +109,7 @@ private:
     void setTemporarilyImmutable();
     void restoreMutability();
     friend class SkSurface_Raster;  // For temporary immutable methods above.
+    friend class SkSurface_RasterTiled;
 
     void setImmutableWithID(uint32_t genID);
     friend void SkBitmapCache_setImmutableWithID(SkPixelRef*, uint32_t);
@@ -92,6 +92,11 @@ struct SK_API SkSerialProcs {
 
     SkSerialTypefaceProc fTypefaceProc = nullptr;
     void*                fTypefaceCtx = nullptr;
+
+    // Pads the sections of a serialized picture to 4 bytes, so that
+    // SkPicture::MakeFromDataWithoutCopy() can read them in place instead of copying them. Builds
+    // of Skia that predate this flag cannot read pictures written with it.
+    bool                 fAlignPictureSections = false;
 };
 
 struct SK_API SkDeserialProcs {
@@ -30,6 +30,7 @@ class SkBitmap;
 class SkCanvas;
 class SkCapabilities;
 class SkColorSpace;
+class SkExecutor;
 class SkPaint;
 class SkSurface;
 struct SkIRect;
@@ -82,6 +83,32 @@ inline sk_sp<SkSurface> Raster(const SkImageInfo& imageInfo,
     return Raster(imageInfo, 0, props);
 }
 
+/** Allocates raster SkSurface whose SkCanvas records draws rather than rasterizing them
+    immediately. Recorded draws are binned into tiles of tileSize and the tiles are rasterized
+    concurrently on executor the next time the pixels are needed, i.e. by makeImageSnapshot(),
+    draw(), readPixels(), peekPixels() or writePixels(). Draws that cross tiles, and layers, are
+    rasterized in order on a single thread between the tiles. The resulting pixels are identical
+    to those produced by a surface returned from Raster().
+
+    The SkCanvas returned by this SkSurface has no pixels of its own: call readPixels() and
+    peekPixels() on the SkSurface rather than on its SkCanvas.
+
+    Pixel memory is deleted when SkSurface is deleted.
+
+    @param imageInfo     width, height, SkColorType, SkAlphaType, SkColorSpace,
+                         of raster surface; width and height must be greater than zero
+    @param executor      runs the tile rasterization tasks; if nullptr,
+                         SkExecutor::GetDefault() is used. Must outlive the SkSurface.
+    @param tileSize      dimensions of each tile; must be greater than zero
+    @param surfaceProps  LCD striping orientation and setting for device independent fonts;
+                         may be nullptr
+    @return              SkSurface if parameters are valid and memory was allocated, else nullptr.
+*/
+SK_API sk_sp<SkSurface> RasterTiled(const SkImageInfo& imageInfo,
+                                    SkExecutor* executor,
+                                    SkISize tileSize = {256, 256},
+                                    const SkSurfaceProps* surfaceProps = nullptr);
+
 /** Allocates raster SkSurface. SkCanvas returned by SkSurface draws directly into the
     provided pixels.
 
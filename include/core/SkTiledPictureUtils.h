@@ -0,0 +1,51 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTiledPictureUtils_DEFINED
+#define SkTiledPictureUtils_DEFINED
+
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSurface.h"
+#include "include/private/base/SkAPI.h"
+
+#include <vector>
+
+class SkExecutor;
+class SkPicture;
+class SkSurfaceProps;
+
+/** \namespace SkTiledPictureUtils
+    SkTiledPictureUtils rasterizes an SkPicture into a grid of separate raster tiles, drawing the
+    tiles concurrently. Pictures recorded with an SkBBHFactory have the ops for every tile found
+    with a single batched query of their bounding-box hierarchy, rather than one query per tile.
+*/
+namespace SkTiledPictureUtils {
+
+/**
+ *  Rasterizes the part of picture inside bounds (in picture coordinates) into a grid of tiles,
+ *  each of them a raster surface made with tileInfo and props. Tile (x, y) shows the area of the
+ *  picture whose top-left corner is
+ *  (bounds.left() + x * tileInfo.width(), bounds.top() + y * tileInfo.height()); anything outside
+ *  of bounds is left clear. The tiles are returned in row-major order.
+ *
+ *  The tiles are drawn as tasks on executor, or one after another on the calling thread if
+ *  executor is null. In either case they are all finished when this returns.
+ *
+ *  Returns an empty vector if picture is null, bounds or tileInfo is empty, or a tile surface
+ *  could not be made.
+ */
+SK_API std::vector<sk_sp<SkSurface>> RasterizeTiles(const SkPicture* picture,
+                                                    const SkIRect& bounds,
+                                                    const SkImageInfo& tileInfo,
+                                                    SkExecutor* executor,
+                                                    const SkSurfaceProps* props = nullptr);
+
+}  // namespace SkTiledPictureUtils
+
+#endif  // SkTiledPictureUtils_DEFINED
@@ -162,7 +162,8 @@ struct Metadata {
     /** Executor to handle threaded work within PDF Backend. If this is nullptr,
         then all work will be done serially on the main thread. To have worker
         threads assist with various tasks, set this to a valid SkExecutor
-        instance. Currently used for executing Deflate algorithm in parallel.
+        instance. Currently used for executing Deflate algorithm in parallel,
+        both across streams and across blocks of large streams.
 
         If set, the PDF output will be non-reproducible in the order and
         internal numbering of objects, but should render the same.
@@ -178,6 +179,11 @@ struct Metadata {
         Default = -1,
         None = 0,
         LowButFast = 1,
+        /** Settings tuned separately for images and for everything else:
+            faster than Average, for output a few percent larger, or even
+            smaller for content streams.
+        */
+        Balanced = 4,
         Average = 6,
         HighButSlow = 9,
     } fCompressionLevel = CompressionLevel::Default;
@@ -186,6 +192,17 @@ struct Metadata {
     enum Subsetter {
         kHarfbuzz_Subsetter,
     } fSubsetter = kHarfbuzz_Subsetter;
+
+    /** If true, each page object is written to the stream as soon as the page
+        ends, rather than being held until the document is closed, so that the
+        memory used by a document no longer grows with its number of pages.
+        Page contents, images and other resources are always written as soon as
+        they are complete; fonts are still subset and written on close.
+
+        The output is a valid PDF either way, but the page tree and the order
+        of objects differ.
+    */
+    bool fStreamPages = false;
 };
 
 /** Associate a node ID with subsequent drawing commands in an
@@ -264,6 +264,50 @@ public:
     bool allowColorFilter()   const { return (fFlags & kAllowColorFilter_Flag);   }
     bool allowBlender()       const { return (fFlags & kAllowBlender_Flag);       }
 
+    /**
+     * Storage that persists between processes for the raster-pipeline programs which runtime
+     * effects compile the first time they are drawn on the CPU. With a cache installed, making an
+     * effect whose program a previous process stored loads that program and the effect's uniforms
+     * and children, and does not parse the SkSL. It is only parsed if the effect is used with a
+     * GPU backend or traced.
+     *
+     * Keys cover the SkSL source, the effect's options and the Skia build. load() must return
+     * exactly the bytes that were passed to store() for the same key. Loaded programs are trusted,
+     * so the storage must only be writable by trusted processes. Both methods may be called from
+     * multiple threads at once.
+     */
+    class SK_API PersistentCache {
+    public:
+        virtual ~PersistentCache() = default;
+
+        /**
+         * Returns the data for the key if it exists in the cache, otherwise returns null.
+         */
+        virtual sk_sp<SkData> load(const SkData& key) = 0;
+
+        /**
+         * Stores data in the cache, indexed by key.
+         */
+        virtual void store(const SkData& key, const SkData& data) = 0;
+
+    protected:
+        PersistentCache() = default;
+        PersistentCache(const PersistentCache&) = delete;
+        PersistentCache& operator=(const PersistentCache&) = delete;
+    };
+
+    /**
+     * Installs the cache used by every runtime effect, or removes it when passed null. The cache
+     * is not owned, and must outlive any drawing done while it is installed.
+     */
+    static void SetPersistentCache(PersistentCache*);
+
+    /**
+     * Returns a PersistentCache that keeps one file per entry in the given directory, which is
+     * created if it does not exist. Returns null if the directory can't be created.
+     */
+    static std::unique_ptr<PersistentCache> MakeFilePersistentCache(const char* directory);
+
     static void RegisterFlattenables();
     ~SkRuntimeEffect() override;
 
@@ -288,15 +332,34 @@ private:
                     std::vector<SkSL::SampleUsage>&& sampleUsages,
                     uint32_t flags);
 
+    // Makes an effect from a persistent cache entry. The names of the uniforms and children point
+    // into `cacheEntry`, and `source` is only parsed when the SkSL program is needed.
+    SkRuntimeEffect(std::string source,
+                    SkSL::ProgramKind kind,
+                    const Options& options,
+                    sk_sp<SkData> cacheEntry,
+                    std::vector<Uniform>&& uniforms,
+                    std::vector<Child>&& children,
+                    std::vector<SkSL::SampleUsage>&& sampleUsages,
+                    uint32_t flags,
+                    SkSL::Version requiredSkSLVersion,
+                    std::unique_ptr<SkSL::RP::Program> rpProgram);
+
     sk_sp<SkRuntimeEffect> makeUnoptimizedClone();
 
     static Result MakeFromSource(SkString sksl, const Options& options, SkSL::ProgramKind kind);
 
+    static sk_sp<SkRuntimeEffect> MakeFromCacheEntry(std::string source,
+                                                     SkSL::ProgramKind kind,
+                                                     const Options& options,
+                                                     sk_sp<SkData> cacheEntry);
+
     static Result MakeInternal(std::unique_ptr<SkSL::Program> program,
                                const Options& options,
                                SkSL::ProgramKind kind);
 
     static SkSL::ProgramSettings MakeSettings(const Options& options);
+    static uint32_t HashSourceAndOptions(const std::string& source, const Options& options);
 
     uint32_t hash() const { return fHash; }
     bool usesSampleCoords()   const { return (fFlags & kUsesSampleCoords_Flag);   }
@@ -305,10 +368,12 @@ private:
     bool alwaysOpaque()       const { return (fFlags & kAlwaysOpaque_Flag);       }
     bool isAlphaUnchanged()   const { return (fFlags & kAlphaUnchanged_Flag);     }
 
+    // Returns the parsed SkSL program, parsing it first if the effect came from a persistent cache.
+    const SkSL::Program& baseProgram() const;
     const SkSL::RP::Program* getRPProgram(SkSL::DebugTracePriv* debugTrace) const;
 
-    friend class GrSkSLFP;              // usesColorTransform
-    friend class SkRuntimeShader;       // fBaseProgram, fMain, fSampleUsages, getRPProgram()
+    friend class GrSkSLFP;              // usesColorTransform, baseProgram()
+    friend class SkRuntimeShader;       // fSampleUsages, getRPProgram()
     friend class SkRuntimeBlender;      //
     friend class SkRuntimeColorFilter;  //
 
@@ -317,10 +382,19 @@ private:
     uint32_t fHash;
     uint32_t fStableKey;
 
-    std::unique_ptr<SkSL::Program> fBaseProgram;
+    Options fOptions;
+    SkSL::ProgramKind fKind;
+    SkSL::Version fRequiredSkSLVersion;
+
+    // Effects loaded from a persistent cache keep their source here, and parse it on demand.
+    const std::unique_ptr<const std::string> fUnparsedSource;
+    const sk_sp<SkData> fCacheEntry;
+
+    mutable std::unique_ptr<SkSL::Program> fBaseProgram;
+    mutable const SkSL::FunctionDefinition* fMain;
+    mutable SkOnce fParseOnce;
     std::unique_ptr<SkSL::RP::Program> fRPProgram;
     mutable SkOnce fCompileRPProgramOnce;
-    const SkSL::FunctionDefinition& fMain;
     std::vector<Uniform> fUniforms;
     std::vector<Child> fChildren;
     std::vector<SkSL::SampleUsage> fSampleUsages;
@@ -10,14 +10,17 @@
 
 #include "include/codec/SkEncodedOrigin.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSize.h"
 #include "include/private/base/SkAPI.h"
 
 #include <memory>
 #include <optional>
+#include <vector>
 
 class SkColorSpace;
 class SkData;
 class SkEncoder;
+class SkExecutor;
 class SkPixmap;
 class SkWStream;
 class SkImage;
@@ -114,6 +117,22 @@ SK_API bool Encode(SkWStream* dst,
 */
 SK_API sk_sp<SkData> Encode(GrDirectContext* ctx, const SkImage* img, const Options& options);
 
+/**
+ *  Encode each |tileSize| tile of |src| as its own jpeg, for example to serve as map tiles.
+ *  The tiles are returned in row-major order starting from the top left of |src|; those in the
+ *  last column and row are cropped to |src|.  The metadata, including the ICC profile, is made
+ *  once and written to every tile.
+ *
+ *  The tiles are encoded concurrently on |executor|, or one after another if it is nullptr.
+ *
+ *  Returns an empty vector on an invalid or unsupported |src|, an empty |tileSize|, or if any
+ *  tile fails to encode.
+ */
+SK_API std::vector<sk_sp<SkData>> EncodeTiles(const SkPixmap& src,
+                                              SkISize tileSize,
+                                              const Options& options,
+                                              SkExecutor* executor = nullptr);
+
 /**
  *  Create a jpeg encoder that will encode the |src| pixels to the |dst| stream.
  *  |options| may be used to control the encoding behavior.
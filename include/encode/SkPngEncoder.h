@@ -19,6 +19,7 @@
 
 class GrDirectContext;
 class SkData;
+class SkExecutor;
 class SkImage;
 class SkPixmap;
 class SkWStream;
@@ -80,6 +81,17 @@ struct Options {
      */
     const skcms_ICCProfile* fICCProfile = nullptr;
     const char* fICCProfileDescription = nullptr;
+
+    /**
+     *  If set, Encode() filters and compresses bands of rows concurrently on this executor.
+     *  Each band is deflated on its own, primed with the end of the band above it, and the
+     *  bands are joined into the single zlib stream that the png format calls for.  The
+     *  result can be read by any png decoder, but is not byte-for-byte the same as a serial
+     *  encode and is usually slightly larger.
+     *
+     *  This does not apply to the incremental encoders returned by Make().
+     */
+    SkExecutor* fExecutor = nullptr;
 };
 
 /**
@@ -9,10 +9,14 @@
 #define SkWebpEncoder_DEFINED
 
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSize.h"
 #include "include/core/SkSpan.h" // IWYU pragma: keep
 #include "include/encode/SkEncoder.h"
 #include "include/private/base/SkAPI.h"
 
+#include <vector>
+
+class SkExecutor;
 class SkPixmap;
 class SkWStream;
 class SkData;
@@ -72,6 +76,23 @@ SK_API bool Encode(SkWStream* dst, const SkPixmap& src, const Options& options);
 */
 SK_API sk_sp<SkData> Encode(GrDirectContext* ctx, const SkImage* img, const Options& options);
 
+/**
+ *  Encode each |tileSize| tile of |src| as its own webp, for example to serve as map tiles.
+ *  The tiles are returned in row-major order starting from the top left of |src|; those in the
+ *  last column and row are cropped to |src|.  The ICC profile is made once and embedded in
+ *  every tile.
+ *
+ *  The tiles are encoded concurrently on |executor|, or one after another if it is nullptr.
+ *  Each thread keeps the buffer it converts pixels into between tiles.
+ *
+ *  Returns an empty vector on an invalid or unsupported |src|, an empty |tileSize|, or if any
+ *  tile fails to encode.
+ */
+SK_API std::vector<sk_sp<SkData>> EncodeTiles(const SkPixmap& src,
+                                              SkISize tileSize,
+                                              const Options& options,
+                                              SkExecutor* executor = nullptr);
+
 /**
  *  Encode the |src| frames to the |dst| stream.
  *  |options| may be used to control the encoding behavior.
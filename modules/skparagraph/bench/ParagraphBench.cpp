@@ -12,8 +12,13 @@
 #include "tools/Resources.h"
 #include "tools/fonts/FontToolUtils.h"
 
+#include <algorithm>
 #include <cfloat>
+#include <memory>
+#include <vector>
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPictureRecorder.h"
+#include "include/core/SkString.h"
 #include "modules/skparagraph/utils/TestFontCollection.h"
 
 using namespace skia::textlayout;
@@ -47,15 +52,187 @@ struct ParagraphBench : public Benchmark {
         SkCanvas* canvas = rec.beginRecording({0,0, 2000,3000});
         while (loops-- > 0) {
             paragraph->layout(fWidth);
-            auto impl = static_cast<ParagraphImpl*>(paragraph.get());
             paragraph->paint(canvas, 0, 0);
             paragraph->markDirty();
-            impl->resetCache();
+            fontCollection->getParagraphCache()->reset();
         }
     }
 };
+
+// Lays out many short, distinct paragraphs that share a FontCollection, as exporting a document
+// would, either one after another or with Paragraph::LayoutAll on a thread pool.
+struct ParagraphBatchBench : public Benchmark {
+    ParagraphBatchBench(int paragraphCount, int threads)
+            : fParagraphCount(paragraphCount), fThreads(threads) {
+        fName.printf("paragraph_batch_%d_%s", paragraphCount,
+                     threads ? SkStringPrintf("%d_threads", threads).c_str() : "serial");
+    }
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+    void onDelayedSetup() override {
+        sk_sp<SkData> data = GetResourceAsData("text/english.txt");
+        if (!data) {
+            return;
+        }
+        std::vector<SkString> lines;
+        const char* text = (const char*)data->data();
+        const char* end = text + data->size();
+        while (text < end) {
+            const char* lineEnd = std::find(text, end, '\n');
+            if (lineEnd > text) {
+                lines.emplace_back(text, lineEnd - text);
+            }
+            text = lineEnd + 1;
+        }
+
+        auto fontCollection = sk_make_sp<FontCollection>();
+        fontCollection->setDefaultFontManager(ToolUtils::TestFontMgr());
+        ParagraphStyle paragraph_style;
+        paragraph_style.turnHintingOff();
+        for (int i = 0; i < fParagraphCount; ++i) {
+            // Number the paragraphs so they aren't found in the paragraph cache.
+            SkString paragraphText = SkStringPrintf("%d. %s", i, lines[i % lines.size()].c_str());
+            ParagraphBuilderImpl builder(paragraph_style, fontCollection);
+            builder.addText(paragraphText.c_str(), paragraphText.size());
+            fParagraphs.push_back(builder.Build());
+        }
+        if (fThreads) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            for (auto& paragraph : fParagraphs) {
+                paragraph->markDirty();
+            }
+            Paragraph::LayoutAll(fParagraphs, 500, fExecutor.get());
+        }
+    }
+
+    const int fParagraphCount;
+    const int fThreads;
+    SkString fName;
+    std::vector<std::unique_ptr<Paragraph>> fParagraphs;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+// Types into the middle of a 50KB paragraph, one keystroke per loop (typing a letter and then
+// deleting it), and lays it out again after each, either with updateText() reusing what the
+// edit did not touch or from scratch.
+struct ParagraphTypingBench : public Benchmark {
+    ParagraphTypingBench(bool incremental) : fIncremental(incremental) {
+        fName.printf("paragraph_typing_50k_%s", incremental ? "incremental" : "full");
+    }
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+    void onDelayedSetup() override {
+        sk_sp<SkData> data = GetResourceAsData("text/english.txt");
+        if (!data) {
+            return;
+        }
+        SkString text;
+        while (text.size() < 50 * 1024) {
+            text.append((const char*)data->data(), data->size());
+        }
+
+        fFontCollection = sk_make_sp<FontCollection>();
+        fFontCollection->setDefaultFontManager(ToolUtils::TestFontMgr());
+        ParagraphStyle paragraph_style;
+        paragraph_style.turnHintingOff();
+        ParagraphBuilderImpl builder(paragraph_style, fFontCollection);
+        builder.addText(text.c_str(), text.size());
+        fParagraph = builder.Build();
+        fParagraph->layout(kWidth);
+        fCaret = text.size() / 2;
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fParagraph) {
+            return;
+        }
+        while (loops-- > 0) {
+            if (fTyped) {
+                fParagraph->updateText(fCaret, fCaret + 1, SkString());
+            } else {
+                fParagraph->updateText(fCaret, fCaret, SkString("x"));
+            }
+            fTyped = !fTyped;
+            if (!fIncremental) {
+                fParagraph->markDirty();
+                fFontCollection->getParagraphCache()->reset();
+            }
+            fParagraph->layout(kWidth);
+        }
+    }
+
+    static constexpr SkScalar kWidth = 500;
+    const bool fIncremental;
+    SkString fName;
+    sk_sp<FontCollection> fFontCollection;
+    std::unique_ptr<Paragraph> fParagraph;
+    size_t fCaret = 0;
+    bool fTyped = false;
+};
+
+// Sizes the cells of a table: every cell is broken at two widths, as it would be while a column
+// is resized. The text stays shaped, so the lines are all that is built again.
+struct ParagraphMeasureBench : public Benchmark {
+    ParagraphMeasureBench(bool measureOnly) : fMeasureOnly(measureOnly) {
+        fName.printf("paragraph_table_cells_%s", measureOnly ? "measure" : "layout");
+    }
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+    void onDelayedSetup() override {
+        sk_sp<SkData> data = GetResourceAsData("text/english.txt");
+        if (!data) {
+            return;
+        }
+
+        auto fontCollection = sk_make_sp<FontCollection>();
+        fontCollection->setDefaultFontManager(ToolUtils::TestFontMgr());
+        ParagraphStyle paragraph_style;
+        paragraph_style.turnHintingOff();
+        const char* text = (const char*)data->data();
+        const size_t cellSize = std::min<size_t>(data->size(), 200);
+        for (int i = 0; i < kCells; ++i) {
+            ParagraphBuilderImpl builder(paragraph_style, fontCollection);
+            const size_t start = (i * 37) % (data->size() - cellSize + 1);
+            builder.addText(text + start, cellSize);
+            fCells.push_back(builder.Build());
+        }
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            for (auto& cell : fCells) {
+                for (SkScalar width : {kNarrow, kWide}) {
+                    if (fMeasureOnly) {
+                        cell->measure(width);
+                    } else {
+                        cell->layout(width);
+                    }
+                }
+            }
+        }
+    }
+
+    static constexpr int kCells = 500;
+    static constexpr SkScalar kNarrow = 120;
+    static constexpr SkScalar kWide = 180;
+    const bool fMeasureOnly;
+    SkString fName;
+    std::vector<std::unique_ptr<Paragraph>> fCells;
+};
 }  // namespace
 
+DEF_BENCH(return new ParagraphBatchBench(1000, 0);)
+DEF_BENCH(return new ParagraphBatchBench(1000, 4);)
+DEF_BENCH(return new ParagraphBatchBench(1000, 8);)
+
+DEF_BENCH(return new ParagraphTypingBench(false);)
+DEF_BENCH(return new ParagraphTypingBench(true);)
+
+DEF_BENCH(return new ParagraphMeasureBench(false);)
+DEF_BENCH(return new ParagraphMeasureBench(true);)
+
 #define PARAGRAPH_BENCH(X) DEF_BENCH(return new ParagraphBench(50000, "text/" #X ".txt", "paragraph_" #X);)
 //PARAGRAPH_BENCH(arabic)
 //PARAGRAPH_BENCH(emoji)
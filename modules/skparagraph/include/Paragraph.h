@@ -3,13 +3,16 @@
 #define Paragraph_DEFINED
 
 #include "include/core/SkPath.h"
+#include "include/core/SkSpan.h"
 #include "modules/skparagraph/include/FontCollection.h"
 #include "modules/skparagraph/include/Metrics.h"
 #include "modules/skparagraph/include/ParagraphStyle.h"
 #include "modules/skparagraph/include/TextStyle.h"
+#include <memory>
 #include <unordered_set>
 
 class SkCanvas;
+class SkExecutor;
 
 namespace skia {
 namespace textlayout {
@@ -41,6 +44,12 @@ public:
 
     virtual void layout(SkScalar width) = 0;
 
+    // Finds only the sizes a layout at this width would have: getHeight(), getLongestLine(),
+    // getMin/MaxIntrinsicWidth(), the baselines, didExceedMaxLines() and lineNumber().
+    // The lines themselves are not built, so nothing else (painting, line metrics, hit testing)
+    // works until layout() is called; that keeps the shaped text and does not shape it again.
+    virtual void measure(SkScalar width) = 0;
+
     virtual void paint(SkCanvas* canvas, SkScalar x, SkScalar y) = 0;
 
     virtual void paint(ParagraphPainter* painter, SkScalar x, SkScalar y) = 0;
@@ -80,6 +89,14 @@ public:
     virtual void updateForegroundPaint(size_t from, size_t to, SkPaint paint) = 0;
     virtual void updateBackgroundPaint(size_t from, size_t to, SkPaint paint) = 0;
 
+    // Experimental: replaces the UTF-8 text in [from, to) with text, which takes the style of the
+    // text before it. If the paragraph is a single left-to-right run of text without placeholders
+    // or letter/word spacing, and the edit falls inside one text style, the next layout() only
+    // reshapes the words around the edit and reuses the lines that did not change;
+    // otherwise it lays out the whole paragraph again.
+    // The edit must not cut through a placeholder.
+    virtual void updateText(size_t from, size_t to, const SkString& text) = 0;
+
     enum VisitorFlags {
         kWhiteSpace_VisitorFlag = 1 << 0,
     };
@@ -127,6 +144,19 @@ public:
      */
     static SkPath GetPath(SkTextBlob* textBlob);
 
+    /* Lays out each paragraph at the given width, as calling layout(width) on each would.
+     * If executor is set the paragraphs are laid out concurrently on it; this still returns
+     * only once they are all done. Paragraphs may share a FontCollection, but no paragraph
+     * may appear twice or be used elsewhere until this returns.
+     *
+     * @param paragraphs  the paragraphs to lay out
+     * @param width       the width to lay them out at
+     * @param executor    the executor to lay them out on, or null to lay them out in turn
+     */
+    static void LayoutAll(SkSpan<const std::unique_ptr<Paragraph>> paragraphs,
+                          SkScalar width,
+                          SkExecutor* executor);
+
     /* Checks if a given text blob contains
      * glyph with emoji
      *
@@ -2,9 +2,12 @@
 #ifndef ParagraphCache_DEFINED
 #define ParagraphCache_DEFINED
 
+#include "include/core/SkString.h"
 #include "include/private/base/SkMutex.h"
-#include "src/core/SkLRUCache.h"
+#include "include/private/base/SkThreadAnnotations.h"
+#include <atomic>
 #include <functional>  // std::function
+#include <memory>
 
 #define PARAGRAPH_CACHE_STATS
 
@@ -17,7 +20,11 @@ class ParagraphCacheValue;
 
 class ParagraphCache {
 public:
-    ParagraphCache();
+    static constexpr int kDefaultMaxEntries = 128;
+
+    // The entries are spread over several independently locked LRU shards by their hash, so
+    // paragraphs laid out on different threads rarely wait for each other.
+    explicit ParagraphCache(int maxEntries = kDefaultMaxEntries);
     ~ParagraphCache();
 
     void abandon();
@@ -25,13 +32,17 @@ public:
     bool updateParagraph(ParagraphImpl* paragraph);
     bool findParagraph(ParagraphImpl* paragraph);
 
+    // Evicts the least recently used entries (of each shard) if there are now too many.
+    void setMaxEntries(int maxEntries);
+    int maxEntries() const { return fMaxEntries.load(std::memory_order_relaxed); }
+
     // For testing
     void setChecker(std::function<void(ParagraphImpl* impl, const char*, bool)> checker) {
         fChecker = std::move(checker);
     }
     void printStatistics();
-    void turnOn(bool value) { fCacheIsOn = value; }
-    int count() { return fLRUCacheMap.count(); }
+    void turnOn(bool value) { fCacheIsOn.store(value, std::memory_order_relaxed); }
+    int count();
 
     bool isPossiblyTextEditing(ParagraphImpl* paragraph);
 
@@ -41,23 +52,32 @@ public:
     void updateFrom(const ParagraphImpl* paragraph, Entry* entry);
     void updateTo(ParagraphImpl* paragraph, const Entry* entry);
 
-     mutable SkMutex fParagraphMutex;
-     std::function<void(ParagraphImpl* impl, const char*, bool)> fChecker;
-
-    static const int kMaxEntries = 128;
-
     struct KeyHash {
         uint32_t operator()(const ParagraphCacheKey& key) const;
     };
 
-    SkLRUCache<ParagraphCacheKey, std::unique_ptr<Entry>, KeyHash> fLRUCacheMap;
-    bool fCacheIsOn;
-    ParagraphCacheValue* fLastCachedValue;
+    struct Shard;
+
+    static constexpr int kShardCount = 8;
+    Shard& shardFor(uint32_t hash) { return *fShards[hash % kShardCount]; }
+
+    std::function<void(ParagraphImpl* impl, const char*, bool)> fChecker;
+
+    // These can be changed while other threads are laying out paragraphs.
+    std::atomic<int> fMaxEntries;
+    std::unique_ptr<Shard> fShards[kShardCount];
+    std::atomic<bool> fCacheIsOn;
+
+    // The start and end of the text last added, for isPossiblyTextEditing(). They are kept
+    // apart from the entry, which another shard's thread could evict while they are compared.
+    SkMutex fLastCachedMutex;
+    SkString fLastCachedPrefix SK_GUARDED_BY(fLastCachedMutex);
+    SkString fLastCachedSuffix SK_GUARDED_BY(fLastCachedMutex);
 
 #ifdef PARAGRAPH_CACHE_STATS
-    int fTotalRequests;
-    int fCacheMisses;
-    int fHashMisses; // cache hit but hash table missed
+    std::atomic<int> fTotalRequests;
+    std::atomic<int> fCacheMisses;
+    std::atomic<int> fHashMisses; // cache hit but hash table missed
 #endif
 };
 
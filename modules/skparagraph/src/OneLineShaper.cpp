@@ -543,7 +543,7 @@ bool OneLineShaper::iterateThroughShapingRegions(const ShapeVisitor& shape) {
 
     size_t bidiIndex = 0;
 
-    SkScalar advanceX = 0;
+    SkScalar advanceX = fStartAdvance;
     for (auto& placeholder : fParagraph->fPlaceholders) {
 
         if (placeholder.fTextBefore.width() > 0) {
@@ -554,13 +554,16 @@ bool OneLineShaper::iterateThroughShapingRegions(const ShapeVisitor& shape) {
                 auto end = std::min(bidiRegion.end, placeholder.fTextBefore.end);
 
                 // Set up the iterators (the style iterator points to a bigger region that it could
-                TextRange textRange(start, end);
-                auto blockRange = fParagraph->findAllBlocks(textRange);
+                TextRange textRange(std::max(start, fShapingRange.start),
+                                    std::min(end, fShapingRange.end));
+                auto blockRange = textRange.start < textRange.end
+                                        ? fParagraph->findAllBlocks(textRange)
+                                        : EMPTY_RANGE;
                 if (!blockRange.empty()) {
                     SkSpan<Block> styleSpan(fParagraph->blocks(blockRange));
 
                     // Shape the text between placeholders
-                    if (!shape(textRange, styleSpan, advanceX, start, bidiRegion.level)) {
+                    if (!shape(textRange, styleSpan, advanceX, textRange.start, bidiRegion.level)) {
                         return false;
                     }
                 }
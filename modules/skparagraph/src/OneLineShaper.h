@@ -22,7 +22,17 @@ public:
         , fBaselineShift(0.0f)
         , fAdvance(SkPoint::Make(0.0f, 0.0f))
         , fUnresolvedGlyphs(0)
-        , fUniqueRunId(paragraph->fRuns.size()){ }
+        , fUniqueRunId(paragraph->fRuns.size())
+        , fShapingRange(0, paragraph->fText.size())
+        , fStartAdvance(0.0f) { }
+
+    // Shapes only the text in textRange, placing it at advanceX
+    // (used to reshape the text around an edit; there must be no placeholders)
+    OneLineShaper(ParagraphImpl* paragraph, TextRange textRange, SkScalar advanceX)
+        : OneLineShaper(paragraph) {
+        fShapingRange = textRange;
+        fStartAdvance = advanceX;
+    }
 
     bool shape();
 
@@ -120,6 +130,8 @@ private:
     SkVector fAdvance;
     size_t fUnresolvedGlyphs;
     size_t fUniqueRunId;
+    TextRange fShapingRange;
+    SkScalar fStartAdvance;
 
     // TODO: Something that is not thead-safe since we don't need it
     std::shared_ptr<Run> fCurrentRun;
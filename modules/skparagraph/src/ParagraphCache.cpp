@@ -5,12 +5,16 @@
 #include "modules/skparagraph/include/ParagraphCache.h"
 #include "modules/skparagraph/src/ParagraphImpl.h"
 #include "src/base/SkFloatBits.h"
+#include "src/core/SkLRUCache.h"
 
 using namespace skia_private;
 
 namespace skia {
 namespace textlayout {
 
+// Special situation: (very) long paragraph that is close to the last formatted paragraph
+#define NOCACHE_PREFIX_LENGTH 40
+
 namespace {
     int32_t relax(SkScalar a) {
         // This rounding is done to match Flutter tests. Must be removed..
@@ -238,17 +242,28 @@ struct ParagraphCache::Entry {
     std::unique_ptr<ParagraphCacheValue> fValue;
 };
 
-ParagraphCache::ParagraphCache()
+struct ParagraphCache::Shard {
+    explicit Shard(int maxEntries) : fLRUCacheMap(maxEntries) {}
+
+    SkMutex fParagraphMutex;
+    SkLRUCache<ParagraphCacheKey, std::unique_ptr<Entry>, KeyHash> fLRUCacheMap
+            SK_GUARDED_BY(fParagraphMutex);
+};
+
+ParagraphCache::ParagraphCache(int maxEntries)
     : fChecker([](ParagraphImpl* impl, const char*, bool){ })
-    , fLRUCacheMap(kMaxEntries)
+    , fMaxEntries(maxEntries)
     , fCacheIsOn(true)
-    , fLastCachedValue(nullptr)
 #ifdef PARAGRAPH_CACHE_STATS
     , fTotalRequests(0)
     , fCacheMisses(0)
     , fHashMisses(0)
 #endif
-{ }
+{
+    for (auto& shard : fShards) {
+        shard = std::make_unique<Shard>((maxEntries + kShardCount - 1) / kShardCount);
+    }
+}
 
 ParagraphCache::~ParagraphCache() { }
 
@@ -274,8 +289,8 @@ void ParagraphCache::updateTo(ParagraphImpl* paragraph, const Entry* entry) {
 
 void ParagraphCache::printStatistics() {
     SkDebugf("--- Paragraph Cache ---\n");
-    SkDebugf("Total requests: %d\n", fTotalRequests);
-    SkDebugf("Cache misses: %d\n", fCacheMisses);
+    SkDebugf("Total requests: %d\n", fTotalRequests.load());
+    SkDebugf("Cache misses: %d\n", fCacheMisses.load());
     SkDebugf("Cache miss %%: %f\n", (fTotalRequests > 0) ? 100.f * fCacheMisses / fTotalRequests : 0.f);
     int cacheHits = fTotalRequests - fCacheMisses;
     SkDebugf("Hash miss %%: %f\n", (cacheHits > 0) ? 100.f * fHashMisses / cacheHits : 0.f);
@@ -287,26 +302,48 @@ void ParagraphCache::abandon() {
 }
 
 void ParagraphCache::reset() {
-    SkAutoMutexExclusive lock(fParagraphMutex);
 #ifdef PARAGRAPH_CACHE_STATS
     fTotalRequests = 0;
     fCacheMisses = 0;
     fHashMisses = 0;
 #endif
-    fLRUCacheMap.reset();
-    fLastCachedValue = nullptr;
+    for (auto& shard : fShards) {
+        SkAutoMutexExclusive lock(shard->fParagraphMutex);
+        shard->fLRUCacheMap.reset();
+    }
+    SkAutoMutexExclusive lock(fLastCachedMutex);
+    fLastCachedPrefix.reset();
+    fLastCachedSuffix.reset();
+}
+
+void ParagraphCache::setMaxEntries(int maxEntries) {
+    fMaxEntries.store(maxEntries, std::memory_order_relaxed);
+    for (auto& shard : fShards) {
+        SkAutoMutexExclusive lock(shard->fParagraphMutex);
+        shard->fLRUCacheMap.setMaxCount((maxEntries + kShardCount - 1) / kShardCount);
+    }
+}
+
+int ParagraphCache::count() {
+    int count = 0;
+    for (auto& shard : fShards) {
+        SkAutoMutexExclusive lock(shard->fParagraphMutex);
+        count += shard->fLRUCacheMap.count();
+    }
+    return count;
 }
 
 bool ParagraphCache::findParagraph(ParagraphImpl* paragraph) {
-    if (!fCacheIsOn) {
+    if (!fCacheIsOn.load(std::memory_order_relaxed)) {
         return false;
     }
 #ifdef PARAGRAPH_CACHE_STATS
     ++fTotalRequests;
 #endif
-    SkAutoMutexExclusive lock(fParagraphMutex);
     ParagraphCacheKey key(paragraph);
-    std::unique_ptr<Entry>* entry = fLRUCacheMap.find(key);
+    Shard& shard = this->shardFor(key.hash());
+    SkAutoMutexExclusive lock(shard.fParagraphMutex);
+    std::unique_ptr<Entry>* entry = shard.fLRUCacheMap.find(key);
 
     if (!entry) {
         // We have a cache miss
@@ -322,26 +359,37 @@ bool ParagraphCache::findParagraph(ParagraphImpl* paragraph) {
 }
 
 bool ParagraphCache::updateParagraph(ParagraphImpl* paragraph) {
-    if (!fCacheIsOn) {
+    if (!fCacheIsOn.load(std::memory_order_relaxed)) {
         return false;
     }
 #ifdef PARAGRAPH_CACHE_STATS
     ++fTotalRequests;
 #endif
-    SkAutoMutexExclusive lock(fParagraphMutex);
+    // isTooMuchMemoryWasted(paragraph) not needed for now
+    if (isPossiblyTextEditing(paragraph)) {
+        // Skip this paragraph
+        return false;
+    }
 
     ParagraphCacheKey key(paragraph);
-    std::unique_ptr<Entry>* entry = fLRUCacheMap.find(key);
+    Shard& shard = this->shardFor(key.hash());
+    SkAutoMutexExclusive lock(shard.fParagraphMutex);
+    std::unique_ptr<Entry>* entry = shard.fLRUCacheMap.find(key);
     if (!entry) {
-        // isTooMuchMemoryWasted(paragraph) not needed for now
-        if (isPossiblyTextEditing(paragraph)) {
-            // Skip this paragraph
-            return false;
-        }
         ParagraphCacheValue* value = new ParagraphCacheValue(std::move(key), paragraph);
-        fLRUCacheMap.insert(value->fKey, std::make_unique<Entry>(value));
+        shard.fLRUCacheMap.insert(value->fKey, std::make_unique<Entry>(value));
         fChecker(paragraph, "addedParagraph", true);
-        fLastCachedValue = value;
+
+        SkAutoMutexExclusive lastLock(fLastCachedMutex);
+        const SkString& text = value->fKey.text();
+        if (text.size() < NOCACHE_PREFIX_LENGTH) {
+            fLastCachedPrefix.reset();
+            fLastCachedSuffix.reset();
+        } else {
+            fLastCachedPrefix.set(text.c_str(), NOCACHE_PREFIX_LENGTH);
+            fLastCachedSuffix.set(text.c_str() + text.size() - NOCACHE_PREFIX_LENGTH,
+                                  NOCACHE_PREFIX_LENGTH);
+        }
         return true;
     } else {
         // We do not have to update the paragraph
@@ -349,27 +397,21 @@ bool ParagraphCache::updateParagraph(ParagraphImpl* paragraph) {
     }
 }
 
-// Special situation: (very) long paragraph that is close to the last formatted paragraph
-#define NOCACHE_PREFIX_LENGTH 40
 bool ParagraphCache::isPossiblyTextEditing(ParagraphImpl* paragraph) {
-    if (fLastCachedValue == nullptr) {
-        return false;
-    }
-
-    auto& lastText = fLastCachedValue->fKey.text();
     auto& text = paragraph->fText;
 
-    if ((lastText.size() < NOCACHE_PREFIX_LENGTH) || (text.size() < NOCACHE_PREFIX_LENGTH)) {
+    SkAutoMutexExclusive lock(fLastCachedMutex);
+    if ((fLastCachedPrefix.isEmpty()) || (text.size() < NOCACHE_PREFIX_LENGTH)) {
         // Either last text or the current are too short
         return false;
     }
 
-    if (std::strncmp(lastText.c_str(), text.c_str(), NOCACHE_PREFIX_LENGTH) == 0) {
+    if (std::strncmp(fLastCachedPrefix.c_str(), text.c_str(), NOCACHE_PREFIX_LENGTH) == 0) {
         // Texts have the same starts
         return true;
     }
 
-    if (std::strncmp(lastText.c_str() + lastText.size() - NOCACHE_PREFIX_LENGTH, &text[text.size() - NOCACHE_PREFIX_LENGTH], NOCACHE_PREFIX_LENGTH) == 0) {
+    if (std::strncmp(fLastCachedSuffix.c_str(), &text[text.size() - NOCACHE_PREFIX_LENGTH], NOCACHE_PREFIX_LENGTH) == 0) {
         // Texts have the same ends
         return true;
     }
@@ -19,13 +19,17 @@
 #include "modules/skparagraph/src/Run.h"
 #include "modules/skparagraph/src/TextLine.h"
 #include "modules/skparagraph/src/TextWrapper.h"
+#include "modules/skshaper/include/SkShaper_harfbuzz.h"
 #include "modules/skunicode/include/SkUnicode.h"
 #include "src/base/SkUTF.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkTextBlobPriv.h"
 
 #include <algorithm>
 #include <cfloat>
 #include <cmath>
+#include <new>
+#include <optional>
 #include <utility>
 
 using namespace skia_private;
@@ -82,6 +86,7 @@ ParagraphImpl::ParagraphImpl(const SkString& text,
         , fText(text)
         , fState(kUnknown)
         , fUnresolvedGlyphs(0)
+        , fMeasuredLines(0)
         , fPicture(nullptr)
         , fStrutMetrics(false)
         , fOldWidth(0)
@@ -134,12 +139,22 @@ void ParagraphImpl::addUnresolvedCodepoints(TextRange textRange) {
     );
 }
 
-void ParagraphImpl::layout(SkScalar rawWidth) {
+SkScalar ParagraphImpl::roundWidth(SkScalar rawWidth) const {
     // TODO: This rounding is done to match Flutter tests. Must be removed...
     auto floorWidth = rawWidth;
     if (getApplyRoundingHack()) {
         floorWidth = SkScalarFloorToScalar(floorWidth);
     }
+    return floorWidth;
+}
+
+void ParagraphImpl::layout(SkScalar rawWidth) {
+    auto floorWidth = this->roundWidth(rawWidth);
+
+    if (fState == kMeasured) {
+        // The text is shaped but the lines were not built
+        fState = kShaped;
+    }
 
     if ((!SkIsFinite(rawWidth) || fLongestLine <= floorWidth) &&
         fState >= kLineBroken &&
@@ -155,57 +170,21 @@ void ParagraphImpl::layout(SkScalar rawWidth) {
         // Nothing changed case: we can reuse the data from the last layout
     }
 
-    if (fState < kShaped) {
-        // Check if we have the text in the cache and don't need to shape it again
-        if (!fFontCollection->getParagraphCache()->findParagraph(this)) {
-            if (fState < kIndexed) {
-                // This only happens once at the first layout; the text is immutable
-                // and there is no reason to repeat it
-                if (this->computeCodeUnitProperties()) {
-                    fState = kIndexed;
-                }
-            }
-            this->fRuns.clear();
-            this->fClusters.clear();
-            this->fClustersIndexFromCodeUnit.clear();
-            this->fClustersIndexFromCodeUnit.push_back_n(fText.size() + 1, EMPTY_INDEX);
-            if (!this->shapeTextIntoEndlessLine()) {
-                this->resetContext();
-                // TODO: merge the two next calls - they always come together
-                this->resolveStrut();
-                this->computeEmptyMetrics();
-                this->fLines.clear();
-
-                // Set the important values that are not zero
-                fWidth = floorWidth;
-                fHeight = fEmptyMetrics.height();
-                if (fParagraphStyle.getStrutStyle().getStrutEnabled() &&
-                    fParagraphStyle.getStrutStyle().getForceStrutHeight()) {
-                    fHeight = fStrutMetrics.height();
-                }
-                fAlphabeticBaseline = fEmptyMetrics.alphabeticBaseline();
-                fIdeographicBaseline = fEmptyMetrics.ideographicBaseline();
-                fLongestLine = FLT_MIN - FLT_MAX;  // That is what flutter has
-                fMinIntrinsicWidth = 0;
-                fMaxIntrinsicWidth = 0;
-                this->fOldWidth = floorWidth;
-                this->fOldHeight = this->fHeight;
-
-                return;
-            } else {
-                // Add the paragraph to the cache
-                fFontCollection->getParagraphCache()->updateParagraph(this);
-            }
-        }
-        fState = kShaped;
+    if (!this->shapeIfNeeded(floorWidth)) {
+        return;
     }
 
     if (fState == kShaped) {
+        if (fTextEdit != nullptr && fTextEdit->fWidth != floorWidth) {
+            // The lines from before the edit were broken at another width
+            fTextEdit.reset();
+        }
         this->resetContext();
         this->resolveStrut();
         this->computeEmptyMetrics();
         this->fLines.clear();
         this->breakShapedTextIntoLines(floorWidth);
+        fTextEdit.reset();
         fState = kLineBroken;
     }
 
@@ -216,6 +195,88 @@ void ParagraphImpl::layout(SkScalar rawWidth) {
         fState = kFormatted;
     }
 
+    this->finishLayout(floorWidth);
+}
+
+void ParagraphImpl::measure(SkScalar rawWidth) {
+    auto floorWidth = this->roundWidth(rawWidth);
+
+    if (fState >= kMeasured && fOldWidth == floorWidth) {
+        // Measured or laid out at this width already
+        return;
+    }
+    fState = std::min(fState, kShaped);
+
+    if (!this->shapeIfNeeded(floorWidth)) {
+        return;
+    }
+
+    this->resetContext();
+    this->resolveStrut();
+    this->computeEmptyMetrics();
+    this->fLines.clear();
+    this->breakShapedTextIntoLines(floorWidth, /*measureOnly=*/true);
+    fState = kMeasured;
+
+    this->finishLayout(floorWidth);
+}
+
+// Returns false if there is no text to shape, in which case the paragraph gets the sizes of an
+// empty line and the layout is done
+bool ParagraphImpl::shapeIfNeeded(SkScalar floorWidth) {
+    if (fState >= kShaped) {
+        return true;
+    }
+
+    // Whatever was edited is shaped again from scratch
+    fTextEdit.reset();
+
+    // Check if we have the text in the cache and don't need to shape it again
+    if (!fFontCollection->getParagraphCache()->findParagraph(this)) {
+        if (fState < kIndexed) {
+            // This only happens once at the first layout; the text is immutable
+            // and there is no reason to repeat it
+            if (this->computeCodeUnitProperties()) {
+                fState = kIndexed;
+            }
+        }
+        this->fRuns.clear();
+        this->fClusters.clear();
+        this->fClustersIndexFromCodeUnit.clear();
+        this->fClustersIndexFromCodeUnit.push_back_n(fText.size() + 1, EMPTY_INDEX);
+        if (!this->shapeTextIntoEndlessLine()) {
+            this->resetContext();
+            // TODO: merge the two next calls - they always come together
+            this->resolveStrut();
+            this->computeEmptyMetrics();
+            this->fLines.clear();
+
+            // Set the important values that are not zero
+            fWidth = floorWidth;
+            fHeight = fEmptyMetrics.height();
+            if (fParagraphStyle.getStrutStyle().getStrutEnabled() &&
+                fParagraphStyle.getStrutStyle().getForceStrutHeight()) {
+                fHeight = fStrutMetrics.height();
+            }
+            fAlphabeticBaseline = fEmptyMetrics.alphabeticBaseline();
+            fIdeographicBaseline = fEmptyMetrics.ideographicBaseline();
+            fLongestLine = FLT_MIN - FLT_MAX;  // That is what flutter has
+            fMinIntrinsicWidth = 0;
+            fMaxIntrinsicWidth = 0;
+            this->fOldWidth = floorWidth;
+            this->fOldHeight = this->fHeight;
+
+            return false;
+        } else {
+            // Add the paragraph to the cache
+            fFontCollection->getParagraphCache()->updateParagraph(this);
+        }
+    }
+    fState = kShaped;
+    return true;
+}
+
+void ParagraphImpl::finishLayout(SkScalar floorWidth) {
     this->fOldWidth = floorWidth;
     this->fOldHeight = this->fHeight;
 
@@ -270,7 +331,8 @@ bool ParagraphImpl::computeCodeUnitProperties() {
         return false;
     }
 
-    // Get bidi regions
+    // Get bidi regions (again, if the text was updated)
+    fBidiRegions.clear();
     auto textDirection = fParagraphStyle.getTextDirection() == TextDirection::kLtr
                               ? SkUnicode::TextDirection::kLTR
                               : SkUnicode::TextDirection::kRTL;
@@ -280,14 +342,16 @@ bool ParagraphImpl::computeCodeUnitProperties() {
 
     // Collect all spaces and some extra information
     // (and also substitute \t with a space while we are at it)
-    if (!fUnicode->computeCodeUnitFlags(&fText[0],
-                                        fText.size(),
-                                        this->paragraphStyle().getReplaceTabCharacters(),
-                                        &fCodeUnitProperties)) {
+    if (!fUnicode->getCodeUnitFlags(&fText[0],
+                                    fText.size(),
+                                    this->paragraphStyle().getReplaceTabCharacters(),
+                                    &fCodeUnitProperties)) {
         return false;
     }
 
     // Get some information about trailing spaces / hard line breaks
+    fHasLineBreaks = false;
+    fHasWhitespacesInside = false;
     fTrailingSpaces = fText.size();
     TextIndex firstWhitespace = EMPTY_INDEX;
     for (int i = 0; i < fCodeUnitProperties.size(); ++i) {
@@ -570,8 +634,8 @@ bool ParagraphImpl::shapeTextIntoEndlessLine() {
     return result;
 }
 
-void ParagraphImpl::breakShapedTextIntoLines(SkScalar maxWidth) {
-
+void ParagraphImpl::breakShapedTextIntoLines(SkScalar maxWidth, bool measureOnly) {
+    fMeasuredLines = 0;
     if (!fHasLineBreaks &&
         !fHasWhitespacesInside &&
         fPlaceholders.size() == 1 &&
@@ -618,22 +682,28 @@ void ParagraphImpl::breakShapedTextIntoLines(SkScalar maxWidth) {
         advance.fY = metrics.height();
         auto clusterRange = ClusterRange(0, trailingSpaces);
         auto clusterRangeWithGhosts = ClusterRange(0, this->clusters().size() - 1);
-        this->addLine(SkPoint::Make(0, 0), advance,
-                      textExcludingSpaces, textRange, textRange,
-                      clusterRange, clusterRangeWithGhosts, run.advance().x(),
-                      metrics);
+        if (measureOnly) {
+            fMeasuredLines = 1;
+        } else {
+            this->addLine(SkPoint::Make(0, 0), advance,
+                          textExcludingSpaces, textRange, textRange,
+                          clusterRange, clusterRangeWithGhosts, run.advance().x(),
+                          metrics);
+        }
 
         fLongestLine = nearlyZero(advance.fX) ? run.advance().fX : advance.fX;
         fHeight = advance.fY;
         fWidth = maxWidth;
         fMaxIntrinsicWidth = run.advance().fX;
         fMinIntrinsicWidth = advance.fX;
-        fAlphabeticBaseline = fLines.empty() ? fEmptyMetrics.alphabeticBaseline() : fLines.front().alphabeticBaseline();
-        fIdeographicBaseline = fLines.empty() ? fEmptyMetrics.ideographicBaseline() : fLines.front().ideographicBaseline();
+        fAlphabeticBaseline = metrics.alphabeticBaseline();
+        fIdeographicBaseline = metrics.ideographicBaseline();
         fExceededMaxLines = false;
         return;
     }
 
+    // The baselines are taken from the first line, which is not kept when only measuring
+    std::optional<InternalLineMetrics> firstLineMetrics;
     TextWrapper textWrapper;
     textWrapper.breakTextIntoLines(
             this,
@@ -650,8 +720,28 @@ void ParagraphImpl::breakShapedTextIntoLines(SkScalar maxWidth) {
                 SkVector advance,
                 InternalLineMetrics metrics,
                 bool addEllipsis) {
+                if (!firstLineMetrics) {
+                    firstLineMetrics = metrics;
+                }
+                if (measureOnly) {
+                    ++fMeasuredLines;
+                    auto width = advance.fX;
+                    if (addEllipsis) {
+                        // The ellipsis is shaped to find out how much of the line it replaces
+                        TextLine line(this, offset, advance, this->findAllBlocks(textExcludingSpaces),
+                                      textExcludingSpaces, text, textWithNewlines,
+                                      clusters, clustersWithGhosts, widthWithSpaces, metrics);
+                        line.createEllipsis(maxWidth, this->getEllipsis(), true);
+                        width = line.width();
+                    }
+                    fLongestLine = std::max(fLongestLine, nearlyZero(width) ? widthWithSpaces : width);
+                    return;
+                }
                 // TODO: Take in account clipped edges
-                auto& line = this->addLine(offset, advance, textExcludingSpaces, text, textWithNewlines, clusters, clustersWithGhosts, widthWithSpaces, metrics);
+                bool reused = !addEllipsis &&
+                              this->reuseLine(offset, advance, textExcludingSpaces, text, textWithNewlines, clusters, clustersWithGhosts, widthWithSpaces, metrics);
+                auto& line = reused ? fLines.back()
+                                    : this->addLine(offset, advance, textExcludingSpaces, text, textWithNewlines, clusters, clustersWithGhosts, widthWithSpaces, metrics);
                 if (addEllipsis) {
                     line.createEllipsis(maxWidth, this->getEllipsis(), true);
                 }
@@ -662,8 +752,8 @@ void ParagraphImpl::breakShapedTextIntoLines(SkScalar maxWidth) {
     fWidth = maxWidth;
     fMaxIntrinsicWidth = textWrapper.maxIntrinsicWidth();
     fMinIntrinsicWidth = textWrapper.minIntrinsicWidth();
-    fAlphabeticBaseline = fLines.empty() ? fEmptyMetrics.alphabeticBaseline() : fLines.front().alphabeticBaseline();
-    fIdeographicBaseline = fLines.empty() ? fEmptyMetrics.ideographicBaseline() : fLines.front().ideographicBaseline();
+    fAlphabeticBaseline = firstLineMetrics ? firstLineMetrics->alphabeticBaseline() : fEmptyMetrics.alphabeticBaseline();
+    fIdeographicBaseline = firstLineMetrics ? firstLineMetrics->ideographicBaseline() : fEmptyMetrics.ideographicBaseline();
     fExceededMaxLines = textWrapper.exceededMaxLines();
 }
 
@@ -1120,6 +1210,352 @@ void ParagraphImpl::updateBackgroundPaint(size_t from, size_t to, SkPaint paint)
     }
 }
 
+bool ParagraphImpl::canUpdateTextIncrementally(size_t from, size_t to) const {
+    if (fState < kShaped || fRuns.empty() || fPlaceholders.size() != 1) {
+        return false;
+    }
+    if (fBidiRegions.size() != 1 || (fBidiRegions[0].level & 1) != 0) {
+        return false;
+    }
+    bool inOneBlock = false;
+    for (int i = 0; i < fTextStyles.size(); ++i) {
+        const auto& block = fTextStyles[i];
+        if (!SkScalarNearlyZero(block.fStyle.getLetterSpacing()) ||
+            !SkScalarNearlyZero(block.fStyle.getWordSpacing())) {
+            return false;
+        }
+        // The inserted text goes to the block before it, as in updateText()
+        if ((block.fRange.start < from || i == 0) && to <= block.fRange.end) {
+            inOneBlock = true;
+        }
+    }
+    return inOneBlock;
+}
+
+void ParagraphImpl::addRunPiece(const Run& run,
+                                GlyphRange glyphs,
+                                ptrdiff_t textDelta,
+                                SkScalar& advanceX) {
+    // The same as a piece of a run in OneLineShaper::finish(), moved by textDelta
+    TextRange text(run.globalClusterIndex(glyphs.start), run.globalClusterIndex(glyphs.end));
+    auto runAdvance = SkVector::Make(run.posX(glyphs.end) - run.posX(glyphs.start), run.fAdvance.fY);
+    const SkShaper::RunHandler::RunInfo info = {
+            run.fFont,
+            run.fBidiLevel,
+            runAdvance,
+            glyphs.width(),
+            SkShaper::RunHandler::Range(text.start - run.fClusterStart, text.width())
+    };
+    auto& piece = fRuns.emplace_back(this,
+                                     info,
+                                     run.fClusterStart + textDelta,
+                                     run.fHeightMultiplier,
+                                     run.fUseHalfLeading,
+                                     run.fBaselineShift,
+                                     fRuns.size(),
+                                     advanceX);
+
+    SkPoint zero = {run.fPositions[glyphs.start].fX, 0};
+    for (size_t i = glyphs.start; i <= glyphs.end; ++i) {
+        auto index = i - glyphs.start;
+        if (i < glyphs.end) {
+            piece.fGlyphs[index] = run.fGlyphs[i];
+            piece.fClusterIndexes[index] = run.fClusterIndexes[i];
+        }
+        piece.fPositions[index] = run.fPositions[i] - zero;
+        piece.fOffsets[index] = run.fOffsets[i];
+        piece.addX(index, advanceX);
+    }
+    if (textDelta != 0) {
+        fFontSwitches.emplace_back(text.start + textDelta, run.fFont);
+    }
+    advanceX += runAdvance.fX;
+}
+
+// Replaces the runs of oldRange (in the text from before the edit) with the new text shaped
+// again, and moves the runs after it by textDelta; the runs before it stay where they are.
+bool ParagraphImpl::updateRunsIncrementally(TextRange oldRange, ptrdiff_t textDelta) {
+    // A run split at a space, or shaped again next to one, must be in a font that doesn't kern
+    // or substitute the space with what is around it; otherwise the text is shaped whole
+    auto spaceIsContextFree = [](const Run& run) {
+        const SkTypeface* typeface = run.fFont.getTypeface();
+        return typeface && SkShapers::HB::SpaceIsContextFree(*typeface);
+    };
+    for (const auto& run : fRuns) {
+        const bool splitAtStart = run.textRange().start < oldRange.start &&
+                                  run.textRange().end >= oldRange.start;
+        const bool splitAtEnd = run.textRange().start <= oldRange.end &&
+                                run.textRange().end > oldRange.end;
+        if ((splitAtStart || splitAtEnd) && !spaceIsContextFree(run)) {
+            return false;
+        }
+    }
+
+    TArray<Run, false> oldRuns = std::move(fRuns);
+    TArray<ResolvedFontDescriptor> oldFontSwitches = std::move(fFontSwitches);
+    fRuns.clear();
+    fFontSwitches.clear();
+    for (const auto& fontSwitch : oldFontSwitches) {
+        if (fontSwitch.fTextStart < oldRange.start) {
+            fFontSwitches.push_back(fontSwitch);
+        }
+    }
+
+    auto firstGlyphFrom = [](const Run& run, TextIndex textIndex) {
+        GlyphIndex glyph = 0;
+        while (glyph < run.size() && run.globalClusterIndex(glyph) < textIndex) {
+            ++glyph;
+        }
+        return glyph;
+    };
+
+    // The glyphs of the old text that no font had are not there anymore
+    // (unresolved codepoints are only added to, not taken away from)
+    for (const auto& run : oldRuns) {
+        if (run.textRange().end <= oldRange.start || run.textRange().start >= oldRange.end) {
+            continue;
+        }
+        for (size_t i = 0; i < run.size(); ++i) {
+            auto textIndex = run.globalClusterIndex(i);
+            if (run.fGlyphs[i] == 0 && textIndex >= oldRange.start && textIndex < oldRange.end &&
+                fUnresolvedGlyphs > 0) {
+                --fUnresolvedGlyphs;
+            }
+        }
+    }
+
+    // Keep the runs before the edited text, and cut the one it starts in
+    SkScalar advanceX = 0;
+    int index = 0;
+    for (; index < oldRuns.size() && oldRuns[index].textRange().end <= oldRange.start; ++index) {
+        advanceX = oldRuns[index].offset().fX + oldRuns[index].advance().fX;
+        fRuns.push_back(std::move(oldRuns[index]));
+    }
+    if (index < oldRuns.size() && oldRuns[index].textRange().start < oldRange.start) {
+        const Run& run = oldRuns[index];
+        this->addRunPiece(run, GlyphRange(0, firstGlyphFrom(run, oldRange.start)), 0, advanceX);
+    }
+
+    // Shape the edited text
+    const TextRange newRange(oldRange.start, oldRange.end + textDelta);
+    if (newRange.width() > 0) {
+        const int firstNewRun = fRuns.size();
+        OneLineShaper oneLineShaper(this, newRange, advanceX);
+        if (!oneLineShaper.shape()) {
+            return false;
+        }
+        for (int i = firstNewRun; i < fRuns.size(); ++i) {
+            if (!spaceIsContextFree(fRuns[i])) {
+                return false;
+            }
+        }
+        fUnresolvedGlyphs += oneLineShaper.unresolvedGlyphs();
+        if (!fRuns.empty()) {
+            advanceX = fRuns.back().offset().fX + fRuns.back().advance().fX;
+        }
+    }
+
+    // Move the runs after it, starting with the rest of the one it ends in
+    while (index < oldRuns.size() && oldRuns[index].textRange().end <= oldRange.end) {
+        ++index;
+    }
+    for (; index < oldRuns.size(); ++index) {
+        const Run& run = oldRuns[index];
+        auto start = run.textRange().start < oldRange.end ? firstGlyphFrom(run, oldRange.end) : 0;
+        this->addRunPiece(run, GlyphRange(start, run.size()), textDelta, advanceX);
+    }
+
+    fClusters.clear();
+    fClustersIndexFromCodeUnit.clear();
+    fClustersIndexFromCodeUnit.push_back_n(fText.size() + 1, EMPTY_INDEX);
+    this->buildClusterTable();
+    return true;
+}
+
+void ParagraphImpl::updateText(size_t from, size_t to, const SkString& text) {
+    SkASSERT(from <= to && to <= fText.size());
+    to = std::min(to, fText.size());
+    from = std::min(from, to);
+    const ptrdiff_t textDelta = SkToS64(text.size()) - SkToS64(to - from);
+
+    // Find the text to shape again: the edit, some context and then up to the next word start
+    // after a space on each side (staying inside the text style). Shaping the text in pieces
+    // split there gives the same glyphs as shaping it whole, if the fonts there never carry
+    // anything across a space; updateRunsIncrementally() checks that.
+    TextRange oldRange = EMPTY_TEXT;
+    bool incremental = this->canUpdateTextIncrementally(from, to);
+    if (incremental) {
+        constexpr size_t kContextMargin = 16;
+        auto isWordStart = [this](TextIndex index) {
+            return fText[index - 1] == ' ' &&
+                   !SkUnicode::hasPartOfWhiteSpaceBreakFlag(fCodeUnitProperties[index]);
+        };
+        TextRange blockRange = EMPTY_TEXT;
+        for (int i = 0; i < fTextStyles.size(); ++i) {
+            const auto& block = fTextStyles[i];
+            if ((block.fRange.start < from || i == 0) && to <= block.fRange.end) {
+                blockRange = block.fRange;
+                break;
+            }
+        }
+        TextIndex start = from;
+        while (start > blockRange.start && (from - start < kContextMargin || !isWordStart(start))) {
+            --start;
+        }
+        TextIndex end = to;
+        while (end < blockRange.end && (end - to < kContextMargin || !isWordStart(end))) {
+            ++end;
+        }
+        oldRange = TextRange(start, end);
+        // Blocks with the same font were shaped together, and may share a cluster
+        incremental = this->codeUnitHasProperty(start, SkUnicode::CodeUnitFlags::kGlyphClusterStart) &&
+                      this->codeUnitHasProperty(end, SkUnicode::CodeUnitFlags::kGlyphClusterStart);
+    }
+
+    const int oldClusterCount = fClusters.size();
+    const int oldRunCount = fRuns.size();
+    if (incremental) {
+        fTextEdit = std::make_unique<TextEdit>();
+        fTextEdit->fOldRange = oldRange;
+        fTextEdit->fStartCluster = this->clusterIndex(oldRange.start);
+        fTextEdit->fOldEndCluster = this->clusterIndex(oldRange.end);
+        fTextEdit->fTextDelta = textDelta;
+        fTextEdit->fWidth = fOldWidth;
+        if (fState >= kLineBroken) {
+            fTextEdit->fLines = std::move(fLines);
+        }
+    } else {
+        fTextEdit.reset();
+    }
+    fLines.clear();
+
+    // The text inserted at a style boundary takes the style before it
+    const size_t insertedEnd = from + text.size();
+    auto mapStart = [&](TextIndex index) -> TextIndex {
+        if (index < from || index == 0) {
+            return index;
+        }
+        return index <= to ? insertedEnd : index + textDelta;
+    };
+    auto mapEnd = [&](TextIndex index) -> TextIndex {
+        if (index < from) {
+            return index;
+        }
+        return index <= to ? insertedEnd : index + textDelta;
+    };
+    fText.remove(from, to - from);
+    fText.insert(from, text);
+    for (auto& block : fTextStyles) {
+        block.fRange = TextRange(mapStart(block.fRange.start), mapEnd(block.fRange.end));
+    }
+    for (auto& placeholder : fPlaceholders) {
+        SkASSERT(placeholder.fRange.end <= from || placeholder.fRange.start >= to ||
+                 placeholder.fRange.width() == 0);
+        placeholder.fRange = TextRange(mapStart(placeholder.fRange.start),
+                                       mapEnd(placeholder.fRange.end));
+        placeholder.fTextBefore = TextRange(mapStart(placeholder.fTextBefore.start),
+                                            mapEnd(placeholder.fTextBefore.end));
+    }
+
+    fWords.clear();
+    fUTF8IndexForUTF16Index.clear();
+    fUTF16IndexForUTF8Index.clear();
+    fillUTF16MappingOnce.emplace();
+    fPicture = nullptr;
+    fOldWidth = 0;
+    fOldHeight = 0;
+
+    // The unicode properties are not local (think of bidi), so they are found for all the text
+    fState = kUnknown;
+    if (incremental && !fText.isEmpty() && this->computeCodeUnitProperties()) {
+        fState = kIndexed;
+        if (fBidiRegions.size() == 1 && (fBidiRegions[0].level & 1) == 0 &&
+            this->updateRunsIncrementally(oldRange, textDelta)) {
+            SkASSERT(this->clusterIndex(oldRange.start) == fTextEdit->fStartCluster);
+            fTextEdit->fClusterDelta = fClusters.size() - oldClusterCount;
+            fTextEdit->fRunDelta = fRuns.size() - oldRunCount;
+            fState = kShaped;
+            return;
+        }
+    }
+    fTextEdit.reset();
+}
+
+// Lines away from the edit come out of the line breaking the same as before it, apart from
+// where they are; such lines are moved over rather than constructed again
+bool ParagraphImpl::reuseLine(SkVector offset,
+                              SkVector advance,
+                              TextRange textExcludingSpaces,
+                              TextRange text,
+                              TextRange textIncludingNewlines,
+                              ClusterRange clusters,
+                              ClusterRange clustersWithGhosts,
+                              SkScalar widthWithSpaces,
+                              InternalLineMetrics sizes) {
+    if (fTextEdit == nullptr) {
+        return false;
+    }
+    auto& edit = *fTextEdit;
+
+    enum class Where { kBefore, kEdited, kAfter };
+    auto where = [&edit](const TextLine& line) {
+        if (line.textWithNewlines().end <= edit.fOldRange.start &&
+            line.clustersWithSpaces().end <= edit.fStartCluster) {
+            return Where::kBefore;
+        }
+        if (line.textWithNewlines().start >= edit.fOldRange.end &&
+            line.clustersWithSpaces().start >= edit.fOldEndCluster) {
+            return Where::kAfter;
+        }
+        return Where::kEdited;
+    };
+
+    // Skip the old lines that start before this one (the edited ones count as starting
+    // where the edit does, to keep them in order)
+    while (edit.fNextLine < edit.fLines.size()) {
+        const auto& line = edit.fLines[edit.fNextLine];
+        TextIndex start = line.textWithNewlines().start;
+        switch (where(line)) {
+            case Where::kBefore: break;
+            case Where::kEdited: start = edit.fOldRange.start; break;
+            case Where::kAfter:  start += edit.fTextDelta; break;
+        }
+        if (start >= textIncludingNewlines.start) {
+            break;
+        }
+        ++edit.fNextLine;
+    }
+    if (edit.fNextLine == edit.fLines.size()) {
+        return false;
+    }
+
+    auto& line = edit.fLines[edit.fNextLine];
+    const Where lineWhere = where(line);
+    if (lineWhere == Where::kEdited || line.ellipsis() != nullptr) {
+        return false;
+    }
+    const bool after = lineWhere == Where::kAfter;
+    const ptrdiff_t textDelta = after ? edit.fTextDelta : 0;
+    const ptrdiff_t clusterDelta = after ? edit.fClusterDelta : 0;
+    auto moved = [](SkRange<size_t> range, ptrdiff_t delta) {
+        range.Shift(delta);
+        return range;
+    };
+    if (!(moved(line.trimmedText(), textDelta) == textExcludingSpaces) ||
+        !(moved(line.text(), textDelta) == text) ||
+        !(moved(line.textWithNewlines(), textDelta) == textIncludingNewlines) ||
+        !(moved(line.clusters(), clusterDelta) == clusters) ||
+        !(moved(line.clustersWithSpaces(), clusterDelta) == clustersWithGhosts)) {
+        return false;
+    }
+
+    line.relocate(offset, advance, widthWithSpaces, sizes,
+                  textDelta, clusterDelta, after ? edit.fRunDelta : 0);
+    fLines.emplace_back(std::move(line));
+    ++edit.fNextLine;
+    return true;
+}
+
 TArray<TextIndex> ParagraphImpl::countSurroundingGraphemes(TextRange textRange) const {
     textRange = textRange.intersection({0, fText.size()});
     TArray<TextIndex> graphemes;
@@ -1168,7 +1604,7 @@ TextIndex ParagraphImpl::findPreviousGlyphClusterBoundary(TextIndex utf8) const
 }
 
 void ParagraphImpl::ensureUTF16Mapping() {
-    fillUTF16MappingOnce([&] {
+    (*fillUTF16MappingOnce)([&] {
         SkUnicode::extractUtfConversionMapping(
                 this->text(),
                 [&](size_t index) { fUTF8IndexForUTF16Index.emplace_back(index); },
@@ -1526,6 +1962,20 @@ SkPath Paragraph::GetPath(SkTextBlob* textBlob) {
     return path;
 }
 
+void Paragraph::LayoutAll(SkSpan<const std::unique_ptr<Paragraph>> paragraphs,
+                          SkScalar width,
+                          SkExecutor* executor) {
+    if (!executor || paragraphs.size() < 2) {
+        for (const auto& paragraph : paragraphs) {
+            paragraph->layout(width);
+        }
+        return;
+    }
+    SkTaskGroup(*executor).batch(SkToInt(paragraphs.size()), [&](int i) {
+        paragraphs[i]->layout(width);
+    });
+}
+
 bool ParagraphImpl::containsEmoji(SkTextBlob* textBlob) {
     bool result = false;
     SkTextBlobRunIterator iter(textBlob);
@@ -29,6 +29,7 @@
 #include "src/core/SkTHash.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -72,6 +73,7 @@ enum InternalState {
   kUnknown = 0,
   kIndexed = 1,     // Text is indexed
   kShaped = 2,      // Text is shaped
+  kMeasured = 3,    // Lines are measured but not built
   kLineBroken = 5,
   kFormatted = 6,
   kDrawn = 7
@@ -106,6 +108,7 @@ public:
     ~ParagraphImpl() override;
 
     void layout(SkScalar width) override;
+    void measure(SkScalar width) override;
     void paint(SkCanvas* canvas, SkScalar x, SkScalar y) override;
     void paint(ParagraphPainter* canvas, SkScalar x, SkScalar y) override;
     std::vector<TextBox> getRectsForRange(unsigned start,
@@ -119,7 +122,7 @@ public:
 
     bool getApplyRoundingHack() const { return fParagraphStyle.getApplyRoundingHack(); }
 
-    size_t lineNumber() override { return fLines.size(); }
+    size_t lineNumber() override { return fState == kMeasured ? fMeasuredLines : fLines.size(); }
 
     TextLine& addLine(SkVector offset, SkVector advance,
                       TextRange textExcludingSpaces, TextRange text, TextRange textIncludingNewlines,
@@ -201,12 +204,13 @@ public:
     void applySpacingAndBuildClusterTable();
     void buildClusterTable();
     bool shapeTextIntoEndlessLine();
-    void breakShapedTextIntoLines(SkScalar maxWidth);
+    void breakShapedTextIntoLines(SkScalar maxWidth, bool measureOnly = false);
 
     void updateTextAlign(TextAlign textAlign) override;
     void updateFontSize(size_t from, size_t to, SkScalar fontSize) override;
     void updateForegroundPaint(size_t from, size_t to, SkPaint paint) override;
     void updateBackgroundPaint(size_t from, size_t to, SkPaint paint) override;
+    void updateText(size_t from, size_t to, const SkString& text) override;
 
     void visit(const Visitor&) override;
     void extendedVisit(const ExtendedVisitor&) override;
@@ -256,6 +260,32 @@ private:
     friend class OneLineShaper;
 
     void computeEmptyMetrics();
+    SkScalar roundWidth(SkScalar rawWidth) const;
+    bool shapeIfNeeded(SkScalar floorWidth);
+    void finishLayout(SkScalar floorWidth);
+
+    // What updateText() leaves for the next layout() to reuse: the lines broken before the edit,
+    // and how to find their text, clusters and runs after it. Text before fOldRange.start
+    // kept its clusters and runs; text from fOldRange.end on moved by the deltas.
+    struct TextEdit {
+        TextRange fOldRange;            // The text reshaped by the edit, as it was before
+        ClusterIndex fStartCluster;     // The first reshaped cluster
+        ClusterIndex fOldEndCluster;    // The first cluster after fOldRange, before the edit
+        ptrdiff_t fTextDelta;
+        ptrdiff_t fClusterDelta;
+        ptrdiff_t fRunDelta;
+        SkScalar fWidth;                // The width fLines were broken at
+        skia_private::TArray<TextLine, false> fLines;
+        int fNextLine = 0;
+    };
+
+    bool canUpdateTextIncrementally(size_t from, size_t to) const;
+    bool updateRunsIncrementally(TextRange oldRange, ptrdiff_t textDelta);
+    void addRunPiece(const Run& run, GlyphRange glyphs, ptrdiff_t textDelta, SkScalar& advanceX);
+    bool reuseLine(SkVector offset, SkVector advance, TextRange textExcludingSpaces,
+                   TextRange text, TextRange textIncludingNewlines, ClusterRange clusters,
+                   ClusterRange clustersWithGhosts, SkScalar widthWithSpaces,
+                   InternalLineMetrics sizes);
 
     // Input
     skia_private::TArray<StyleBlock<SkScalar>> fLetterSpaceStyles;
@@ -280,11 +310,14 @@ private:
     // They are filled lazily whenever they need and cached
     skia_private::TArray<TextIndex, true> fUTF8IndexForUTF16Index;
     skia_private::TArray<size_t, true> fUTF16IndexForUTF8Index;
-    SkOnce fillUTF16MappingOnce;
+    // Reset by updateText(), which changes the text the mapping is made from
+    std::optional<SkOnce> fillUTF16MappingOnce{std::in_place};
     size_t fUnresolvedGlyphs;
     std::unordered_set<SkUnichar> fUnresolvedCodepoints;
 
     skia_private::TArray<TextLine, false> fLines;   // kFormatted   (cached: width, max lines, ellipsis, text align)
+    std::unique_ptr<TextEdit> fTextEdit;            // Set between updateText() and layout()
+    size_t fMeasuredLines;                          // kMeasured
     sk_sp<SkPicture> fPicture;          // kRecorded    (cached: text styles)
 
     skia_private::TArray<ResolvedFontDescriptor> fFontSwitches;
@@ -184,6 +184,36 @@ TextLine::TextLine(ParagraphImpl* owner,
     }
 }
 
+void TextLine::relocate(SkVector offset,
+                        SkVector advance,
+                        SkScalar widthWithSpaces,
+                        InternalLineMetrics sizes,
+                        ptrdiff_t textDelta,
+                        ptrdiff_t clusterDelta,
+                        ptrdiff_t runDelta) {
+    // Only lines without ellipsis or letter spacing are moved
+    SkASSERT(fEllipsis == nullptr);
+    fTextExcludingSpaces.Shift(textDelta);
+    fText.Shift(textDelta);
+    fTextIncludingNewlines.Shift(textDelta);
+    fClusterRange.Shift(clusterDelta);
+    fGhostClusterRange.Shift(clusterDelta);
+    for (auto& runIndex : fRunsInVisualOrder) {
+        runIndex += runDelta;
+    }
+    fOffset = offset;
+    fAdvance = advance;
+    fShift = 0;
+    fWidthWithSpaces = widthWithSpaces;
+    fSizes = sizes;
+    fAscentStyle = LineMetricStyle::CSS;
+    fDescentStyle = LineMetricStyle::CSS;
+
+    // The blobs point to the runs from before the edit
+    fTextBlobCache.clear();
+    fTextBlobCachePopulated = false;
+}
+
 void TextLine::paint(ParagraphPainter* painter, SkScalar x, SkScalar y) {
     if (fHasBackground) {
         this->iterateThroughVisualRuns(false,
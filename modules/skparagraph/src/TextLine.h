@@ -137,6 +137,16 @@ public:
 
     void shiftVertically(SkScalar shift) { fOffset.fY += shift; }
 
+    // Moves a line broken before the paragraph text was edited to the same text after the edit,
+    // as if it had been constructed again with these arguments
+    void relocate(SkVector offset,
+                  SkVector advance,
+                  SkScalar widthWithSpaces,
+                  InternalLineMetrics sizes,
+                  ptrdiff_t textDelta,
+                  ptrdiff_t clusterDelta,
+                  ptrdiff_t runDelta);
+
     void setAscentStyle(LineMetricStyle style) { fAscentStyle = style; }
     void setDescentStyle(LineMetricStyle style) { fDescentStyle = style; }
 
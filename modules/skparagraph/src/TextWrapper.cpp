@@ -301,6 +301,8 @@ void TextWrapper::breakTextIntoLines(ParagraphImpl* parent,
     auto start = span.begin();
     InternalLineMetrics maxRunMetrics;
     bool needEllipsis = false;
+    // The lines are not added to the parent when it is only measured
+    bool addedLines = false;
     while (fEndLine.endCluster() != end) {
 
         this->lookAhead(maxWidth, end, parent->getApplyRoundingHack());
@@ -396,6 +398,7 @@ void TextWrapper::breakTextIntoLines(ParagraphImpl* parent,
                 SkVector::Make(fEndLine.width(), lineHeight),
                 fEndLine.metrics(),
                 needEllipsis && !fHardLineBreak);
+        addedLines = true;
 
         softLineMaxIntrinsicWidth += widthWithSpaces;
 
@@ -461,7 +464,7 @@ void TextWrapper::breakTextIntoLines(ParagraphImpl* parent,
         fMinIntrinsicWidth = std::max(fMinIntrinsicWidth, lastWordLength);
         fMaxIntrinsicWidth = std::max(fMaxIntrinsicWidth, softLineMaxIntrinsicWidth);
 
-        if (parent->lines().empty()) {
+        if (!addedLines) {
             // In case we could not place even a single cluster on the line
             if (disableFirstAscent) {
                 fEndLine.metrics().fAscent = fEndLine.metrics().fRawAscent;
@@ -498,7 +501,9 @@ void TextWrapper::breakTextIntoLines(ParagraphImpl* parent,
                 fEndLine.metrics(),
                 needEllipsis);
         fHeight += fEndLine.metrics().height();
-        parent->lines().back().setMaxRunMetrics(maxRunMetrics);
+        if (!parent->lines().empty()) {
+            parent->lines().back().setMaxRunMetrics(maxRunMetrics);
+        }
     }
 
     if (parent->lines().empty()) {
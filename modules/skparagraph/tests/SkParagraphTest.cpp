@@ -7,6 +7,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFontMgr.h"
 #include "include/core/SkFontStyle.h"
 #include "include/core/SkPaint.h"
@@ -5608,6 +5609,469 @@ UNIX_ONLY_TEST(SkParagraph_CacheStyles, reporter) {
     test(2, false);
 }
 
+UNIX_ONLY_TEST(SkParagraph_CacheMaxEntries, reporter) {
+    ParagraphCache cache(16);
+    sk_sp<ResourceFontCollection> fontCollection = sk_make_sp<ResourceFontCollection>();
+    SKIP_IF_FONTS_NOT_FOUND(reporter, fontCollection)
+
+    ParagraphStyle paragraph_style;
+    TextStyle text_style;
+    text_style.setFontFamilies({SkString("Roboto")});
+    text_style.setColor(SK_ColorBLACK);
+
+    for (int i = 0; i < 100; ++i) {
+        ParagraphBuilderImpl builder(paragraph_style, fontCollection, get_unicode());
+        builder.pushStyle(text_style);
+        builder.addText(SkStringPrintf("text%d", i).c_str());
+        builder.pop();
+        auto paragraph = builder.Build();
+        cache.updateParagraph(static_cast<ParagraphImpl*>(paragraph.get()));
+        REPORTER_ASSERT(reporter, cache.count() <= 16, "%d entries", cache.count());
+    }
+    REPORTER_ASSERT(reporter, cache.count() > 0);
+
+    cache.setMaxEntries(8);
+    REPORTER_ASSERT(reporter, cache.maxEntries() == 8);
+    REPORTER_ASSERT(reporter, cache.count() <= 8, "%d entries", cache.count());
+}
+
+// Adds and finds paragraphs on several threads while another one resizes, switches and resets
+// the cache. Run under TSAN to check the shards, the last cached text and the settings.
+UNIX_ONLY_TEST(SkParagraph_CacheConcurrentAccess, reporter) {
+    ParagraphCache cache(64);
+    sk_sp<ResourceFontCollection> fontCollection = sk_make_sp<ResourceFontCollection>();
+    SKIP_IF_FONTS_NOT_FOUND(reporter, fontCollection)
+
+    ParagraphStyle paragraph_style;
+    TextStyle text_style;
+    text_style.setFontFamilies({SkString("Roboto")});
+    text_style.setColor(SK_ColorBLACK);
+
+    constexpr int kThreads = 4;
+    constexpr int kParagraphs = 32;
+    std::vector<std::unique_ptr<Paragraph>> paragraphs[kThreads];
+    for (int t = 0; t < kThreads; ++t) {
+        for (int i = 0; i < kParagraphs; ++i) {
+            // Half the texts start alike, so they look like an edit of the last cached one
+            SkString text = i % 2 == 0
+                    ? SkStringPrintf("A paragraph that starts like the others do: %d %d", t, i)
+                    : SkStringPrintf("%d %d is a paragraph that starts differently.", t, i);
+            ParagraphBuilderImpl builder(paragraph_style, fontCollection, get_unicode());
+            builder.pushStyle(text_style);
+            builder.addText(text.c_str());
+            builder.pop();
+            paragraphs[t].push_back(builder.Build());
+        }
+    }
+
+    std::thread threads[kThreads];
+    for (int t = 0; t < kThreads; ++t) {
+        threads[t] = std::thread([&, t] {
+            for (int round = 0; round < 4; ++round) {
+                for (auto& paragraph : paragraphs[t]) {
+                    auto impl = static_cast<ParagraphImpl*>(paragraph.get());
+                    if (!cache.findParagraph(impl)) {
+                        cache.updateParagraph(impl);
+                    }
+                }
+            }
+        });
+    }
+    for (int i = 0; i < 64; ++i) {
+        cache.setMaxEntries(i % 2 == 0 ? 8 : 64);
+        cache.turnOn(i % 3 != 0);
+        REPORTER_ASSERT(reporter, cache.count() >= 0);
+        if (i % 16 == 0) {
+            cache.reset();
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    cache.turnOn(true);
+    cache.setMaxEntries(16);
+    REPORTER_ASSERT(reporter, cache.maxEntries() == 16);
+    REPORTER_ASSERT(reporter, cache.count() <= 16, "%d entries", cache.count());
+}
+
+// Laying out paragraphs that share a FontCollection on several threads gives the same results
+// as laying them out in turn.
+UNIX_ONLY_TEST(SkParagraph_LayoutAll, reporter) {
+    sk_sp<ResourceFontCollection> fontCollection = sk_make_sp<ResourceFontCollection>();
+    SKIP_IF_FONTS_NOT_FOUND(reporter, fontCollection)
+    fontCollection->setDefaultFontManager(ToolUtils::TestFontMgr());
+    fontCollection->enableFontFallback();
+
+    ParagraphStyle paragraph_style;
+    TextStyle text_style;
+    text_style.setFontFamilies({SkString("Roboto")});
+    text_style.setFontSize(20);
+    text_style.setColor(SK_ColorBLACK);
+
+    const char* texts[] = {
+        "Hello world, this is a paragraph long enough to wrap onto more than one line.",
+        "من أسر وإعلان الخاصّة وهولندا،, عل قائمة الضغوط بالمطالبة تلك. الصفحة",
+        "人人生而自由,在尊严和权利上一律平等。",
+        "A short one.",
+    };
+    auto build = [&](int i) {
+        ParagraphBuilderImpl builder(paragraph_style, fontCollection, get_unicode());
+        builder.pushStyle(text_style);
+        builder.addText(SkStringPrintf("%d %s", i, texts[i % std::size(texts)]).c_str());
+        builder.pop();
+        return builder.Build();
+    };
+
+    constexpr int kCount = 64;
+    std::vector<std::unique_ptr<Paragraph>> expected, actual;
+    for (int i = 0; i < kCount; ++i) {
+        expected.push_back(build(i));
+        actual.push_back(build(i));
+    }
+    Paragraph::LayoutAll(expected, 300, nullptr);
+    fontCollection->getParagraphCache()->reset();
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    Paragraph::LayoutAll(actual, 300, executor.get());
+    for (int i = 0; i < kCount; ++i) {
+        REPORTER_ASSERT(reporter, actual[i]->lineNumber() == expected[i]->lineNumber(), "%d", i);
+        REPORTER_ASSERT(reporter, actual[i]->getHeight() == expected[i]->getHeight(), "%d", i);
+        REPORTER_ASSERT(reporter, actual[i]->getLongestLine() == expected[i]->getLongestLine(),
+                        "%d", i);
+    }
+}
+
+// The pieces of runs kept by updateText() are placed by adding up their advances, which rounds
+// differently from adding up whole runs; allow for that (far less than any kerning).
+static constexpr SkScalar kTolerance = 1.0f / 64;
+
+// Checks that two paragraphs have the same glyphs on each line, at the same places and with the
+// same advances (to the next glyph on the line), however the glyphs are split into runs.
+static void check_same_glyphs(skiatest::Reporter* reporter,
+                              Paragraph* actual,
+                              Paragraph* expected) {
+    struct Glyph {
+        int line;
+        uint16_t id;
+        uint32_t utf8Start;
+        SkPoint position;
+        SkScalar advance;
+    };
+    auto collect = [](Paragraph* paragraph) {
+        std::vector<Glyph> glyphs;
+        size_t lineStart = 0;
+        paragraph->visit([&](int lineNumber, const Paragraph::VisitorInfo* info) {
+            if (!info) {
+                for (size_t i = lineStart; i + 1 < glyphs.size(); ++i) {
+                    glyphs[i].advance = glyphs[i + 1].position.fX - glyphs[i].position.fX;
+                }
+                lineStart = glyphs.size();
+                return;
+            }
+            for (int i = 0; i < info->count; ++i) {
+                glyphs.push_back({lineNumber, info->glyphs[i], info->utf8Starts[i],
+                                  info->origin + info->positions[i], 0});
+            }
+        });
+        return glyphs;
+    };
+    std::vector<Glyph> actualGlyphs = collect(actual), expectedGlyphs = collect(expected);
+    REPORTER_ASSERT(reporter, actualGlyphs.size() == expectedGlyphs.size(),
+                    "%zu glyphs, expected %zu", actualGlyphs.size(), expectedGlyphs.size());
+    for (size_t i = 0; i < std::min(actualGlyphs.size(), expectedGlyphs.size()); ++i) {
+        const Glyph& a = actualGlyphs[i];
+        const Glyph& e = expectedGlyphs[i];
+        REPORTER_ASSERT(reporter, a.line == e.line && a.id == e.id && a.utf8Start == e.utf8Start,
+                        "glyph %zu", i);
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(a.position.fX, e.position.fX, kTolerance) &&
+                                  SkScalarNearlyEqual(a.position.fY, e.position.fY, kTolerance),
+                        "glyph %zu at (%g, %g), expected (%g, %g)", i, a.position.fX,
+                        a.position.fY, e.position.fX, e.position.fY);
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(a.advance, e.advance, kTolerance),
+                        "glyph %zu advance %g, expected %g", i, a.advance, e.advance);
+    }
+}
+
+UNIX_ONLY_TEST(SkParagraph_UpdateText, reporter) {
+    sk_sp<ResourceFontCollection> fontCollection = sk_make_sp<ResourceFontCollection>();
+    SKIP_IF_FONTS_NOT_FOUND(reporter, fontCollection)
+    fontCollection->setDefaultFontManager(ToolUtils::TestFontMgr());
+    fontCollection->enableFontFallback();
+
+    ParagraphStyle paragraph_style;
+    TextStyle text_style;
+    text_style.setFontSize(20);
+    text_style.setColor(SK_ColorBLACK);
+    auto build = [&](const SkString& text) {
+        ParagraphBuilderImpl builder(paragraph_style, fontCollection, get_unicode());
+        builder.pushStyle(text_style);
+        builder.addText(text.c_str(), text.size());
+        builder.pop();
+        return builder.Build();
+    };
+
+    // Ahem is shaped again only around the edits, Roboto (which kerns the space) all over
+    for (const char* family : {"Roboto", "Ahem"}) {
+        text_style.setFontFamilies({SkString(family)});
+        SkString text;
+        for (int i = 0; i < 20; ++i) {
+            text.appendf("Sentence number %d goes on for a few more words than the others. ", i);
+        }
+        auto paragraph = build(text);
+        paragraph->layout(300);
+
+        struct Edit {
+            size_t from;
+            size_t to;
+            const char* text;
+        } edits[] = {
+            {600, 600, "x"},                        // Typing in the middle of a word
+            {600, 601, ""},                         // ...and deleting it
+            {100, 100, "a few inserted words "},
+            {50, 250, ""},                          // Deleting lines
+            {300, 300, "\n"},                       // A hard line break
+            {0, 0, "Start "},
+            {text.size() / 2, text.size() / 2, " end"},
+            {10, 20, "من أسر وإعلان"},              // Bidi text, laid out from scratch
+        };
+        for (const Edit& edit : edits) {
+            size_t from = std::min(edit.from, text.size());
+            size_t to = std::min(edit.to, text.size());
+            text.remove(from, to - from);
+            text.insert(from, edit.text);
+            paragraph->updateText(from, to, SkString(edit.text));
+            paragraph->layout(300);
+
+            auto expected = build(text);
+            expected->layout(300);
+            REPORTER_ASSERT(reporter, paragraph->lineNumber() == expected->lineNumber(),
+                            "%zu", from);
+            REPORTER_ASSERT(reporter, paragraph->getHeight() == expected->getHeight(), "%zu", from);
+            REPORTER_ASSERT(reporter, SkScalarNearlyEqual(paragraph->getLongestLine(),
+                                                          expected->getLongestLine(), kTolerance),
+                            "%s %zu", family, from);
+            REPORTER_ASSERT(reporter, SkScalarNearlyEqual(paragraph->getMaxIntrinsicWidth(),
+                                                          expected->getMaxIntrinsicWidth(),
+                                                          kTolerance),
+                            "%s %zu", family, from);
+
+            std::vector<LineMetrics> actualLines, expectedLines;
+            paragraph->getLineMetrics(actualLines);
+            expected->getLineMetrics(expectedLines);
+            REPORTER_ASSERT(reporter, actualLines.size() == expectedLines.size(), "%zu", from);
+            for (size_t i = 0; i < std::min(actualLines.size(), expectedLines.size()); ++i) {
+                const LineMetrics& a = actualLines[i];
+                const LineMetrics& e = expectedLines[i];
+                REPORTER_ASSERT(reporter, a.fStartIndex == e.fStartIndex);
+                REPORTER_ASSERT(reporter, a.fEndIndex == e.fEndIndex);
+                REPORTER_ASSERT(reporter, a.fBaseline == e.fBaseline);
+                REPORTER_ASSERT(reporter, SkScalarNearlyEqual(a.fWidth, e.fWidth, kTolerance));
+            }
+            check_same_glyphs(reporter, paragraph.get(), expected.get());
+        }
+    }
+}
+
+// Typing next to a space, where a font that kerns the space with the letters around it puts the
+// glyphs somewhere else than shaping the words on their own would.
+UNIX_ONLY_TEST(SkParagraph_UpdateTextKernedSpace, reporter) {
+    sk_sp<ResourceFontCollection> fontCollection = sk_make_sp<ResourceFontCollection>();
+    SKIP_IF_FONTS_NOT_FOUND(reporter, fontCollection)
+    fontCollection->setDefaultFontManager(ToolUtils::TestFontMgr());
+    fontCollection->enableFontFallback();
+
+    ParagraphStyle paragraph_style;
+    TextStyle text_style;
+    text_style.setFontSize(20);
+    text_style.setColor(SK_ColorBLACK);
+    auto build = [&](const SkString& text) {
+        ParagraphBuilderImpl builder(paragraph_style, fontCollection, get_unicode());
+        builder.pushStyle(text_style);
+        builder.addText(text.c_str(), text.size());
+        builder.pop();
+        return builder.Build();
+    };
+
+    // Roboto kerns the space, Ahem doesn't (so only it is shaped incrementally)
+    for (const char* family : {"Roboto", "Ahem"}) {
+        text_style.setFontFamilies({SkString(family)});
+        SkString text;
+        for (int i = 0; i < 10; ++i) {
+            text.append("AV To Ty Wa Yo \"T\" L' ");
+        }
+        auto paragraph = build(text);
+        paragraph->layout(300);
+        for (size_t from : {30, 31, 45, 100, 101}) {
+            text.insert(from, "T");
+            paragraph->updateText(from, from, SkString("T"));
+            paragraph->layout(300);
+
+            auto expected = build(text);
+            expected->layout(300);
+            REPORTER_ASSERT(reporter, paragraph->lineNumber() == expected->lineNumber(),
+                            "%s %zu", family, from);
+            check_same_glyphs(reporter, paragraph.get(), expected.get());
+        }
+    }
+}
+
+UNIX_ONLY_TEST(SkParagraph_Measure, reporter) {
+    sk_sp<ResourceFontCollection> fontCollection = sk_make_sp<ResourceFontCollection>();
+    SKIP_IF_FONTS_NOT_FOUND(reporter, fontCollection)
+    fontCollection->setDefaultFontManager(ToolUtils::TestFontMgr());
+    fontCollection->enableFontFallback();
+
+    TextStyle text_style;
+    text_style.setFontFamilies({SkString("Roboto")});
+    text_style.setFontSize(20);
+    text_style.setColor(SK_ColorBLACK);
+    auto build = [&](const ParagraphStyle& paragraph_style, const char* text) {
+        ParagraphBuilderImpl builder(paragraph_style, fontCollection, get_unicode());
+        builder.pushStyle(text_style);
+        builder.addText(text);
+        builder.pop();
+        return builder.Build();
+    };
+    auto check = [&](Paragraph* measured, Paragraph* expected, SkScalar width) {
+        REPORTER_ASSERT(reporter, measured->lineNumber() == expected->lineNumber(), "%g", width);
+        REPORTER_ASSERT(reporter, measured->getHeight() == expected->getHeight(), "%g", width);
+        REPORTER_ASSERT(reporter, measured->getLongestLine() == expected->getLongestLine(),
+                        "%g", width);
+        REPORTER_ASSERT(reporter, measured->getMinIntrinsicWidth() ==
+                                  expected->getMinIntrinsicWidth(), "%g", width);
+        REPORTER_ASSERT(reporter, measured->getMaxIntrinsicWidth() ==
+                                  expected->getMaxIntrinsicWidth(), "%g", width);
+        REPORTER_ASSERT(reporter, measured->getAlphabeticBaseline() ==
+                                  expected->getAlphabeticBaseline(), "%g", width);
+        REPORTER_ASSERT(reporter, measured->getIdeographicBaseline() ==
+                                  expected->getIdeographicBaseline(), "%g", width);
+        REPORTER_ASSERT(reporter, measured->didExceedMaxLines() == expected->didExceedMaxLines(),
+                        "%g", width);
+    };
+
+    const char* text = "A paragraph that is measured at a few widths before it is laid out, "
+                       "and then laid out at the last one without shaping it again.";
+    ParagraphStyle unlimited;
+    ParagraphStyle ellipsized;
+    ellipsized.setMaxLines(2);
+    ellipsized.setEllipsis(u"\u2026");
+    ParagraphStyle oneWord;
+    for (const ParagraphStyle* style : {&unlimited, &ellipsized, &oneWord}) {
+        const char* styleText = style == &oneWord ? "Word" : text;
+        auto measured = build(*style, styleText);
+        for (SkScalar width : {100.0f, 250.0f, 1000.0f, 250.0f}) {
+            measured->measure(width);
+            auto expected = build(*style, styleText);
+            expected->layout(width);
+            check(measured.get(), expected.get(), width);
+        }
+
+        // Laying out the measured paragraph builds the lines
+        measured->layout(250);
+        auto expected = build(*style, styleText);
+        expected->layout(250);
+        check(measured.get(), expected.get(), 250);
+        std::vector<LineMetrics> measuredLines, expectedLines;
+        measured->getLineMetrics(measuredLines);
+        expected->getLineMetrics(expectedLines);
+        REPORTER_ASSERT(reporter, measuredLines.size() == expectedLines.size());
+        for (size_t i = 0; i < std::min(measuredLines.size(), expectedLines.size()); ++i) {
+            REPORTER_ASSERT(reporter, measuredLines[i].fStartIndex == expectedLines[i].fStartIndex);
+            REPORTER_ASSERT(reporter, measuredLines[i].fEndIndex == expectedLines[i].fEndIndex);
+            REPORTER_ASSERT(reporter, measuredLines[i].fWidth == expectedLines[i].fWidth);
+        }
+
+        // ...and measuring it again at the same width keeps them
+        measured->measure(250);
+        REPORTER_ASSERT(reporter, measured->lineNumber() == expectedLines.size());
+        measured->getLineMetrics(measuredLines);
+        REPORTER_ASSERT(reporter, measuredLines.size() == expectedLines.size());
+    }
+}
+
+// Editing a paragraph, measuring it and only then laying it out must end up where laying out the
+// edited text from scratch does: measure() breaks the lines of the runs updateText() kept.
+UNIX_ONLY_TEST(SkParagraph_UpdateTextThenMeasure, reporter) {
+    sk_sp<ResourceFontCollection> fontCollection = sk_make_sp<ResourceFontCollection>();
+    SKIP_IF_FONTS_NOT_FOUND(reporter, fontCollection)
+    fontCollection->setDefaultFontManager(ToolUtils::TestFontMgr());
+    fontCollection->enableFontFallback();
+
+    ParagraphStyle paragraph_style;
+    TextStyle text_style;
+    text_style.setFontSize(20);
+    text_style.setColor(SK_ColorBLACK);
+    auto build = [&](const SkString& text) {
+        ParagraphBuilderImpl builder(paragraph_style, fontCollection, get_unicode());
+        builder.pushStyle(text_style);
+        builder.addText(text.c_str(), text.size());
+        builder.pop();
+        return builder.Build();
+    };
+
+    for (const char* family : {"Roboto", "Ahem"}) {
+        text_style.setFontFamilies({SkString(family)});
+        SkString text;
+        for (int i = 0; i < 10; ++i) {
+            text.appendf("Cell %d holds a few words that wrap onto more lines. ", i);
+        }
+        auto paragraph = build(text);
+        paragraph->layout(300);
+
+        struct Edit {
+            size_t from;
+            size_t to;
+            const char* text;
+        } edits[] = {
+            {120, 120, "x"},
+            {40, 90, ""},
+            {200, 200, " some more words"},
+        };
+        for (const Edit& edit : edits) {
+            text.remove(edit.from, edit.to - edit.from);
+            text.insert(edit.from, edit.text);
+            paragraph->updateText(edit.from, edit.to, SkString(edit.text));
+
+            // Measured at another width than the last layout, and then at the width laid out next
+            for (SkScalar width : {180.0f, 300.0f}) {
+                paragraph->measure(width);
+                auto expected = build(text);
+                expected->layout(width);
+                REPORTER_ASSERT(reporter, paragraph->lineNumber() == expected->lineNumber(),
+                                "%s %zu %g", family, edit.from, width);
+                REPORTER_ASSERT(reporter, paragraph->getHeight() == expected->getHeight(),
+                                "%s %zu %g", family, edit.from, width);
+                REPORTER_ASSERT(reporter, SkScalarNearlyEqual(paragraph->getLongestLine(),
+                                                              expected->getLongestLine(),
+                                                              kTolerance),
+                                "%s %zu %g", family, edit.from, width);
+                REPORTER_ASSERT(reporter, SkScalarNearlyEqual(paragraph->getMaxIntrinsicWidth(),
+                                                              expected->getMaxIntrinsicWidth(),
+                                                              kTolerance),
+                                "%s %zu %g", family, edit.from, width);
+            }
+
+            paragraph->layout(300);
+            auto expected = build(text);
+            expected->layout(300);
+            std::vector<LineMetrics> actualLines, expectedLines;
+            paragraph->getLineMetrics(actualLines);
+            expected->getLineMetrics(expectedLines);
+            REPORTER_ASSERT(reporter, actualLines.size() == expectedLines.size(),
+                            "%s %zu", family, edit.from);
+            for (size_t i = 0; i < std::min(actualLines.size(), expectedLines.size()); ++i) {
+                const LineMetrics& a = actualLines[i];
+                const LineMetrics& e = expectedLines[i];
+                REPORTER_ASSERT(reporter, a.fStartIndex == e.fStartIndex);
+                REPORTER_ASSERT(reporter, a.fEndIndex == e.fEndIndex);
+                REPORTER_ASSERT(reporter, a.fBaseline == e.fBaseline);
+            }
+            check_same_glyphs(reporter, paragraph.get(), expected.get());
+        }
+    }
+}
+
 UNIX_ONLY_TEST(SkParagraph_ParagraphWithLineBreak, reporter) {
     sk_sp<ResourceFontCollection> fontCollection = sk_make_sp<ResourceFontCollection>();
     SKIP_IF_FONTS_NOT_FOUND(reporter, fontCollection)
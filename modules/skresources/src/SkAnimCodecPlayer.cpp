@@ -13,6 +13,7 @@
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
@@ -21,7 +22,9 @@
 #include "include/core/SkSamplingOptions.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkTypes.h"
+#include "include/private/base/SkTo.h"
 #include "src/codec/SkCodecImageGenerator.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <algorithm>
 #include <cstddef>
@@ -29,10 +32,16 @@
 #include <utility>
 #include <vector>
 
-SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(std::move(codec)) {
+SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec)
+        : SkAnimCodecPlayer(std::move(codec), Options()) {}
+
+SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec, const Options& options)
+        : fOptions(options), fCodec(std::move(codec)) {
     fImageInfo = fCodec->getInfo();
+    fOrigin = fCodec->getOrigin();
     fFrameInfos = fCodec->getFrameInfo();
     fImages.resize(fFrameInfos.size());
+    fLastUse.resize(fFrameInfos.size());
 
     // change the interpretation of fDuration to a end-time for that frame
     size_t dur = 0;
@@ -46,31 +55,136 @@ SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(st
         // Static image -- may or may not have returned a single frame info.
         fFrameInfos.clear();
         fImages.clear();
+        fLastUse.clear();
         fImages.push_back(SkImages::DeferredFromGenerator(
                 SkCodecImageGenerator::MakeFromCodec(std::move(fCodec))));
+    } else if (fOptions.fExecutor && fOptions.fDecodeAhead > 0) {
+        fDecodeAheadTasks = std::make_unique<SkTaskGroup>(*fOptions.fExecutor);
     }
 }
 
-SkAnimCodecPlayer::~SkAnimCodecPlayer() {}
+SkAnimCodecPlayer::~SkAnimCodecPlayer() {
+    if (fDecodeAheadTasks) {
+        fDecodeAheadTasks->wait();
+    }
+}
 
 SkISize SkAnimCodecPlayer::dimensions() const {
-    if (!fCodec) {
+    if (!fTotalDuration) {
+        SkAutoMutexExclusive lock(fCacheMutex);
         auto image = fImages.front();
         return image ? image->dimensions() : SkISize::MakeEmpty();
     }
-    if (SkEncodedOriginSwapsWidthHeight(fCodec->getOrigin())) {
+    if (SkEncodedOriginSwapsWidthHeight(fOrigin)) {
         return { fImageInfo.height(), fImageInfo.width() };
     }
     return { fImageInfo.width(), fImageInfo.height() };
 }
 
+size_t SkAnimCodecPlayer::cacheBytes() const {
+    SkAutoMutexExclusive lock(fCacheMutex);
+    return fCacheBytes;
+}
+
+int SkAnimCodecPlayer::decodeAheadCount() const {
+    return fDecodeAheadTasks ? fOptions.fDecodeAhead : 0;
+}
+
+sk_sp<SkImage> SkAnimCodecPlayer::findFrame(int index) {
+    SkAutoMutexExclusive lock(fCacheMutex);
+    if (fImages[index]) {
+        fLastUse[index] = ++fUseCount;
+    }
+    return fImages[index];
+}
+
+void SkAnimCodecPlayer::insertFrame(int index, sk_sp<SkImage> image) {
+    SkAutoMutexExclusive lock(fCacheMutex);
+    SkASSERT(!fImages[index]);
+    fCacheBytes += image->imageInfo().computeMinByteSize();
+    fImages[index] = std::move(image);
+    fLastUse[index] = ++fUseCount;
+
+    if (fCacheBytes <= fOptions.fCacheBudget) {
+        return;
+    }
+
+    // Keep the new frame, the current frame and the frames decoded ahead of it, and the frames
+    // those depend on, since they are about to be needed.
+    const int frameCount = SkToInt(fFrameInfos.size());
+    std::vector<bool> keep(frameCount);
+    auto keepWithRequired = [&](int i) {
+        keep[i] = true;
+        if (fFrameInfos[i].fRequiredFrame != SkCodec::kNoFrame) {
+            keep[fFrameInfos[i].fRequiredFrame] = true;
+        }
+    };
+    keepWithRequired(index);
+    for (int i = 0; i <= this->decodeAheadCount(); i++) {
+        keepWithRequired((fCurrIndex + i) % frameCount);
+    }
+
+    while (fCacheBytes > fOptions.fCacheBudget) {
+        // Drop frames that depend on others first, since the others are where a seek starts
+        // decoding from, and then the least recently used ones.
+        int victim = -1;
+        std::pair<bool, uint64_t> victimOrder;
+        for (int i = 0; i < frameCount; i++) {
+            const auto order = std::make_pair(
+                    fFrameInfos[i].fRequiredFrame == SkCodec::kNoFrame, fLastUse[i]);
+            if (fImages[i] && !keep[i] && (victim < 0 || order < victimOrder)) {
+                victim = i;
+                victimOrder = order;
+            }
+        }
+        if (victim < 0) {
+            break;
+        }
+        fCacheBytes -= fImages[victim]->imageInfo().computeMinByteSize();
+        fImages[victim] = nullptr;
+    }
+}
+
 sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
     SkASSERT((unsigned)index < fFrameInfos.size());
 
-    if (fImages[index]) {
-        return fImages[index];
+    if (auto image = this->findFrame(index)) {
+        return image;
     }
 
+    SkAutoMutexExclusive lock(fCodecMutex);
+    // The decode-ahead task may have decoded the frame while we waited for the codec.
+    if (auto image = this->findFrame(index)) {
+        return image;
+    }
+    return this->decodeFrame(index);
+}
+
+sk_sp<SkImage> SkAnimCodecPlayer::decodeFrame(int index) {
+    // Walk back to the closest frame this one depends on that is still cached, and decode
+    // forward from there. Otherwise SkCodec would decode the frames it depends on again,
+    // without keeping them for the next frame.
+    std::vector<int> toDecode;
+    sk_sp<SkImage> prior;
+    for (int i = index; i != SkCodec::kNoFrame; i = fFrameInfos[i].fRequiredFrame) {
+        if ((prior = this->findFrame(i))) {
+            break;
+        }
+        toDecode.push_back(i);
+    }
+
+    for (auto i = toDecode.rbegin(); i != toDecode.rend(); ++i) {
+        auto image = this->decodeFrame(*i, prior.get());
+        if (!image) {
+            return nullptr;
+        }
+        this->insertFrame(*i, image);
+        prior = std::move(image);
+    }
+    return prior;
+}
+
+sk_sp<SkImage> SkAnimCodecPlayer::decodeFrame(int index, const SkImage* prior) {
     size_t rb = fImageInfo.minRowBytes();
     size_t size = fImageInfo.computeByteSize(rb);
     auto data = SkData::MakeUninitialized(size);
@@ -91,8 +205,8 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
         imageInfo = imageInfo.makeAlphaType(kPremul_SkAlphaType);
     }
     const int requiredFrame = fFrameInfos[index].fRequiredFrame;
-    if (requiredFrame != SkCodec::kNoFrame && fImages[requiredFrame]) {
-        auto requiredImage = fImages[requiredFrame];
+    if (prior) {
+        SkASSERT(requiredFrame != SkCodec::kNoFrame);
         auto canvas = SkCanvas::MakeRasterDirect(imageInfo, data->writable_data(), rb);
         if (origin != kDefault_SkEncodedOrigin) {
             // The required frame is stored after applying the origin. Undo that,
@@ -106,7 +220,7 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
             SkAssertResult(originMatrix.invert(&inverse));
             canvas->concat(inverse);
         }
-        canvas->drawImage(requiredImage, 0, 0, SkSamplingOptions(), &paint);
+        canvas->drawImage(prior, 0, 0, SkSamplingOptions(), &paint);
         opts.fPriorFrame = requiredFrame;
     }
 
@@ -125,15 +239,24 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
         canvas->drawImage(image, 0, 0, SkSamplingOptions(), &paint);
         image = SkImages::RasterFromData(imageInfo, std::move(data), rb);
     }
-    return fImages[index] = image;
+    return image;
 }
 
 sk_sp<SkImage> SkAnimCodecPlayer::getFrame() {
-    SkASSERT(fTotalDuration > 0 || fImages.size() == 1);
+    if (!fTotalDuration) {
+        SkAutoMutexExclusive lock(fCacheMutex);
+        SkASSERT(fImages.size() == 1);
+        return fImages.front();
+    }
 
-    return fTotalDuration > 0
-        ? this->getFrameAt(fCurrIndex)
-        : fImages.front();
+    int index;
+    {
+        SkAutoMutexExclusive lock(fCacheMutex);
+        index = fCurrIndex;
+    }
+    auto image = this->getFrameAt(index);
+    this->scheduleDecodeAhead();
+    return image;
 }
 
 bool SkAnimCodecPlayer::seek(uint32_t msec) {
@@ -147,9 +270,58 @@ bool SkAnimCodecPlayer::seek(uint32_t msec) {
                                   [](const SkCodec::FrameInfo& info, uint32_t msec) {
                                       return (uint32_t)info.fDuration <= msec;
                                   });
-    int prevIndex = fCurrIndex;
-    fCurrIndex = lower - fFrameInfos.begin();
-    return fCurrIndex != prevIndex;
+    int prevIndex;
+    {
+        SkAutoMutexExclusive lock(fCacheMutex);
+        prevIndex = fCurrIndex;
+        fCurrIndex = lower - fFrameInfos.begin();
+        if (fCurrIndex == prevIndex) {
+            return false;
+        }
+    }
+    this->scheduleDecodeAhead();
+    return true;
+}
+
+void SkAnimCodecPlayer::scheduleDecodeAhead() {
+    if (!fDecodeAheadTasks) {
+        return;
+    }
+    {
+        SkAutoMutexExclusive lock(fCacheMutex);
+        if (fDecodingAhead) {
+            // The running task picks up the new current frame.
+            return;
+        }
+        fDecodingAhead = true;
+    }
+    fDecodeAheadTasks->add([this] { this->decodeAhead(); });
 }
 
+void SkAnimCodecPlayer::decodeAhead() {
+    const int frameCount = SkToInt(fFrameInfos.size());
+    for (;;) {
+        int index = SkCodec::kNoFrame;
+        {
+            SkAutoMutexExclusive lock(fCacheMutex);
+            for (int i = 0; i <= this->decodeAheadCount(); i++) {
+                if (!fImages[(fCurrIndex + i) % frameCount]) {
+                    index = (fCurrIndex + i) % frameCount;
+                    break;
+                }
+            }
+            if (index == SkCodec::kNoFrame) {
+                fDecodingAhead = false;
+                return;
+            }
+        }
 
+        SkAutoMutexExclusive lock(fCodecMutex);
+        if (!this->findFrame(index) && !this->decodeFrame(index)) {
+            // Leave the error for getFrame() to report, rather than retrying.
+            SkAutoMutexExclusive cacheLock(fCacheMutex);
+            fDecodingAhead = false;
+            return;
+        }
+    }
+}
@@ -9,19 +9,43 @@
 #define SkAnimCodecPlayer_DEFINED
 
 #include "include/codec/SkCodec.h"
+#include "include/codec/SkEncodedOrigin.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSize.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkThreadAnnotations.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <vector>
 
+class SkExecutor;
 class SkImage;
+class SkTaskGroup;
 
 class SkAnimCodecPlayer {
 public:
+    struct Options {
+        /**
+         *  Upper bound on the bytes of decoded frames kept for reuse. When it is exceeded, the
+         *  least recently used frames are dropped first, and frames that depend on no other frame
+         *  (which make cheap starting points for a seek) last. The current frame, the frames
+         *  being decoded ahead, and the frames they depend on are kept even past the budget.
+         */
+        size_t      fCacheBudget = SIZE_MAX;
+
+        /**
+         *  If not null, the current frame and the fDecodeAhead frames after it are decoded on
+         *  this executor, so getFrame() usually finds its frame already decoded.
+         */
+        SkExecutor* fExecutor = nullptr;
+        int         fDecodeAhead = 2;
+    };
+
     SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec);
+    SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec, const Options&);
     ~SkAnimCodecPlayer();
 
     /**
@@ -51,16 +75,46 @@ public:
      */
     bool seek(uint32_t msec);
 
+    /**
+     *  Returns the bytes of decoded frames currently held for reuse.
+     */
+    size_t cacheBytes() const;
 
 private:
-    std::unique_ptr<SkCodec>        fCodec;
+    const Options                   fOptions;
+    // Held for each frame decode, since the codec may also be used by the decode-ahead task.
+    SkMutex                         fCodecMutex;
+    std::unique_ptr<SkCodec>        fCodec SK_GUARDED_BY(fCodecMutex);
     SkImageInfo                     fImageInfo;
+    SkEncodedOrigin                 fOrigin;
     std::vector<SkCodec::FrameInfo> fFrameInfos;
-    std::vector<sk_sp<SkImage> >    fImages;
-    int                             fCurrIndex = 0;
     uint32_t                        fTotalDuration;
 
+    // Guards the cached frames and the current frame, which the decode-ahead task reads.
+    mutable SkMutex                 fCacheMutex;
+    std::vector<sk_sp<SkImage> >    fImages            SK_GUARDED_BY(fCacheMutex);
+    std::vector<uint64_t>           fLastUse           SK_GUARDED_BY(fCacheMutex);
+    uint64_t                        fUseCount          SK_GUARDED_BY(fCacheMutex) = 0;
+    size_t                          fCacheBytes        SK_GUARDED_BY(fCacheMutex) = 0;
+    int                             fCurrIndex         SK_GUARDED_BY(fCacheMutex) = 0;
+    bool                            fDecodingAhead     SK_GUARDED_BY(fCacheMutex) = false;
+
+    std::unique_ptr<SkTaskGroup>    fDecodeAheadTasks;
+
     sk_sp<SkImage> getFrameAt(int index);
+
+    // Returns the frame if it is cached, marking it as recently used.
+    sk_sp<SkImage> findFrame(int index);
+    void insertFrame(int index, sk_sp<SkImage>);
+    int decodeAheadCount() const;
+
+    // Decodes the frame, and any frames it depends on that are no longer cached.
+    sk_sp<SkImage> decodeFrame(int index) SK_REQUIRES(fCodecMutex);
+    // Decodes one frame on top of prior, the image of the frame it depends on, if any.
+    sk_sp<SkImage> decodeFrame(int index, const SkImage* prior) SK_REQUIRES(fCodecMutex);
+
+    void scheduleDecodeAhead();
+    void decodeAhead();
 };
 
 #endif
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/codec/SkCodec.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "modules/skresources/src/SkAnimCodecPlayer.h"
+#include "tests/Test.h"
+#include "tools/Resources.h"
+#include "tools/ToolUtils.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+static bool read_frame(SkAnimCodecPlayer* player, SkBitmap* bm) {
+    sk_sp<SkImage> image = player->getFrame();
+    return image && bm->tryAllocPixels(image->imageInfo()) && image->readPixels(bm->pixmap(), 0, 0);
+}
+
+// Plays the animation forwards and then seeks around it, checking that players with a bounded
+// cache or decoding ahead show the same frames as one that keeps every frame.
+DEF_TEST(AnimCodecPlayer_boundedCache, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    for (const char* path : {"images/required.gif", "images/alphabetAnim.gif",
+                             "images/flightAnim.gif", "images/required.webp",
+                             "images/blendBG.webp"}) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+        if (!codec) {
+            // WebP support may be disabled.
+            continue;
+        }
+
+        std::vector<uint32_t> times;
+        uint32_t time = 0;
+        for (const SkCodec::FrameInfo& info : codec->getFrameInfo()) {
+            times.push_back(time);
+            time += info.fDuration;
+        }
+        for (int i = (int)times.size() - 1; i >= 0; i -= 3) {
+            times.push_back(times[i]);
+        }
+        const size_t frameBytes = codec->getInfo().computeMinByteSize();
+        SkAnimCodecPlayer expected(std::move(codec));
+
+        for (size_t budget : {size_t(0), 2 * frameBytes}) {
+            for (SkExecutor* decodeAheadExecutor : {(SkExecutor*)nullptr, executor.get()}) {
+                SkAnimCodecPlayer::Options options;
+                options.fCacheBudget = budget;
+                options.fExecutor = decodeAheadExecutor;
+                SkAnimCodecPlayer player(SkCodec::MakeFromData(data), options);
+
+                for (uint32_t msec : times) {
+                    expected.seek(msec);
+                    player.seek(msec);
+                    SkBitmap expectedBitmap, bitmap;
+                    if (!read_frame(&expected, &expectedBitmap) || !read_frame(&player, &bitmap)) {
+                        ERRORF(r, "%s: failed to decode the frame at %u ms", path, msec);
+                        break;
+                    }
+                    REPORTER_ASSERT(r, ToolUtils::equal_pixels(expectedBitmap, bitmap),
+                                    "%s: frame at %u ms, budget %zu", path, msec, budget);
+                    if (!decodeAheadExecutor) {
+                        // Only the current frame and the one it depends on outlive the budget.
+                        REPORTER_ASSERT(r, player.cacheBytes() <= std::max(budget, 2 * frameBytes),
+                                        "%s: %zu bytes cached", path, player.cacheBytes());
+                    }
+                }
+            }
+        }
+    }
+}
@@ -17,15 +17,45 @@
 #include <memory>
 
 class SkFontMgr;
+class SkTypeface;
 class SkUnicode;
 
 namespace SkShapers::HB {
+/**
+ *  Caches the glyphs that words shape to, for text where the same words recur. Shapers given a
+ *  WordCache split their runs at spaces and shape each word on its own, looking it up by its
+ *  text, font, features, script, direction and language. This is only done with fonts whose
+ *  substitution and positioning lookups never involve the space glyph, so that a word shapes
+ *  the same on its own as it does in context; runs in other fonts are shaped whole, as without
+ *  a cache.
+ *
+ *  A WordCache is thread safe, and may be shared by any number of shapers.
+ */
+class SKSHAPER_API WordCache : public SkRefCnt {
+public:
+    /** Makes a cache that keeps the glyphs of up to maxWords words, evicting the least recently
+        used first. */
+    static sk_sp<WordCache> Make(int maxWords = 8192);
+
+    /** The number of words cached. */
+    virtual int count() const = 0;
+
+    /** Removes every word from the cache. */
+    virtual void purge() = 0;
+
+protected:
+    WordCache() = default;
+};
+
 SKSHAPER_API std::unique_ptr<SkShaper> ShaperDrivenWrapper(sk_sp<SkUnicode> unicode,
-                                                           sk_sp<SkFontMgr> fallback);
+                                                           sk_sp<SkFontMgr> fallback,
+                                                           sk_sp<WordCache> wordCache = nullptr);
 SKSHAPER_API std::unique_ptr<SkShaper> ShapeThenWrap(sk_sp<SkUnicode> unicode,
-                                                     sk_sp<SkFontMgr> fallback);
+                                                     sk_sp<SkFontMgr> fallback,
+                                                     sk_sp<WordCache> wordCache = nullptr);
 SKSHAPER_API std::unique_ptr<SkShaper> ShapeDontWrapOrReorder(sk_sp<SkUnicode> unicode,
-                                                              sk_sp<SkFontMgr> fallback);
+                                                              sk_sp<SkFontMgr> fallback,
+                                                              sk_sp<WordCache> wordCache = nullptr);
 
 SKSHAPER_API std::unique_ptr<SkShaper::ScriptRunIterator> ScriptRunIterator(const char* utf8,
                                                                             size_t utf8Bytes);
@@ -33,6 +63,13 @@ SKSHAPER_API std::unique_ptr<SkShaper::ScriptRunIterator> ScriptRunIterator(cons
                                                                             size_t utf8Bytes,
                                                                             SkFourByteTag script);
 
+/**
+ *  Whether text in this typeface shapes to the same glyphs and positions when it is split after
+ *  a space (U+0020) and the pieces are shaped on their own: no substitution, positioning or
+ *  kerning involves the space glyph. This is the test a WordCache uses on fonts.
+ */
+SKSHAPER_API bool SpaceIsContextFree(const SkTypeface& typeface);
+
 SKSHAPER_API void PurgeCaches();
 }  // namespace SkShapers::HB
 
@@ -34,7 +34,10 @@
 #include "modules/skunicode/include/SkUnicode.h"
 #include "src/base/SkTDPQueue.h"
 #include "src/base/SkUTF.h"
+#include "src/base/SkUtils.h"
+#include "src/core/SkChecksum.h"
 #include "src/core/SkLRUCache.h"
+#include "src/core/SkTHash.h"
 
 #if !defined(SK_DISABLE_LEGACY_SKSHAPER_FUNCTIONS)
 #include "modules/skshaper/include/SkShaper_skunicode.h"
@@ -43,6 +46,7 @@
 #include <hb-ot.h>
 #include <hb.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <memory>
@@ -65,6 +69,7 @@ using HBBlob   = std::unique_ptr<hb_blob_t  , SkFunctionObject<hb_blob_destroy>
 using HBFace   = std::unique_ptr<hb_face_t  , SkFunctionObject<hb_face_destroy>  >;
 using HBFont   = std::unique_ptr<hb_font_t  , SkFunctionObject<hb_font_destroy>  >;
 using HBBuffer = std::unique_ptr<hb_buffer_t, SkFunctionObject<hb_buffer_destroy>>;
+using HBSet    = std::unique_ptr<hb_set_t   , SkFunctionObject<hb_set_destroy>   >;
 
 using SkUnicodeBreak = std::unique_ptr<SkBreakIterator>;
 
@@ -622,11 +627,304 @@ struct ShapedRunGlyphIterator {
     size_t fGlyphIndex;
 };
 
+// Converts the features that apply to [begin, end) of the text, and returns false if any of them
+// only apply to part of it.
+bool collect_features(const SkShaper::Feature* features, size_t featuresSize,
+                      size_t begin, size_t end, TArray<hb_feature_t>* hbFeatures) {
+    bool allGlobal = true;
+    for (const auto& feature : SkSpan(features, featuresSize)) {
+        if (feature.end < begin || end <= feature.start) {
+            continue;
+        }
+        if (feature.start <= begin && end <= feature.end) {
+            hbFeatures->push_back({ (hb_tag_t)feature.tag, feature.value,
+                                    HB_FEATURE_GLOBAL_START, HB_FEATURE_GLOBAL_END});
+        } else {
+            hbFeatures->push_back({ (hb_tag_t)feature.tag, feature.value,
+                                    SkTo<unsigned>(feature.start), SkTo<unsigned>(feature.end)});
+            allGlobal = false;
+        }
+    }
+    return allGlobal;
+}
+
+// Shapes [utf8Start, utf8End) of utf8, with the rest as context, and appends its glyphs in logical
+// order. Clusters are offsets into utf8.
+void shape_span(hb_buffer_t* buffer, hb_font_t* hbFont, const SkFont& font,
+                const char* utf8, size_t utf8Bytes,
+                const char* utf8Start, const char* utf8End,
+                hb_direction_t direction, hb_script_t script, hb_language_t language,
+                const TArray<hb_feature_t>& hbFeatures,
+                TArray<ShapedGlyph>* glyphs) {
+    SkAutoTCallVProc<hb_buffer_t, hb_buffer_clear_contents> autoClearBuffer(buffer);
+    hb_buffer_set_content_type(buffer, HB_BUFFER_CONTENT_TYPE_UNICODE);
+    hb_buffer_set_cluster_level(buffer, HB_BUFFER_CLUSTER_LEVEL_MONOTONE_CHARACTERS);
+
+    // Documentation for HB_BUFFER_FLAG_BOT/EOT at 763e5466c0a03a7c27020e1e2598e488612529a7.
+    // Currently BOT forces a dotted circle when first codepoint is a mark; EOT has no effect.
+    // Avoid adding dotted circle, re-evaluate if BOT/EOT change. See https://skbug.com/9618.
+    // hb_buffer_set_flags(buffer, HB_BUFFER_FLAG_BOT | HB_BUFFER_FLAG_EOT);
+
+    // Add precontext.
+    hb_buffer_add_utf8(buffer, utf8, utf8Start - utf8, utf8Start - utf8, 0);
+
+    // Populate the hb_buffer directly with utf8 cluster indexes.
+    const char* utf8Current = utf8Start;
+    while (utf8Current < utf8End) {
+        unsigned int cluster = utf8Current - utf8;
+        hb_codepoint_t u = utf8_next(&utf8Current, utf8End);
+        hb_buffer_add(buffer, u, cluster);
+    }
+
+    // Add postcontext.
+    hb_buffer_add_utf8(buffer, utf8Current, utf8 + utf8Bytes - utf8Current, 0, 0);
+
+    hb_buffer_set_direction(buffer, direction);
+    hb_buffer_set_script(buffer, script);
+    hb_buffer_set_language(buffer, language);
+    hb_buffer_guess_segment_properties(buffer);
+
+    hb_shape(hbFont, buffer, hbFeatures.data(), hbFeatures.size());
+    unsigned len = hb_buffer_get_length(buffer);
+    if (len == 0) {
+        return;
+    }
+
+    if (direction == HB_DIRECTION_RTL) {
+        // Put the clusters back in logical order.
+        // Note that the advances remain ltr.
+        hb_buffer_reverse(buffer);
+    }
+    hb_glyph_info_t* info = hb_buffer_get_glyph_infos(buffer, nullptr);
+    hb_glyph_position_t* pos = hb_buffer_get_glyph_positions(buffer, nullptr);
+
+    // Undo skhb_position with (1.0/(1<<16)) and scale as needed.
+    AutoSTArray<32, SkGlyphID> glyphIDs(len);
+    for (unsigned i = 0; i < len; i++) {
+        glyphIDs[i] = info[i].codepoint;
+    }
+    AutoSTArray<32, SkRect> glyphBounds(len);
+    SkPaint p;
+    font.getBounds(glyphIDs.get(), len, glyphBounds.get(), &p);
+
+    double SkScalarFromHBPosX = +(1.52587890625e-5) * font.getScaleX();
+    double SkScalarFromHBPosY = -(1.52587890625e-5);  // HarfBuzz y-up, Skia y-down
+    ShapedGlyph* glyph = glyphs->push_back_n(len);
+    for (unsigned i = 0; i < len; i++, glyph++) {
+        glyph->fID = info[i].codepoint;
+        glyph->fCluster = info[i].cluster;
+        glyph->fOffset.fX = pos[i].x_offset * SkScalarFromHBPosX;
+        glyph->fOffset.fY = pos[i].y_offset * SkScalarFromHBPosY;
+        glyph->fAdvance.fX = pos[i].x_advance * SkScalarFromHBPosX;
+        glyph->fAdvance.fY = pos[i].y_advance * SkScalarFromHBPosY;
+
+        glyph->fHasVisual = !glyphBounds[i].isEmpty(); //!font->currentTypeface()->glyphBoundsAreZero(glyph.fID);
+#if SK_HB_VERSION_CHECK(1, 5, 0)
+        glyph->fUnsafeToBreak = info[i].mask & HB_GLYPH_FLAG_UNSAFE_TO_BREAK;
+#else
+        glyph->fUnsafeToBreak = false;
+#endif
+        glyph->fMustLineBreakBefore = false;
+    }
+}
+
+// Whether text may be shaped in two pieces split at p, which is next to a space. The piece after
+// a space can't start with a mark or joiner, which would have attached to the space.
+bool can_split_before(const char* utf8, const char* utf8End, const char* p) {
+    SkASSERT(utf8 < p && p < utf8End);
+    if (p[-1] != ' ' && p[0] != ' ') {
+        return false;
+    }
+    hb_codepoint_t u = utf8_next(&p, utf8End);
+    if (u == 0x200C || u == 0x200D) {  // ZWNJ and ZWJ
+        return false;
+    }
+    switch (hb_unicode_general_category(hb_unicode_funcs_get_default(), u)) {
+        case HB_UNICODE_GENERAL_CATEGORY_NON_SPACING_MARK:
+        case HB_UNICODE_GENERAL_CATEGORY_SPACING_MARK:
+        case HB_UNICODE_GENERAL_CATEGORY_ENCLOSING_MARK:
+            return false;
+        default:
+            return true;
+    }
+}
+
+// Returns true unless the 'kern' table is one HarfBuzz can't apply or has a pair with glyph.
+bool kern_table_ignores(hb_face_t* face, hb_codepoint_t glyph) {
+    HBBlob blob(hb_face_reference_table(face, HB_TAG('k','e','r','n')));
+    unsigned size = 0;
+    const uint8_t* data = (const uint8_t*)hb_blob_get_data(blob.get(), &size);
+    if (size == 0) {
+        return true;
+    }
+    auto u16 = [data](size_t offset) { return (uint16_t)(data[offset] << 8 | data[offset + 1]); };
+    // Only look in version 0 tables (version 1 is Apple's) of format 0 subtables.
+    if (size < 4 || u16(0) != 0) {
+        return false;
+    }
+    size_t offset = 4;
+    for (int i = u16(2); i > 0; --i) {
+        if (size < offset + 14) {
+            return false;
+        }
+        const size_t length = u16(offset + 2);
+        const int format = u16(offset + 4) >> 8;
+        const size_t pairs = u16(offset + 6);
+        if (format != 0 || size < offset + 14 + 6 * pairs) {
+            return false;
+        }
+        for (size_t pair = offset + 14; pair < offset + 14 + 6 * pairs; pair += 6) {
+            if (u16(pair) == glyph || u16(pair + 2) == glyph) {
+                return false;
+            }
+        }
+        offset += std::max<size_t>(length, 14 + 6 * pairs);
+    }
+    return true;
+}
+
+// Whether shaping never carries anything across a space in this font, so text may be shaped a
+// word at a time: no GSUB or GPOS lookup involves the space glyph (as a context glyph, input or
+// output), no kerning pair in 'kern' does, and there are no AAT tables for HarfBuzz to use
+// instead. Glyphs in class 0 of a class-based pair adjustment are not listed by HarfBuzz, so a
+// kerning value for "any other glyph" and the space would be missed.
+bool space_is_context_free(hb_font_t* hbFont) {
+    hb_codepoint_t space;
+    if (!hb_font_get_nominal_glyph(hbFont, ' ', &space)) {
+        return false;
+    }
+    hb_face_t* face = hb_font_get_face(hbFont);
+    for (hb_tag_t tag : {HB_TAG('m','o','r','x'), HB_TAG('m','o','r','t'),
+                         HB_TAG('k','e','r','x')}) {
+        HBBlob blob(hb_face_reference_table(face, tag));
+        if (hb_blob_get_length(blob.get()) > 0) {
+            return false;
+        }
+    }
+    if (!kern_table_ignores(face, space)) {
+        return false;
+    }
+    HBSet glyphs(hb_set_create());
+    for (hb_tag_t table : {HB_OT_TAG_GSUB, HB_OT_TAG_GPOS}) {
+        unsigned lookupCount = hb_ot_layout_table_get_lookup_count(face, table);
+        for (unsigned i = 0; i < lookupCount; ++i) {
+            hb_ot_layout_lookup_collect_glyphs(face, table, i, glyphs.get(), glyphs.get(),
+                                               glyphs.get(), glyphs.get());
+        }
+    }
+    return !hb_set_has(glyphs.get(), space);
+}
+
+// Words longer than this are shaped without the cache; they are unlikely to recur.
+constexpr size_t kMaxCachedWordBytes = 64;
+
+struct WordKey {
+    SkString fBytes;
+
+    bool operator==(const WordKey& that) const { return fBytes == that.fBytes; }
+    struct Hash {
+        uint32_t operator()(const WordKey& key) const { return SkGoodHash()(key.fBytes); }
+    };
+};
+
+class WordCacheImpl final : public SkShapers::HB::WordCache {
+public:
+    explicit WordCacheImpl(int maxWords) : fWords(maxWords) {}
+
+    int count() const override {
+        SkAutoMutexExclusive lock(fMutex);
+        return fWords.count();
+    }
+
+    void purge() override {
+        SkAutoMutexExclusive lock(fMutex);
+        fWords.reset();
+    }
+
+    bool canShapeWords(const SkFont& font, hb_font_t* hbFont) {
+        const SkTypefaceID typefaceID = font.getTypeface()->uniqueID();
+        {
+            SkAutoMutexExclusive lock(fMutex);
+            if (const bool* contextFree = fSpaceIsContextFree.find(typefaceID)) {
+                return *contextFree;
+            }
+        }
+        const bool contextFree = space_is_context_free(hbFont);
+        SkAutoMutexExclusive lock(fMutex);
+        fSpaceIsContextFree.set(typefaceID, contextFree);
+        return contextFree;
+    }
+
+    // Appends the glyphs of [word, word + wordBytes) of utf8, shaping it without context if it
+    // isn't cached. The features must all apply to the whole word.
+    void shapeWord(hb_buffer_t* buffer, hb_font_t* hbFont, const SkFont& font,
+                   const char* utf8, const char* word, size_t wordBytes,
+                   hb_direction_t direction, hb_script_t script, hb_language_t language,
+                   const TArray<hb_feature_t>& hbFeatures,
+                   TArray<ShapedGlyph>* glyphs) {
+        const uint64_t languageBits = (uint64_t)(uintptr_t)language;
+        const uint32_t fontFlags = (uint32_t)font.getEdging()            |
+                                   (uint32_t)font.getHinting()     << 2  |
+                                   (uint32_t)font.isSubpixel()     << 4  |
+                                   (uint32_t)font.isLinearMetrics()<< 5  |
+                                   (uint32_t)font.isEmbolden()     << 6  |
+                                   (uint32_t)font.isBaselineSnap() << 7  |
+                                   (uint32_t)font.isForceAutoHinting() << 8 |
+                                   (uint32_t)font.isEmbeddedBitmaps()  << 9;
+        const uint32_t header[] = {
+            font.getTypeface()->uniqueID(),
+            sk_bit_cast<uint32_t>(font.getSize()),
+            sk_bit_cast<uint32_t>(font.getScaleX()),
+            sk_bit_cast<uint32_t>(font.getSkewX()),
+            fontFlags,
+            (uint32_t)direction,
+            (uint32_t)script,
+            (uint32_t)languageBits,
+            (uint32_t)(languageBits >> 32),
+            SkToU32(hbFeatures.size()),
+        };
+        WordKey key;
+        key.fBytes.append((const char*)header, sizeof(header));
+        for (const hb_feature_t& feature : hbFeatures) {
+            const uint32_t tagAndValue[] = {feature.tag, feature.value};
+            key.fBytes.append((const char*)tagAndValue, sizeof(tagAndValue));
+        }
+        key.fBytes.append(word, wordBytes);
+
+        const uint32_t wordCluster = SkToU32(word - utf8);
+        auto append = [&](const TArray<ShapedGlyph>& wordGlyphs) {
+            ShapedGlyph* glyph = glyphs->push_back_n(wordGlyphs.size(), wordGlyphs.data());
+            for (int i = 0; i < wordGlyphs.size(); ++i) {
+                glyph[i].fCluster += wordCluster;
+            }
+        };
+        {
+            SkAutoMutexExclusive lock(fMutex);
+            if (const TArray<ShapedGlyph>* wordGlyphs = fWords.find(key)) {
+                append(*wordGlyphs);
+                return;
+            }
+        }
+        TArray<ShapedGlyph> wordGlyphs;
+        shape_span(buffer, hbFont, font, word, wordBytes, word, word + wordBytes,
+                   direction, script, language, hbFeatures, &wordGlyphs);
+        append(wordGlyphs);
+        SkAutoMutexExclusive lock(fMutex);
+        fWords.insert_or_update(key, std::move(wordGlyphs));
+    }
+
+private:
+    mutable SkMutex fMutex;
+    SkLRUCache<WordKey, TArray<ShapedGlyph>, WordKey::Hash> fWords SK_GUARDED_BY(fMutex);
+    THashMap<SkTypefaceID, bool> fSpaceIsContextFree SK_GUARDED_BY(fMutex);
+};
+
 class ShaperHarfBuzz : public SkShaper {
 public:
     ShaperHarfBuzz(sk_sp<SkUnicode>,
                    HBBuffer,
-                   sk_sp<SkFontMgr>);
+                   sk_sp<SkFontMgr>,
+                   sk_sp<SkShapers::HB::WordCache>);
 
 protected:
     sk_sp<SkUnicode> fUnicode;
@@ -643,6 +941,7 @@ private:
     const sk_sp<SkFontMgr> fFontMgr; // for fallback
     HBBuffer               fBuffer;
     hb_language_t          fUndefinedLanguage;
+    const sk_sp<SkShapers::HB::WordCache> fWordCache;
 
 #if !defined(SK_DISABLE_LEGACY_SKSHAPER_FUNCTIONS)
     void shape(const char* utf8, size_t utf8Bytes,
@@ -727,11 +1026,13 @@ private:
 
 ShaperHarfBuzz::ShaperHarfBuzz(sk_sp<SkUnicode> unicode,
                                HBBuffer buffer,
-                               sk_sp<SkFontMgr> fallback)
+                               sk_sp<SkFontMgr> fallback,
+                               sk_sp<SkShapers::HB::WordCache> wordCache)
     : fUnicode(unicode)
     , fFontMgr(fallback ? std::move(fallback) : SkFontMgr::RefEmpty())
     , fBuffer(std::move(buffer))
-    , fUndefinedLanguage(hb_language_from_string("und", -1)) {
+    , fUndefinedLanguage(hb_language_from_string("und", -1))
+    , fWordCache(std::move(wordCache)) {
 #if defined(SK_DISABLE_LEGACY_SKSHAPER_FUNCTIONS)
     SkASSERT(fUnicode);
 #endif
@@ -1289,33 +1590,8 @@ ShapedRun ShaperHarfBuzz::shape(char const * const utf8,
     ShapedRun run(RunHandler::Range(utf8Start - utf8, utf8runLength),
                   font.currentFont(), bidi.currentLevel(), nullptr, 0);
 
-    hb_buffer_t* buffer = fBuffer.get();
-    SkAutoTCallVProc<hb_buffer_t, hb_buffer_clear_contents> autoClearBuffer(buffer);
-    hb_buffer_set_content_type(buffer, HB_BUFFER_CONTENT_TYPE_UNICODE);
-    hb_buffer_set_cluster_level(buffer, HB_BUFFER_CLUSTER_LEVEL_MONOTONE_CHARACTERS);
-
-    // Documentation for HB_BUFFER_FLAG_BOT/EOT at 763e5466c0a03a7c27020e1e2598e488612529a7.
-    // Currently BOT forces a dotted circle when first codepoint is a mark; EOT has no effect.
-    // Avoid adding dotted circle, re-evaluate if BOT/EOT change. See https://skbug.com/9618.
-    // hb_buffer_set_flags(buffer, HB_BUFFER_FLAG_BOT | HB_BUFFER_FLAG_EOT);
-
-    // Add precontext.
-    hb_buffer_add_utf8(buffer, utf8, utf8Start - utf8, utf8Start - utf8, 0);
-
-    // Populate the hb_buffer directly with utf8 cluster indexes.
-    const char* utf8Current = utf8Start;
-    while (utf8Current < utf8End) {
-        unsigned int cluster = utf8Current - utf8;
-        hb_codepoint_t u = utf8_next(&utf8Current, utf8End);
-        hb_buffer_add(buffer, u, cluster);
-    }
-
-    // Add postcontext.
-    hb_buffer_add_utf8(buffer, utf8Current, utf8 + utf8Bytes - utf8Current, 0, 0);
-
     hb_direction_t direction = is_LTR(bidi.currentLevel()) ? HB_DIRECTION_LTR:HB_DIRECTION_RTL;
-    hb_buffer_set_direction(buffer, direction);
-    hb_buffer_set_script(buffer, hb_script_from_iso15924_tag((hb_tag_t)script.currentScript()));
+    hb_script_t hbScript = hb_script_from_iso15924_tag((hb_tag_t)script.currentScript());
     // Buffers with HB_LANGUAGE_INVALID race since hb_language_get_default is not thread safe.
     // The user must provide a language, but may provide data hb_language_from_string cannot use.
     // Use "und" for the undefined language in this case (RFC5646 4.1 5).
@@ -1323,8 +1599,6 @@ ShapedRun ShaperHarfBuzz::shape(char const * const utf8,
     if (hbLanguage == HB_LANGUAGE_INVALID) {
         hbLanguage = fUndefinedLanguage;
     }
-    hb_buffer_set_language(buffer, hbLanguage);
-    hb_buffer_guess_segment_properties(buffer);
 
     // TODO: better cache HBFace (data) / hbfont (typeface)
     // An HBFace is expensive (it sanitizes the bits).
@@ -1346,72 +1620,57 @@ ShapedRun ShaperHarfBuzz::shape(char const * const utf8,
         return run;
     }
 
+    STArray<32, ShapedGlyph> glyphs;
     STArray<32, hb_feature_t> hbFeatures;
-    for (const auto& feature : SkSpan(features, featuresSize)) {
-        if (feature.end < SkTo<size_t>(utf8Start - utf8) ||
-                          SkTo<size_t>(utf8End   - utf8)  <= feature.start)
-        {
-            continue;
-        }
-        if (feature.start <= SkTo<size_t>(utf8Start - utf8) &&
-                             SkTo<size_t>(utf8End   - utf8) <= feature.end)
-        {
-            hbFeatures.push_back({ (hb_tag_t)feature.tag, feature.value,
-                                   HB_FEATURE_GLOBAL_START, HB_FEATURE_GLOBAL_END});
-        } else {
-            hbFeatures.push_back({ (hb_tag_t)feature.tag, feature.value,
-                                   SkTo<unsigned>(feature.start), SkTo<unsigned>(feature.end)});
+    auto* wordCache = static_cast<WordCacheImpl*>(fWordCache.get());
+    if (wordCache && wordCache->canShapeWords(font.currentFont(), hbFont.get())) {
+        // Shape each word and each space on its own. Those with a space or the end of the text on
+        // either side shape the same anywhere, so come from the cache; the pieces at the ends
+        // of a run that starts or ends mid-word are shaped in context.
+        const char* const textEnd = utf8 + utf8Bytes;
+        const char* pieceStart = utf8Start;
+        while (pieceStart < utf8End) {
+            const char* pieceEnd = pieceStart;
+            do {
+                utf8_next(&pieceEnd, utf8End);
+            } while (pieceEnd < utf8End && !can_split_before(utf8, textEnd, pieceEnd));
+
+            hbFeatures.clear();
+            const bool featuresAreGlobal = collect_features(features, featuresSize,
+                                                            pieceStart - utf8, pieceEnd - utf8,
+                                                            &hbFeatures);
+            if (featuresAreGlobal &&
+                SkToSizeT(pieceEnd - pieceStart) <= kMaxCachedWordBytes &&
+                (pieceStart == utf8 || can_split_before(utf8, textEnd, pieceStart)) &&
+                (pieceEnd == textEnd || can_split_before(utf8, textEnd, pieceEnd))) {
+                wordCache->shapeWord(fBuffer.get(), hbFont.get(), font.currentFont(),
+                                     utf8, pieceStart, pieceEnd - pieceStart,
+                                     direction, hbScript, hbLanguage, hbFeatures, &glyphs);
+            } else {
+                shape_span(fBuffer.get(), hbFont.get(), font.currentFont(),
+                           utf8, utf8Bytes, pieceStart, pieceEnd,
+                           direction, hbScript, hbLanguage, hbFeatures, &glyphs);
+            }
+            pieceStart = pieceEnd;
         }
+    } else {
+        collect_features(features, featuresSize, utf8Start - utf8, utf8End - utf8, &hbFeatures);
+        shape_span(fBuffer.get(), hbFont.get(), font.currentFont(),
+                   utf8, utf8Bytes, utf8Start, utf8End,
+                   direction, hbScript, hbLanguage, hbFeatures, &glyphs);
     }
-
-    hb_shape(hbFont.get(), buffer, hbFeatures.data(), hbFeatures.size());
-    unsigned len = hb_buffer_get_length(buffer);
-    if (len == 0) {
+    if (glyphs.empty()) {
         return run;
     }
 
-    if (direction == HB_DIRECTION_RTL) {
-        // Put the clusters back in logical order.
-        // Note that the advances remain ltr.
-        hb_buffer_reverse(buffer);
-    }
-    hb_glyph_info_t* info = hb_buffer_get_glyph_infos(buffer, nullptr);
-    hb_glyph_position_t* pos = hb_buffer_get_glyph_positions(buffer, nullptr);
-
+    const size_t len = glyphs.size();
     run = ShapedRun(RunHandler::Range(utf8Start - utf8, utf8runLength),
                     font.currentFont(), bidi.currentLevel(),
                     std::unique_ptr<ShapedGlyph[]>(new ShapedGlyph[len]), len);
-
-    // Undo skhb_position with (1.0/(1<<16)) and scale as needed.
-    AutoSTArray<32, SkGlyphID> glyphIDs(len);
-    for (unsigned i = 0; i < len; i++) {
-        glyphIDs[i] = info[i].codepoint;
-    }
-    AutoSTArray<32, SkRect> glyphBounds(len);
-    SkPaint p;
-    run.fFont.getBounds(glyphIDs.get(), len, glyphBounds.get(), &p);
-
-    double SkScalarFromHBPosX = +(1.52587890625e-5) * run.fFont.getScaleX();
-    double SkScalarFromHBPosY = -(1.52587890625e-5);  // HarfBuzz y-up, Skia y-down
     SkVector runAdvance = { 0, 0 };
-    for (unsigned i = 0; i < len; i++) {
-        ShapedGlyph& glyph = run.fGlyphs[i];
-        glyph.fID = info[i].codepoint;
-        glyph.fCluster = info[i].cluster;
-        glyph.fOffset.fX = pos[i].x_offset * SkScalarFromHBPosX;
-        glyph.fOffset.fY = pos[i].y_offset * SkScalarFromHBPosY;
-        glyph.fAdvance.fX = pos[i].x_advance * SkScalarFromHBPosX;
-        glyph.fAdvance.fY = pos[i].y_advance * SkScalarFromHBPosY;
-
-        glyph.fHasVisual = !glyphBounds[i].isEmpty(); //!font->currentTypeface()->glyphBoundsAreZero(glyph.fID);
-#if SK_HB_VERSION_CHECK(1, 5, 0)
-        glyph.fUnsafeToBreak = info[i].mask & HB_GLYPH_FLAG_UNSAFE_TO_BREAK;
-#else
-        glyph.fUnsafeToBreak = false;
-#endif
-        glyph.fMustLineBreakBefore = false;
-
-        runAdvance += glyph.fAdvance;
+    for (size_t i = 0; i < len; i++) {
+        run.fGlyphs[i] = glyphs[i];
+        runAdvance += glyphs[i].fAdvance;
     }
     run.fAdvance = runAdvance;
 
@@ -1480,7 +1739,8 @@ void SkShaper::PurgeHarfBuzzCache() { SkShapers::HB::PurgeCaches(); }
 
 namespace SkShapers::HB {
 std::unique_ptr<SkShaper> ShaperDrivenWrapper(sk_sp<SkUnicode> unicode,
-                                              sk_sp<SkFontMgr> fallback) {
+                                              sk_sp<SkFontMgr> fallback,
+                                              sk_sp<WordCache> wordCache) {
     if (!unicode) {
         return nullptr;
     }
@@ -1490,11 +1750,12 @@ std::unique_ptr<SkShaper> ShaperDrivenWrapper(sk_sp<SkUnicode> unicode,
         return nullptr;
     }
     return std::make_unique<::ShaperDrivenWrapper>(
-            unicode, std::move(buffer), std::move(fallback));
+            unicode, std::move(buffer), std::move(fallback), std::move(wordCache));
 }
 
 std::unique_ptr<SkShaper> ShapeThenWrap(sk_sp<SkUnicode> unicode,
-                                        sk_sp<SkFontMgr> fallback) {
+                                        sk_sp<SkFontMgr> fallback,
+                                        sk_sp<WordCache> wordCache) {
     if (!unicode) {
         return nullptr;
     }
@@ -1504,11 +1765,12 @@ std::unique_ptr<SkShaper> ShapeThenWrap(sk_sp<SkUnicode> unicode,
         return nullptr;
     }
     return std::make_unique<::ShapeThenWrap>(
-            unicode, std::move(buffer), std::move(fallback));
+            unicode, std::move(buffer), std::move(fallback), std::move(wordCache));
 }
 
 std::unique_ptr<SkShaper> ShapeDontWrapOrReorder(sk_sp<SkUnicode> unicode,
-                                                 sk_sp<SkFontMgr> fallback) {
+                                                 sk_sp<SkFontMgr> fallback,
+                                                 sk_sp<WordCache> wordCache) {
     if (!unicode) {
         return nullptr;
     }
@@ -1518,7 +1780,7 @@ std::unique_ptr<SkShaper> ShapeDontWrapOrReorder(sk_sp<SkUnicode> unicode,
         return nullptr;
     }
     return std::make_unique<::ShapeDontWrapOrReorder>(
-            unicode, std::move(buffer), std::move(fallback));
+            unicode, std::move(buffer), std::move(fallback), std::move(wordCache));
 }
 
 std::unique_ptr<SkShaper::ScriptRunIterator> ScriptRunIterator(const char* utf8, size_t utf8Bytes) {
@@ -1531,8 +1793,43 @@ std::unique_ptr<SkShaper::ScriptRunIterator> ScriptRunIterator(const char* utf8,
             utf8, utf8Bytes, hb_script_from_iso15924_tag((hb_tag_t)script));
 }
 
+sk_sp<WordCache> WordCache::Make(int maxWords) {
+    return sk_make_sp<WordCacheImpl>(maxWords);
+}
+
+// Whether the space is context free in each typeface, for SpaceIsContextFree()
+struct SpaceIsContextFreeCache {
+    SkMutex fMutex;
+    THashMap<SkTypefaceID, bool> fContextFree SK_GUARDED_BY(fMutex);
+};
+static SpaceIsContextFreeCache& space_is_context_free_cache() {
+    static SpaceIsContextFreeCache cache;
+    return cache;
+}
+
+bool SpaceIsContextFree(const SkTypeface& typeface) {
+    SpaceIsContextFreeCache& cache = space_is_context_free_cache();
+    const SkTypefaceID typefaceID = typeface.uniqueID();
+    {
+        SkAutoMutexExclusive lock(cache.fMutex);
+        if (const bool* contextFree = cache.fContextFree.find(typefaceID)) {
+            return *contextFree;
+        }
+    }
+    HBFont hbFont(create_typeface_hb_font(typeface));
+    const bool contextFree = hbFont && space_is_context_free(hbFont.get());
+    SkAutoMutexExclusive lock(cache.fMutex);
+    cache.fContextFree.set(typefaceID, contextFree);
+    return contextFree;
+}
+
 void PurgeCaches() {
-    HBLockedFaceCache cache = get_hbFace_cache();
-    cache.reset();
+    {
+        HBLockedFaceCache cache = get_hbFace_cache();
+        cache.reset();
+    }
+    SpaceIsContextFreeCache& cache = space_is_context_free_cache();
+    SkAutoMutexExclusive lock(cache.fMutex);
+    cache.fContextFree.reset();
 }
 }  // namespace SkShapers::HB
@@ -5,6 +5,7 @@
 
 #include "include/core/SkData.h"
 #include "include/core/SkFont.h"
+#include "include/core/SkFontMgr.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSpan.h"
@@ -17,12 +18,15 @@
 #include "modules/skshaper/include/SkShaper_skunicode.h"
 #include "modules/skunicode/include/SkUnicode.h"
 #include "src/base/SkZip.h"
+#include "src/core/SkPointPriv.h"
 #include "tools/Resources.h"
 #include "tools/fonts/FontToolUtils.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #if defined(SK_UNICODE_ICU_IMPLEMENTATION)
 #include "modules/skunicode/include/SkUnicode_icu.h"
@@ -226,6 +230,81 @@ void cluster_test(skiatest::Reporter* reporter, const char* resource) {
     shaper_test(reporter, resource, data.get());
 }
 
+// Records every glyph shaped, across all runs and lines.
+struct GlyphRecorder final : public SkShaper::RunHandler {
+    std::vector<SkGlyphID> fGlyphs;
+    std::vector<SkPoint> fPositions;
+    std::vector<uint32_t> fClusters;
+    size_t fRunStart = 0;
+
+    void beginLine() override {}
+    void runInfo(const RunInfo&) override {}
+    void commitRunInfo() override {}
+    Buffer runBuffer(const RunInfo& info) override {
+        fRunStart = fGlyphs.size();
+        fGlyphs.resize(fRunStart + info.glyphCount);
+        fPositions.resize(fRunStart + info.glyphCount);
+        fClusters.resize(fRunStart + info.glyphCount);
+        return {fGlyphs.data() + fRunStart, fPositions.data() + fRunStart, nullptr,
+                fClusters.data() + fRunStart, {0, 0}};
+    }
+    void commitRunBuffer(const RunInfo&) override {}
+    void commitLine() override {}
+};
+
+void word_cache_test(skiatest::Reporter* reporter, const char* resource) {
+    skiatest::ReporterContext context(reporter, resource);
+    auto data = GetResourceAsData(resource);
+    auto unicode = get_unicode();
+    if (!data || !unicode) {
+        ERRORF(reporter, "Could not get resource or unicode.");
+        return;
+    }
+    const char* utf8 = (const char*)data->data();
+    const size_t utf8Bytes = data->size();
+    SkFont font = ToolUtils::DefaultFont();
+    sk_sp<SkFontMgr> fontMgr = ToolUtils::TestFontMgr();
+
+    auto shape = [&](const SkShaper& shaper) {
+        GlyphRecorder recorder;
+        auto fontRuns = SkShaper::MakeFontMgrRunIterator(utf8, utf8Bytes, font, fontMgr);
+        auto bidi = SkShapers::unicode::BidiRunIterator(unicode, utf8, utf8Bytes, 0);
+        auto script = SkShapers::HB::ScriptRunIterator(utf8, utf8Bytes);
+        auto language = SkShaper::MakeStdLanguageRunIterator(utf8, utf8Bytes);
+        shaper.shape(utf8, utf8Bytes, *fontRuns, *bidi, *script, *language, nullptr, 0, 400,
+                     &recorder);
+        return recorder;
+    };
+
+    sk_sp<SkShapers::HB::WordCache> cache = SkShapers::HB::WordCache::Make();
+    auto expected = shape(*SkShapers::HB::ShapeThenWrap(unicode, fontMgr));
+    auto shaper = SkShapers::HB::ShapeThenWrap(unicode, fontMgr, cache);
+    // The first pass fills the cache and the second is served from it.
+    for (int pass = 0; pass < 2; ++pass) {
+        auto actual = shape(*shaper);
+        REPORTER_ASSERT(reporter, actual.fGlyphs == expected.fGlyphs, "pass %d", pass);
+        REPORTER_ASSERT(reporter, actual.fClusters == expected.fClusters, "pass %d", pass);
+        REPORTER_ASSERT(reporter, actual.fPositions.size() == expected.fPositions.size());
+        for (size_t i = 0; i < std::min(actual.fPositions.size(), expected.fPositions.size());
+             ++i) {
+            if (!SkPointPriv::EqualsWithinTolerance(actual.fPositions[i],
+                                                    expected.fPositions[i])) {
+                ERRORF(reporter, "pass %d: glyph %zu at (%g, %g), expected (%g, %g)", pass, i,
+                       actual.fPositions[i].fX, actual.fPositions[i].fY,
+                       expected.fPositions[i].fX, expected.fPositions[i].fY);
+                break;
+            }
+        }
+    }
+
+    // The words of a font whose space is shaped without context were served from the cache.
+    if (SkShapers::HB::SpaceIsContextFree(*font.getTypeface())) {
+        REPORTER_ASSERT(reporter, cache->count() > 0);
+    }
+    cache->purge();
+    REPORTER_ASSERT(reporter, cache->count() == 0);
+}
+
 #endif  // defined(SK_SHAPER_HARFBUZZ_AVAILABLE) && defined(SK_SHAPER_UNICODE_AVAILABLE)
 
 }  // namespace
@@ -271,4 +350,13 @@ SHAPER_TEST(taitham)
 SHAPER_TEST(tamil)
 #undef SHAPER_TEST
 
+// Shaping with a word cache gives the same glyphs as shaping without one, both when filling it
+// and when reading from it.
+DEF_TEST(Shaper_wordCache, r) {
+    for (const char* resource : {"text/english.txt", "text/arabic.txt", "text/devanagari.txt",
+                                 "text/han_simplified.txt", "text/thai.txt"}) {
+        word_cache_test(r, resource);
+    }
+}
+
 #endif  // #if defined(SK_SHAPER_HARFBUZZ_AVAILABLE) && defined(SK_SHAPER_UNICODE_AVAILABLE)
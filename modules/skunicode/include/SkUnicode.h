@@ -183,6 +183,14 @@ class SKUNICODE_API SkUnicode : public SkRefCnt {
         virtual bool computeCodeUnitFlags(
                 char16_t utf16[], int utf16Units, bool replaceTabs,
                 skia_private::TArray<SkUnicode::CodeUnitFlags, true>* results) = 0;
+        // Returns the same flags as computeCodeUnitFlags(utf8...), but may remember them for the
+        // texts seen last and return them without breaking the same text again.
+        // Thread safe for the implementations that are.
+        virtual bool getCodeUnitFlags(
+                char utf8[], int utf8Units, bool replaceTabs,
+                skia_private::TArray<SkUnicode::CodeUnitFlags, true>* results) {
+            return this->computeCodeUnitFlags(utf8, utf8Units, replaceTabs, results);
+        }
 
         static SkString convertUtf16ToUtf8(const char16_t * utf16, int utf16Units);
         static SkString convertUtf16ToUtf8(const std::u16string& utf16);
@@ -6,6 +6,7 @@
 */
 #include "modules/skunicode/include/SkUnicode_icu.h"
 
+#include "include/core/SkData.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTypes.h"
@@ -22,6 +23,7 @@
 #include "src/base/SkBitmaskEnum.h"
 #include "src/base/SkUTF.h"
 #include "src/core/SkChecksum.h"
+#include "src/core/SkLRUCache.h"
 #include "src/core/SkTHash.h"
 
 #include <unicode/ubrk.h>
@@ -36,6 +38,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -96,56 +99,6 @@ static UBreakIteratorType convertType(SkUnicode::BreakType type) {
     }
 }
 
-class SkBreakIterator_icu : public SkBreakIterator {
-    ICUBreakIterator fBreakIterator;
-    Position fLastResult;
- public:
-    explicit SkBreakIterator_icu(ICUBreakIterator iter)
-            : fBreakIterator(std::move(iter))
-            , fLastResult(0) {}
-    Position first() override { return fLastResult = sk_ubrk_first(fBreakIterator.get()); }
-    Position current() override { return fLastResult = sk_ubrk_current(fBreakIterator.get()); }
-    Position next() override { return fLastResult = sk_ubrk_next(fBreakIterator.get()); }
-    Status status() override { return sk_ubrk_getRuleStatus(fBreakIterator.get()); }
-    bool isDone() override { return fLastResult == UBRK_DONE; }
-
-    bool setText(const char utftext8[], int utf8Units) override {
-        UErrorCode status = U_ZERO_ERROR;
-        ICUUText text(sk_utext_openUTF8(nullptr, &utftext8[0], utf8Units, &status));
-
-        if (U_FAILURE(status)) {
-            SkDEBUGF("Break error: %s", sk_u_errorName(status));
-            return false;
-        }
-        SkASSERT(text);
-        sk_ubrk_setUText(fBreakIterator.get(), text.get(), &status);
-        if (U_FAILURE(status)) {
-            SkDEBUGF("Break error: %s", sk_u_errorName(status));
-            return false;
-        }
-        fLastResult = 0;
-        return true;
-    }
-    bool setText(const char16_t utftext16[], int utf16Units) override {
-        UErrorCode status = U_ZERO_ERROR;
-        ICUUText text(sk_utext_openUChars(nullptr, reinterpret_cast<const UChar*>(&utftext16[0]),
-                                          utf16Units, &status));
-
-        if (U_FAILURE(status)) {
-            SkDEBUGF("Break error: %s", sk_u_errorName(status));
-            return false;
-        }
-        SkASSERT(text);
-        sk_ubrk_setUText(fBreakIterator.get(), text.get(), &status);
-        if (U_FAILURE(status)) {
-            SkDEBUGF("Break error: %s", sk_u_errorName(status));
-            return false;
-        }
-        fLastResult = 0;
-        return true;
-    }
-};
-
 class SkIcuBreakIteratorCache final {
     struct Request final {
         Request(SkUnicode::BreakType type, const char* icuLocale)
@@ -333,6 +286,230 @@ class SkIcuBreakIteratorCache final {
 };
 /*static*/ int32_t SkIcuBreakIteratorCache::BreakIteratorRef::Instances{0};
 
+/* The break iterators a thread is done with, so that breaking the next text with the same type
+ * and locale neither takes the cache's lock nor clones an iterator.
+ */
+class SkIcuBreakIteratorPool final {
+    struct Entry {
+        SkUnicode::BreakType fType;
+        SkString fLocale;
+        ICUBreakIterator fIterator;
+    };
+    static constexpr size_t kMaxIterators = 8;
+    std::vector<Entry> fIterators;  // Oldest first
+
+    // Set when this thread's pool is gone, for the iterators released after it
+    static thread_local bool gDestroyed;
+
+    static SkIcuBreakIteratorPool* Get() {
+        static thread_local SkIcuBreakIteratorPool pool;
+        return gDestroyed ? nullptr : &pool;
+    }
+
+    ~SkIcuBreakIteratorPool() { gDestroyed = true; }
+
+public:
+    static ICUBreakIterator Take(SkUnicode::BreakType type, const char* locale) {
+        if (SkIcuBreakIteratorPool* pool = Get()) {
+            auto& iterators = pool->fIterators;
+            for (auto entry = iterators.rbegin(); entry != iterators.rend(); ++entry) {
+                if (entry->fType == type && entry->fLocale.equals(locale)) {
+                    ICUBreakIterator iterator = std::move(entry->fIterator);
+                    iterators.erase(std::next(entry).base());
+                    return iterator;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    static void Give(SkUnicode::BreakType type, SkString locale, ICUBreakIterator iterator) {
+        SkIcuBreakIteratorPool* pool = Get();
+        if (!pool || !iterator) {
+            return;
+        }
+        auto& iterators = pool->fIterators;
+        if (iterators.size() == kMaxIterators) {
+            iterators.erase(iterators.begin());
+        }
+        iterators.push_back({type, std::move(locale), std::move(iterator)});
+    }
+};
+/*static*/ thread_local bool SkIcuBreakIteratorPool::gDestroyed{false};
+
+// A break iterator borrowed from this thread's pool, or made if there is none to borrow,
+// that goes back to the pool when done with.
+class SkPooledBreakIterator final {
+public:
+    SkPooledBreakIterator(SkUnicode::BreakType type, const char* bcp47)
+            : fType(type)
+            // The iterator for no locale is for whatever the default is now
+            , fLocale(bcp47 ? bcp47 : sk_uloc_getDefault())
+            , fIterator(SkIcuBreakIteratorPool::Take(type, fLocale.c_str())) {
+        if (!fIterator) {
+            fIterator = SkIcuBreakIteratorCache::get().makeBreakIterator(type, bcp47);
+        }
+    }
+    ~SkPooledBreakIterator() {
+        SkIcuBreakIteratorPool::Give(fType, std::move(fLocale), std::move(fIterator));
+    }
+    SkPooledBreakIterator(const SkPooledBreakIterator&) = delete;
+    SkPooledBreakIterator& operator=(const SkPooledBreakIterator&) = delete;
+
+    UBreakIterator* get() const { return fIterator.get(); }
+    explicit operator bool() const { return fIterator != nullptr; }
+
+private:
+    const SkUnicode::BreakType fType;
+    SkString fLocale;
+    ICUBreakIterator fIterator;
+};
+
+/* The code unit flags of the texts broken last, shared by all the SkUnicode_icu instances.
+ * Longer texts are not kept, so the cache never holds more than about
+ * kMaxTexts * kMaxTextSize * (1 + sizeof(CodeUnitFlags)) bytes.
+ */
+class SkIcuCodeUnitFlagsCache final {
+    // A key made for a lookup views the caller's text. The keys in the cache view their own copy,
+    // which is made only when inserting.
+    class Key {
+    public:
+        Key(const char text[], size_t size, const char* locale, bool replaceTabs)
+                : fText(text, size)
+                , fLocale(locale)
+                , fReplaceTabs(replaceTabs)
+                , fHash(SkChecksum::Hash32(fText.data(), fText.size(),
+                                           SkChecksum::Hash32(fLocale.data(), fLocale.size(),
+                                                              replaceTabs))) {}
+
+        Key makeOwned() const {
+            Key key = *this;
+            key.fStorage = SkData::MakeUninitialized(fText.size() + fLocale.size());
+            char* data = static_cast<char*>(key.fStorage->writable_data());
+            memcpy(data, fText.data(), fText.size());
+            memcpy(data + fText.size(), fLocale.data(), fLocale.size());
+            key.fText = std::string_view(data, fText.size());
+            key.fLocale = std::string_view(data + fText.size(), fLocale.size());
+            return key;
+        }
+
+        bool replaceTabs() const { return fReplaceTabs; }
+
+        bool operator==(const Key& that) const {
+            return fHash == that.fHash && fReplaceTabs == that.fReplaceTabs &&
+                   fLocale == that.fLocale && fText == that.fText;
+        }
+        struct Hash {
+            uint32_t operator()(const Key& key) const { return key.fHash; }
+        };
+
+    private:
+        sk_sp<SkData> fStorage;
+        std::string_view fText;
+        // The line and grapheme break rules depend on the default locale
+        std::string_view fLocale;
+        bool fReplaceTabs;
+        uint32_t fHash;
+    };
+    using Flags = TArray<SkUnicode::CodeUnitFlags, true>;
+
+    static constexpr int kMaxTexts = 64;
+    static constexpr int kMaxTextSize = 16 * 1024;
+
+    SkMutex fMutex;
+    SkLRUCache<Key, Flags, Key::Hash> fFlags SK_GUARDED_BY(fMutex);
+
+    SkIcuCodeUnitFlagsCache() : fFlags(kMaxTexts) {}
+
+public:
+    static SkIcuCodeUnitFlagsCache& get() {
+        static SkIcuCodeUnitFlagsCache instance;
+        return instance;
+    }
+
+    static bool CanCache(int utf8Units) { return utf8Units <= kMaxTextSize; }
+
+    static Key MakeKey(const char utf8[], int utf8Units, bool replaceTabs) {
+        return Key(utf8, utf8Units, sk_uloc_getDefault(), replaceTabs);
+    }
+
+    // The key is for the text as it was before any tabs in it were replaced
+    bool find(const Key& key, char utf8[], int utf8Units, Flags* results) {
+        {
+            SkAutoMutexExclusive lock(fMutex);
+            const Flags* flags = fFlags.find(key);
+            if (!flags) {
+                return false;
+            }
+            *results = *flags;
+        }
+        if (key.replaceTabs()) {
+            for (int i = 0; i < utf8Units; ++i) {
+                if ((*results)[i] & SkUnicode::kTabulation) {
+                    utf8[i] = ' ';
+                }
+            }
+        }
+        return true;
+    }
+
+    void add(Key key, const Flags& flags) {
+        SkAutoMutexExclusive lock(fMutex);
+        fFlags.insert_or_update(std::move(key), flags);
+    }
+};
+
+class SkBreakIterator_icu : public SkBreakIterator {
+    SkPooledBreakIterator fBreakIterator;
+    Position fLastResult;
+ public:
+    SkBreakIterator_icu(SkUnicode::BreakType type, const char* bcp47)
+            : fBreakIterator(type, bcp47)
+            , fLastResult(0) {}
+    bool isValid() const { return (bool)fBreakIterator; }
+    Position first() override { return fLastResult = sk_ubrk_first(fBreakIterator.get()); }
+    Position current() override { return fLastResult = sk_ubrk_current(fBreakIterator.get()); }
+    Position next() override { return fLastResult = sk_ubrk_next(fBreakIterator.get()); }
+    Status status() override { return sk_ubrk_getRuleStatus(fBreakIterator.get()); }
+    bool isDone() override { return fLastResult == UBRK_DONE; }
+
+    bool setText(const char utftext8[], int utf8Units) override {
+        UErrorCode status = U_ZERO_ERROR;
+        ICUUText text(sk_utext_openUTF8(nullptr, &utftext8[0], utf8Units, &status));
+
+        if (U_FAILURE(status)) {
+            SkDEBUGF("Break error: %s", sk_u_errorName(status));
+            return false;
+        }
+        SkASSERT(text);
+        sk_ubrk_setUText(fBreakIterator.get(), text.get(), &status);
+        if (U_FAILURE(status)) {
+            SkDEBUGF("Break error: %s", sk_u_errorName(status));
+            return false;
+        }
+        fLastResult = 0;
+        return true;
+    }
+    bool setText(const char16_t utftext16[], int utf16Units) override {
+        UErrorCode status = U_ZERO_ERROR;
+        ICUUText text(sk_utext_openUChars(nullptr, reinterpret_cast<const UChar*>(&utftext16[0]),
+                                          utf16Units, &status));
+
+        if (U_FAILURE(status)) {
+            SkDEBUGF("Break error: %s", sk_u_errorName(status));
+            return false;
+        }
+        SkASSERT(text);
+        sk_ubrk_setUText(fBreakIterator.get(), text.get(), &status);
+        if (U_FAILURE(status)) {
+            SkDEBUGF("Break error: %s", sk_u_errorName(status));
+            return false;
+        }
+        fLastResult = 0;
+        return true;
+    }
+};
+
 class SkUnicode_icu : public SkUnicode {
 
     static bool extractWords(uint16_t utf16[], int utf16Units, const char* locale,
@@ -341,7 +518,7 @@ class SkUnicode_icu : public SkUnicode {
         UErrorCode status = U_ZERO_ERROR;
 
         const BreakType type = BreakType::kWords;
-        ICUBreakIterator iterator = SkIcuBreakIteratorCache::get().makeBreakIterator(type, locale);
+        SkPooledBreakIterator iterator(type, locale);
         if (!iterator) {
             SkDEBUGF("Break error: %s", sk_u_errorName(status));
             return false;
@@ -382,7 +559,7 @@ class SkUnicode_icu : public SkUnicode {
         }
         SkASSERT(text);
 
-        ICUBreakIterator iterator = SkIcuBreakIteratorCache::get().makeBreakIterator(type, locale);
+        SkPooledBreakIterator iterator(type, locale);
         if (!iterator) {
             return false;
         }
@@ -482,11 +659,11 @@ public:
     }
     std::unique_ptr<SkBreakIterator> makeBreakIterator(const char locale[],
                                                        BreakType type) override {
-        ICUBreakIterator iterator = SkIcuBreakIteratorCache::get().makeBreakIterator(type, locale);
-        if (!iterator) {
+        auto iterator = std::make_unique<SkBreakIterator_icu>(type, locale);
+        if (!iterator->isValid()) {
             return nullptr;
         }
-        return std::unique_ptr<SkBreakIterator>(new SkBreakIterator_icu(std::move(iterator)));
+        return iterator;
     }
     std::unique_ptr<SkBreakIterator> makeBreakIterator(BreakType type) override {
         return makeBreakIterator(sk_uloc_getDefault(), type);
@@ -618,6 +795,25 @@ public:
         return true;
     }
 
+    bool getCodeUnitFlags(char utf8[], int utf8Units, bool replaceTabs,
+                          TArray<SkUnicode::CodeUnitFlags, true>* results) override {
+        if (!SkIcuCodeUnitFlagsCache::CanCache(utf8Units)) {
+            return this->computeCodeUnitFlags(utf8, utf8Units, replaceTabs, results);
+        }
+        auto& cache = SkIcuCodeUnitFlagsCache::get();
+        auto key = SkIcuCodeUnitFlagsCache::MakeKey(utf8, utf8Units, replaceTabs);
+        if (cache.find(key, utf8, utf8Units, results)) {
+            return true;
+        }
+        // Copy the text now, since computing its flags replaces the tabs in it
+        auto ownedKey = key.makeOwned();
+        if (!this->computeCodeUnitFlags(utf8, utf8Units, replaceTabs, results)) {
+            return false;
+        }
+        cache.add(std::move(ownedKey), *results);
+        return true;
+    }
+
     bool computeCodeUnitFlags(char16_t utf16[], int utf16Units, bool replaceTabs,
                           TArray<SkUnicode::CodeUnitFlags, true>* results) override {
         results->clear();
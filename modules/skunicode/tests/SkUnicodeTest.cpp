@@ -27,6 +27,8 @@
 #include "modules/skunicode/include/SkUnicode_client.h"
 #endif
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
 #ifdef SK_UNICODE_ICU_IMPLEMENTATION
@@ -283,6 +285,70 @@ DEF_TEST_ICU_UNICODES(SkUnicode_ComputeCodeUnitFlags, reporter) {
     }
 }
 
+DEF_TEST_ICU_UNICODES(SkUnicode_GetCodeUnitFlags, reporter) {
+    if (!unicode) {
+        return;
+    }
+    const char* texts[] = {
+        "Tabs\tare\treplaced\tonly when asked to",
+        "Mixed English, \xD7\xA2\xD7\x91\xD7\xA8\xD7\x99\xD7\xAA and \xE4\xB8\xAD\xE6\x96\x87\nlines",
+    };
+    for (const char* text : texts) {
+        for (bool replaceTabs : {false, true}) {
+            SkString expectedText(text);
+            TArray<SkUnicode::CodeUnitFlags, true> expected;
+            REPORTER_ASSERT(reporter, unicode->computeCodeUnitFlags(
+                    expectedText.data(), expectedText.size(), replaceTabs, &expected));
+            // The second time the flags may be remembered from the first
+            for (int i = 0; i < 2; ++i) {
+                SkString actualText(text);
+                TArray<SkUnicode::CodeUnitFlags, true> actual;
+                REPORTER_ASSERT(reporter, unicode->getCodeUnitFlags(
+                        actualText.data(), actualText.size(), replaceTabs, &actual));
+                REPORTER_ASSERT(reporter, actualText == expectedText);
+                REPORTER_ASSERT(reporter, actual.size() == expected.size());
+                for (int j = 0; j < std::min(actual.size(), expected.size()); ++j) {
+                    REPORTER_ASSERT(reporter, actual[j] == expected[j], "%d", j);
+                }
+            }
+        }
+    }
+}
+
+#if defined(SK_UNICODE_ICU_IMPLEMENTATION)
+UNIX_ONLY_TEST(SkUnicode_ReuseBreakIterator, reporter) {
+    auto unicode = SkUnicodes::ICU::Make();
+    if (!unicode) {
+        REPORTER_ASSERT(reporter, unicode);
+        return;
+    }
+    auto lineBreaks = [&](const char* locale, const char* text) {
+        std::vector<SkBreakIterator::Position> breaks;
+        auto iter = unicode->makeBreakIterator(locale, SkUnicode::BreakType::kLines);
+        if (!iter || !iter->setText(text, strlen(text))) {
+            return breaks;
+        }
+        for (auto pos = iter->first(); !iter->isDone(); pos = iter->next()) {
+            breaks.push_back(pos);
+        }
+        return breaks;
+    };
+    const char* text = "An iterator given back after breaking one text breaks the next from the start";
+    auto expected = lineBreaks("en", text);
+    REPORTER_ASSERT(reporter, !expected.empty());
+    // Break other texts in between, so the iterators are taken and given back in another order
+    for (int i = 0; i < 3; ++i) {
+        {
+            auto held = unicode->makeBreakIterator("en", SkUnicode::BreakType::kLines);
+            REPORTER_ASSERT(reporter, lineBreaks("en", "Short text") ==
+                                      std::vector<SkBreakIterator::Position>({0, 6, 10}));
+        }
+        REPORTER_ASSERT(reporter, lineBreaks("en", text) == expected);
+        REPORTER_ASSERT(reporter, !lineBreaks("ja", "\xE6\x97\xA5\xE6\x9C\xAC").empty());
+    }
+}
+#endif
+
 DEF_TEST_UNICODES(SkUnicode_ReorderVisual, reporter) {
     if (!unicode) {
         return;
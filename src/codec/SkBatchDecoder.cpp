@@ -0,0 +1,83 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/codec/SkBatchDecoder.h"
+
+#include "include/core/SkStream.h"
+#include "include/private/base/SkTPin.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#if defined(SK_CODEC_DECODES_PNG)
+#include "src/codec/SkPngCodec.h"
+#endif
+
+// The decoder state kept by one task between images.
+class SkBatchDecoder::Context {
+public:
+    SkCodec::Result decode(const SkBatchDecoder::Image& image) {
+        if (!image.fEncoded) {
+            return SkCodec::kInvalidInput;
+        }
+        SkCodec::Result result = SkCodec::kUnimplemented;
+        std::unique_ptr<SkCodec> codec = this->makeCodec(image.fEncoded, &result);
+        if (!codec) {
+            return result;
+        }
+        return codec->getResizedPixels(image.fDst);
+    }
+
+private:
+    std::unique_ptr<SkCodec> makeCodec(const sk_sp<SkData>& data, SkCodec::Result* result) {
+        std::unique_ptr<SkStream> stream = SkMemoryStream::Make(data);
+#if defined(SK_CODEC_DECODES_PNG)
+        if (SkPngCodec::IsPng(data->data(), data->size())) {
+            return SkPngCodec::MakeFromStream(std::move(stream), result, nullptr, &fIccProfiles);
+        }
+#endif
+        return SkCodec::MakeFromStream(std::move(stream), result);
+    }
+
+#if defined(SK_CODEC_DECODES_PNG)
+    SkPngCodec::IccProfileCache fIccProfiles;
+#endif
+};
+
+SkBatchDecoder::SkBatchDecoder() : SkBatchDecoder(Options()) {}
+
+SkBatchDecoder::SkBatchDecoder(const Options& options) : fOptions(options) {}
+
+SkBatchDecoder::~SkBatchDecoder() = default;
+
+void SkBatchDecoder::decode(SkSpan<Image> images) {
+    const int tasks = fOptions.fExecutor
+            ? SkTPin(fOptions.fMaxParallelDecodes, 1, (int)std::min<size_t>(images.size(), 64))
+            : 1;
+    while ((int)fContexts.size() < tasks) {
+        fContexts.push_back(std::make_unique<Context>());
+    }
+
+    if (tasks == 1) {
+        for (Image& image : images) {
+            image.fResult = fContexts[0]->decode(image);
+        }
+        return;
+    }
+
+    // Each task keeps one context and takes the next image until none are left, so a few large
+    // images don't hold up the small ones queued behind them.
+    std::atomic<size_t> next{0};
+    SkTaskGroup(*fOptions.fExecutor).batch(tasks, [&](int i) {
+        Context* context = fContexts[i].get();
+        for (size_t j; (j = next.fetch_add(1, std::memory_order_relaxed)) < images.size();) {
+            images[j].fResult = context->decode(images[j]);
+        }
+    });
+}
@@ -26,7 +26,10 @@
 #include "src/codec/SkFrameHolder.h"
 #include "src/codec/SkPixmapUtilsPriv.h"
 #include "src/codec/SkSampler.h"
+#include "src/codec/SkStreamingResizer.h"
+#include "src/core/SkImageInfoPriv.h"
 
+#include <algorithm>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -512,9 +515,10 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t
         return frameIndexResult;
     }
 
-    // FIXME: Support subsets somehow? Note that this works for SkWebpCodec
+    // A subset may be decoded at its own size. Scaling a subset only works for SkWebpCodec,
     // because it supports arbitrary scaling/subset combinations.
-    if (!this->dimensionsSupported(info.dimensions())) {
+    const bool unscaledSubset = options->fSubset && options->fSubset->size() == info.dimensions();
+    if (!unscaledSubset && !this->dimensionsSupported(info.dimensions())) {
         return kInvalidScale;
     }
 
@@ -534,9 +538,10 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t
     if ((kIncompleteInput == result || kErrorInInput == result) && rowsDecoded != info.height()) {
         // FIXME: (skbug.com/5772) fillIncompleteImage will fill using the swizzler's width, unless
         // there is a subset. In that case, it will use the width of the subset. From here, the
-        // subset will only be non-null in the case of SkWebpCodec, but it treats the subset
-        // differenty from the other codecs, and it needs to use the width specified by the info.
-        // Set the subset to null so SkWebpCodec uses the correct width.
+        // subset is only non-null for SkWebpCodec and SkPngCodec, and info is already the size of
+        // the decoded subset. SkWebpCodec has no swizzler and may scale the subset, so it needs
+        // the width specified by the info. SkPngCodec's swizzler is as wide as the subset, and
+        // without a swizzler the info is too. Set the subset to null so both use that width.
         fOptions.fSubset = nullptr;
         this->fillIncompleteImage(info, pixels, rowBytes, options->fZeroInitialized, info.height(),
                 rowsDecoded);
@@ -587,6 +592,81 @@ std::tuple<sk_sp<SkImage>, SkCodec::Result> SkCodec::getImage() {
     return this->getImage(info, nullptr);
 }
 
+SkCodec::Result SkCodec::getResizedPixels(const SkPixmap& pm, const SkCubicResampler& cubic) {
+    if (pm.dimensions().isEmpty() || kUnknown_SkColorType == pm.colorType()) {
+        return kInvalidConversion;
+    }
+    if (nullptr == pm.addr()) {
+        return kInvalidParameters;
+    }
+
+    // Find the smallest size the codec can decode to natively that still covers pm. Scales are
+    // tried in sixteenths, finer than any codec's choice of native scales.
+    const SkISize srcSize = this->dimensions();
+    SkISize decodeSize = srcSize;
+    for (float scale = std::max((float)pm.width() / srcSize.width(),
+                                (float)pm.height() / srcSize.height());
+         scale < 1;
+         scale += 1 / 16.0f) {
+        const SkISize size = this->getScaledDimensions(scale);
+        if (size.width() >= pm.width() && size.height() >= pm.height()) {
+            decodeSize = size;
+            break;
+        }
+    }
+    if (decodeSize == pm.dimensions()) {
+        const Result result = this->getPixels(pm);
+        if (kInvalidConversion != result) {
+            return result;
+        }
+    }
+
+    // Decode to 8 bits per channel, unless pm would keep more, and premultiply for filtering.
+    const SkColorType colorType = SkColorTypeMaxBitsPerChannel(pm.colorType()) > 8
+            ? kRGBA_F16_SkColorType
+            : kRGBA_8888_SkColorType;
+    const SkAlphaType alphaType = kOpaque_SkAlphaType == this->getInfo().alphaType()
+            ? kOpaque_SkAlphaType
+            : kPremul_SkAlphaType;
+    const SkImageInfo decodeInfo =
+            SkImageInfo::Make(decodeSize, colorType, alphaType, pm.refColorSpace());
+    SkStreamingResizer resizer(decodeInfo, pm, cubic);
+
+    SkBitmap rows;
+    Result result = this->startScanlineDecode(decodeInfo);
+    if (kSuccess == result && kTopDown_SkScanlineOrder == this->getScanlineOrder()) {
+        if (!rows.tryAllocPixels(decodeInfo.makeWH(decodeSize.width(), 1))) {
+            return kInternalError;
+        }
+        for (int y = 0; y < decodeSize.height(); y++) {
+            // A row that fails to decode is filled in, like getPixels() does.
+            if (1 != this->getScanlines(rows.getPixels(), 1, rows.rowBytes())) {
+                result = kIncompleteInput;
+            }
+            resizer.addRow(rows.getPixels());
+        }
+        return result;
+    }
+
+    // Otherwise decode the whole image, then resize it.
+    if (!rows.tryAllocPixels(decodeInfo)) {
+        return kInternalError;
+    }
+    result = this->getPixels(rows.pixmap());
+    switch (result) {
+        case kSuccess:
+        case kIncompleteInput:
+        case kErrorInInput:
+            break;
+        default:
+            return result;
+    }
+    for (int y = 0; y < decodeSize.height(); y++) {
+        resizer.addRow(rows.getAddr(0, y));
+    }
+    return result;
+}
+
 SkCodec::Result SkCodec::startIncrementalDecode(const SkImageInfo& info, void* pixels,
         size_t rowBytes, const SkCodec::Options* options) {
     fStartedIncrementalDecode = false;
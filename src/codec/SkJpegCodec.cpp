@@ -29,15 +29,20 @@
 #include "src/codec/SkJpegPriv.h"
 #include "src/codec/SkParseEncodedOrigin.h"
 #include "src/codec/SkSwizzler.h"
+#include "src/core/SkTaskGroup.h"
 
 #ifdef SK_CODEC_DECODES_JPEG_GAINMAPS
 #include "include/private/SkGainmapInfo.h"
 #endif  // SK_CODEC_DECODES_JPEG_GAINMAPS
 
+#include <algorithm>
 #include <array>
 #include <csetjmp>
 #include <cstring>
+#include <memory>
+#include <numeric>
 #include <utility>
+#include <vector>
 
 using namespace skia_private;
 
@@ -449,6 +454,248 @@ int SkJpegCodec::readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes
     return count;
 }
 
+namespace {
+// Where the restart intervals of a JPEG's only scan are, so that bands of MCU (minimum coded unit)
+// rows can be decoded separately.
+struct JpegRestartLayout {
+    // The size of the headers, up to the end of the StartOfScan segment.
+    size_t fHeaderSize = 0;
+    // The offset of the image height in the StartOfFrame segment.
+    size_t fHeightOffset = 0;
+    // The offsets of the restart markers that end each interval but the last.
+    std::vector<size_t> fMarkerOffsets;
+    // The offset of the EndOfImage marker, which ends the last interval.
+    size_t fEndOffset = 0;
+
+    int fImageHeight = 0;
+    int fRestartInterval = 0;
+    int fMCUsPerRow = 0;
+    int fMCURows = 0;
+    int fMCUHeight = 0;
+    // The number of output rows in each MCU row, after scaling.
+    int fOutputMCUHeight = 0;
+    // Bands may only start at multiples of this many MCU rows, where restart intervals start.
+    int fAlignment = 0;
+};
+}  // namespace
+
+// Images are split into bands of at least this many MCU rows to decode in parallel. Each band
+// also decodes up to two extra MCU rows of context, for the upsampler.
+static constexpr int kParallelBandMCURows = 16;
+
+static bool is_start_of_frame(uint8_t marker) {
+    // SOF0 through SOF15, except for DHT (0xC4), JPG (0xC8) and DAC (0xCC).
+    return marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+}
+
+static bool is_restart(uint8_t marker) {
+    return marker >= kJpegMarkerRestart0 &&
+           marker < kJpegMarkerRestart0 + kJpegRestartMarkerCount;
+}
+
+/*
+ * Finds the headers and restart markers in data, which must be a whole JPEG with a single scan.
+ */
+static bool find_restart_markers(const uint8_t* data, size_t size, JpegRestartLayout* layout) {
+    if (size < sizeof(kJpegSig) || 0 != memcmp(data, kJpegSig, sizeof(kJpegSig))) {
+        return false;
+    }
+
+    // Walk the header segments up to the StartOfScan.
+    size_t offset = kJpegMarkerCodeSize;
+    while (true) {
+        if (offset + kJpegMarkerCodeSize + kJpegSegmentParameterLengthSize > size ||
+            0xFF != data[offset]) {
+            return false;
+        }
+        const uint8_t marker = data[offset + 1];
+        if (0xFF == marker) {
+            // A fill byte.
+            offset++;
+            continue;
+        }
+        const size_t length = (data[offset + 2] << 8) | data[offset + 3];
+        if (length < kJpegSegmentParameterLengthSize) {
+            return false;
+        }
+        if (is_start_of_frame(marker)) {
+            // The height follows the one byte sample precision.
+            layout->fHeightOffset =
+                    offset + kJpegMarkerCodeSize + kJpegSegmentParameterLengthSize + 1;
+        }
+        offset += kJpegMarkerCodeSize + length;
+        if (kJpegMarkerStartOfScan == marker) {
+            break;
+        }
+    }
+    layout->fHeaderSize = offset;
+    if (0 == layout->fHeightOffset || layout->fHeightOffset + 2 > layout->fHeaderSize) {
+        return false;
+    }
+
+    // In the entropy-coded data, 0xFF is followed by a zero byte, fill bytes, or a marker.
+    for (; offset + 1 < size; offset++) {
+        if (0xFF != data[offset] || 0x00 == data[offset + 1] || 0xFF == data[offset + 1]) {
+            continue;
+        }
+        const uint8_t marker = data[offset + 1];
+        if (is_restart(marker)) {
+            layout->fMarkerOffsets.push_back(offset);
+            offset++;
+        } else if (kJpegMarkerEndOfImage == marker) {
+            layout->fEndOffset = offset;
+            return true;
+        } else {
+            // Another scan, or a DefineNumberOfLines segment.
+            return false;
+        }
+    }
+    return false;
+}
+
+/*
+ * Decodes MCU rows [top, bottom) to dst, which points at the first of their outputRows rows, as
+ * a JPEG of their own made from the headers and the restart intervals that hold them.
+ *
+ * Decoding starts an aligned step above top and ends an MCU row below bottom, so that the
+ * upsampled rows at the edges of the band match a decode of the whole image.
+ */
+static bool decode_band(const uint8_t* data, const JpegRestartLayout& layout,
+                        const jpeg_decompress_struct& settings, int top, int bottom,
+                        void* dst, size_t rowBytes, int outputRows) {
+    const int decodeTop = top > 0 ? top - layout.fAlignment : 0;
+    const int decodeBottom = std::min(layout.fMCURows, bottom + 1);
+    const size_t firstInterval = (size_t)decodeTop * layout.fMCUsPerRow / layout.fRestartInterval;
+    const size_t lastInterval =
+            ((size_t)decodeBottom * layout.fMCUsPerRow - 1) / layout.fRestartInterval;
+    const size_t start = firstInterval > 0
+            ? layout.fMarkerOffsets[firstInterval - 1] + kJpegMarkerCodeSize
+            : layout.fHeaderSize;
+    const size_t end = lastInterval < layout.fMarkerOffsets.size()
+            ? layout.fMarkerOffsets[lastInterval]
+            : layout.fEndOffset;
+
+    std::vector<uint8_t> band(data, data + layout.fHeaderSize);
+    band.insert(band.end(), data + start, data + end);
+    band.push_back(0xFF);
+    band.push_back(kJpegMarkerEndOfImage);
+
+    const int height = decodeBottom == layout.fMCURows
+            ? layout.fImageHeight - decodeTop * layout.fMCUHeight
+            : (decodeBottom - decodeTop) * layout.fMCUHeight;
+    band[layout.fHeightOffset + 0] = (uint8_t)(height >> 8);
+    band[layout.fHeightOffset + 1] = (uint8_t)(height >> 0);
+    // The decoder expects the band's restart markers to count up from RST0.
+    for (size_t i = firstInterval; i < lastInterval; i++) {
+        band[layout.fHeaderSize + layout.fMarkerOffsets[i] - start + 1] =
+                kJpegMarkerRestart0 + (i - firstInterval) % kJpegRestartMarkerCount;
+    }
+
+    SkMemoryStream stream(band.data(), band.size(), /*copyData=*/false);
+    JpegDecoderMgr decoderMgr(&stream);
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(decoderMgr.errorMgr());
+    if (setjmp(jmp)) {
+        return false;
+    }
+    decoderMgr.init();
+    jpeg_decompress_struct* dinfo = decoderMgr.dinfo();
+    if (JPEG_HEADER_OK != jpeg_read_header(dinfo, TRUE)) {
+        return false;
+    }
+    dinfo->out_color_space = settings.out_color_space;
+    dinfo->dither_mode = settings.dither_mode;
+    dinfo->dct_method = settings.dct_method;
+    dinfo->do_fancy_upsampling = settings.do_fancy_upsampling;
+    dinfo->scale_num = settings.scale_num;
+    dinfo->scale_denom = settings.scale_denom;
+    if (!jpeg_start_decompress(dinfo)) {
+        return false;
+    }
+
+    // The rows above the band are decoded into its first row, which is overwritten after.
+    JSAMPLE* row = (JSAMPLE*)dst;
+    for (int y = (top - decodeTop) * layout.fOutputMCUHeight; y > 0; y--) {
+        if (1 != jpeg_read_scanlines(dinfo, &row, 1)) {
+            return false;
+        }
+    }
+    for (int y = 0; y < outputRows; y++) {
+        if (1 != jpeg_read_scanlines(dinfo, &row, 1)) {
+            return false;
+        }
+        row = SkTAddOffset<JSAMPLE>(row, rowBytes);
+    }
+    return true;
+}
+
+bool SkJpegCodec::decodeInParallel(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                   SkExecutor* executor) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    // Every band must start at a restart marker in the only scan, and be decoded straight to dst.
+    // A scan of a single component holds one block per MCU, whatever its sampling factors.
+    if (0 == dinfo->restart_interval || dinfo->progressive_mode ||
+        dinfo->comps_in_scan != dinfo->num_components ||
+        (1 == dinfo->num_components &&
+            (1 != dinfo->max_h_samp_factor || 1 != dinfo->max_v_samp_factor)) ||
+        JCS_CMYK == dinfo->out_color_space ||
+        (this->colorXform() && sizeof(uint32_t) != dstInfo.bytesPerPixel())) {
+        return false;
+    }
+
+    SkStream* stream = this->stream();
+    const uint8_t* data = static_cast<const uint8_t*>(stream->getMemoryBase());
+    if (!data || !stream->hasLength()) {
+        return false;
+    }
+    JpegRestartLayout layout;
+    if (!find_restart_markers(data, stream->getLength(), &layout)) {
+        return false;
+    }
+
+    const int mcuWidth = 8 * dinfo->max_h_samp_factor;
+    layout.fImageHeight = dinfo->image_height;
+    layout.fRestartInterval = dinfo->restart_interval;
+    layout.fMCUsPerRow = SkToInt((dinfo->image_width + mcuWidth - 1) / mcuWidth);
+    layout.fMCUHeight = 8 * dinfo->max_v_samp_factor;
+    layout.fMCURows = SkToInt((dinfo->image_height + layout.fMCUHeight - 1) / layout.fMCUHeight);
+    if ((layout.fMCUHeight * dinfo->scale_num) % dinfo->scale_denom != 0) {
+        return false;
+    }
+    layout.fOutputMCUHeight = layout.fMCUHeight * dinfo->scale_num / dinfo->scale_denom;
+    layout.fAlignment = layout.fRestartInterval /
+                        std::gcd(layout.fRestartInterval, layout.fMCUsPerRow);
+
+    const size_t intervals = ((size_t)layout.fMCUsPerRow * layout.fMCURows +
+                              layout.fRestartInterval - 1) / layout.fRestartInterval;
+    if (layout.fMarkerOffsets.size() + 1 != intervals) {
+        return false;
+    }
+
+    const int bandMCURows = layout.fAlignment *
+            ((kParallelBandMCURows + layout.fAlignment - 1) / layout.fAlignment);
+    if (bandMCURows >= layout.fMCURows) {
+        return false;
+    }
+    const int bands = (layout.fMCURows + bandMCURows - 1) / bandMCURows;
+
+    std::unique_ptr<bool[]> decoded(new bool[bands]);
+    SkTaskGroup(*executor).batch(bands, [&](int i) {
+        const int top = i * bandMCURows,
+                  bottom = std::min(layout.fMCURows, top + bandMCURows),
+                  firstRow = top * layout.fOutputMCUHeight,
+                  rows = std::min(dstInfo.height(), bottom * layout.fOutputMCUHeight) - firstRow;
+        void* bandDst = SkTAddOffset<void>(dst, firstRow * rowBytes);
+        decoded[i] = decode_band(data, layout, *dinfo, top, bottom, bandDst, rowBytes, rows);
+        if (decoded[i] && this->colorXform()) {
+            for (int y = 0; y < rows; y++) {
+                void* row = SkTAddOffset<void>(bandDst, y * rowBytes);
+                this->applyColorXform(row, row, dstInfo.width());
+            }
+        }
+    });
+    return std::all_of(decoded.get(), decoded.get() + bands, [](bool b) { return b; });
+}
+
 /*
  * This is a bit tricky.  We only need the swizzler to do format conversion if the jpeg is
  * encoded as CMYK.
@@ -478,6 +725,11 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return kUnimplemented;
     }
 
+    if (options.fExecutor &&
+        this->decodeInParallel(dstInfo, dst, dstRowBytes, options.fExecutor)) {
+        return kSuccess;
+    }
+
     // Get a pointer to the decompress info since we will use it quite frequently
     jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
 
@@ -23,6 +23,7 @@
 #include <memory>
 
 class JpegDecoderMgr;
+class SkExecutor;
 class SkSampler;
 class SkStream;
 class SkSwizzler;
@@ -132,6 +133,14 @@ private:
     [[nodiscard]] bool allocateStorage(const SkImageInfo& dstInfo);
     int readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count, const Options&);
 
+    /*
+     * Decodes the whole image into dst on executor, in bands of rows that begin at restart
+     * markers. Returns false if the image can't be split this way, or if any band fails to decode;
+     * the caller should then decode it serially.
+     */
+    bool decodeInParallel(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                          SkExecutor* executor);
+
     /*
      * Scanline decoding.
      */
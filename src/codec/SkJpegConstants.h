@@ -20,6 +20,11 @@ static constexpr uint8_t kJpegMarkerEndOfImage = 0xD9;
 // The header of a JPEG file is the data in all segments before the first StartOfScan.
 static constexpr uint8_t kJpegMarkerStartOfScan = 0xDA;
 
+// Restart markers RST0 through RST7 separate the restart intervals of the entropy-coded data,
+// numbered modulo eight.
+static constexpr uint8_t kJpegMarkerRestart0 = 0xD0;
+static constexpr uint8_t kJpegRestartMarkerCount = 8;
+
 // Metadata and auxiliary images are stored in the APP1 through APP15 markers.
 static constexpr uint8_t kJpegMarkerAPP0 = 0xE0;
 
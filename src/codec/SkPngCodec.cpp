@@ -19,6 +19,7 @@
 #include "include/private/SkEncodedInfo.h"
 #include "include/private/base/SkNoncopyable.h"
 #include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
 #include "modules/skcms/skcms.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkPngPriv.h"
@@ -28,9 +29,11 @@
 #include <algorithm>
 #include <cstring>
 #include <utility>
+#include <vector>
 
 #include <png.h>
 #include <pngconf.h>
+#include "zlib.h"  // NO_G3_REWRITE
 
 using namespace skia_private;
 
@@ -74,6 +77,35 @@ static int sk_read_user_chunk(png_structp png_ptr, png_unknown_chunkp chunk) {
 }
 #endif
 
+// The chunks passed to the user chunk callback while reading the header.
+struct HeaderChunks {
+    SkPngChunkReader*            fChunkReader;
+    // If not null, libpng hands over the iCCP chunk instead of inflating it itself.
+    SkPngCodec::IccProfileCache* fIccCache;
+    bool                         fReadIcc = false;
+    sk_sp<SkData>                fIccProfile;
+};
+
+#ifdef PNG_READ_UNKNOWN_CHUNKS_SUPPORTED
+static int sk_read_header_chunk(png_structp png_ptr, png_unknown_chunkp chunk) {
+    HeaderChunks* chunks = (HeaderChunks*)png_get_user_chunk_ptr(png_ptr);
+    if (chunks->fIccCache && 0 == memcmp(chunk->name, "iCCP", 4)) {
+        // Like libpng, ignore all but the first iCCP chunk.
+        if (!chunks->fReadIcc) {
+            chunks->fReadIcc = true;
+            chunks->fIccProfile = chunks->fIccCache->decompress(chunk->data, chunk->size);
+        }
+        return 1;
+    }
+    if (!chunks->fChunkReader) {
+        return 0;
+    }
+    // readChunk() returning true means continue decoding
+    return chunks->fChunkReader->readChunk((const char*)chunk->name, chunk->data, chunk->size)
+            ? 1 : -1;
+}
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 // Helpers
 ///////////////////////////////////////////////////////////////////////////////
@@ -87,11 +119,12 @@ public:
      *  the png_ptr and info_ptr.
      */
     AutoCleanPng(png_structp png_ptr, SkStream* stream, SkPngChunkReader* reader,
-            SkCodec** codecPtr)
+            const HeaderChunks* headerChunks, SkCodec** codecPtr)
         : fPng_ptr(png_ptr)
         , fInfo_ptr(nullptr)
         , fStream(stream)
         , fChunkReader(reader)
+        , fHeaderChunks(headerChunks)
         , fOutCodec(codecPtr)
     {}
 
@@ -127,6 +160,7 @@ private:
     png_infop           fInfo_ptr;
     SkStream*           fStream;
     SkPngChunkReader*   fChunkReader;
+    const HeaderChunks* fHeaderChunks;
     SkCodec**           fOutCodec;
 
     void infoCallback(size_t idatLength);
@@ -305,10 +339,14 @@ static float png_inverted_fixed_point_to_float(png_fixed_point x) {
 
 // If there is no color profile information, it will use sRGB.
 std::unique_ptr<SkEncodedInfo::ICCProfile> read_color_profile(png_structp png_ptr,
-                                                              png_infop info_ptr) {
+                                                              png_infop info_ptr,
+                                                              const HeaderChunks& headerChunks) {
 
 #if (PNG_LIBPNG_VER_MAJOR > 1) || (PNG_LIBPNG_VER_MAJOR == 1 && PNG_LIBPNG_VER_MINOR >= 6)
-    // First check for an ICC profile
+    // First check for an ICC profile, which is either in headerChunks or read by libpng.
+    if (headerChunks.fIccProfile) {
+        return SkEncodedInfo::ICCProfile::Make(headerChunks.fIccProfile);
+    }
     png_bytep profile;
     png_uint_32 length;
     // The below variables are unused, however, we need to pass them in anyway or
@@ -679,7 +717,7 @@ private:
 //      png_destroy_read_struct(png_ptrp, info_ptrp).
 //      Otherwise, the passed in fields (except stream) are unchanged.
 static SkCodec::Result read_header(SkStream* stream, SkPngChunkReader* chunkReader,
-                                   SkCodec** outCodec,
+                                   SkPngCodec::IccProfileCache* iccCache, SkCodec** outCodec,
                                    png_structp* png_ptrp, png_infop* info_ptrp) {
     // The image is known to be a PNG. Decode enough to know the SkImageInfo.
     png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr,
@@ -694,7 +732,8 @@ static SkCodec::Result read_header(SkStream* stream, SkPngChunkReader* chunkRead
     png_set_option(png_ptr, PNG_MAXIMUM_INFLATE_WINDOW, PNG_OPTION_ON);
 #endif
 
-    AutoCleanPng autoClean(png_ptr, stream, chunkReader, outCodec);
+    HeaderChunks headerChunks = {chunkReader, iccCache};
+    AutoCleanPng autoClean(png_ptr, stream, chunkReader, &headerChunks, outCodec);
 
     png_infop info_ptr = png_create_info_struct(png_ptr);
     if (info_ptr == nullptr) {
@@ -713,7 +752,12 @@ static SkCodec::Result read_header(SkStream* stream, SkPngChunkReader* chunkRead
     // chunks in the header.
     if (chunkReader) {
         png_set_keep_unknown_chunks(png_ptr, PNG_HANDLE_CHUNK_ALWAYS, (png_const_bytep)"", 0);
-        png_set_read_user_chunk_fn(png_ptr, (png_voidp) chunkReader, sk_read_user_chunk);
+    }
+    if (iccCache) {
+        png_set_keep_unknown_chunks(png_ptr, PNG_HANDLE_CHUNK_ALWAYS, (png_const_bytep)"iCCP", 1);
+    }
+    if (chunkReader || iccCache) {
+        png_set_read_user_chunk_fn(png_ptr, &headerChunks, sk_read_header_chunk);
     }
 #endif
 
@@ -723,6 +767,18 @@ static SkCodec::Result read_header(SkStream* stream, SkPngChunkReader* chunkRead
         return SkCodec::kIncompleteInput;
     }
 
+#ifdef PNG_READ_UNKNOWN_CHUNKS_SUPPORTED
+    // headerChunks goes out of scope, but the chunkReader may still see chunks after IDAT.
+    if (iccCache) {
+        png_set_keep_unknown_chunks(png_ptr, PNG_HANDLE_CHUNK_AS_DEFAULT, (png_const_bytep)"iCCP",
+                                    1);
+    }
+    if (chunkReader || iccCache) {
+        png_set_read_user_chunk_fn(png_ptr, (png_voidp) chunkReader,
+                                   chunkReader ? sk_read_user_chunk : nullptr);
+    }
+#endif
+
     // On success, decodeBounds releases ownership of png_ptr and info_ptr.
     if (png_ptrp) {
         *png_ptrp = png_ptr;
@@ -819,7 +875,7 @@ void AutoCleanPng::infoCallback(size_t idatLength) {
 
     if (fOutCodec) {
         SkASSERT(nullptr == *fOutCodec);
-        auto profile = read_color_profile(fPng_ptr, fInfo_ptr);
+        auto profile = read_color_profile(fPng_ptr, fInfo_ptr, *fHeaderChunks);
         if (!SkPngCodecBase::isCompatibleColorProfileAndType(profile.get(), color)) {
             profile = nullptr;
         }
@@ -936,7 +992,7 @@ bool SkPngCodec::onRewind() {
 
     png_structp png_ptr;
     png_infop info_ptr;
-    if (kSuccess != read_header(this->stream(), fPngChunkReader.get(), nullptr,
+    if (kSuccess != read_header(this->stream(), fPngChunkReader.get(), nullptr, nullptr,
                                 &png_ptr, &info_ptr)) {
         return false;
     }
@@ -950,19 +1006,31 @@ bool SkPngCodec::onRewind() {
 SkCodec::Result SkPngCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
                                         size_t rowBytes, const Options& options,
                                         int* rowsDecoded) {
+    if (options.fSubset) {
+        // Decode only the subset's rows, like an incremental decode of the whole image would.
+        // The rows above it are decompressed and dropped, and the swizzler only converts the
+        // subset's columns, so dst can be the size of the subset.
+        const SkImageInfo fullInfo = dstInfo.makeDimensions(this->dimensions());
+        Result result = this->onStartIncrementalDecode(fullInfo, dst, rowBytes, options);
+        if (kSuccess != result) {
+            return result;
+        }
+        return this->onIncrementalDecode(rowsDecoded);
+    }
+
     Result result = this->initializeXforms(dstInfo, options);
     if (kSuccess != result) {
         return result;
     }
 
-    if (options.fSubset) {
-        return kUnimplemented;
-    }
-
     this->initializeXformParams();
     return this->decodeAllRows(dst, rowBytes, rowsDecoded);
 }
 
+bool SkPngCodec::onGetValidSubset(SkIRect* desiredSubset) const {
+    return desiredSubset && this->bounds().contains(*desiredSubset);
+}
+
 SkCodec::Result SkPngCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo,
         void* dst, size_t rowBytes, const SkCodec::Options& options) {
     Result result = this->initializeXforms(dstInfo, options);
@@ -990,14 +1058,15 @@ SkCodec::Result SkPngCodec::onIncrementalDecode(int* rowsDecoded) {
 }
 
 std::unique_ptr<SkCodec> SkPngCodec::MakeFromStream(std::unique_ptr<SkStream> stream,
-                                                    Result* result, SkPngChunkReader* chunkReader) {
+                                                    Result* result, SkPngChunkReader* chunkReader,
+                                                    IccProfileCache* iccCache) {
     SkASSERT(result);
     if (!stream) {
         *result = SkCodec::kInvalidInput;
         return nullptr;
     }
     SkCodec* outCodec = nullptr;
-    *result = read_header(stream.get(), chunkReader, &outCodec, nullptr, nullptr);
+    *result = read_header(stream.get(), chunkReader, iccCache, &outCodec, nullptr, nullptr);
     if (kSuccess == *result) {
         // Codec has taken ownership of the stream.
         SkASSERT(outCodec);
@@ -1006,6 +1075,73 @@ std::unique_ptr<SkCodec> SkPngCodec::MakeFromStream(std::unique_ptr<SkStream> st
     return std::unique_ptr<SkCodec>(outCodec);
 }
 
+SkPngCodec::IccProfileCache::IccProfileCache() = default;
+
+SkPngCodec::IccProfileCache::~IccProfileCache() {
+    if (fZStream) {
+        inflateEnd(fZStream.get());
+    }
+}
+
+sk_sp<SkData> SkPngCodec::IccProfileCache::decompress(const uint8_t* chunk, size_t length) {
+    for (size_t i = fEntries.size(); i-- > 0;) {
+        const SkData* cached = fEntries[i].fChunk.get();
+        if (cached->size() == length && 0 == memcmp(cached->data(), chunk, length)) {
+            std::rotate(fEntries.begin() + i, fEntries.begin() + i + 1, fEntries.end());
+            return fEntries.back().fProfile;
+        }
+    }
+
+    // The chunk holds the profile's name (1 to 79 bytes) and a null, the compression method,
+    // which must be 0 (deflate), and then the compressed profile.
+    const uint8_t* nameEnd = (const uint8_t*)memchr(chunk, 0, std::min<size_t>(length, 80));
+    if (!nameEnd || nameEnd == chunk || (size_t)(nameEnd - chunk) + 2 > length || nameEnd[1]) {
+        return nullptr;
+    }
+
+    if (!fZStream) {
+        fZStream = std::make_unique<z_stream>();
+        if (Z_OK != inflateInit(fZStream.get())) {
+            fZStream = nullptr;
+            return nullptr;
+        }
+    } else if (Z_OK != inflateReset(fZStream.get())) {
+        return nullptr;
+    }
+    z_stream* z = fZStream.get();
+    z->next_in = const_cast<uint8_t*>(nameEnd + 2);
+    z->avail_in = SkToUInt(length - (nameEnd + 2 - chunk));
+
+    // The profile starts with its size. Like libpng, don't allocate more than 8MB for it.
+    constexpr size_t kMaxProfileSize = 8000000;
+    uint8_t header[4];
+    z->next_out = header;
+    z->avail_out = sizeof(header);
+    if (Z_OK != inflate(z, Z_NO_FLUSH) || z->avail_out) {
+        return nullptr;
+    }
+    const size_t size = png_get_uint_32(header);
+    if (size < sizeof(header) || size > kMaxProfileSize) {
+        return nullptr;
+    }
+    sk_sp<SkData> profile = SkData::MakeUninitialized(size);
+    uint8_t* dst = (uint8_t*)profile->writable_data();
+    memcpy(dst, header, sizeof(header));
+    z->next_out = dst + sizeof(header);
+    z->avail_out = SkToUInt(size - sizeof(header));
+    if (Z_STREAM_END != inflate(z, Z_FINISH) || z->avail_out) {
+        return nullptr;
+    }
+
+    // A handful of profiles covers what most collections of images embed.
+    constexpr size_t kMaxEntries = 8;
+    if (fEntries.size() == kMaxEntries) {
+        fEntries.erase(fEntries.begin());
+    }
+    fEntries.push_back({SkData::MakeWithCopy(chunk, length), profile});
+    return profile;
+}
+
 namespace SkPngDecoder {
 bool IsPng(const void* data, size_t len) {
     return SkPngCodec::IsPng(data, len);
@@ -11,24 +11,50 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "include/codec/SkCodec.h"
 #include "include/core/SkRefCnt.h"
 #include "src/codec/SkPngCodecBase.h"
 
+class SkData;
 class SkPngChunkReader;
 class SkStream;
 struct SkEncodedInfo;
 struct SkImageInfo;
 template <typename T> class SkSpan;
+struct z_stream_s;
 
 class SkPngCodec : public SkPngCodecBase {
 public:
     static bool IsPng(const void*, size_t);
 
+    // Remembers the ICC profiles of the PNGs read with it, keyed by their compressed iCCP chunk,
+    // so that a series of PNGs embedding the same profile only inflates it once. It also keeps
+    // its zlib stream between profiles. Not thread safe.
+    class IccProfileCache {
+    public:
+        IccProfileCache();
+        ~IccProfileCache();
+
+        // Returns the profile in the contents of an iCCP chunk, or null if it is invalid.
+        sk_sp<SkData> decompress(const uint8_t* chunk, size_t length);
+
+    private:
+        struct Entry {
+            sk_sp<SkData> fChunk;
+            sk_sp<SkData> fProfile;
+        };
+        // Most recently used last.
+        std::vector<Entry>          fEntries;
+        std::unique_ptr<z_stream_s> fZStream;
+    };
+
     // Assume IsPng was called and returned true.
+    // iccCache, if not null, is only used while reading the header, i.e. before this returns.
     static std::unique_ptr<SkCodec> MakeFromStream(std::unique_ptr<SkStream>, Result*,
-                                                   SkPngChunkReader* = nullptr);
+                                                   SkPngChunkReader* = nullptr,
+                                                   IccProfileCache* iccCache = nullptr);
 
     // FIXME (scroggo): Temporarily needed by AutoCleanPng.
     void setIdatLength(size_t len) { fIdatLength = len; }
@@ -57,6 +83,7 @@ protected:
 
     Result onGetPixels(const SkImageInfo&, void*, size_t, const Options&, int*)
             override;
+    bool onGetValidSubset(SkIRect* desiredSubset) const override;
     bool onRewind() override;
 
     voidp png_ptr() { return fPng_ptr; }
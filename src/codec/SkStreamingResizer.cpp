@@ -0,0 +1,131 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/codec/SkStreamingResizer.h"
+
+#include "include/core/SkAlphaType.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkColorType.h"
+#include "include/private/base/SkAssert.h"
+#include "src/base/SkVx.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+// The Mitchell-Netravali family of cubics, which are zero beyond |x| >= 2.
+static float cubic_weight(float x, const SkCubicResampler& cubic) {
+    const float B = cubic.B,
+                C = cubic.C;
+    x = std::fabs(x);
+    if (x < 1) {
+        return ((12 - 9*B - 6*C) * x*x*x + (-18 + 12*B + 6*C) * x*x + (6 - 2*B)) / 6;
+    }
+    if (x < 2) {
+        return ((-B - 6*C) * x*x*x + (6*B + 30*C) * x*x + (-12*B - 48*C) * x + (8*B + 24*C)) / 6;
+    }
+    return 0;
+}
+
+SkStreamingResizer::Filter::Filter(int srcSize, int dstSize, const SkCubicResampler& cubic) {
+    const float scale = (float)srcSize / dstSize,
+                // Downscaling stretches the filter to cover every source pixel.
+                filterScale = std::max(1.0f, scale),
+                support = 2 * filterScale;
+    fTaps = std::min(srcSize, (int)std::ceil(2 * support) + 1);
+    fStart.resize(dstSize);
+    fCount.resize(dstSize);
+    fWeights.assign((size_t)dstSize * fTaps, 0.0f);
+
+    for (int i = 0; i < dstSize; i++) {
+        // Pixel centers are at half-integers in both images.
+        const float center = (i + 0.5f) * scale;
+        const int start = std::max(0, (int)std::floor(center - support + 0.5f)),
+                  end = std::min({srcSize, start + fTaps,
+                                  (int)std::floor(center + support - 0.5f) + 1});
+        float* weights = fWeights.data() + (size_t)i * fTaps;
+        float sum = 0;
+        for (int j = start; j < end; j++) {
+            weights[j - start] = cubic_weight((j + 0.5f - center) / filterScale, cubic);
+            sum += weights[j - start];
+        }
+        if (sum != 0) {
+            for (int j = start; j < end; j++) {
+                weights[j - start] /= sum;
+            }
+        } else {
+            weights[0] = 1;
+        }
+        fStart[i] = start;
+        fCount[i] = std::max(1, end - start);
+    }
+}
+
+SkStreamingResizer::SkStreamingResizer(const SkImageInfo& srcInfo, const SkPixmap& dst,
+                                       const SkCubicResampler& cubic)
+        : fSrcInfo(srcInfo)
+        , fDst(dst)
+        , fX(srcInfo.width(), dst.width(), cubic)
+        , fY(srcInfo.height(), dst.height(), cubic)
+        , fSrcRow((size_t)srcInfo.width() * 4)
+        , fFilteredRows((size_t)fY.fTaps * dst.width() * 4)
+        , fDstRow((size_t)dst.width() * 4) {
+    SkASSERT(kPremul_SkAlphaType == srcInfo.alphaType() ||
+             kOpaque_SkAlphaType == srcInfo.alphaType());
+}
+
+void SkStreamingResizer::addRow(const void* row) {
+    SkASSERT(fRowsAdded < fSrcInfo.height());
+    const SkImageInfo rowInfo = fSrcInfo.makeWH(fSrcInfo.width(), 1);
+    SkAssertResult(SkPixmap(rowInfo, row, rowInfo.minRowBytes())
+            .readPixels(rowInfo.makeColorType(kRGBA_F32_SkColorType), fSrcRow.data(),
+                        fSrcRow.size() * sizeof(float)));
+
+    float* filtered = this->filteredRow(fRowsAdded);
+    for (int x = 0; x < fDst.width(); x++) {
+        const float* src = fSrcRow.data() + (size_t)fX.fStart[x] * 4;
+        const float* weights = fX.fWeights.data() + (size_t)x * fX.fTaps;
+        skvx::float4 sum = 0;
+        for (int j = 0; j < fX.fCount[x]; j++) {
+            sum += weights[j] * skvx::float4::Load(src + j * 4);
+        }
+        sum.store(filtered + x * 4);
+    }
+    fRowsAdded++;
+
+    // Output rows need source rows further down as they go, so they complete in order.
+    while (fRowsWritten < fDst.height() && fY.end(fRowsWritten) <= fRowsAdded) {
+        this->writeRow(fRowsWritten++);
+    }
+}
+
+void SkStreamingResizer::writeRow(int dstY) {
+    const float* weights = fY.fWeights.data() + (size_t)dstY * fY.fTaps;
+    std::fill(fDstRow.begin(), fDstRow.end(), 0.0f);
+    for (int j = 0; j < fY.fCount[dstY]; j++) {
+        const float* filtered = this->filteredRow(fY.fStart[dstY] + j);
+        for (size_t i = 0; i < fDstRow.size(); i += 4) {
+            (skvx::float4::Load(fDstRow.data() + i) +
+             weights[j] * skvx::float4::Load(filtered + i)).store(fDstRow.data() + i);
+        }
+    }
+
+    // The cubic's negative lobes can overshoot, so keep the pixels valid and premultiplied.
+    const bool opaque = kOpaque_SkAlphaType == fSrcInfo.alphaType();
+    for (size_t i = 0; i < fDstRow.size(); i += 4) {
+        skvx::float4 px = skvx::pin(skvx::float4::Load(fDstRow.data() + i),
+                                    skvx::float4(0), skvx::float4(1));
+        px = opaque ? skvx::float4(px[0], px[1], px[2], 1) : skvx::min(px, px[3]);
+        px.store(fDstRow.data() + i);
+    }
+
+    const SkImageInfo rowInfo =
+            fSrcInfo.makeWH(fDst.width(), 1).makeColorType(kRGBA_F32_SkColorType);
+    SkAssertResult(SkPixmap(rowInfo, fDstRow.data(), rowInfo.minRowBytes())
+            .readPixels(fDst.info().makeWH(fDst.width(), 1), fDst.writable_addr(0, dstY),
+                        fDst.rowBytes()));
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStreamingResizer_DEFINED
+#define SkStreamingResizer_DEFINED
+
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/private/base/SkNoncopyable.h"
+
+#include <vector>
+
+/**
+ *  Resizes an image into a pixmap as the image's rows arrive from the top down, with a separable
+ *  cubic filter. When downscaling, the filter is widened by the scale factor so every source
+ *  pixel contributes to the result.
+ *
+ *  Each source row is filtered horizontally as it arrives, and only the horizontally filtered
+ *  rows that the next output row needs are kept, so the whole source is never held at once.
+ */
+class SkStreamingResizer : SkNoncopyable {
+public:
+    /**
+     *  srcInfo describes the rows that will be passed to addRow(). Its alpha type must be
+     *  premultiplied or opaque. The rows are converted to dst's color type, alpha type and
+     *  color space as they are written.
+     */
+    SkStreamingResizer(const SkImageInfo& srcInfo, const SkPixmap& dst, const SkCubicResampler&);
+
+    /**
+     *  Adds the next row of the source, and writes any rows of dst that it completes. Once all
+     *  srcInfo.height() rows have been added, all of dst has been written.
+     */
+    void addRow(const void* row);
+
+private:
+    // Contributions of a run of source pixels to each output pixel along one axis.
+    struct Filter {
+        Filter(int srcSize, int dstSize, const SkCubicResampler&);
+
+        int end(int i) const { return fStart[i] + fCount[i]; }
+
+        // The most source pixels any output pixel uses.
+        int fTaps;
+        // Output pixel i uses fCount[i] source pixels from fStart[i], with the weights that
+        // start at fWeights[i * fTaps].
+        std::vector<int>   fStart;
+        std::vector<int>   fCount;
+        std::vector<float> fWeights;
+    };
+
+    float* filteredRow(int srcY) {
+        return fFilteredRows.data() + (size_t)(srcY % fY.fTaps) * fDst.width() * 4;
+    }
+    void writeRow(int dstY);
+
+    const SkImageInfo  fSrcInfo;
+    const SkPixmap     fDst;
+    const Filter       fX;
+    const Filter       fY;
+    int                fRowsAdded = 0;
+    int                fRowsWritten = 0;
+
+    // The latest source row as premultiplied float RGBA.
+    std::vector<float> fSrcRow;
+    // A ring of the last fY.fTaps source rows after horizontal filtering.
+    std::vector<float> fFilteredRows;
+    // The output row, before it is converted to dst's format.
+    std::vector<float> fDstRow;
+};
+
+#endif  // SkStreamingResizer_DEFINED
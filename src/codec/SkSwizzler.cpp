@@ -255,6 +255,17 @@ static void swizzle_index_to_n32(
     }
 }
 
+static void fast_swizzle_index_to_n32(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::index_to_8888((uint32_t*) dst, src + offset, ctable, width);
+}
+
 static void swizzle_index_to_n32_skipZ(
         void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int dstWidth,
         int bpp, int deltaSrc, int offset, const SkPMColor ctable[]) {
@@ -270,6 +281,17 @@ static void swizzle_index_to_n32_skipZ(
     }
 }
 
+static void fast_swizzle_index_to_n32_skipZ(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::index_to_8888_skipZ((uint32_t*) dst, src + offset, ctable, width);
+}
+
 static void swizzle_index_to_565(
       void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int dstWidth,
       int bytesPerPixel, int deltaSrc, int offset, const SkPMColor ctable[]) {
@@ -546,6 +568,17 @@ static void swizzle_rgb16_to_rgba(
     }
 }
 
+static void fast_swizzle_rgb16_to_rgba(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGB16_to_RGB1((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgb16_to_bgra(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -561,6 +594,17 @@ static void swizzle_rgb16_to_bgra(
     }
 }
 
+static void fast_swizzle_rgb16_to_bgra(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGB16_to_BGR1((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgb16_to_565(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -591,6 +635,17 @@ static void swizzle_rgba16_to_rgba_unpremul(
     }
 }
 
+static void fast_swizzle_rgba16_to_rgba_unpremul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_RGBA((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgba16_to_rgba_premul(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -606,6 +661,17 @@ static void swizzle_rgba16_to_rgba_premul(
     }
 }
 
+static void fast_swizzle_rgba16_to_rgba_premul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_rgbA((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgba16_to_bgra_unpremul(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -621,6 +687,17 @@ static void swizzle_rgba16_to_bgra_unpremul(
     }
 }
 
+static void fast_swizzle_rgba16_to_bgra_unpremul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_BGRA((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgba16_to_bgra_premul(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -636,6 +713,17 @@ static void swizzle_rgba16_to_bgra_premul(
     }
 }
 
+static void fast_swizzle_rgba16_to_bgra_premul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_bgrA((uint32_t*) dst, src + offset, width);
+}
+
 // kCMYK
 //
 // CMYK is stored as four bytes per pixel.
@@ -945,8 +1033,10 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                         case kBGR_101010x_XR_SkColorType:
                             if (SkCodec::kYes_ZeroInitialized == zeroInit) {
                                 proc = &swizzle_index_to_n32_skipZ;
+                                fastProc = &fast_swizzle_index_to_n32_skipZ;
                             } else {
                                 proc = &swizzle_index_to_n32;
+                                fastProc = &fast_swizzle_index_to_n32;
                             }
                             break;
                         case kRGB_565_SkColorType:
@@ -969,6 +1059,7 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                 case kRGBA_8888_SkColorType:
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = &swizzle_rgb16_to_rgba;
+                        fastProc = &fast_swizzle_rgb16_to_rgba;
                         break;
                     }
 
@@ -979,6 +1070,7 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                 case kBGRA_8888_SkColorType:
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = &swizzle_rgb16_to_bgra;
+                        fastProc = &fast_swizzle_rgb16_to_bgra;
                         break;
                     }
 
@@ -1004,6 +1096,8 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = premultiply ? &swizzle_rgba16_to_rgba_premul :
                                              &swizzle_rgba16_to_rgba_unpremul;
+                        fastProc = premultiply ? &fast_swizzle_rgba16_to_rgba_premul :
+                                                 &fast_swizzle_rgba16_to_rgba_unpremul;
                         break;
                     }
 
@@ -1031,6 +1125,8 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = premultiply ? &swizzle_rgba16_to_bgra_premul :
                                              &swizzle_rgba16_to_bgra_unpremul;
+                        fastProc = premultiply ? &fast_swizzle_rgba16_to_bgra_premul :
+                                                 &fast_swizzle_rgba16_to_bgra_unpremul;
                         break;
                     }
 
@@ -8,13 +8,24 @@
 #include "include/core/SkBBHFactory.h"
 
 #include "include/core/SkRect.h"
+#include "src/core/SkFlatRTree.h"
 #include "src/core/SkRTree.h"
 
 sk_sp<SkBBoxHierarchy> SkRTreeFactory::operator()() const {
     return sk_make_sp<SkRTree>();
 }
 
+sk_sp<SkBBoxHierarchy> SkFlatRTreeFactory::operator()() const {
+    return sk_make_sp<SkFlatRTree>();
+}
+
 void SkBBoxHierarchy::insert(const SkRect rects[], const Metadata[], int N) {
     // Ignore Metadata.
     this->insert(rects, N);
 }
+
+void SkBBoxHierarchy::searchBatch(SkSpan<const SkRect> queries, std::vector<int> results[]) const {
+    for (size_t i = 0; i < queries.size(); ++i) {
+        this->search(queries[i], &results[i]);
+    }
+}
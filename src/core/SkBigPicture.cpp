@@ -13,8 +13,10 @@
 #include "src/core/SkRecord.h"
 #include "src/core/SkRecordDraw.h"
 #include "src/core/SkRecords.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <utility>
+#include <vector>
 
 SkBigPicture::SkBigPicture(const SkRect& cull,
                            sk_sp<SkRecord> record,
@@ -43,6 +45,43 @@ void SkBigPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
                  callback);
 }
 
+void SkBigPicture::playback(SkSpan<SkCanvas* const> canvases, SkExecutor* executor) const {
+    // Only the canvases whose clip doesn't contain the whole picture use the BBH, as in
+    // playback() above. Those are all searched for together.
+    std::vector<SkRect> queries;
+    std::vector<int> queryForCanvas(canvases.size(), -1);
+    if (fBBH) {
+        for (size_t i = 0; i < canvases.size(); ++i) {
+            SkRect bounds = canvases[i]->getLocalClipBounds();
+            if (!bounds.contains(this->cullRect())) {
+                queryForCanvas[i] = (int)queries.size();
+                queries.push_back(bounds);
+            }
+        }
+    }
+    std::vector<std::vector<int>> ops(queries.size());
+    if (!queries.empty()) {
+        fBBH->searchBatch(queries, ops.data());
+    }
+
+    auto draw = [&](int i) {
+        if (queryForCanvas[i] < 0) {
+            SkRecordDraw(*fRecord, canvases[i], this->drawablePicts(), nullptr,
+                         this->drawableCount(), nullptr, nullptr);
+        } else {
+            SkRecordDrawOps(*fRecord, ops[queryForCanvas[i]], canvases[i], this->drawablePicts(),
+                            nullptr, this->drawableCount(), nullptr);
+        }
+    };
+    if (executor) {
+        SkTaskGroup(*executor).batch((int)canvases.size(), draw);
+    } else {
+        for (size_t i = 0; i < canvases.size(); ++i) {
+            draw((int)i);
+        }
+    }
+}
+
 struct NestedApproxOpCounter {
     int fCount = 0;
 
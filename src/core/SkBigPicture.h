@@ -12,6 +12,7 @@
 #include "include/core/SkPicture.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSpan.h"
 #include "include/private/base/SkNoncopyable.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/core/SkRecord.h"
@@ -20,6 +21,7 @@
 #include <memory>
 
 class SkCanvas;
+class SkExecutor;
 
 // An implementation of SkPicture supporting an arbitrary number of drawing commands.
 // This is called "big" because there used to be a "mini" that only supported a subset of the
@@ -53,6 +55,11 @@ public:
     size_t approximateBytesUsed() const override;
     const SkBigPicture* asSkBigPicture() const override { return this; }
 
+    // Plays this picture back into each of the canvases, as playback() would, drawing the
+    // canvases concurrently on executor (or in turn if it is null). The ops for all of the
+    // canvases are found with a single batched search of the BBH.
+    void playback(SkSpan<SkCanvas* const> canvases, SkExecutor* executor) const;
+
 // Used by GrRecordReplaceDraw
     const SkBBoxHierarchy* bbh() const { return fBBH.get(); }
     const SkRecord*     record() const { return fRecord.get(); }
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkFlatRTree.h"
+
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkFloatingPoint.h"
+#include "src/base/SkVx.h"
+
+#include <algorithm>
+
+static_assert(SkFlatRTree::kBranching == 8, "intersects() tests nodes with skvx::float8");
+
+// Which of a node's children intersect query, using the same strict test as SkRect::Intersects.
+// Unused child slots hold inverted bounds, which never intersect anything.
+static skvx::int8 intersects(const float lefts[], const float tops[],
+                             const float rights[], const float bottoms[],
+                             const SkRect& query) {
+    return (skvx::float8::Load(lefts) < query.fRight) &
+           (query.fLeft < skvx::float8::Load(rights)) &
+           (skvx::float8::Load(tops) < query.fBottom) &
+           (query.fTop < skvx::float8::Load(bottoms));
+}
+
+// SkRect::Intersects() is false for every rect when the query itself is empty (or NaN).
+static bool is_searchable(const SkRect& query) {
+    return query.fLeft < query.fRight && query.fTop < query.fBottom;
+}
+
+void SkFlatRTree::insert(const SkRect rects[], int N) {
+    SkASSERT(0 == fCount);
+
+    std::vector<SkRect> bounds;
+    bounds.reserve(N);
+    fOpIndex.reserve(N);
+    for (int i = 0; i < N; ++i) {
+        if (!rects[i].isEmpty()) {
+            bounds.push_back(rects[i]);
+            fOpIndex.push_back(i);
+        }
+    }
+    fCount = (int)bounds.size();
+    if ((int)bounds.size() == N) {
+        fOpIndex = {};
+    }
+    if (fCount == 0) {
+        return;
+    }
+
+    // Build the levels bottom-up, each node taking the next kBranching entries of the level
+    // below, until a level fits in a single node.
+    std::vector<std::vector<Node>> levels;
+    do {
+        const int nodeCount = ((int)bounds.size() + kBranching - 1) / kBranching;
+        std::vector<Node> nodes(nodeCount);
+        std::vector<SkRect> nodeBounds(nodeCount, SkRect::MakeEmpty());
+        for (int i = 0; i < nodeCount * kBranching; ++i) {
+            Node& node = nodes[i / kBranching];
+            const int slot = i % kBranching;
+            if (i < (int)bounds.size()) {
+                node.fLeft  [slot] = bounds[i].fLeft;
+                node.fTop   [slot] = bounds[i].fTop;
+                node.fRight [slot] = bounds[i].fRight;
+                node.fBottom[slot] = bounds[i].fBottom;
+                nodeBounds[i / kBranching].join(bounds[i]);
+            } else {
+                node.fLeft  [slot] = node.fTop   [slot] =  SK_FloatInfinity;
+                node.fRight [slot] = node.fBottom[slot] = -SK_FloatInfinity;
+            }
+        }
+        levels.push_back(std::move(nodes));
+        bounds = std::move(nodeBounds);
+    } while (bounds.size() > 1);
+
+    // Pack the levels breadth-first, root first.
+    size_t nodeCount = 0;
+    for (const std::vector<Node>& level : levels) {
+        nodeCount += level.size();
+    }
+    fNodes.reserve(nodeCount);
+    for (auto level = levels.rbegin(); level != levels.rend(); ++level) {
+        fLevelStart.push_back((int)fNodes.size());
+        fNodes.insert(fNodes.end(), level->begin(), level->end());
+    }
+}
+
+void SkFlatRTree::search(const SkRect& query, std::vector<int>* results) const {
+    if (fCount > 0 && is_searchable(query)) {
+        this->search(0, 0, query, results);
+    }
+}
+
+void SkFlatRTree::search(int level, int node, const SkRect& query,
+                         std::vector<int>* results) const {
+    const Node& n = fNodes[fLevelStart[level] + node];
+    const skvx::int8 hit = intersects(n.fLeft, n.fTop, n.fRight, n.fBottom, query);
+    if (!any(hit)) {
+        return;
+    }
+    const bool isLeaf = level + 1 == this->getDepth();
+    for (int i = 0; i < kBranching; ++i) {
+        if (hit[i]) {
+            const int child = node * kBranching + i;
+            if (isLeaf) {
+                results->push_back(this->opIndex(child));
+            } else {
+                this->search(level + 1, child, query, results);
+            }
+        }
+    }
+}
+
+void SkFlatRTree::searchBatch(SkSpan<const SkRect> queries, std::vector<int> results[]) const {
+    if (fCount == 0) {
+        return;
+    }
+    // The root's list of active queries, then for each level a list of the active queries of
+    // one child and the child hit masks of every active query.
+    const size_t n = queries.size();
+    std::vector<int> scratch(n + 2 * n * this->getDepth());
+    int activeCount = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (is_searchable(queries[i])) {
+            scratch[activeCount++] = (int)i;
+        }
+    }
+    if (activeCount > 0) {
+        this->searchBatch(0, 0, queries, scratch.data(), activeCount, scratch.data() + n, results);
+    }
+}
+
+void SkFlatRTree::searchBatch(int level, int node, SkSpan<const SkRect> queries,
+                              const int active[], int activeCount, int* scratch,
+                              std::vector<int> results[]) const {
+    const Node& n = fNodes[fLevelStart[level] + node];
+    int* childActive = scratch;
+    int* masks = scratch + queries.size();
+
+    int anyHits = 0;
+    for (int j = 0; j < activeCount; ++j) {
+        const skvx::int8 hit = intersects(n.fLeft, n.fTop, n.fRight, n.fBottom,
+                                          queries[active[j]]);
+        int mask = 0;
+        for (int i = 0; i < kBranching; ++i) {
+            mask |= hit[i] & (1 << i);
+        }
+        masks[j] = mask;
+        anyHits |= mask;
+    }
+
+    // Children are visited in order, so each query's results come out in increasing op order,
+    // just as they do from search().
+    const bool isLeaf = level + 1 == this->getDepth();
+    for (int i = 0; i < kBranching; ++i) {
+        if (!(anyHits & (1 << i))) {
+            continue;
+        }
+        int childActiveCount = 0;
+        for (int j = 0; j < activeCount; ++j) {
+            if (masks[j] & (1 << i)) {
+                childActive[childActiveCount++] = active[j];
+            }
+        }
+        const int child = node * kBranching + i;
+        if (isLeaf) {
+            const int opIndex = this->opIndex(child);
+            for (int j = 0; j < childActiveCount; ++j) {
+                results[childActive[j]].push_back(opIndex);
+            }
+        } else {
+            this->searchBatch(level + 1, child, queries, childActive, childActiveCount,
+                              scratch + 2 * queries.size(), results);
+        }
+    }
+}
+
+size_t SkFlatRTree::bytesUsed() const {
+    return sizeof(SkFlatRTree) +
+           fLevelStart.capacity() * sizeof(int) +
+           fNodes.capacity() * sizeof(Node) +
+           fOpIndex.capacity() * sizeof(int);
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkFlatRTree_DEFINED
+#define SkFlatRTree_DEFINED
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkSpan.h"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * An R-Tree laid out for fast searching rather than for flexibility.
+ *
+ * Like SkRTree it is bulk-loaded once, from a batch of rects in recording order, without sorting,
+ * so searches return op indices in increasing order. Unlike SkRTree there are no pointers: the
+ * nodes of each level are packed one after another, root first, and the children of the i'th
+ * node of a level are nodes [i * kBranching, (i + 1) * kBranching) of the level below. Each node
+ * keeps its children's bounds as four arrays (lefts, tops, rights, bottoms), so a query is tested
+ * against all of a node's children at once with SIMD.
+ */
+class SkFlatRTree : public SkBBoxHierarchy {
+public:
+    SkFlatRTree() = default;
+
+    void insert(const SkRect[], int N) override;
+    void search(const SkRect& query, std::vector<int>* results) const override;
+    void searchBatch(SkSpan<const SkRect> queries, std::vector<int> results[]) const override;
+    size_t bytesUsed() const override;
+
+    // Methods and constants below here are only public for tests.
+
+    // Return the depth of the tree structure.
+    int getDepth() const { return (int)fLevelStart.size(); }
+    // Insertion count of non-empty rects.
+    int getCount() const { return fCount; }
+
+    inline static constexpr int kBranching = 8;
+
+private:
+    struct Node {
+        float fLeft  [kBranching];
+        float fTop   [kBranching];
+        float fRight [kBranching];
+        float fBottom[kBranching];
+    };
+
+    // The op index for slot i of the leaf level.
+    int opIndex(int slot) const { return fOpIndex.empty() ? slot : fOpIndex[slot]; }
+
+    void search(int level, int node, const SkRect& query, std::vector<int>* results) const;
+    void searchBatch(int level, int node, SkSpan<const SkRect> queries, const int active[],
+                     int activeCount, int* scratch, std::vector<int> results[]) const;
+
+    int               fCount = 0;
+    // The index in fNodes of the first node of each level, from the root down to the leaves.
+    std::vector<int>  fLevelStart;
+    std::vector<Node> fNodes;
+    // Maps leaf slots to op indices. Left empty when no rects were skipped, since then they match.
+    std::vector<int>  fOpIndex;
+};
+
+#endif
@@ -14,7 +14,9 @@
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkMemset.h"
 #include "src/core/SkOpts.h"
+#include "src/core/SkPngFilter.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkRuntimeEffectPriv.h"
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkSwizzlePriv.h"
 #include "src/core/SkTypefaceCache.h"
@@ -27,6 +29,7 @@ void SkGraphics::Init() {
     SkOpts::Init_BlitMask();
     SkOpts::Init_BlitRow();
     SkOpts::Init_Memset();
+    SkOpts::Init_PngFilter();
     SkOpts::Init_Swizzler();
 }
 
@@ -35,12 +38,14 @@ void SkGraphics::Init() {
 void SkGraphics::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
   SkResourceCache::DumpMemoryStatistics(dump);
   SkStrikeCache::DumpMemoryStatistics(dump);
+  SkDumpRuntimeEffectCacheStatistics(dump);
 }
 
 void SkGraphics::PurgeAllCaches() {
     SkGraphics::PurgeFontCache();
     SkGraphics::PurgeResourceCache();
     SkImageFilter_Base::PurgeCache();
+    SkPurgeRuntimeEffectCache();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
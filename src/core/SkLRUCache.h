@@ -84,6 +84,18 @@ public:
         return fMap.count();
     }
 
+    int maxCount() const {
+        return fMaxCount;
+    }
+
+    // Evicts the least recently used entries if there are now more than maxCount.
+    void setMaxCount(int maxCount) {
+        fMaxCount = maxCount;
+        while (fMap.count() > fMaxCount) {
+            this->remove(fLRU.tail()->fKey);
+        }
+    }
+
     template <typename Fn>  // f(K*, V*)
     void foreach(Fn&& fn) {
         typename SkTInternalLList<Entry>::Iter iter;
@@ -40,6 +40,17 @@ enum {
     kCustom_TrailingStreamByteAfterPictInfo      = 2,   // -size32 follows
 };
 
+static void write_trailing_stream_byte(SkWStream* stream, uint8_t value, bool alignedSections) {
+    if (!alignedSections) {
+        stream->write8(value);
+        return;
+    }
+    stream->write8(value | SkPicturePriv::kAlignedSections_TrailingStreamByteFlag);
+    for (size_t i = 0; i < SkPicturePriv::kAlignedSections_TrailingStreamBytePadding; ++i) {
+        stream->write8(0);
+    }
+}
+
 /* SkPicture impl.  This handles generic responsibilities like unique IDs and serialization. */
 
 SkPicture::SkPicture() {
@@ -165,8 +176,44 @@ sk_sp<SkPicture> SkPicture::MakeFromData(const SkData* data, const SkDeserialPro
     return MakeFromStreamPriv(&stream, procs, nullptr, kNestedSKPLimit);
 }
 
+sk_sp<SkPicture> SkPicture::MakeFromDataWithoutCopy(sk_sp<SkData> data,
+                                                    const SkDeserialProcs* procs) {
+    if (!data) {
+        return nullptr;
+    }
+    SkMemoryStream stream(data);
+    return MakeFromStreamPriv(&stream, procs, nullptr, kNestedSKPLimit, data);
+}
+
+// Plays back directly from the SkPictureData it was loaded into, instead of converting it to an
+// SkRecord, so that its ops (and anything else the SkPictureData keeps as a view) stay in the
+// SkData it was loaded from.
+class SkMappedPicture final : public SkPicture {
+public:
+    explicit SkMappedPicture(std::unique_ptr<const SkPictureData> data) : fData(std::move(data)) {}
+
+    void playback(SkCanvas* canvas, AbortCallback* callback) const override {
+        SkPicturePlayback playback(fData.get());
+        playback.draw(canvas, callback, nullptr);
+    }
+
+    // Every op is at least one 32-bit word, so this is an upper bound, found without touching
+    // the ops themselves.
+    int approximateOpCount(bool) const override {
+        return SkToInt(fData->opData()->size() / sizeof(uint32_t));
+    }
+    size_t approximateBytesUsed() const override {
+        return sizeof(*this) + fData->opData()->size();
+    }
+    SkRect cullRect() const override { return fData->info().fCullRect; }
+
+private:
+    std::unique_ptr<const SkPictureData> fData;
+};
+
 sk_sp<SkPicture> SkPicture::MakeFromStreamPriv(SkStream* stream, const SkDeserialProcs* procsPtr,
-                                               SkTypefacePlayback* typefaces, int recursionLimit) {
+                                               SkTypefacePlayback* typefaces, int recursionLimit,
+                                               const sk_sp<SkData>& backingData) {
     if (recursionLimit <= 0) {
         return nullptr;
     }
@@ -182,11 +229,27 @@ sk_sp<SkPicture> SkPicture::MakeFromStreamPriv(SkStream* stream, const SkDeseria
 
     uint8_t trailingStreamByteAfterPictInfo;
     if (!stream->readU8(&trailingStreamByteAfterPictInfo)) { return nullptr; }
+    constexpr uint8_t kAlignedFlag = SkPicturePriv::kAlignedSections_TrailingStreamByteFlag;
+    constexpr size_t kPadding = SkPicturePriv::kAlignedSections_TrailingStreamBytePadding;
+    const bool alignedSections = trailingStreamByteAfterPictInfo & kAlignedFlag;
+    if (alignedSections) {
+        trailingStreamByteAfterPictInfo &= ~kAlignedFlag;
+        if (stream->skip(kPadding) != kPadding) {
+            return nullptr;
+        }
+    }
     switch (trailingStreamByteAfterPictInfo) {
         case kPictureData_TrailingStreamByteAfterPictInfo: {
             std::unique_ptr<SkPictureData> data(
                     SkPictureData::CreateFromStream(stream, info, procs, typefaces,
-                                                    recursionLimit));
+                                                    recursionLimit, alignedSections,
+                                                    backingData));
+            if (backingData) {
+                if (!data || !data->opData()) {
+                    return nullptr;
+                }
+                return sk_make_sp<SkMappedPicture>(std::move(data));
+            }
             return Forwardport(info, data.get(), nullptr);
         }
         case kCustom_TrailingStreamByteAfterPictInfo: {
@@ -290,13 +353,14 @@ void SkPicture::serialize(SkWStream* stream, const SkSerialProcs* procsPtr,
     SkPictInfo info = this->createHeader();
     stream->write(&info, sizeof(info));
 
+    const bool aligned = procs.fAlignPictureSections;
     if (auto custom = custom_serialize(this, procs)) {
         int32_t size = SkToS32(custom->size());
         if (size == 0) {
-            stream->write8(kFailure_TrailingStreamByteAfterPictInfo);
+            write_trailing_stream_byte(stream, kFailure_TrailingStreamByteAfterPictInfo, aligned);
             return;
         }
-        stream->write8(kCustom_TrailingStreamByteAfterPictInfo);
+        write_trailing_stream_byte(stream, kCustom_TrailingStreamByteAfterPictInfo, aligned);
         stream->write32(-size);    // negative for custom format
         write_pad32(stream, custom->data(), size);
         return;
@@ -304,10 +368,10 @@ void SkPicture::serialize(SkWStream* stream, const SkSerialProcs* procsPtr,
 
     std::unique_ptr<SkPictureData> data(this->backport());
     if (data) {
-        stream->write8(kPictureData_TrailingStreamByteAfterPictInfo);
+        write_trailing_stream_byte(stream, kPictureData_TrailingStreamByteAfterPictInfo, aligned);
         data->serialize(stream, procs, typefaceSet, textBlobsOnly);
     } else {
-        stream->write8(kFailure_TrailingStreamByteAfterPictInfo);
+        write_trailing_stream_byte(stream, kFailure_TrailingStreamByteAfterPictInfo, aligned);
     }
 }
 
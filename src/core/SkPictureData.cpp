@@ -13,11 +13,11 @@
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTypeface.h"
+#include "include/private/base/SkAlign.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkTFitsIn.h"
 #include "include/private/base/SkTemplates.h"
 #include "include/private/base/SkTo.h"
-#include "src/base/SkAutoMalloc.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkPictureRecord.h"
 #include "src/core/SkPtrRecorder.h"
@@ -28,6 +28,7 @@
 #include "src/core/SkVerticesPriv.h"
 #include "src/core/SkWriteBuffer.h"
 
+#include <cstdint>
 #include <cstring>
 #include <utility>
 
@@ -101,7 +102,13 @@ static void write_tag_size(SkWStream* stream, uint32_t tag, size_t size) {
     stream->write32(SkToU32(size));
 }
 
-void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
+// Pads a section of 'size' bytes out to a multiple of 4 bytes.
+static void write_padding(SkWStream* stream, size_t size) {
+    const uint32_t zero = 0;
+    stream->write(&zero, SkAlign4(size) - size);
+}
+
+void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec, bool aligned) {
     int count = rec.count();
 
     AutoSTMalloc<16, SkFlattenable::Factory> storage(count);
@@ -111,7 +118,7 @@ void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
     size_t size = compute_chunk_size(array, count);
 
     // TODO: write_tag_size should really take a size_t
-    write_tag_size(stream, SK_PICT_FACTORY_TAG, (uint32_t) size);
+    write_tag_size(stream, SK_PICT_FACTORY_TAG, (uint32_t) (aligned ? SkAlign4(size) : size));
     SkDEBUGCODE(size_t start = stream->bytesWritten());
     stream->write32(count);
 
@@ -127,6 +134,9 @@ void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
     }
 
     SkASSERT(size == (stream->bytesWritten() - start));
+    if (aligned) {
+        write_padding(stream, size);
+    }
 }
 
 void SkPictureData::WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec,
@@ -139,12 +149,15 @@ void SkPictureData::WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec,
     SkTypeface** array = (SkTypeface**)storage.get();
     rec.copyToArray((SkRefCnt**)array);
 
+    // Aligned typefaces are followed by padding, so they are preceded by their padded size.
+    SkDynamicMemoryWStream typefaces;
+    SkWStream* out = procs.fAlignPictureSections ? &typefaces : stream;
     for (int i = 0; i < count; i++) {
         SkTypeface* tf = array[i];
         if (procs.fTypefaceProc) {
             auto data = procs.fTypefaceProc(tf, procs.fTypefaceCtx);
             if (data) {
-                stream->write(data->data(), data->size());
+                out->write(data->data(), data->size());
                 continue;
             }
         }
@@ -152,7 +165,13 @@ void SkPictureData::WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec,
         // kIncludeDataIfLocal does not always work because there is no default
         // fontmgr to pass into SkTypeface::MakeDeserialize, so there is no
         // fontmgr to find a font given the descriptor only.
-        tf->serialize(stream, SkTypeface::SerializeBehavior::kDoIncludeData);
+        tf->serialize(out, SkTypeface::SerializeBehavior::kDoIncludeData);
+    }
+    if (procs.fAlignPictureSections) {
+        size_t size = typefaces.bytesWritten();
+        stream->write32(SkToU32(SkAlign4(size)));
+        typefaces.writeToAndReset(stream);
+        write_padding(stream, size);
     }
 }
 
@@ -257,7 +276,7 @@ void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
 
     // We need to write factories before we write the buffer.
     // We need to write typefaces before we write the buffer or any sub-picture.
-    WriteFactories(stream, factSet);
+    WriteFactories(stream, factSet, procs.fAlignPictureSections);
     // Pass the original typefaceproc (if any) now that we're ready to actually serialize the
     // typefaces. We skipped this proc before, when we were serializing paints, so that the
     // paints would just write indices into our typeface set.
@@ -312,17 +331,19 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
     switch (tag) {
         case SK_PICT_READER_TAG:
             SkASSERT(nullptr == fOpData);
-            fOpData = SkData::MakeFromStream(stream, size);
+            fOpData = this->readChunk(stream, size);
             if (!fOpData) {
                 return false;
             }
             break;
         case SK_PICT_FACTORY_TAG: {
+            const uint32_t chunkSize = size;
             if (!stream->readU32(&size)) { return false; }
             if (StreamRemainingLengthIsBelow(stream, size)) {
                 return false;
             }
             fFactoryPlayback = std::make_unique<SkFactoryPlayback>(size);
+            size_t bytesRead = sizeof(uint32_t);
             for (size_t i = 0; i < size; i++) {
                 SkString str;
                 size_t len;
@@ -334,33 +355,32 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
                 if (stream->read(str.data(), len) != len) {
                     return false;
                 }
+                bytesRead += SkWStream::SizeOfPackedUInt(len) + len;
                 fFactoryPlayback->base()[i] = SkFlattenable::NameToFactory(str.c_str());
             }
-        } break;
-        case SK_PICT_TYPEFACE_TAG: {
-            if (StreamRemainingLengthIsBelow(stream, size)) {
-                return false;
-            }
-            fTFPlayback.setCount(size);
-            for (uint32_t i = 0; i < size; ++i) {
-                if (stream->isAtEnd()) {
+            if (fAlignedSections) {
+                if (bytesRead > chunkSize) {
                     return false;
                 }
-                sk_sp<SkTypeface> tf;
-                if (procs.fTypefaceProc) {
-                    tf = procs.fTypefaceProc(&stream, sizeof(stream), procs.fTypefaceCtx);
-                }
-                else {
-                    tf = SkTypeface::MakeDeserialize(stream, nullptr);
-                }
-                if (!tf) {    // failed to deserialize
-                    // fTFPlayback asserts it never has a null, so we plop in
-                    // a default here.
-                    tf = SkTypeface::MakeEmpty();
+                const size_t padding = chunkSize - bytesRead;
+                if (stream->skip(padding) != padding) {
+                    return false;
                 }
-                fTFPlayback[i] = std::move(tf);
             }
         } break;
+        case SK_PICT_TYPEFACE_TAG: {
+            if (!fAlignedSections) {
+                return this->parseTypefaces(stream, size, procs);
+            }
+            uint32_t chunkSize;
+            if (!stream->readU32(&chunkSize)) { return false; }
+            sk_sp<SkData> chunk = this->readChunk(stream, chunkSize);
+            if (!chunk) {
+                return false;
+            }
+            SkMemoryStream typefaces(std::move(chunk));
+            return this->parseTypefaces(&typefaces, size, procs);
+        }
         case SK_PICT_PICTURE_TAG: {
             SkASSERT(fPictures.empty());
             if (StreamRemainingLengthIsBelow(stream, size)) {
@@ -370,7 +390,8 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
 
             for (uint32_t i = 0; i < size; i++) {
                 auto pic = SkPicture::MakeFromStreamPriv(stream, &procs,
-                                                         topLevelTFPlayback, recursionLimit - 1);
+                                                         topLevelTFPlayback, recursionLimit - 1,
+                                                         fBackingData);
                 if (!pic) {
                     return false;
                 }
@@ -378,16 +399,19 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            if (StreamRemainingLengthIsBelow(stream, size)) {
-                return false;
-            }
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
+            const size_t offset = fBackingData ? stream->getPosition() : 0;
+            sk_sp<SkData> storage = this->readChunk(stream, size);
+            if (!storage) {
                 return false;
             }
 
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(storage->data(), size);
             buffer.setVersion(fInfo.getVersion());
+            if (fBackingData) {
+                // Encoded images become subsets of the backing data, even if this chunk had to
+                // be copied out of it.
+                buffer.setBackingData(fBackingData, offset);
+            }
 
             if (!fFactoryPlayback) {
                 return false;
@@ -416,6 +440,52 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
     return true;    // success
 }
 
+bool SkPictureData::parseTypefaces(SkStream* stream, uint32_t count,
+                                   const SkDeserialProcs& procs) {
+    if (StreamRemainingLengthIsBelow(stream, count)) {
+        return false;
+    }
+    fTFPlayback.setCount(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (stream->isAtEnd()) {
+            return false;
+        }
+        sk_sp<SkTypeface> tf;
+        if (procs.fTypefaceProc) {
+            tf = procs.fTypefaceProc(&stream, sizeof(stream), procs.fTypefaceCtx);
+        }
+        else {
+            tf = SkTypeface::MakeDeserialize(stream, nullptr);
+        }
+        if (!tf) {    // failed to deserialize
+            // fTFPlayback asserts it never has a null, so we plop in
+            // a default here.
+            tf = SkTypeface::MakeEmpty();
+        }
+        fTFPlayback[i] = std::move(tf);
+    }
+    return true;
+}
+
+sk_sp<SkData> SkPictureData::readChunk(SkStream* stream, size_t size) const {
+    if (StreamRemainingLengthIsBelow(stream, size)) {
+        return nullptr;
+    }
+    if (fBackingData) {
+        // SkReadBuffer needs 4-byte aligned memory, which is only guaranteed for pictures written
+        // with SkSerialProcs::fAlignPictureSections.
+        const size_t offset = stream->getPosition();
+        if (SkIsAlign4(reinterpret_cast<uintptr_t>(fBackingData->bytes() + offset)) &&
+            offset + size <= fBackingData->size()) {
+            if (stream->skip(size) != size) {
+                return nullptr;
+            }
+            return SkData::MakeSubset(fBackingData.get(), offset, size);
+        }
+    }
+    return SkData::MakeFromStream(stream, size);
+}
+
 static sk_sp<SkImage> create_image_from_buffer(SkReadBuffer& buffer) {
     return buffer.readImage();
 }
@@ -519,15 +589,24 @@ SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
                                                const SkPictInfo& info,
                                                const SkDeserialProcs& procs,
                                                SkTypefacePlayback* topLevelTFPlayback,
-                                               int recursionLimit) {
+                                               int recursionLimit,
+                                               bool alignedSections,
+                                               const sk_sp<SkData>& backingData) {
     std::unique_ptr<SkPictureData> data(new SkPictureData(info));
     if (!topLevelTFPlayback) {
         topLevelTFPlayback = &data->fTFPlayback;
     }
 
+    data->fAlignedSections = alignedSections;
+    data->fBackingData = backingData;
     if (!data->parseStream(stream, procs, topLevelTFPlayback, recursionLimit)) {
         return nullptr;
     }
+    if (backingData) {
+        // This data will be played back directly, possibly from several threads at once.
+        data->fBackingData = nullptr;
+        data->initForPlayback();
+    }
     return data.release();
 }
 
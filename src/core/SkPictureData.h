@@ -88,12 +88,17 @@ T* read_index_base_1_or_null(SkReadBuffer* reader,
 class SkPictureData {
 public:
     SkPictureData(const SkPictureRecord& record, const SkPictInfo&);
-    // Does not affect ownership of SkStream.
+    // Does not affect ownership of SkStream. alignedSections is set for pictures written with
+    // SkSerialProcs::fAlignPictureSections. If backingData is set, the stream must be reading
+    // from backingData, starting at its first byte. The op data, and other large chunks where
+    // possible, are then kept as subsets of backingData rather than copied out of the stream.
     static SkPictureData* CreateFromStream(SkStream*,
                                            const SkPictInfo&,
                                            const SkDeserialProcs&,
                                            SkTypefacePlayback*,
-                                           int recursionLimit);
+                                           int recursionLimit,
+                                           bool alignedSections = false,
+                                           const sk_sp<SkData>& backingData = nullptr);
     static SkPictureData* CreateFromBuffer(SkReadBuffer&, const SkPictInfo&);
 
     void serialize(SkWStream*, const SkSerialProcs&, SkRefCntSet*, bool textBlobsOnly=false) const;
@@ -158,6 +163,9 @@ private:
                         const SkDeserialProcs&, SkTypefacePlayback*,
                         int recursionLimit);
     void parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size);
+    bool parseTypefaces(SkStream*, uint32_t count, const SkDeserialProcs&);
+    // Reads the next 'size' bytes of the stream, as a view into fBackingData when possible.
+    sk_sp<SkData> readChunk(SkStream*, size_t size) const;
     void flattenToBuffer(SkWriteBuffer&, bool textBlobsOnly) const;
 
     skia_private::TArray<SkPaint> fPaints;
@@ -178,9 +186,12 @@ private:
     SkTypefacePlayback                 fTFPlayback;
     std::unique_ptr<SkFactoryPlayback> fFactoryPlayback;
 
+    bool fAlignedSections = false;  // only used while parsing
+    sk_sp<SkData> fBackingData;     // only set while parsing
+
     const SkPictInfo fInfo;
 
-    static void WriteFactories(SkWStream* stream, const SkFactorySet& rec);
+    static void WriteFactories(SkWStream* stream, const SkFactorySet& rec, bool aligned);
     static void WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec, const SkSerialProcs&);
 
     void initForPlayback() const;
@@ -52,6 +52,13 @@ public:
         pic->fAddedToCache.store(true);
     }
 
+    // Set in the byte that follows the SkPictInfo of a picture written with
+    // SkSerialProcs::fAlignPictureSections. That byte is then padded out to 4 bytes, and so are
+    // the factory and typeface chunks of its SkPictureData, whose typefaces are also preceded by
+    // their size in bytes.
+    static constexpr uint8_t kAlignedSections_TrailingStreamByteFlag = 0x80;
+    static constexpr size_t  kAlignedSections_TrailingStreamBytePadding = 3;
+
     // V35: Store SkRect (rather then width & height) in header
     // V36: Remove (obsolete) alphatype from SkColorTable
     // V37: Added shadow only option to SkDropShadowImageFilter (last version to record CLEAR)
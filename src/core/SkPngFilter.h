@@ -0,0 +1,28 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPngFilter_DEFINED
+#define SkPngFilter_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SkOpts {
+    // Writes |row| filtered with PNG filter |type| (0 through 4, i.e. None, Sub, Up, Average
+    // and Paeth) to |dst|, given the unfiltered row above it in |prev|. Both |row| and |prev|
+    // must be preceded by |bpp| zero bytes, which stand in for the pixel left of the first one.
+    //
+    // Returns the sum of the filtered bytes' absolute values, read as signed, which is the
+    // heuristic PNG encoders use to choose between filters. Once that sum reaches |limit| the
+    // function may stop early, leaving the rest of |dst| unwritten.
+    extern uint64_t (*png_filter_row)(int type, const uint8_t* row, const uint8_t* prev,
+                                      size_t rowBytes, size_t bpp, uint8_t* dst, uint64_t limit);
+
+    void Init_PngFilter();
+}  // namespace SkOpts
+
+#endif // SkPngFilter_DEFINED
@@ -0,0 +1,39 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/private/base/SkFeatures.h"
+#include "src/core/SkCpu.h"
+#include "src/core/SkOptsTargets.h"
+#include "src/core/SkPngFilter.h"
+
+#define SK_OPTS_TARGET SK_OPTS_TARGET_DEFAULT
+#include "src/opts/SkOpts_SetTarget.h"
+
+#include "src/opts/SkPngFilter_opts.h"  // IWYU pragma: keep
+
+#include "src/opts/SkOpts_RestoreTarget.h"
+
+namespace SkOpts {
+    DEFINE_DEFAULT(png_filter_row);
+
+    void Init_PngFilter_hsw();
+
+    static bool init() {
+    #if defined(SK_ENABLE_OPTIMIZE_SIZE)
+        // All Init_foo functions are omitted when optimizing for size
+    #elif defined(SK_CPU_X86)
+        #if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_AVX2
+            if (SkCpu::Supports(SkCpu::HSW)) { Init_PngFilter_hsw(); }
+        #endif
+    #endif
+      return true;
+    }
+
+    void Init_PngFilter() {
+        [[maybe_unused]] static bool gInitialized = init();
+    }
+}  // namespace SkOpts
@@ -162,6 +162,50 @@ void SkRTree::search(Node* node, const SkRect& query, std::vector<int>* results)
     }
 }
 
+void SkRTree::searchBatch(SkSpan<const SkRect> queries, std::vector<int> results[]) const {
+    if (fCount == 0) {
+        return;
+    }
+    // One list of active query indices for the root, and one for each level below it.
+    std::vector<int> scratch((this->getDepth() + 1) * queries.size());
+    int activeCount = 0;
+    for (size_t i = 0; i < queries.size(); ++i) {
+        if (SkRect::Intersects(fRoot.fBounds, queries[i])) {
+            scratch[activeCount++] = (int)i;
+        }
+    }
+    if (activeCount > 0) {
+        this->searchBatch(fRoot.fSubtree, queries, scratch.data(), activeCount,
+                          scratch.data() + queries.size(), results);
+    }
+}
+
+void SkRTree::searchBatch(const Node* node, SkSpan<const SkRect> queries, const int active[],
+                          int activeCount, int* scratch, std::vector<int> results[]) const {
+    // Children are visited in order, so each query's results come out in increasing op order,
+    // just as they do from search().
+    for (int i = 0; i < node->fNumChildren; ++i) {
+        const Branch& child = node->fChildren[i];
+        int childActiveCount = 0;
+        for (int j = 0; j < activeCount; ++j) {
+            if (SkRect::Intersects(child.fBounds, queries[active[j]])) {
+                scratch[childActiveCount++] = active[j];
+            }
+        }
+        if (childActiveCount == 0) {
+            continue;
+        }
+        if (0 == node->fLevel) {
+            for (int j = 0; j < childActiveCount; ++j) {
+                results[scratch[j]].push_back(child.fOpIndex);
+            }
+        } else {
+            this->searchBatch(child.fSubtree, queries, scratch, childActiveCount,
+                              scratch + queries.size(), results);
+        }
+    }
+}
+
 size_t SkRTree::bytesUsed() const {
     size_t byteCount = sizeof(SkRTree);
 
@@ -37,6 +37,7 @@ public:
 
     void insert(const SkRect[], int N) override;
     void search(const SkRect& query, std::vector<int>* results) const override;
+    void searchBatch(SkSpan<const SkRect> queries, std::vector<int> results[]) const override;
     size_t bytesUsed() const override;
 
     // Methods and constants below here are only public for tests.
@@ -69,6 +70,11 @@ private:
 
     void search(Node* root, const SkRect& query, std::vector<int>* results) const;
 
+    // Search node for the queries listed in active, which all intersect node's bounds. scratch
+    // has room for the active lists of node's level and every level below it.
+    void searchBatch(const Node* node, SkSpan<const SkRect> queries, const int active[],
+                     int activeCount, int* scratch, std::vector<int> results[]) const;
+
     // Consumes the input array.
     Branch bulkLoad(std::vector<Branch>* branches, int level = 0);
 
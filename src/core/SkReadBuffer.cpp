@@ -320,6 +320,14 @@ sk_sp<SkData> SkReadBuffer::readByteArrayAsData() {
         return nullptr;
     }
 
+    if (fBackingData) {
+        size_t offset = fBackingOffset + this->offset() + sizeof(uint32_t);
+        if (!this->skipByteArray(nullptr)) {
+            return nullptr;
+        }
+        return SkData::MakeSubset(fBackingData.get(), offset, numBytes);
+    }
+
     SkAutoMalloc buffer(numBytes);
     if (!this->readByteArray(buffer.get(), numBytes)) {
         return nullptr;
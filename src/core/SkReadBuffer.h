@@ -10,6 +10,7 @@
 
 #include "include/core/SkColor.h"
 #include "include/core/SkColorFilter.h"
+#include "include/core/SkData.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkPaint.h"
@@ -35,9 +36,9 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <utility>
 
 class SkBlender;
-class SkData;
 class SkImage;
 class SkM44;
 class SkMaskFilter;
@@ -58,6 +59,16 @@ public:
 
     void setMemory(const void*, size_t);
 
+    /**
+     *  Declares that the memory being read holds the same bytes as 'data', starting at 'offset'.
+     *  readByteArrayAsData() then returns subsets of 'data' instead of copies.
+     */
+    void setBackingData(sk_sp<SkData> data, size_t offset) {
+        SkASSERT(!data || offset + this->size() <= data->size());
+        fBackingData = std::move(data);
+        fBackingOffset = offset;
+    }
+
     /**
      *  Returns true IFF the version is older than the specified version.
      */
@@ -250,6 +261,9 @@ private:
 
     SkDeserialProcs fProcs;
 
+    sk_sp<SkData> fBackingData;
+    size_t        fBackingOffset = 0;
+
     static bool IsPtrAlign4(const void* ptr) {
         return SkIsAlign4((uintptr_t)ptr);
     }
@@ -42,6 +42,25 @@
 
 class SkImageFilter;
 
+static void draw_ops(const SkRecord& record,
+                     SkSpan<const int> ops,
+                     SkCanvas* canvas,
+                     SkPicture const* const drawablePicts[],
+                     SkDrawable* const drawables[],
+                     int drawableCount,
+                     SkPicture::AbortCallback* callback) {
+    SkRecords::Draw draw(canvas, drawablePicts, drawables, drawableCount);
+    for (int op : ops) {
+        if (callback && callback->abort()) {
+            return;
+        }
+        // This visit call uses the SkRecords::Draw::operator() to call
+        // methods on the |canvas|, wrapped by methods defined with the
+        // DRAW() macro.
+        record.visit(op, draw);
+    }
+}
+
 void SkRecordDraw(const SkRecord& record,
                   SkCanvas* canvas,
                   SkPicture const* const drawablePicts[],
@@ -62,16 +81,7 @@ void SkRecordDraw(const SkRecord& record,
         std::vector<int> ops;
         bbh->search(query, &ops);
 
-        SkRecords::Draw draw(canvas, drawablePicts, drawables, drawableCount);
-        for (int i = 0; i < (int)ops.size(); i++) {
-            if (callback && callback->abort()) {
-                return;
-            }
-            // This visit call uses the SkRecords::Draw::operator() to call
-            // methods on the |canvas|, wrapped by methods defined with the
-            // DRAW() macro.
-            record.visit(ops[i], draw);
-        }
+        draw_ops(record, ops, canvas, drawablePicts, drawables, drawableCount, callback);
     } else {
         // Draw all ops.
         SkRecords::Draw draw(canvas, drawablePicts, drawables, drawableCount);
@@ -87,6 +97,17 @@ void SkRecordDraw(const SkRecord& record,
     }
 }
 
+void SkRecordDrawOps(const SkRecord& record,
+                     SkSpan<const int> ops,
+                     SkCanvas* canvas,
+                     SkPicture const* const drawablePicts[],
+                     SkDrawable* const drawables[],
+                     int drawableCount,
+                     SkPicture::AbortCallback* callback) {
+    SkAutoCanvasRestore saveRestore(canvas, true /*save now, restore at exit*/);
+    draw_ops(record, ops, canvas, drawablePicts, drawables, drawableCount, callback);
+}
+
 namespace SkRecords {
 
 // NoOps draw nothing.
@@ -205,14 +226,21 @@ template <> void Draw::draw(const DrawDrawable& r) {
 class FillBounds : SkNoncopyable {
 public:
     FillBounds(const SkRect& cullRect, const SkRecord& record,
-               SkRect bounds[], SkBBoxHierarchy::Metadata meta[])
+               SkRect bounds[], SkBBoxHierarchy::Metadata meta[],
+               const SkMatrix& ctm = SkMatrix::I(), int openSaves = 0)
         : fCullRect(cullRect)
         , fBounds(bounds)
         , fMeta(meta) {
-        fCTM = SkMatrix::I();
+        fCTM = ctm;
 
         // We push an extra save block to track the bounds of any top-level control operations.
         fSaveStack.push_back({ 0, Bounds::MakeEmpty(), nullptr, fCTM });
+
+        // Saves made before the first op we visit have no control ops of ours to bound, but the
+        // Restores we visit may pop them.
+        for (int i = 0; i < openSaves; i++) {
+            fSaveStack.push_back({ 0, Bounds::MakeEmpty(), nullptr, fCTM });
+        }
     }
 
     ~FillBounds() {
@@ -585,3 +613,13 @@ void SkRecordFillBounds(const SkRect& cullRect, const SkRecord& record,
         }
     }
 }
+
+void SkRecordFillBounds(const SkRect& cullRect, const SkRecord& record,
+                        int startOp, const SkMatrix& ctm, int openSaves,
+                        SkRect bounds[], SkBBoxHierarchy::Metadata meta[]) {
+    SkRecords::FillBounds visitor(cullRect, record, bounds, meta, ctm, openSaves);
+    for (int i = startOp; i < record.count(); i++) {
+        visitor.setCurrentOp(i - startOp);
+        record.visit(i, visitor);
+    }
+}
@@ -12,9 +12,11 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkM44.h"
 #include "include/core/SkPicture.h"
+#include "include/core/SkSpan.h"
 #include "include/private/base/SkNoncopyable.h"
 
 class SkDrawable;
+class SkMatrix;
 class SkRecord;
 struct SkRect;
 
@@ -22,11 +24,24 @@ struct SkRect;
 void SkRecordFillBounds(const SkRect& cullRect, const SkRecord&,
                         SkRect bounds[], SkBBoxHierarchy::Metadata[]);
 
+// As above, but only for the ops from startOp on, which bounds[0] and meta[0] are for. Those ops
+// start out drawn with the given matrix, inside openSaves saves (not layers) made by earlier ops.
+void SkRecordFillBounds(const SkRect& cullRect, const SkRecord&,
+                        int startOp, const SkMatrix& ctm, int openSaves,
+                        SkRect bounds[], SkBBoxHierarchy::Metadata[]);
+
 // Draw an SkRecord into an SkCanvas.  A convenience wrapper around SkRecords::Draw.
 void SkRecordDraw(const SkRecord&, SkCanvas*, SkPicture const* const drawablePicts[],
                   SkDrawable* const drawables[], int drawableCount,
                   const SkBBoxHierarchy*, SkPicture::AbortCallback*);
 
+// Draw only the given ops of an SkRecord, in order, into an SkCanvas. The ops are usually the
+// result of searching an SkBBoxHierarchy with the canvas's local clip bounds, as SkRecordDraw
+// does; this lets callers batch that search across several canvases.
+void SkRecordDrawOps(const SkRecord&, SkSpan<const int> ops, SkCanvas*,
+                     SkPicture const* const drawablePicts[], SkDrawable* const drawables[],
+                     int drawableCount, SkPicture::AbortCallback*);
+
 namespace SkRecords {
 
 // This is an SkRecord visitor that will draw that SkRecord to an SkCanvas.
@@ -29,6 +29,8 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 
 using namespace skia_private;
 
@@ -52,6 +54,10 @@ static inline bool SkShouldPostMessageToBus(
     #define SK_DEFAULT_IMAGE_CACHE_LIMIT     (32 * 1024 * 1024)
 #endif
 
+#ifndef SK_RESOURCE_CACHE_SHARD_COUNT
+    #define SK_RESOURCE_CACHE_SHARD_COUNT    8
+#endif
+
 void SkResourceCache::Key::init(void* nameSpace, uint64_t sharedID, size_t dataSize) {
     SkASSERT(SkAlign4(dataSize) == dataSize);
 
@@ -96,6 +102,7 @@ void SkResourceCache::init() {
     fTotalBytesUsed = 0;
     fCount = 0;
     fSingleAllocationByteLimit = 0;
+    fDiscardableCountLimit = SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
 
     // One of these should be explicit set by the caller after we return.
     fTotalByteLimit = 0;
@@ -217,7 +224,7 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
     int    countLimit;
 
     if (fDiscardableFactory) {
-        countLimit = SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
+        countLimit = fDiscardableCountLimit;
         byteLimit = UINT32_MAX;  // no limit based on bytes
     } else {
         countLimit = SK_MaxS32; // no limit based on count
@@ -303,6 +310,15 @@ size_t SkResourceCache::setTotalByteLimit(size_t newLimit) {
     return prevLimit;
 }
 
+int SkResourceCache::setDiscardableCountLimit(int newLimit) {
+    int prevLimit = fDiscardableCountLimit;
+    fDiscardableCountLimit = newLimit;
+    if (newLimit < prevLimit) {
+        this->purgeAsNeeded();
+    }
+    return prevLimit;
+}
+
 SkCachedData* SkResourceCache::newCachedData(size_t bytes) {
     this->checkMessages();
 
@@ -463,94 +479,173 @@ void SkResourceCache::checkMessages() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-static SkResourceCache* gResourceCache = nullptr;
-static SkMutex& resource_cache_mutex() {
-    static SkMutex& mutex = *(new SkMutex);
-    return mutex;
+static constexpr int kShardCount = SK_RESOURCE_CACHE_SHARD_COUNT;
+static_assert(kShardCount > 0, "SK_RESOURCE_CACHE_SHARD_COUNT must be positive");
+
+namespace {
+struct CacheShard {
+    SkMutex          fMutex;
+    SkResourceCache* fCache = nullptr;  // Only touched while holding fMutex.
+};
+}  // namespace
+
+// Splits a global budget across the shards. Shard 0 also takes the remainder, so that the shares
+// always add up to exactly the global budget.
+template <typename T>
+static T shard_share(T total, int shardIndex) {
+    T share = total / kShardCount;
+    return shardIndex == 0 ? share + total % kShardCount : share;
 }
 
-/** Must hold resource_cache_mutex() when calling. */
-static SkResourceCache* get_cache() {
-    // resource_cache_mutex() is always held when this is called, so we don't need to be fancy in here.
-    resource_cache_mutex().assertHeld();
-    if (nullptr == gResourceCache) {
+static CacheShard* get_shards() {
+    static CacheShard* shards = [] {
+        CacheShard* shards = new CacheShard[kShardCount];
+        for (int i = 0; i < kShardCount; ++i) {
 #ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
-        gResourceCache = new SkResourceCache(SkDiscardableMemory::Create);
+            shards[i].fCache = new SkResourceCache(SkDiscardableMemory::Create);
+            shards[i].fCache->setDiscardableCountLimit(
+                    shard_share(SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT, i));
 #else
-        gResourceCache = new SkResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
+            shards[i].fCache = new SkResourceCache(
+                    shard_share<size_t>(SK_DEFAULT_IMAGE_CACHE_LIMIT, i));
 #endif
-    }
-    return gResourceCache;
+        }
+        return shards;
+    }();
+    return shards;
+}
+
+static CacheShard& shard_for_key(const SkResourceCache::Key& key) {
+    // Each shard's hash table indexes with the low bits of the key's hash, so remix it rather
+    // than picking the shard from those same bits.
+    return get_shards()[SkChecksum::CheapMix(key.hash()) % kShardCount];
+}
+
+// Serializes the setters that update every shard, so that concurrent calls can't interleave and
+// leave the shards with shares of different budgets.
+static SkMutex& resource_cache_limits_mutex() {
+    static SkMutex& mutex = *(new SkMutex);
+    return mutex;
 }
 
 size_t SkResourceCache::GetTotalBytesUsed() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->getTotalBytesUsed();
+    size_t used = 0;
+    for (int i = 0; i < kShardCount; ++i) {
+        CacheShard& shard = get_shards()[i];
+        SkAutoMutexExclusive am(shard.fMutex);
+        used += shard.fCache->getTotalBytesUsed();
+    }
+    return used;
 }
 
 size_t SkResourceCache::GetTotalByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->getTotalByteLimit();
+    SkAutoMutexExclusive lm(resource_cache_limits_mutex());
+    size_t limit = 0;
+    for (int i = 0; i < kShardCount; ++i) {
+        CacheShard& shard = get_shards()[i];
+        SkAutoMutexExclusive am(shard.fMutex);
+        limit += shard.fCache->getTotalByteLimit();
+    }
+    return limit;
 }
 
 size_t SkResourceCache::SetTotalByteLimit(size_t newLimit) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->setTotalByteLimit(newLimit);
+    SkAutoMutexExclusive lm(resource_cache_limits_mutex());
+    size_t prevLimit = 0;
+    for (int i = 0; i < kShardCount; ++i) {
+        CacheShard& shard = get_shards()[i];
+        SkAutoMutexExclusive am(shard.fMutex);
+        prevLimit += shard.fCache->setTotalByteLimit(shard_share(newLimit, i));
+    }
+    return prevLimit;
 }
 
 SkResourceCache::DiscardableFactory SkResourceCache::GetDiscardableFactory() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->discardableFactory();
+    CacheShard& shard = get_shards()[0];
+    SkAutoMutexExclusive am(shard.fMutex);
+    return shard.fCache->discardableFactory();
 }
 
 SkCachedData* SkResourceCache::NewCachedData(size_t bytes) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->newCachedData(bytes);
+    // Any shard can allocate; spread the calls out so they don't all contend on one lock.
+    static std::atomic<uint32_t> nextShard{0};
+    CacheShard& shard =
+            get_shards()[nextShard.fetch_add(1, std::memory_order_relaxed) % kShardCount];
+    SkAutoMutexExclusive am(shard.fMutex);
+    return shard.fCache->newCachedData(bytes);
 }
 
 void SkResourceCache::Dump() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    get_cache()->dump();
+    for (int i = 0; i < kShardCount; ++i) {
+        CacheShard& shard = get_shards()[i];
+        SkAutoMutexExclusive am(shard.fMutex);
+        SkDebugf("shard %d: ", i);
+        shard.fCache->dump();
+    }
 }
 
 size_t SkResourceCache::SetSingleAllocationByteLimit(size_t size) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->setSingleAllocationByteLimit(size);
+    SkAutoMutexExclusive lm(resource_cache_limits_mutex());
+    size_t prevLimit = 0;
+    for (int i = 0; i < kShardCount; ++i) {
+        CacheShard& shard = get_shards()[i];
+        SkAutoMutexExclusive am(shard.fMutex);
+        prevLimit = shard.fCache->setSingleAllocationByteLimit(size);
+    }
+    return prevLimit;
 }
 
 size_t SkResourceCache::GetSingleAllocationByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->getSingleAllocationByteLimit();
+    CacheShard& shard = get_shards()[0];
+    SkAutoMutexExclusive am(shard.fMutex);
+    return shard.fCache->getSingleAllocationByteLimit();
 }
 
 size_t SkResourceCache::GetEffectiveSingleAllocationByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->getEffectiveSingleAllocationByteLimit();
+    // A Rec has to fit in the budget of the shard it lands in, so pin against the smallest share.
+    size_t limit = SIZE_MAX;
+    for (int i = 0; i < kShardCount; ++i) {
+        CacheShard& shard = get_shards()[i];
+        SkAutoMutexExclusive am(shard.fMutex);
+        limit = std::min(limit, shard.fCache->getEffectiveSingleAllocationByteLimit());
+    }
+    return limit;
 }
 
 void SkResourceCache::PurgeAll() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->purgeAll();
+    for (int i = 0; i < kShardCount; ++i) {
+        CacheShard& shard = get_shards()[i];
+        SkAutoMutexExclusive am(shard.fMutex);
+        shard.fCache->purgeAll();
+    }
 }
 
 void SkResourceCache::CheckMessages() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->checkMessages();
+    for (int i = 0; i < kShardCount; ++i) {
+        CacheShard& shard = get_shards()[i];
+        SkAutoMutexExclusive am(shard.fMutex);
+        shard.fCache->checkMessages();
+    }
 }
 
 bool SkResourceCache::Find(const Key& key, FindVisitor visitor, void* context) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->find(key, visitor, context);
+    CacheShard& shard = shard_for_key(key);
+    SkAutoMutexExclusive am(shard.fMutex);
+    return shard.fCache->find(key, visitor, context);
 }
 
 void SkResourceCache::Add(Rec* rec, void* payload) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    get_cache()->add(rec, payload);
+    CacheShard& shard = shard_for_key(rec->getKey());
+    SkAutoMutexExclusive am(shard.fMutex);
+    shard.fCache->add(rec, payload);
 }
 
 void SkResourceCache::VisitAll(Visitor visitor, void* context) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    get_cache()->visitAll(visitor, context);
+    for (int i = 0; i < kShardCount; ++i) {
+        CacheShard& shard = get_shards()[i];
+        SkAutoMutexExclusive am(shard.fMutex);
+        shard.fCache->visitAll(visitor, context);
+    }
 }
 
 void SkResourceCache::PostPurgeSharedID(uint64_t sharedID) {
@@ -138,8 +138,10 @@ public:
     typedef SkDiscardableMemory* (*DiscardableFactory)(size_t bytes);
 
     /*
-     *  The following static methods are thread-safe wrappers around a global
-     *  instance of this cache.
+     *  The following static methods are thread-safe wrappers around a global cache. The global
+     *  cache is split into SK_RESOURCE_CACHE_SHARD_COUNT instances, each guarded by its own mutex,
+     *  so that threads looking up unrelated keys do not contend. A Key's hash selects its shard,
+     *  and each shard gets an equal share of the total byte limit.
      */
 
     /**
@@ -244,6 +246,12 @@ public:
      */
     size_t setTotalByteLimit(size_t newLimit);
 
+    /**
+     *  Only respected when the cache is backed by discardable memory, where it bounds the number
+     *  of Recs in place of the byte limit. setDiscardableCountLimit() returns the previous value.
+     */
+    int setDiscardableCountLimit(int newLimit);
+
     void purgeSharedID(uint64_t sharedID);
 
     void purgeAll() {
@@ -272,6 +280,7 @@ private:
     size_t  fTotalByteLimit;
     size_t  fSingleAllocationByteLimit;
     int     fCount;
+    int     fDiscardableCountLimit;
 
     SkMessageBus<PurgeSharedIDMessage, uint32_t>::Inbox fPurgeSharedIDInbox;
 
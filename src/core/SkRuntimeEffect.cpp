@@ -13,6 +13,13 @@
 #include "include/core/SkColor.h"
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkData.h"
+#include "include/core/SkFourByteTag.h"
+#include "include/core/SkMilestone.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
+#include "include/core/SkSpan.h"
+#include "include/core/SkTraceMemoryDump.h"
 #include "include/private/base/SkAlign.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkMutex.h"
@@ -21,6 +28,7 @@
 #include "src/base/SkArenaAlloc.h"
 #include "src/base/SkEnumBitMask.h"
 #include "src/base/SkNoDestructor.h"
+#include "src/base/SkTime.h"
 #include "src/core/SkBlenderBase.h"
 #include "src/core/SkChecksum.h"
 #include "src/core/SkColorSpacePriv.h"
@@ -62,6 +70,8 @@
 #include "src/sksl/transform/SkSLTransform.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 
 using namespace skia_private;
 
@@ -215,37 +225,197 @@ sk_sp<const SkData> SkRuntimeEffectPriv::TransformUniforms(
     return data ? data : originalData;
 }
 
+static std::atomic<SkRuntimeEffect::PersistentCache*> gPersistentCache{nullptr};
+
+void SkRuntimeEffect::SetPersistentCache(PersistentCache* cache) {
+    gPersistentCache.store(cache, std::memory_order_release);
+}
+
+// Bump this whenever the layout written by write_rp_cache_entry() changes.
+static constexpr uint32_t kRPCacheFormatVersion = 2;
+
+// The key covers everything that the parsed program, and so the rest of the effect, depends on.
+static sk_sp<SkData> make_rp_cache_key(const std::string& source,
+                                       SkSL::ProgramKind kind,
+                                       const SkSL::ProgramSettings& settings) {
+    SkDynamicMemoryWStream key;
+    key.write32(SkSetFourByteTag('s', 'k', 'r', 'e'));
+    key.write32(SK_MILESTONE);
+    key.write32(kRPCacheFormatVersion);
+    key.write32((uint32_t)kind);
+    key.write32(settings.fOptimize);
+    key.write32(settings.fForceNoInline);
+    key.write32((uint32_t)settings.fMaxVersionAllowed);
+    key.write(source.data(), source.size());
+    return key.detachAsData();
+}
+
+static void write_string(SkWStream* out, std::string_view str) {
+    out->write32(SkToU32(str.size()));
+    out->write(str.data(), str.size());
+}
+
+// The string points into the stream's memory, which the caller keeps alive.
+static bool read_string(SkMemoryStream* in, std::string_view* str) {
+    uint32_t size;
+    if (!in->readU32(&size) || in->getLength() - in->getPosition() < size) {
+        return false;
+    }
+    *str = std::string_view(static_cast<const char*>(in->getAtPos()), size);
+    return in->skip(size) == size;
+}
+
+// A cache entry holds everything an effect reflects from its program, followed by its RP program.
+// An effect can be made from it without parsing the SkSL.
+static sk_sp<SkData> write_rp_cache_entry(uint32_t flags,
+                                          SkSL::Version requiredSkSLVersion,
+                                          SkSpan<const SkRuntimeEffect::Uniform> uniforms,
+                                          SkSpan<const SkRuntimeEffect::Child> children,
+                                          SkSpan<const SkSL::SampleUsage> sampleUsages,
+                                          const SkSL::RP::Program& program) {
+    SkDynamicMemoryWStream entry;
+    entry.write32(flags);
+    entry.write32((uint32_t)requiredSkSLVersion);
+    entry.write32(SkToU32(uniforms.size()));
+    for (const SkRuntimeEffect::Uniform& u : uniforms) {
+        write_string(&entry, u.name);
+        entry.write32(SkToU32(u.offset));
+        entry.write32((uint32_t)u.type);
+        entry.write32(u.count);
+        entry.write32(u.flags);
+    }
+    entry.write32(SkToU32(children.size()));
+    for (size_t i = 0; i < children.size(); ++i) {
+        write_string(&entry, children[i].name);
+        entry.write32((uint32_t)children[i].type);
+        entry.write32((uint32_t)sampleUsages[i].kind());
+        entry.write32(sampleUsages[i].hasPerspective());
+    }
+    if (!program.serialize(&entry)) {
+        return nullptr;
+    }
+    return entry.detachAsData();
+}
+
+sk_sp<SkRuntimeEffect> SkRuntimeEffect::MakeFromCacheEntry(std::string source,
+                                                           SkSL::ProgramKind kind,
+                                                           const Options& options,
+                                                           sk_sp<SkData> cacheEntry) {
+    SkMemoryStream entry(cacheEntry->data(), cacheEntry->size(), /*copyData=*/false);
+    uint32_t flags, requiredSkSLVersion, uniformCount, childCount;
+    if (!entry.readU32(&flags) || !entry.readU32(&requiredSkSLVersion) ||
+        requiredSkSLVersion > (uint32_t)SkSL::Version::k300 || !entry.readU32(&uniformCount)) {
+        return nullptr;
+    }
+
+    std::vector<Uniform> uniforms;
+    for (uint32_t i = 0; i < uniformCount; ++i) {
+        Uniform u;
+        uint32_t offset, type, count;
+        if (!read_string(&entry, &u.name) || !entry.readU32(&offset) || !entry.readU32(&type) ||
+            type > (uint32_t)Uniform::Type::kInt4 || !entry.readU32(&count) ||
+            !entry.readU32(&u.flags)) {
+            return nullptr;
+        }
+        u.offset = offset;
+        u.type = (Uniform::Type)type;
+        u.count = count;
+        uniforms.push_back(u);
+    }
+
+    if (!entry.readU32(&childCount)) {
+        return nullptr;
+    }
+    std::vector<Child> children;
+    std::vector<SkSL::SampleUsage> sampleUsages;
+    for (uint32_t i = 0; i < childCount; ++i) {
+        Child c;
+        uint32_t type, usage, hasPerspective;
+        if (!read_string(&entry, &c.name) || !entry.readU32(&type) ||
+            type > (uint32_t)ChildType::kBlender || !entry.readU32(&usage) ||
+            usage > (uint32_t)SkSL::SampleUsage::Kind::kExplicit ||
+            !entry.readU32(&hasPerspective) ||
+            (hasPerspective && usage != (uint32_t)SkSL::SampleUsage::Kind::kUniformMatrix)) {
+            return nullptr;
+        }
+        c.type = (ChildType)type;
+        c.index = i;
+        children.push_back(c);
+        sampleUsages.emplace_back((SkSL::SampleUsage::Kind)usage, hasPerspective != 0);
+    }
+
+    std::unique_ptr<SkSL::RP::Program> rpProgram = SkSL::RP::Program::Deserialize(&entry);
+    if (!rpProgram) {
+        return nullptr;
+    }
+    return sk_sp<SkRuntimeEffect>(new SkRuntimeEffect(std::move(source),
+                                                      kind,
+                                                      options,
+                                                      std::move(cacheEntry),
+                                                      std::move(uniforms),
+                                                      std::move(children),
+                                                      std::move(sampleUsages),
+                                                      flags,
+                                                      (SkSL::Version)requiredSkSLVersion,
+                                                      std::move(rpProgram)));
+}
+
+const SkSL::Program& SkRuntimeEffect::baseProgram() const {
+    fParseOnce([&] {
+        if (fBaseProgram) {
+            return;
+        }
+        // The cache entry was stored by an effect made from the same source and options, by the
+        // same build, so the source is known to parse.
+        SkSL::Compiler compiler;
+        fBaseProgram = compiler.convertProgram(fKind, *fUnparsedSource, MakeSettings(fOptions));
+        SkASSERT_RELEASE(fBaseProgram);
+        fMain = fBaseProgram->getFunction("main")->definition();
+    });
+    return *fBaseProgram;
+}
+
 const SkSL::RP::Program* SkRuntimeEffect::getRPProgram(SkSL::DebugTracePriv* debugTrace) const {
     // Lazily compile the program the first time `getRPProgram` is called.
     // By using an SkOnce, we avoid thread hazards and behave in a conceptually const way, but we
     // can avoid the cost of invoking the RP code generator until it's actually needed.
     fCompileRPProgramOnce([&] {
+        if (fRPProgram) {
+            // Loaded from the persistent cache along with the rest of the effect.
+            return;
+        }
+
+        SkSL::Program& baseProgram = const_cast<SkSL::Program&>(this->baseProgram());
+
         // We generally do not run the inliner when an SkRuntimeEffect program is initially created,
         // because the final compile to native shader code will do this. However, in SkRP, there's
         // no additional compilation occurring, so we need to manually inline here if we want the
         // performance boost of inlining.
         if (!(fFlags & kDisableOptimization_Flag)) {
             SkSL::Compiler compiler;
-            fBaseProgram->fConfig->fSettings.fInlineThreshold = SkSL::kDefaultInlineThreshold;
-            compiler.runInliner(*fBaseProgram);
+            baseProgram.fConfig->fSettings.fInlineThreshold = SkSL::kDefaultInlineThreshold;
+            compiler.runInliner(baseProgram);
 
             // After inlining, the program is likely to have dead functions left behind.
-            while (SkSL::Transform::EliminateDeadFunctions(*fBaseProgram)) {
+            while (SkSL::Transform::EliminateDeadFunctions(baseProgram)) {
                 // Removing dead functions may cause more functions to become unreferenced.
             }
         }
 
+        // Traced programs aren't cached; they write trace ops that refer to this effect's trace.
+        const bool cacheable = !debugTrace && !kRPEnableLiveTrace;
+
         SkSL::DebugTracePriv tempDebugTrace;
         if (debugTrace) {
             const_cast<SkRuntimeEffect*>(this)->fRPProgram = MakeRasterPipelineProgram(
-                    *fBaseProgram, fMain, debugTrace, /*writeTraceOps=*/true);
+                    baseProgram, *fMain, debugTrace, /*writeTraceOps=*/true);
         } else if (kRPEnableLiveTrace) {
             debugTrace = &tempDebugTrace;
             const_cast<SkRuntimeEffect*>(this)->fRPProgram = MakeRasterPipelineProgram(
-                    *fBaseProgram, fMain, debugTrace, /*writeTraceOps=*/false);
+                    baseProgram, *fMain, debugTrace, /*writeTraceOps=*/false);
         } else {
             const_cast<SkRuntimeEffect*>(this)->fRPProgram = MakeRasterPipelineProgram(
-                    *fBaseProgram, fMain, /*debugTrace=*/nullptr, /*writeTraceOps=*/false);
+                    baseProgram, *fMain, /*debugTrace=*/nullptr, /*writeTraceOps=*/false);
         }
 
         if (kRPEnableLiveTrace) {
@@ -258,6 +428,16 @@ const SkSL::RP::Program* SkRuntimeEffect::getRPProgram(SkSL::DebugTracePriv* deb
                 SkDebugf("----- RP unsupported -----\n\n");
             }
         }
+
+        PersistentCache* persistentCache = gPersistentCache.load(std::memory_order_acquire);
+        if (persistentCache && cacheable && fRPProgram) {
+            if (sk_sp<SkData> entry = write_rp_cache_entry(fFlags, fRequiredSkSLVersion,
+                                                           this->uniforms(), this->children(),
+                                                           fSampleUsages, *fRPProgram)) {
+                persistentCache->store(
+                        *make_rp_cache_key(this->source(), fKind, MakeSettings(fOptions)), *entry);
+            }
+        }
     });
 
     return fRPProgram.get();
@@ -363,7 +543,7 @@ bool SkRuntimeEffectPriv::CanDraw(const SkCapabilities* caps, const SkSL::Progra
 
 bool SkRuntimeEffectPriv::CanDraw(const SkCapabilities* caps, const SkRuntimeEffect* effect) {
     SkASSERT(effect);
-    return CanDraw(caps, effect->fBaseProgram.get());
+    return effect->fRequiredSkSLVersion <= caps->skslVersion();
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -473,10 +653,24 @@ SkSL::ProgramSettings SkRuntimeEffect::MakeSettings(const Options& options) {
 SkRuntimeEffect::Result SkRuntimeEffect::MakeFromSource(SkString sksl,
                                                         const Options& options,
                                                         SkSL::ProgramKind kind) {
-    SkSL::Compiler compiler;
     SkSL::ProgramSettings settings = MakeSettings(options);
+    std::string source(sksl.c_str(), sksl.size());
+
+    // An effect whose RP program is in the persistent cache is made without parsing its source.
+    PersistentCache* persistentCache = gPersistentCache.load(std::memory_order_acquire);
+    if (persistentCache && !kRPEnableLiveTrace) {
+        sk_sp<SkData> key = make_rp_cache_key(source, kind, settings);
+        if (sk_sp<SkData> entry = persistentCache->load(*key)) {
+            if (sk_sp<SkRuntimeEffect> effect =
+                        MakeFromCacheEntry(source, kind, options, std::move(entry))) {
+                return Result{std::move(effect), SkString()};
+            }
+        }
+    }
+
+    SkSL::Compiler compiler;
     std::unique_ptr<SkSL::Program> program =
-            compiler.convertProgram(kind, std::string(sksl.c_str(), sksl.size()), settings);
+            compiler.convertProgram(kind, std::move(source), settings);
 
     if (!program) {
         RETURN_FAILURE("%s", compiler.errorText().c_str());
@@ -630,7 +824,7 @@ sk_sp<SkRuntimeEffect> SkRuntimeEffect::makeUnoptimizedClone() {
     options.allowPrivateAccess = true;
 
     // We do know the original ProgramKind, so we don't need to re-derive it.
-    SkSL::ProgramKind kind = fBaseProgram->fConfig->fKind;
+    SkSL::ProgramKind kind = fKind;
 
     // Attempt to recompile the program's source with optimizations off. This ensures that the
     // Debugger shows results on every line, even for things that could be optimized away (static
@@ -638,7 +832,7 @@ sk_sp<SkRuntimeEffect> SkRuntimeEffect::makeUnoptimizedClone() {
     SkSL::Compiler compiler;
     SkSL::ProgramSettings settings = MakeSettings(options);
     std::unique_ptr<SkSL::Program> program =
-            compiler.convertProgram(kind, *fBaseProgram->fSource, settings);
+            compiler.convertProgram(kind, this->source(), settings);
 
     if (!program) {
         // Turning off compiler optimizations can theoretically expose a program error that
@@ -683,16 +877,35 @@ SkRuntimeEffect::Result SkRuntimeEffect::MakeForBlender(SkString sksl, const Opt
     return result;
 }
 
+#ifndef SK_DEFAULT_RUNTIME_EFFECT_CACHE_COUNT_LIMIT
+    #define SK_DEFAULT_RUNTIME_EFFECT_CACHE_COUNT_LIMIT 64
+#endif
+
+namespace {
+struct RuntimeEffectCache {
+    SkMutex                                      fMutex;
+    SkLRUCache<uint64_t, sk_sp<SkRuntimeEffect>> fLRU{SK_DEFAULT_RUNTIME_EFFECT_CACHE_COUNT_LIMIT};
+    uint64_t                                     fHits = 0;
+    uint64_t                                     fMisses = 0;
+    double                                       fCompileTimeNs = 0;
+};
+}  // namespace
+
+static RuntimeEffectCache& runtime_effect_cache() {
+    static SkNoDestructor<RuntimeEffectCache> cache;
+    return *cache;
+}
+
 sk_sp<SkRuntimeEffect> SkMakeCachedRuntimeEffect(
         SkRuntimeEffect::Result (*make)(SkString sksl, const SkRuntimeEffect::Options&),
         SkString sksl) {
-    static SkNoDestructor<SkMutex> mutex;
-    static SkNoDestructor<SkLRUCache<uint64_t, sk_sp<SkRuntimeEffect>>> cache(11 /*arbitrary*/);
+    RuntimeEffectCache& cache = runtime_effect_cache();
 
     uint64_t key = SkChecksum::Hash64(sksl.c_str(), sksl.size());
     {
-        SkAutoMutexExclusive _(*mutex);
-        if (sk_sp<SkRuntimeEffect>* found = cache->find(key)) {
+        SkAutoMutexExclusive _(cache.fMutex);
+        if (sk_sp<SkRuntimeEffect>* found = cache.fLRU.find(key)) {
+            cache.fHits++;
             return *found;
         }
     }
@@ -700,7 +913,9 @@ sk_sp<SkRuntimeEffect> SkMakeCachedRuntimeEffect(
     SkRuntimeEffect::Options options;
     SkRuntimeEffectPriv::AllowPrivateAccess(&options);
 
+    const double start = SkTime::GetNSecs();
     auto [effect, err] = make(std::move(sksl), options);
+    const double compileTimeNs = SkTime::GetNSecs() - start;
     if (!effect) {
         SkDEBUGFAILF("%s", err.c_str());
         return nullptr;
@@ -708,12 +923,69 @@ sk_sp<SkRuntimeEffect> SkMakeCachedRuntimeEffect(
     SkASSERT(err.isEmpty());
 
     {
-        SkAutoMutexExclusive _(*mutex);
-        cache->insert_or_update(key, effect);
+        SkAutoMutexExclusive _(cache.fMutex);
+        cache.fMisses++;
+        cache.fCompileTimeNs += compileTimeNs;
+        cache.fLRU.insert_or_update(key, effect);
     }
     return effect;
 }
 
+void SkPrecompileCachedRuntimeEffects(
+        SkRuntimeEffect::Result (*make)(SkString sksl, const SkRuntimeEffect::Options&),
+        SkSpan<const SkString> sksl,
+        SkExecutor* executor) {
+    for (const SkString& program : sksl) {
+        if (executor) {
+            executor->add([make, program] { SkMakeCachedRuntimeEffect(make, program); });
+        } else {
+            SkMakeCachedRuntimeEffect(make, program);
+        }
+    }
+}
+
+SkRuntimeEffectCacheStats SkGetRuntimeEffectCacheStats() {
+    RuntimeEffectCache& cache = runtime_effect_cache();
+    SkAutoMutexExclusive _(cache.fMutex);
+    SkRuntimeEffectCacheStats stats;
+    stats.fHits = cache.fHits;
+    stats.fMisses = cache.fMisses;
+    stats.fCompileTimeNs = cache.fCompileTimeNs;
+    stats.fCount = cache.fLRU.count();
+    stats.fCountLimit = cache.fLRU.maxCount();
+    return stats;
+}
+
+void SkPurgeRuntimeEffectCache() {
+    RuntimeEffectCache& cache = runtime_effect_cache();
+    SkAutoMutexExclusive _(cache.fMutex);
+    cache.fLRU.reset();
+}
+
+void SkDumpRuntimeEffectCacheStatistics(SkTraceMemoryDump* dump) {
+    static constexpr char kDumpName[] = "skia/sk_runtime_effect_cache";
+    const SkRuntimeEffectCacheStats stats = SkGetRuntimeEffectCacheStats();
+    dump->dumpNumericValue(kDumpName, "effect_count", "objects", stats.fCount);
+    dump->dumpNumericValue(kDumpName, "budget_effect_count", "objects", stats.fCountLimit);
+    dump->dumpNumericValue(kDumpName, "hit_count", "objects", stats.fHits);
+    dump->dumpNumericValue(kDumpName, "miss_count", "objects", stats.fMisses);
+    dump->dumpNumericValue(kDumpName, "compile_time", "ns", (uint64_t)stats.fCompileTimeNs);
+}
+
+int SkGraphics::GetRuntimeEffectCacheCountLimit() {
+    RuntimeEffectCache& cache = runtime_effect_cache();
+    SkAutoMutexExclusive _(cache.fMutex);
+    return cache.fLRU.maxCount();
+}
+
+int SkGraphics::SetRuntimeEffectCacheCountLimit(int count) {
+    RuntimeEffectCache& cache = runtime_effect_cache();
+    SkAutoMutexExclusive _(cache.fMutex);
+    const int prev = cache.fLRU.maxCount();
+    cache.fLRU.setMaxCount(std::max(count, 0));
+    return prev;
+}
+
 static size_t uniform_element_size(SkRuntimeEffect::Uniform::Type type) {
     switch (type) {
         case SkRuntimeEffect::Uniform::Type::kFloat:  return sizeof(float);
@@ -738,6 +1010,30 @@ size_t SkRuntimeEffect::Uniform::sizeInBytes() const {
     return uniform_element_size(this->type) * this->count;
 }
 
+uint32_t SkRuntimeEffect::HashSourceAndOptions(const std::string& source, const Options& options) {
+    uint32_t hash = SkChecksum::Hash32(source.c_str(), source.size());
+
+    // Everything from SkRuntimeEffect::Options which could influence the compiled result needs to
+    // be accounted for in the hash. If you've added a new field to Options and caused the static-
+    // assert below to trigger, please incorporate your field into the hash and update KnownOptions
+    // to match the layout of Options.
+    struct KnownOptions {
+        bool forceUnoptimized, allowPrivateAccess;
+        uint32_t fStableKey;
+        SkSL::Version maxVersionAllowed;
+    };
+    static_assert(sizeof(Options) == sizeof(KnownOptions));
+    hash = SkChecksum::Hash32(&options.forceUnoptimized,
+                              sizeof(options.forceUnoptimized), hash);
+    hash = SkChecksum::Hash32(&options.allowPrivateAccess,
+                              sizeof(options.allowPrivateAccess), hash);
+    hash = SkChecksum::Hash32(&options.fStableKey,
+                              sizeof(options.fStableKey), hash);
+    hash = SkChecksum::Hash32(&options.maxVersionAllowed,
+                              sizeof(options.maxVersionAllowed), hash);
+    return hash;
+}
+
 SkRuntimeEffect::SkRuntimeEffect(std::unique_ptr<SkSL::Program> baseProgram,
                                  const Options& options,
                                  const SkSL::FunctionDefinition& main,
@@ -745,41 +1041,53 @@ SkRuntimeEffect::SkRuntimeEffect(std::unique_ptr<SkSL::Program> baseProgram,
                                  std::vector<Child>&& children,
                                  std::vector<SkSL::SampleUsage>&& sampleUsages,
                                  uint32_t flags)
-        : fHash(SkChecksum::Hash32(baseProgram->fSource->c_str(), baseProgram->fSource->size()))
+        : fHash(HashSourceAndOptions(*baseProgram->fSource, options))
         , fStableKey(options.fStableKey)
+        , fOptions(options)
+        , fKind(baseProgram->fConfig->fKind)
+        , fRequiredSkSLVersion(baseProgram->fConfig->fRequiredSkSLVersion)
         , fBaseProgram(std::move(baseProgram))
-        , fMain(main)
+        , fMain(&main)
         , fUniforms(std::move(uniforms))
         , fChildren(std::move(children))
         , fSampleUsages(std::move(sampleUsages))
         , fFlags(flags) {
     SkASSERT(fBaseProgram);
     SkASSERT(fChildren.size() == fSampleUsages.size());
+}
 
-    // Everything from SkRuntimeEffect::Options which could influence the compiled result needs to
-    // be accounted for in `fHash`. If you've added a new field to Options and caused the static-
-    // assert below to trigger, please incorporate your field into `fHash` and update KnownOptions
-    // to match the layout of Options.
-    struct KnownOptions {
-        bool forceUnoptimized, allowPrivateAccess;
-        uint32_t fStableKey;
-        SkSL::Version maxVersionAllowed;
-    };
-    static_assert(sizeof(Options) == sizeof(KnownOptions));
-    fHash = SkChecksum::Hash32(&options.forceUnoptimized,
-                               sizeof(options.forceUnoptimized), fHash);
-    fHash = SkChecksum::Hash32(&options.allowPrivateAccess,
-                               sizeof(options.allowPrivateAccess), fHash);
-    fHash = SkChecksum::Hash32(&options.fStableKey,
-                               sizeof(options.fStableKey), fHash);
-    fHash = SkChecksum::Hash32(&options.maxVersionAllowed,
-                               sizeof(options.maxVersionAllowed), fHash);
+SkRuntimeEffect::SkRuntimeEffect(std::string source,
+                                 SkSL::ProgramKind kind,
+                                 const Options& options,
+                                 sk_sp<SkData> cacheEntry,
+                                 std::vector<Uniform>&& uniforms,
+                                 std::vector<Child>&& children,
+                                 std::vector<SkSL::SampleUsage>&& sampleUsages,
+                                 uint32_t flags,
+                                 SkSL::Version requiredSkSLVersion,
+                                 std::unique_ptr<SkSL::RP::Program> rpProgram)
+        : fHash(HashSourceAndOptions(source, options))
+        , fStableKey(options.fStableKey)
+        , fOptions(options)
+        , fKind(kind)
+        , fRequiredSkSLVersion(requiredSkSLVersion)
+        , fUnparsedSource(std::make_unique<const std::string>(std::move(source)))
+        , fCacheEntry(std::move(cacheEntry))
+        , fMain(nullptr)
+        , fRPProgram(std::move(rpProgram))
+        , fUniforms(std::move(uniforms))
+        , fChildren(std::move(children))
+        , fSampleUsages(std::move(sampleUsages))
+        , fFlags(flags) {
+    SkASSERT(fRPProgram);
+    SkASSERT(fChildren.size() == fSampleUsages.size());
 }
 
 SkRuntimeEffect::~SkRuntimeEffect() = default;
 
 const std::string& SkRuntimeEffect::source() const {
-    return *fBaseProgram->fSource;
+    // fBaseProgram may be parsed on another thread at any time, unless it was set up front.
+    return fUnparsedSource ? *fUnparsedSource : *fBaseProgram->fSource;
 }
 
 size_t SkRuntimeEffect::uniformSize() const {
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkData.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkString.h"
+#include "include/effects/SkRuntimeEffect.h"
+#include "include/private/base/SkTo.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkOSFile.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+namespace {
+
+// Stores each entry in its own file, named after a hash of the key. The file starts with the full
+// key, so that a hash collision reads as a miss rather than as the wrong program.
+class FilePersistentCache final : public SkRuntimeEffect::PersistentCache {
+public:
+    explicit FilePersistentCache(SkString directory) : fDirectory(std::move(directory)) {}
+
+    sk_sp<SkData> load(const SkData& key) override {
+        sk_sp<SkData> file = SkData::MakeFromFileName(this->pathForKey(key).c_str());
+        if (!file) {
+            return nullptr;
+        }
+        SkMemoryStream stream(file);
+        uint32_t keySize;
+        if (!stream.readU32(&keySize) || keySize != key.size() ||
+            stream.getLength() - stream.getPosition() < keySize ||
+            0 != memcmp(stream.getAtPos(), key.data(), keySize)) {
+            return nullptr;
+        }
+        size_t offset = sizeof(uint32_t) + keySize;
+        return SkData::MakeSubset(file.get(), offset, file->size() - offset);
+    }
+
+    void store(const SkData& key, const SkData& data) override {
+        // Write to a private temporary file and then rename it into place, so that concurrent
+        // readers (in this or other processes) never see a partially written entry.
+        SkString path = this->pathForKey(key);
+        SkString tempPath = SkStringPrintf("%s.%u.%p.tmp", path.c_str(),
+                                           fTempCounter.fetch_add(1, std::memory_order_relaxed),
+                                           this);
+        bool written;
+        {
+            SkFILEWStream file(tempPath.c_str());
+            written = file.isValid() &&
+                      file.write32(SkToU32(key.size())) &&
+                      file.write(key.data(), key.size()) &&
+                      file.write(data.data(), data.size());
+        }
+        if (!written || 0 != std::rename(tempPath.c_str(), path.c_str())) {
+            std::remove(tempPath.c_str());
+        }
+    }
+
+private:
+    SkString pathForKey(const SkData& key) const {
+        uint64_t hash = SkChecksum::Hash64(key.data(), key.size());
+        return SkStringPrintf("%s%c%016llx.skrp",
+                              fDirectory.c_str(), kSeparator, (unsigned long long)hash);
+    }
+
+#ifdef _WIN32
+    static constexpr char kSeparator = '\\';
+#else
+    static constexpr char kSeparator = '/';
+#endif
+
+    const SkString        fDirectory;
+    std::atomic<uint32_t> fTempCounter{0};
+};
+
+}  // namespace
+
+std::unique_ptr<SkRuntimeEffect::PersistentCache> SkRuntimeEffect::MakeFilePersistentCache(
+        const char* directory) {
+    if (!directory || !sk_mkdir(directory)) {
+        return nullptr;
+    }
+    return std::make_unique<FilePersistentCache>(SkString(directory));
+}
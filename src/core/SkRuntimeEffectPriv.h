@@ -31,9 +31,11 @@ class SkArenaAlloc;
 class SkCapabilities;
 class SkColorSpace;
 class SkData;
+class SkExecutor;
 class SkMatrix;
 class SkReadBuffer;
 class SkShader;
+class SkTraceMemoryDump;
 class SkWriteBuffer;
 struct SkColorSpaceXformSteps;
 
@@ -84,7 +86,7 @@ public:
     }
 
     static const SkSL::Program& Program(const SkRuntimeEffect& effect) {
-        return *effect.fBaseProgram;
+        return effect.baseProgram();
     }
 
     static SkRuntimeEffect::Options ES3Options() {
@@ -157,6 +159,29 @@ inline sk_sp<SkRuntimeEffect> SkMakeCachedRuntimeEffect(
     return SkMakeCachedRuntimeEffect(make, SkString{sksl});
 }
 
+// Compiles each of the sksl programs through SkMakeCachedRuntimeEffect(), so that the first draw
+// that needs one finds it already in the cache. With an executor the compiles are queued on it and
+// this returns immediately; otherwise they run on the calling thread before returning.
+void SkPrecompileCachedRuntimeEffects(
+        SkRuntimeEffect::Result (*make)(SkString sksl, const SkRuntimeEffect::Options&),
+        SkSpan<const SkString> sksl,
+        SkExecutor* executor = nullptr);
+
+struct SkRuntimeEffectCacheStats {
+    uint64_t fHits = 0;
+    uint64_t fMisses = 0;
+    double   fCompileTimeNs = 0;  // Total time spent compiling SkSL for cache misses.
+    int      fCount = 0;
+    int      fCountLimit = 0;     // See SkGraphics::SetRuntimeEffectCacheCountLimit().
+};
+
+SkRuntimeEffectCacheStats SkGetRuntimeEffectCacheStats();
+
+void SkPurgeRuntimeEffectCache();
+
+// Reports the SkMakeCachedRuntimeEffect() cache's stats; called by SkGraphics::DumpMemoryStatistics.
+void SkDumpRuntimeEffectCacheStatistics(SkTraceMemoryDump*);
+
 // Internal API that assumes (and asserts) that the shader code is valid, but does no internal
 // caching. Used when the caller will cache the result in a static variable. Ownership is passed to
 // the caller; the effect will be leaked if it the pointer is not stored or explicitly deleted.
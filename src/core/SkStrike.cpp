@@ -217,18 +217,27 @@ void SkStrike::findIntercepts(const SkScalar bounds[2], SkScalar scale, SkScalar
 
 SkSpan<const SkGlyph*> SkStrike::metrics(
         SkSpan<const SkGlyphID> glyphIDs, const SkGlyph* results[]) {
+    if (fGlyphIndex.findAll(glyphIDs, GlyphIndex::kMetrics, results)) {
+        return {results, glyphIDs.size()};
+    }
     Monitor m{this};
     return this->internalPrepare(glyphIDs, kMetricsOnly, results);
 }
 
 SkSpan<const SkGlyph*> SkStrike::preparePaths(
         SkSpan<const SkGlyphID> glyphIDs, const SkGlyph* results[]) {
+    if (fGlyphIndex.findAll(glyphIDs, GlyphIndex::kPath, results)) {
+        return {results, glyphIDs.size()};
+    }
     Monitor m{this};
     return this->internalPrepare(glyphIDs, kMetricsAndPath, results);
 }
 
 SkSpan<const SkGlyph*> SkStrike::prepareImages(
         SkSpan<const SkPackedGlyphID> glyphIDs, const SkGlyph* results[]) {
+    if (fGlyphIndex.findAll(glyphIDs, GlyphIndex::kImage, results)) {
+        return {results, glyphIDs.size()};
+    }
     const SkGlyph** cursor = results;
     Monitor m{this};
     for (auto glyphID : glyphIDs) {
@@ -242,6 +251,9 @@ SkSpan<const SkGlyph*> SkStrike::prepareImages(
 
 SkSpan<const SkGlyph*> SkStrike::prepareDrawables(
         SkSpan<const SkGlyphID> glyphIDs, const SkGlyph* results[]) {
+    if (fGlyphIndex.findAll(glyphIDs, GlyphIndex::kDrawable, results)) {
+        return {results, glyphIDs.size()};
+    }
     const SkGlyph** cursor = results;
     {
         Monitor m{this};
@@ -353,6 +365,7 @@ SkGlyphDigest* SkStrike::addGlyphAndDigest(SkGlyph* glyph) {
     SkGlyphDigest digest = SkGlyphDigest{index, *glyph};
     SkGlyphDigest* newDigest = fDigestForPackedGlyphID.set(digest);
     fGlyphForIndex.push_back(glyph);
+    fMemoryIncrease += fGlyphIndex.publish(glyph, GlyphIndex::kMetrics);
     return newDigest;
 }
 
@@ -360,6 +373,7 @@ bool SkStrike::prepareForImage(SkGlyph* glyph) {
     if (glyph->setImage(&fAlloc, fScalerContext.get())) {
         fMemoryIncrease += glyph->imageSize();
     }
+    fMemoryIncrease += fGlyphIndex.publish(glyph, GlyphIndex::kImage);
     return glyph->image() != nullptr;
 }
 
@@ -367,6 +381,7 @@ bool SkStrike::prepareForPath(SkGlyph* glyph) {
     if (glyph->setPath(&fAlloc, fScalerContext.get())) {
         fMemoryIncrease += glyph->path()->approximateBytesUsed();
     }
+    fMemoryIncrease += fGlyphIndex.publish(glyph, GlyphIndex::kPath);
     return glyph->path() !=nullptr;
 }
 
@@ -376,9 +391,89 @@ bool SkStrike::prepareForDrawable(SkGlyph* glyph) {
         SkASSERT(increase > 0);
         fMemoryIncrease += increase;
     }
+    fMemoryIncrease += fGlyphIndex.publish(glyph, GlyphIndex::kDrawable);
     return glyph->drawable() != nullptr;
 }
 
+SkStrike::GlyphIndex::~GlyphIndex() {
+    // Deleting the current table deletes the chain of tables it replaced.
+    delete fTable.load(std::memory_order_relaxed);
+}
+
+// Linear probing from the hash of packedID. Entries are never removed, so an empty slot ends the
+// search, and the load factor is kept below 3/4, so there always is one.
+SkStrike::GlyphIndex::Slot* SkStrike::GlyphIndex::FindSlot(const Table* table,
+                                                           SkPackedGlyphID packedID) {
+    const uint32_t mask = table->fCapacity - 1;
+    for (uint32_t i = packedID.hash() & mask;; i = (i + 1) & mask) {
+        Slot* slot = &table->fSlots[i];
+        const SkGlyph* glyph = slot->fGlyph.load(std::memory_order_acquire);
+        if (glyph == nullptr || glyph->getPackedID() == packedID) {
+            return slot;
+        }
+    }
+}
+
+const SkGlyph* SkStrike::GlyphIndex::find(SkPackedGlyphID packedID, uint32_t ready) const {
+    const Table* table = fTable.load(std::memory_order_acquire);
+    if (table == nullptr) {
+        return nullptr;
+    }
+    const Slot* slot = FindSlot(table, packedID);
+    // The acquire pairs with the release in publish, making the glyph's data visible.
+    if ((slot->fReady.load(std::memory_order_acquire) & ready) != ready) {
+        return nullptr;
+    }
+    return slot->fGlyph.load(std::memory_order_relaxed);
+}
+
+template <typename ID>
+bool SkStrike::GlyphIndex::findAll(
+        SkSpan<const ID> ids, uint32_t ready, const SkGlyph* results[]) const {
+    for (size_t i = 0; i < ids.size(); ++i) {
+        results[i] = this->find(SkPackedGlyphID{ids[i]}, ready);
+        if (results[i] == nullptr) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t SkStrike::GlyphIndex::publish(const SkGlyph* glyph, uint32_t ready) {
+    size_t bytesAllocated = 0;
+    Table* table = fTable.load(std::memory_order_relaxed);
+    Slot* slot = table != nullptr ? FindSlot(table, glyph->getPackedID()) : nullptr;
+    if (slot == nullptr || slot->fGlyph.load(std::memory_order_relaxed) == nullptr) {
+        if (table == nullptr || 4 * (fCount + 1) > 3 * table->fCapacity) {
+            // Build a bigger copy and swap it in. Readers of the old table just miss the glyphs
+            // added from here on, and fall back to the locked path.
+            auto grown = std::make_unique<Table>(table != nullptr ? 2 * table->fCapacity
+                                                                  : kMinCapacity);
+            if (table != nullptr) {
+                for (int i = 0; i < table->fCapacity; ++i) {
+                    const Slot& from = table->fSlots[i];
+                    if (const SkGlyph* g = from.fGlyph.load(std::memory_order_relaxed)) {
+                        Slot* to = FindSlot(grown.get(), g->getPackedID());
+                        to->fReady.store(from.fReady.load(std::memory_order_relaxed),
+                                         std::memory_order_relaxed);
+                        to->fGlyph.store(g, std::memory_order_relaxed);
+                    }
+                }
+            }
+            bytesAllocated = sizeof(Table) + grown->fCapacity * sizeof(Slot);
+            grown->fReplaced.reset(table);
+            table = grown.release();
+            fTable.store(table, std::memory_order_release);
+            slot = FindSlot(table, glyph->getPackedID());
+        }
+        slot->fGlyph.store(glyph, std::memory_order_release);
+        fCount += 1;
+    }
+    SkASSERT(slot->fGlyph.load(std::memory_order_relaxed) == glyph);
+    slot->fReady.fetch_or(ready, std::memory_order_release);
+    return bytesAllocated;
+}
+
 SkGlyph* SkStrike::mergeGlyphFromBuffer(SkReadBuffer& buffer) {
     SkASSERT(buffer.isValid());
     std::optional<SkGlyph> prototypeGlyph = SkGlyph::MakeFromBuffer(buffer);
@@ -21,7 +21,9 @@
 #include "src/core/SkTHash.h"
 #include "src/text/StrikeForGPU.h"
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -138,6 +140,59 @@ private:
     friend class SkStrikeTestingPeer;
     class Monitor;
 
+    // A read-mostly map from SkPackedGlyphID to glyph that can be searched without holding
+    // fStrikeLock, so that threads drawing with the same strike do not serialize on it once the
+    // glyphs they need have been made. Entries are only added, under fStrikeLock, and a Ready bit
+    // is only published after the matching data has been set on the glyph. A reader that finds
+    // all the bits it needs can use the glyph directly; otherwise it falls back to the lock.
+    class GlyphIndex {
+    public:
+        enum Ready : uint32_t {
+            kMetrics  = 1 << 0,
+            kImage    = 1 << 1,
+            kPath     = 1 << 2,
+            kDrawable = 1 << 3,
+        };
+
+        GlyphIndex() = default;
+        GlyphIndex(const GlyphIndex&) = delete;
+        GlyphIndex& operator=(const GlyphIndex&) = delete;
+        ~GlyphIndex();
+
+        // Return the glyph for packedID if all of the ready bits have been published for it.
+        const SkGlyph* find(SkPackedGlyphID packedID, uint32_t ready) const;
+
+        // Fill results with the glyphs for ids, returning false if any of them is not ready.
+        template <typename ID>
+        bool findAll(SkSpan<const ID> ids, uint32_t ready, const SkGlyph* results[]) const;
+
+        // Add the ready bits for glyph, inserting it if needed. Returns the number of bytes
+        // allocated for the index. Only called with the strike's lock held.
+        size_t publish(const SkGlyph* glyph, uint32_t ready);
+
+    private:
+        struct Slot {
+            std::atomic<const SkGlyph*> fGlyph{nullptr};
+            std::atomic<uint32_t>       fReady{0};
+        };
+
+        struct Table {
+            explicit Table(int capacity) : fCapacity{capacity}, fSlots{new Slot[capacity]} {}
+            const int                     fCapacity;
+            const std::unique_ptr<Slot[]> fSlots;
+            // Readers may still be probing a table after it has been replaced, so replaced
+            // tables live as long as the index.
+            std::unique_ptr<Table>        fReplaced;
+        };
+
+        static Slot* FindSlot(const Table* table, SkPackedGlyphID packedID);
+
+        inline static constexpr int kMinCapacity = 16;
+
+        std::atomic<Table*> fTable{nullptr};
+        int                 fCount{0};
+    };
+
     // Return a glyph. Create it if it doesn't exist, and initialize the glyph with metrics and
     // advances using a scaler.
     SkGlyph* glyph(SkPackedGlyphID) SK_REQUIRES(fStrikeLock);
@@ -197,6 +252,9 @@ private:
 
     SkArenaAlloc            fAlloc SK_GUARDED_BY(fStrikeLock) {kMinAllocAmount};
 
+    // Lock-free view of the glyphs in fAlloc. Searched without the lock; updated with it held.
+    GlyphIndex fGlyphIndex;
+
     // The following are protected by the SkStrikeCache's mutex.
     SkStrike*                       fNext{nullptr};
     SkStrike*                       fPrev{nullptr};
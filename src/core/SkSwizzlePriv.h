@@ -29,7 +29,18 @@ namespace SkOpts {
                            RGB_to_BGR1,     // i.e. swap RB and insert an opaque alpha
                            gray_to_RGB1,    // i.e. expand to color channels + an opaque alpha
                            grayA_to_RGBA,   // i.e. expand to color channels
-                           grayA_to_rgbA;   // i.e. expand to color channels and premultiply
+                           grayA_to_rgbA,   // i.e. expand to color channels and premultiply
+                           RGB16_to_RGB1,   // i.e. big-endian 16-bit to 8-bit + an opaque alpha
+                           RGB16_to_BGR1,   // i.e. as above, and swap RB
+                           RGBA16_to_RGBA,  // i.e. big-endian 16-bit to 8-bit
+                           RGBA16_to_BGRA,  // i.e. as above, and swap RB
+                           RGBA16_to_rgbA,  // i.e. as above, and premultiply
+                           RGBA16_to_bgrA;  // i.e. as above, swap RB, and premultiply
+
+    // Look up 8-bit indices in a 256-entry color table.
+    using Swizzle_8888_index = void (*)(uint32_t*, const uint8_t*, const uint32_t*, int);
+    extern Swizzle_8888_index index_to_8888,        // i.e. expand a palette
+                              index_to_8888_skipZ;  // i.e. as above, but don't write 0 colors
 
     void Init_Swizzler();
 }  // namespace SkOpts
@@ -30,6 +30,14 @@ namespace SkOpts {
     DEFINE_DEFAULT(grayA_to_rgbA);
     DEFINE_DEFAULT(inverted_CMYK_to_RGB1);
     DEFINE_DEFAULT(inverted_CMYK_to_BGR1);
+    DEFINE_DEFAULT(RGB16_to_RGB1);
+    DEFINE_DEFAULT(RGB16_to_BGR1);
+    DEFINE_DEFAULT(RGBA16_to_RGBA);
+    DEFINE_DEFAULT(RGBA16_to_BGRA);
+    DEFINE_DEFAULT(RGBA16_to_rgbA);
+    DEFINE_DEFAULT(RGBA16_to_bgrA);
+    DEFINE_DEFAULT(index_to_8888);
+    DEFINE_DEFAULT(index_to_8888_skipZ);
 
     void Init_Swizzler_ssse3();
     void Init_Swizzler_hsw();
@@ -36,6 +36,14 @@ namespace SkOpts {
         grayA_to_rgbA         = hsw::grayA_to_rgbA;
         inverted_CMYK_to_RGB1 = hsw::inverted_CMYK_to_RGB1;
         inverted_CMYK_to_BGR1 = hsw::inverted_CMYK_to_BGR1;
+        RGB16_to_RGB1         = hsw::RGB16_to_RGB1;
+        RGB16_to_BGR1         = hsw::RGB16_to_BGR1;
+        RGBA16_to_RGBA        = hsw::RGBA16_to_RGBA;
+        RGBA16_to_BGRA        = hsw::RGBA16_to_BGRA;
+        RGBA16_to_rgbA        = hsw::RGBA16_to_rgbA;
+        RGBA16_to_bgrA        = hsw::RGBA16_to_bgrA;
+        index_to_8888         = hsw::index_to_8888;
+        index_to_8888_skipZ   = hsw::index_to_8888_skipZ;
     }
 }  // namespace SkOpts
 
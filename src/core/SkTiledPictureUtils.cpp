@@ -0,0 +1,72 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkTiledPictureUtils.h"
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkSpan.h"
+#include "src/core/SkBigPicture.h"
+#include "src/core/SkPicturePriv.h"
+#include "src/core/SkTaskGroup.h"
+
+namespace SkTiledPictureUtils {
+
+std::vector<sk_sp<SkSurface>> RasterizeTiles(const SkPicture* picture,
+                                             const SkIRect& bounds,
+                                             const SkImageInfo& tileInfo,
+                                             SkExecutor* executor,
+                                             const SkSurfaceProps* props) {
+    if (!picture || bounds.isEmpty() || tileInfo.isEmpty()) {
+        return {};
+    }
+    const int tileW = tileInfo.width(),
+              tileH = tileInfo.height();
+    const int columns = (int)((bounds.width() + (int64_t)tileW - 1) / tileW),
+              rows    = (int)((bounds.height() + (int64_t)tileH - 1) / tileH);
+
+    // Making the surfaces up front lets each tile's clip be known before anything is drawn.
+    std::vector<sk_sp<SkSurface>> tiles;
+    std::vector<SkCanvas*> canvases;
+    tiles.reserve(columns * rows);
+    canvases.reserve(columns * rows);
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < columns; ++x) {
+            sk_sp<SkSurface> tile = SkSurfaces::Raster(tileInfo, props);
+            if (!tile) {
+                return {};
+            }
+            SkCanvas* canvas = tile->getCanvas();
+            canvas->save();
+            canvas->translate(-(bounds.fLeft + (SkScalar)x * tileW),
+                              -(bounds.fTop + (SkScalar)y * tileH));
+            canvas->clipIRect(bounds);
+            canvases.push_back(canvas);
+            tiles.push_back(std::move(tile));
+        }
+    }
+
+    sk_sp<const SkPicture> ref = sk_ref_sp(picture);
+    if (const SkBigPicture* bigPicture = SkPicturePriv::AsSkBigPicture(ref)) {
+        bigPicture->playback(canvases, executor);
+    } else {
+        auto draw = [&](int i) { canvases[i]->drawPicture(picture); };
+        if (executor) {
+            SkTaskGroup(*executor).batch((int)canvases.size(), draw);
+        } else {
+            for (int i = 0; i < (int)canvases.size(); ++i) {
+                draw(i);
+            }
+        }
+    }
+    for (SkCanvas* canvas : canvases) {
+        canvas->restore();
+    }
+    return tiles;
+}
+
+}  // namespace SkTiledPictureUtils
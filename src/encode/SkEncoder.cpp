@@ -7,7 +7,12 @@
 
 #include "include/encode/SkEncoder.h"
 
+#include "include/core/SkRect.h"
 #include "include/private/base/SkAssert.h"
+#include "src/core/SkTaskGroup.h"
+#include "src/encode/SkImageEncoderPriv.h"
+
+#include <atomic>
 
 bool SkEncoder::encodeRows(int numRows) {
     SkASSERT(numRows > 0 && fCurrRow < fSrc.height());
@@ -27,3 +32,45 @@ bool SkEncoder::encodeRows(int numRows) {
 
     return true;
 }
+
+std::vector<sk_sp<SkData>> SkEncodeTiles(
+        const SkPixmap& src,
+        SkISize tileSize,
+        SkExecutor* executor,
+        const std::function<sk_sp<SkData>(const SkPixmap& tile)>& encodeTile) {
+    if (!SkPixmapIsValid(src) || tileSize.isEmpty()) {
+        return {};
+    }
+
+    const int cols = (src.width()  + tileSize.width()  - 1) / tileSize.width(),
+              rows = (src.height() + tileSize.height() - 1) / tileSize.height();
+    std::vector<sk_sp<SkData>> tiles(cols * rows);
+    std::atomic<bool> failed{false};
+    auto encode = [&](int i) {
+        if (failed.load(std::memory_order_relaxed)) {
+            return;
+        }
+        SkPixmap tile;
+        SkAssertResult(src.extractSubset(&tile, SkIRect::MakeXYWH((i % cols) * tileSize.width(),
+                                                                  (i / cols) * tileSize.height(),
+                                                                  tileSize.width(),
+                                                                  tileSize.height())));
+        tiles[i] = encodeTile(tile);
+        if (!tiles[i]) {
+            failed.store(true, std::memory_order_relaxed);
+        }
+    };
+
+    if (executor) {
+        SkTaskGroup(*executor).batch(cols * rows, encode);
+    } else {
+        for (int i = 0; i < cols * rows; i++) {
+            encode(i);
+        }
+    }
+
+    if (failed.load()) {
+        return {};
+    }
+    return tiles;
+}
@@ -8,10 +8,18 @@
 #ifndef SkImageEncoderPriv_DEFINED
 #define SkImageEncoderPriv_DEFINED
 
+#include "include/core/SkData.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSize.h"
 #include "src/core/SkImageInfoPriv.h"
 
+#include <functional>
+#include <vector>
+
+class SkExecutor;
+
 static inline bool SkPixmapIsValid(const SkPixmap& src) {
     if (!SkImageInfoIsValid(src.info())) {
         return false;
@@ -24,4 +32,18 @@ static inline bool SkPixmapIsValid(const SkPixmap& src) {
     return true;
 }
 
+/**
+ *  Calls encodeTile on each tileSize tile of src, in row-major order from its top left, and
+ *  returns the results. Tiles in the last column and row are cropped to src. The tiles are
+ *  encoded concurrently on executor, or one after another if it is null.
+ *
+ *  Returns an empty vector if src is invalid, tileSize is empty, or any tile fails to encode
+ *  (encodeTile returns null).
+ */
+std::vector<sk_sp<SkData>> SkEncodeTiles(
+        const SkPixmap& src,
+        SkISize tileSize,
+        SkExecutor* executor,
+        const std::function<sk_sp<SkData>(const SkPixmap& tile)>& encodeTile);
+
 #endif // SkImageEncoderPriv_DEFINED
@@ -36,6 +36,7 @@
 #include <cstring>
 #include <memory>
 #include <utility>
+#include <vector>
 
 class GrDirectContext;
 class SkColorSpace;
@@ -384,6 +385,17 @@ bool SkJpegEncoderImpl::onEncodeRows(int numRows) {
     return true;
 }
 
+static SkJpegMetadataEncoder::SegmentList make_metadata_segments(
+        const SkJpegEncoder::Options& options, const SkColorSpace* colorSpace) {
+    SkJpegMetadataEncoder::SegmentList metadataSegments;
+    SkJpegMetadataEncoder::AppendXMPStandard(metadataSegments, options.xmpMetadata);
+    SkJpegMetadataEncoder::AppendICC(metadataSegments, options, colorSpace);
+    if (options.fOrigin.has_value()) {
+      SkJpegMetadataEncoder::AppendOrigin(metadataSegments, options.fOrigin.value());
+    }
+    return metadataSegments;
+}
+
 namespace SkJpegEncoder {
 
 bool Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
@@ -414,27 +426,33 @@ sk_sp<SkData> Encode(GrDirectContext* ctx, const SkImage* img, const Options& op
     return nullptr;
 }
 
+std::vector<sk_sp<SkData>> EncodeTiles(const SkPixmap& src,
+                                       SkISize tileSize,
+                                       const Options& options,
+                                       SkExecutor* executor) {
+    const SkJpegMetadataEncoder::SegmentList metadataSegments =
+            make_metadata_segments(options, src.colorSpace());
+    return SkEncodeTiles(src, tileSize, executor, [&](const SkPixmap& tile) -> sk_sp<SkData> {
+        SkDynamicMemoryWStream stream;
+        auto encoder = SkJpegEncoderImpl::MakeRGB(&stream, tile, options, metadataSegments);
+        if (!encoder || !encoder->encodeRows(tile.height())) {
+            return nullptr;
+        }
+        return stream.detachAsData();
+    });
+}
+
 std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Options& options) {
-    SkJpegMetadataEncoder::SegmentList metadataSegments;
-    SkJpegMetadataEncoder::AppendXMPStandard(metadataSegments, options.xmpMetadata);
-    SkJpegMetadataEncoder::AppendICC(metadataSegments, options, src.colorSpace());
-    if (options.fOrigin.has_value()) {
-      SkJpegMetadataEncoder::AppendOrigin(metadataSegments, options.fOrigin.value());
-    }
-    return SkJpegEncoderImpl::MakeRGB(dst, src, options, metadataSegments);
+    return SkJpegEncoderImpl::MakeRGB(
+            dst, src, options, make_metadata_segments(options, src.colorSpace()));
 }
 
 std::unique_ptr<SkEncoder> Make(SkWStream* dst,
                                 const SkYUVAPixmaps& src,
                                 const SkColorSpace* srcColorSpace,
                                 const Options& options) {
-    SkJpegMetadataEncoder::SegmentList metadataSegments;
-    SkJpegMetadataEncoder::AppendXMPStandard(metadataSegments, options.xmpMetadata);
-    SkJpegMetadataEncoder::AppendICC(metadataSegments, options, srcColorSpace);
-    if (options.fOrigin.has_value()) {
-      SkJpegMetadataEncoder::AppendOrigin(metadataSegments, options.fOrigin.value());
-    }
-    return SkJpegEncoderImpl::MakeYUV(dst, src, srcColorSpace, options, metadataSegments);
+    return SkJpegEncoderImpl::MakeYUV(
+            dst, src, srcColorSpace, options, make_metadata_segments(options, srcColorSpace));
 }
 
 }  // namespace SkJpegEncoder
@@ -13,6 +13,7 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRefCnt.h"
@@ -22,17 +23,23 @@
 #include "include/encode/SkPngEncoder.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkDebug.h"
+#include "include/private/base/SkMath.h"
 #include "include/private/base/SkNoncopyable.h"
 #include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
 #include "modules/skcms/skcms.h"
 #include "src/base/SkMSAN.h"
 #include "src/codec/SkPngPriv.h"
+#include "src/core/SkPngFilter.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/encode/SkImageEncoderFns.h"
 #include "src/encode/SkImageEncoderPriv.h"
 #include "src/image/SkImage_Base.h"
 
 #include <algorithm>
 #include <csetjmp>
+#include <cstddef>
+#include <cstdlib>
 #include <cstdint>
 #include <cstring>
 #include <memory>
@@ -41,6 +48,7 @@
 
 #include <png.h>
 #include <pngconf.h>
+#include "zlib.h"  // NO_G3_REWRITE
 
 class GrDirectContext;
 class SkImage;
@@ -86,8 +94,27 @@ public:
     png_infop infoPtr() { return fInfoPtr; }
     int pngBytesPerPixel() const { return fPngBytesPerPixel; }
     transform_scanline_proc proc() const { return fProc; }
-
-    ~SkPngEncoderMgr() { png_destroy_write_struct(&fPngPtr, &fInfoPtr); }
+    int filters() const { return fFilters; }
+    int zlibLevel() const { return fZLibLevel; }
+
+    // Whether rows can be filtered and deflated by Skia rather than by libpng, i.e. whether
+    // libpng would write the transformed rows unchanged.
+    bool canFilterRows();
+
+    // Starts filtering and deflating rows with Skia. Each row is then transformed into row()
+    // and written with writeRow(), which also ends the image after its last row. Must be called
+    // before writing any rows; if it is not, rows are written with png_write_rows().
+    bool beginFilteredRows(int width);
+    bool filteringRows() const { return fFilteringRows; }
+    uint8_t* row() { return fCurr; }
+    void writeRow(bool last);
+
+    ~SkPngEncoderMgr() {
+        if (fFilteringRows) {
+            deflateEnd(&fZStream);
+        }
+        png_destroy_write_struct(&fPngPtr, &fInfoPtr);
+    }
 
 private:
     SkPngEncoderMgr(png_structp pngPtr, png_infop infoPtr) : fPngPtr(pngPtr), fInfoPtr(infoPtr) {}
@@ -96,6 +123,18 @@ private:
     png_infop fInfoPtr;
     int fPngBytesPerPixel;
     transform_scanline_proc fProc;
+    int fFilters;
+    int fZLibLevel;
+
+    bool fFilteringRows = false;
+    size_t fRowBytes = 0;
+    std::vector<uint8_t> fRows;
+    uint8_t* fPrev = nullptr;
+    uint8_t* fCurr = nullptr;
+    uint8_t* fScratch = nullptr;
+    std::vector<uint8_t> fFiltered;
+    std::vector<uint8_t> fIDAT;
+    z_stream fZStream = {};
 };
 
 std::unique_ptr<SkPngEncoderMgr> SkPngEncoderMgr::Make(SkWStream* stream) {
@@ -234,13 +273,13 @@ bool SkPngEncoderMgr::setHeader(const SkImageInfo& srcInfo, const SkPngEncoder::
                  PNG_FILTER_TYPE_BASE);
     png_set_sBIT(fPngPtr, fInfoPtr, &sigBit);
 
-    int filters = (int)options.fFilterFlags & (int)SkPngEncoder::FilterFlag::kAll;
-    SkASSERT(filters == (int)options.fFilterFlags);
-    png_set_filter(fPngPtr, PNG_FILTER_TYPE_BASE, filters);
+    fFilters = (int)options.fFilterFlags & (int)SkPngEncoder::FilterFlag::kAll;
+    SkASSERT(fFilters == (int)options.fFilterFlags);
+    png_set_filter(fPngPtr, PNG_FILTER_TYPE_BASE, fFilters);
 
-    int zlibLevel = std::min(std::max(0, options.fZLibLevel), 9);
-    SkASSERT(zlibLevel == options.fZLibLevel);
-    png_set_compression_level(fPngPtr, zlibLevel);
+    fZLibLevel = std::min(std::max(0, options.fZLibLevel), 9);
+    SkASSERT(fZLibLevel == options.fZLibLevel);
+    png_set_compression_level(fPngPtr, fZLibLevel);
 
     // Set comments in tEXt chunk
     const sk_sp<SkDataTable>& comments = options.fComments;
@@ -478,26 +517,266 @@ bool SkPngEncoderImpl::onEncodeRows(int numRows) {
     for (int y = 0; y < numRows; y++) {
         sk_msan_assert_initialized(srcRow,
                                    (const uint8_t*)srcRow + (fSrc.width() << fSrc.shiftPerPixel()));
-        fEncoderMgr->proc()((char*)fStorage.get(),
-                            (const char*)srcRow,
-                            fSrc.width(),
-                            SkColorTypeBytesPerPixel(fSrc.colorType()));
-
-        png_bytep rowPtr = (png_bytep)fStorage.get();
-        png_write_rows(fEncoderMgr->pngPtr(), &rowPtr, 1);
+        if (fEncoderMgr->filteringRows()) {
+            fEncoderMgr->proc()((char*)fEncoderMgr->row(),
+                                (const char*)srcRow,
+                                fSrc.width(),
+                                SkColorTypeBytesPerPixel(fSrc.colorType()));
+            fEncoderMgr->writeRow(fCurrRow + y + 1 == fSrc.height());
+        } else {
+            fEncoderMgr->proc()((char*)fStorage.get(),
+                                (const char*)srcRow,
+                                fSrc.width(),
+                                SkColorTypeBytesPerPixel(fSrc.colorType()));
+
+            png_bytep rowPtr = (png_bytep)fStorage.get();
+            png_write_rows(fEncoderMgr->pngPtr(), &rowPtr, 1);
+        }
         srcRow = SkTAddOffset<const void>(srcRow, fSrc.rowBytes());
     }
 
     fCurrRow += numRows;
-    if (fCurrRow == fSrc.height()) {
+    if (fCurrRow == fSrc.height() && !fEncoderMgr->filteringRows()) {
         png_write_end(fEncoderMgr->pngPtr(), fEncoderMgr->infoPtr());
     }
 
     return true;
 }
 
-namespace SkPngEncoder {
-std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Options& options) {
+// libpng treats an empty set of filters as kNone.
+static int filters_or_none(int filters) {
+    return filters ? filters : (int)SkPngEncoder::FilterFlag::kNone;
+}
+
+// Writes the filter type byte and the filtered |row| to |dst|. When |filters| allows more than
+// one filter, this picks the one whose output has the smallest sum of absolute (signed) values,
+// the same heuristic libpng uses. |row| and |prev| (the unfiltered row above) must be preceded
+// by bpp zero bytes, and |scratch| must hold rowBytes bytes.
+static void filter_row(int filters, const uint8_t* row, const uint8_t* prev, size_t rowBytes,
+                       size_t bpp, uint8_t* dst, uint8_t* scratch) {
+    uint8_t* best = nullptr;
+    uint64_t bestSum = UINT64_MAX;
+    for (int type = 0; type <= 4; type++) {
+        if (!(filters & ((int)SkPngEncoder::FilterFlag::kNone << type))) {
+            continue;
+        }
+        uint8_t* out = best == dst + 1 ? scratch : dst + 1;
+        uint64_t sum = SkOpts::png_filter_row(type, row, prev, rowBytes, bpp, out, bestSum);
+        if (sum < bestSum) {
+            bestSum = sum;
+            best = out;
+            dst[0] = type;
+        }
+    }
+    if (best == scratch) {
+        memcpy(dst + 1, scratch, rowBytes);
+    }
+}
+
+// Matches libpng's default IDAT chunk size.
+static constexpr size_t kIDATBytes = 8192;
+
+bool SkPngEncoderMgr::canFilterRows() {
+    return fProc && png_get_rowbytes(fPngPtr, fInfoPtr) ==
+                            (size_t)fPngBytesPerPixel * png_get_image_width(fPngPtr, fInfoPtr);
+}
+
+bool SkPngEncoderMgr::beginFilteredRows(int width) {
+    SkASSERT(this->canFilterRows() && !fFilteringRows);
+    const size_t bpp = fPngBytesPerPixel;
+    fRowBytes = bpp * width;
+    // The rows are preceded by a pixel of zeros, which the filters treat as the pixel left of
+    // the first one.
+    fRows.assign(2 * (bpp + fRowBytes) + fRowBytes, 0);
+    fPrev = fRows.data() + bpp;
+    fCurr = fPrev + fRowBytes + bpp;
+    fScratch = fCurr + fRowBytes;
+    fFiltered.resize(fRowBytes + 1);
+    fIDAT.resize(kIDATBytes);
+
+    const int strategy = filters_or_none(fFilters) == (int)SkPngEncoder::FilterFlag::kNone
+                                 ? Z_DEFAULT_STRATEGY
+                                 : Z_FILTERED;
+    if (Z_OK != deflateInit2(&fZStream, fZLibLevel, Z_DEFLATED, 15, 8, strategy)) {
+        return false;
+    }
+    fZStream.next_out = fIDAT.data();
+    fZStream.avail_out = SkToUInt(fIDAT.size());
+    fFilteringRows = true;
+    return true;
+}
+
+void SkPngEncoderMgr::writeRow(bool last) {
+    SkASSERT(fFilteringRows);
+    filter_row(filters_or_none(fFilters), fCurr, fPrev, fRowBytes, fPngBytesPerPixel,
+               fFiltered.data(), fScratch);
+    std::swap(fPrev, fCurr);
+
+    fZStream.next_in = fFiltered.data();
+    fZStream.avail_in = SkToUInt(fFiltered.size());
+    for (;;) {
+        const int result = deflate(&fZStream, last ? Z_FINISH : Z_NO_FLUSH);
+        if (result != Z_OK && result != Z_STREAM_END) {
+            png_error(fPngPtr, "zlib failed to deflate a row");
+        }
+        if (fZStream.avail_out == 0 || result == Z_STREAM_END) {
+            png_write_chunk(fPngPtr, (png_const_bytep)"IDAT", fIDAT.data(),
+                            fIDAT.size() - fZStream.avail_out);
+            fZStream.next_out = fIDAT.data();
+            fZStream.avail_out = SkToUInt(fIDAT.size());
+        }
+        if (last ? result == Z_STREAM_END : fZStream.avail_in == 0) {
+            break;
+        }
+    }
+    if (last) {
+        png_write_chunk(fPngPtr, (png_const_bytep)"IEND", nullptr, 0);
+    }
+}
+
+// Encoding rows in parallel works like pigz: the image is split into bands of rows that are
+// transformed, filtered and deflated independently. Each band is raw deflate data, primed with
+// the last 32KB of the (filtered) band above it and ended on a byte boundary with Z_SYNC_FLUSH,
+// so the bands concatenate into a single zlib stream. The band size does not depend on the
+// number of threads, so neither does the output.
+static constexpr size_t kParallelBandBytes = 256 * 1024;
+static constexpr size_t kDeflateWindowBytes = 32 * 1024;
+
+namespace {
+struct PngBand {
+    int fTop;
+    int fBottom;
+    std::vector<uint8_t> fDeflated;
+    uLong fAdler = 1;
+    size_t fFilteredBytes = 0;
+    bool fSuccess = false;
+};
+}  // namespace
+
+static bool deflate_band(const SkPixmap& src,
+                         transform_scanline_proc proc,
+                         size_t rowBytes,
+                         size_t bpp,
+                         int filters,
+                         int zlibLevel,
+                         bool last,
+                         PngBand* band) {
+    const size_t filteredRowBytes = rowBytes + 1;
+    // Filter enough of the rows above this band to recreate the dictionary that the band above
+    // ends with.
+    const int dictionaryRows = std::min<int>(
+            band->fTop, SkToInt((kDeflateWindowBytes + filteredRowBytes - 1) / filteredRowBytes));
+    const int firstRow = band->fTop - dictionaryRows;
+
+    std::vector<uint8_t> filtered((band->fBottom - firstRow) * filteredRowBytes);
+    // The unfiltered rows are preceded by a pixel of zeros, which the filters treat as the
+    // pixel left of the first one.
+    std::vector<uint8_t> rows(2 * (bpp + rowBytes) + rowBytes, 0);
+    uint8_t* prev = rows.data() + bpp;
+    uint8_t* curr = prev + rowBytes + bpp;
+    uint8_t* scratch = curr + rowBytes;
+    const int srcBpp = SkColorTypeBytesPerPixel(src.colorType());
+    filters = filters_or_none(filters);
+    if (firstRow > 0) {
+        proc((char*)prev, (const char*)src.addr(0, firstRow - 1), src.width(), srcBpp);
+    }
+    for (int y = firstRow; y < band->fBottom; y++) {
+        proc((char*)curr, (const char*)src.addr(0, y), src.width(), srcBpp);
+        filter_row(filters, curr, prev, rowBytes, bpp,
+                   filtered.data() + (y - firstRow) * filteredRowBytes, scratch);
+        std::swap(prev, curr);
+    }
+
+    const size_t dictionaryBytes = dictionaryRows * filteredRowBytes;
+    const uint8_t* bandData = filtered.data() + dictionaryBytes;
+    const size_t bandSize = filtered.size() - dictionaryBytes;
+
+    z_stream zstream = {};
+    const int strategy = filters == (int)SkPngEncoder::FilterFlag::kNone ? Z_DEFAULT_STRATEGY
+                                                                         : Z_FILTERED;
+    if (Z_OK != deflateInit2(&zstream, zlibLevel, Z_DEFLATED, -15, 8, strategy)) {
+        return false;
+    }
+    if (dictionaryBytes > 0) {
+        const size_t dictionarySize = std::min(kDeflateWindowBytes, dictionaryBytes);
+        if (Z_OK != deflateSetDictionary(&zstream, bandData - dictionarySize,
+                                         SkToUInt(dictionarySize))) {
+            deflateEnd(&zstream);
+            return false;
+        }
+    }
+
+    // deflateBound() does not account for the empty stored block that Z_SYNC_FLUSH ends with.
+    band->fDeflated.resize(deflateBound(&zstream, bandSize) + 16);
+    zstream.next_in = const_cast<Bytef*>(bandData);
+    zstream.avail_in = SkToUInt(bandSize);
+    zstream.next_out = band->fDeflated.data();
+    zstream.avail_out = SkToUInt(band->fDeflated.size());
+    const int result = deflate(&zstream, last ? Z_FINISH : Z_SYNC_FLUSH);
+    const bool success = (last ? result == Z_STREAM_END : result == Z_OK) &&
+                         zstream.avail_in == 0 && zstream.avail_out > 0;
+    band->fDeflated.resize(zstream.total_out);
+    deflateEnd(&zstream);
+
+    band->fAdler = adler32(1, bandData, SkToUInt(bandSize));
+    band->fFilteredBytes = bandSize;
+    return success;
+}
+
+// Returns the second byte of the zlib header that zlib itself would write at |level|.
+static uint8_t zlib_header_flags(int level) {
+    const int flevel = level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+    const int header = (0x78 << 8) | (flevel << 6);
+    return (uint8_t)((header + 31 - header % 31) & 0xff);
+}
+
+static bool encode_rows_in_parallel(SkPngEncoderMgr* encoderMgr,
+                                    const SkPixmap& src,
+                                    const SkPngEncoder::Options& options) {
+    const size_t rowBytes = (size_t)encoderMgr->pngBytesPerPixel() * src.width();
+    const size_t bpp = encoderMgr->pngBytesPerPixel();
+    const int rowsPerBand = std::max(1, SkToInt(kParallelBandBytes / (rowBytes + 1)));
+    const int bandCount = (src.height() + rowsPerBand - 1) / rowsPerBand;
+
+    std::vector<PngBand> bands(bandCount);
+    for (int i = 0; i < bandCount; i++) {
+        bands[i].fTop = i * rowsPerBand;
+        bands[i].fBottom = std::min(src.height(), bands[i].fTop + rowsPerBand);
+    }
+    SkTaskGroup(*options.fExecutor).batch(bandCount, [&](int i) {
+        bands[i].fSuccess = deflate_band(src, encoderMgr->proc(), rowBytes, bpp,
+                                         encoderMgr->filters(), encoderMgr->zlibLevel(),
+                                         i == bandCount - 1, &bands[i]);
+    });
+
+    uLong adler = 1;
+    for (const PngBand& band : bands) {
+        if (!band.fSuccess) {
+            return false;
+        }
+        adler = adler32_combine(adler, band.fAdler, band.fFilteredBytes);
+    }
+    const uint8_t header[] = {0x78, zlib_header_flags(encoderMgr->zlibLevel())};
+    bands.front().fDeflated.insert(bands.front().fDeflated.begin(), header, header + 2);
+    const uint8_t trailer[] = {(uint8_t)(adler >> 24), (uint8_t)(adler >> 16),
+                               (uint8_t)(adler >> 8), (uint8_t)adler};
+    bands.back().fDeflated.insert(bands.back().fDeflated.end(), trailer, trailer + 4);
+
+    png_structp pngPtr = encoderMgr->pngPtr();
+    if (setjmp(png_jmpbuf(pngPtr))) {
+        return false;
+    }
+    for (const PngBand& band : bands) {
+        png_write_chunk(pngPtr, (png_const_bytep)"IDAT", band.fDeflated.data(),
+                        band.fDeflated.size());
+    }
+    png_write_chunk(pngPtr, (png_const_bytep)"IEND", nullptr, 0);
+    return true;
+}
+
+static std::unique_ptr<SkPngEncoderMgr> make_encoder_mgr(SkWStream* dst,
+                                                         const SkPixmap& src,
+                                                         const SkPngEncoder::Options& options) {
     if (!SkPixmapIsValid(src)) {
         return nullptr;
     }
@@ -520,13 +799,38 @@ std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Optio
     }
 
     encoderMgr->chooseProc(src.info());
+    return encoderMgr;
+}
 
+namespace SkPngEncoder {
+std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Options& options) {
+    std::unique_ptr<SkPngEncoderMgr> encoderMgr = make_encoder_mgr(dst, src, options);
+    if (!encoderMgr) {
+        return nullptr;
+    }
+    if (encoderMgr->canFilterRows() && !encoderMgr->beginFilteredRows(src.width())) {
+        return nullptr;
+    }
     return std::make_unique<SkPngEncoderImpl>(std::move(encoderMgr), src);
 }
 
 bool Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
-    auto encoder = Make(dst, src, options);
-    return encoder.get() && encoder->encodeRows(src.height());
+    std::unique_ptr<SkPngEncoderMgr> encoderMgr = make_encoder_mgr(dst, src, options);
+    if (!encoderMgr) {
+        return false;
+    }
+    // Rows that libpng itself transforms (e.g. dropping the alpha of opaque F16) are always
+    // filtered and deflated serially by libpng.
+    if (encoderMgr->canFilterRows()) {
+        if (options.fExecutor) {
+            return encode_rows_in_parallel(encoderMgr.get(), src, options);
+        }
+        if (!encoderMgr->beginFilteredRows(src.width())) {
+            return false;
+        }
+    }
+    SkPngEncoderImpl encoder(std::move(encoderMgr), src);
+    return encoder.encodeRows(src.height());
 }
 
 sk_sp<SkData> Encode(GrDirectContext* ctx, const SkImage* img, const Options& options) {
@@ -17,6 +17,7 @@
 #include "include/core/SkSpan.h"
 #include "include/core/SkStream.h"
 #include "include/encode/SkEncoder.h"
+#include "include/private/base/SkMutex.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/core/SkImageInfoPriv.h"
 #include "src/encode/SkImageEncoderFns.h"
@@ -26,6 +27,8 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <utility>
+#include <vector>
 
 class GrDirectContext;
 class SkImage;
@@ -51,10 +54,13 @@ static int stream_writer(const uint8_t* data, size_t data_size, const WebPPictur
 
 using WebPPictureImportProc = int (*)(WebPPicture* picture, const uint8_t* pixels, int stride);
 
+// |scratch| holds the pixels converted for libwebp, if they need to be. Its pixels are reused if
+// they are large enough.
 static bool preprocess_webp_picture(WebPPicture* pic,
                                     WebPConfig* webp_config,
                                     const SkPixmap& pixmap,
-                                    const SkWebpEncoder::Options& opts) {
+                                    const SkWebpEncoder::Options& opts,
+                                    SkBitmap* scratch) {
     if (!SkPixmapIsValid(pixmap)) {
         return false;
     }
@@ -92,7 +98,7 @@ static bool preprocess_webp_picture(WebPPicture* pic,
         const SkColorType ct = pixmap.colorType();
         const bool premul = pixmap.alphaType() == kPremul_SkAlphaType;
 
-        SkBitmap tmpBm;
+        SkPixmap tmp;
         WebPPictureImportProc importProc = nullptr;
         const SkPixmap* src = &pixmap;
         if (ct == kRGB_888x_SkColorType) {
@@ -110,11 +116,17 @@ static bool preprocess_webp_picture(WebPPicture* pic,
             auto info = pixmap.info()
                                 .makeColorType(kRGBA_8888_SkColorType)
                                 .makeAlphaType(kUnpremul_SkAlphaType);
-            if (!tmpBm.tryAllocPixels(info) ||
-                !pixmap.readPixels(tmpBm.info(), tmpBm.getPixels(), tmpBm.rowBytes())) {
+            if (scratch->width() < info.width() || scratch->height() < info.height() ||
+                scratch->colorType() != info.colorType()) {
+                if (!scratch->tryAllocPixels(info)) {
+                    return false;
+                }
+            }
+            tmp.reset(info, scratch->getPixels(), scratch->rowBytes());
+            if (!pixmap.readPixels(tmp)) {
                 return false;
             }
-            src = &tmpBm.pixmap();
+            src = &tmp;
         }
 
         if (!importProc(pic, reinterpret_cast<const uint8_t*>(src->addr()), src->rowBytes())) {
@@ -125,13 +137,12 @@ static bool preprocess_webp_picture(WebPPicture* pic,
     return true;
 }
 
-namespace SkWebpEncoder {
-
-bool Encode(SkWStream* stream, const SkPixmap& pixmap, const Options& opts) {
-    if (!stream) {
-        return false;
-    }
-
+// |icc| is the profile to embed, if any.
+static bool encode_webp(SkWStream* stream,
+                        const SkPixmap& pixmap,
+                        const SkWebpEncoder::Options& opts,
+                        const SkData* icc,
+                        SkBitmap* scratch) {
     WebPConfig webp_config;
     if (!WebPConfigPreset(&webp_config, WEBP_PRESET_DEFAULT, opts.fQuality)) {
         return false;
@@ -143,15 +154,13 @@ bool Encode(SkWStream* stream, const SkPixmap& pixmap, const Options& opts) {
     }
     SkAutoTCallVProc<WebPPicture, WebPPictureFree> autoPic(&pic);
 
-    if (!preprocess_webp_picture(&pic, &webp_config, pixmap, opts)) {
+    if (!preprocess_webp_picture(&pic, &webp_config, pixmap, opts, scratch)) {
         return false;
     }
 
     // If there is no need to embed an ICC profile, we write directly to the input stream.
     // Otherwise, we will first encode to |tmp| and use a mux to add the ICC chunk.  libwebp
     // forces us to have an encoded image before we can add a profile.
-    sk_sp<SkData> icc =
-            icc_from_color_space(pixmap.info(), opts.fICCProfile, opts.fICCProfileDescription);
     SkDynamicMemoryWStream tmp;
     pic.custom_ptr = icc ? (void*)&tmp : (void*)stream;
     pic.writer = stream_writer;
@@ -188,6 +197,51 @@ bool Encode(SkWStream* stream, const SkPixmap& pixmap, const Options& opts) {
     return true;
 }
 
+namespace SkWebpEncoder {
+
+bool Encode(SkWStream* stream, const SkPixmap& pixmap, const Options& opts) {
+    if (!stream) {
+        return false;
+    }
+
+    sk_sp<SkData> icc =
+            icc_from_color_space(pixmap.info(), opts.fICCProfile, opts.fICCProfileDescription);
+    SkBitmap scratch;
+    return encode_webp(stream, pixmap, opts, icc.get(), &scratch);
+}
+
+std::vector<sk_sp<SkData>> EncodeTiles(const SkPixmap& src,
+                                       SkISize tileSize,
+                                       const Options& opts,
+                                       SkExecutor* executor) {
+    const sk_sp<SkData> icc =
+            icc_from_color_space(src.info(), opts.fICCProfile, opts.fICCProfileDescription);
+
+    // Scratch bitmaps not in use by a tile. There are only ever as many as tiles encoded at once.
+    SkMutex scratchMutex;
+    std::vector<std::unique_ptr<SkBitmap>> scratchPool;
+    return SkEncodeTiles(src, tileSize, executor, [&](const SkPixmap& tile) -> sk_sp<SkData> {
+        std::unique_ptr<SkBitmap> scratch;
+        {
+            SkAutoMutexExclusive lock(scratchMutex);
+            if (!scratchPool.empty()) {
+                scratch = std::move(scratchPool.back());
+                scratchPool.pop_back();
+            }
+        }
+        if (!scratch) {
+            scratch = std::make_unique<SkBitmap>();
+        }
+
+        SkDynamicMemoryWStream stream;
+        const bool success = encode_webp(&stream, tile, opts, icc.get(), scratch.get());
+
+        SkAutoMutexExclusive lock(scratchMutex);
+        scratchPool.push_back(std::move(scratch));
+        return success ? stream.detachAsData() : nullptr;
+    });
+}
+
 bool EncodeAnimated(SkWStream* stream, SkSpan<const SkEncoder::Frame> frames, const Options& opts) {
     if (!stream || frames.empty()) {
         return false;
@@ -196,6 +250,7 @@ bool EncodeAnimated(SkWStream* stream, SkSpan<const SkEncoder::Frame> frames, co
     const int canvasWidth = frames.front().pixmap.width();
     const int canvasHeight = frames.front().pixmap.height();
     int timestamp = 0;
+    SkBitmap scratch;
 
     std::unique_ptr<WebPAnimEncoder, void (*)(WebPAnimEncoder*)> enc(
             WebPAnimEncoderNew(canvasWidth, canvasHeight, nullptr), WebPAnimEncoderDelete);
@@ -221,7 +276,7 @@ bool EncodeAnimated(SkWStream* stream, SkSpan<const SkEncoder::Frame> frames, co
         }
         SkAutoTCallVProc<WebPPicture, WebPPictureFree> autoPic(&pic);
 
-        if (!preprocess_webp_picture(&pic, &webp_config, pixmap, opts)) {
+        if (!preprocess_webp_picture(&pic, &webp_config, pixmap, opts, &scratch)) {
             return false;
         }
 
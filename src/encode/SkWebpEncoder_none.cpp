@@ -10,7 +10,10 @@
 #include "include/encode/SkWebpEncoder.h"
 #include "include/private/base/SkAssert.h"
 
+#include <vector>
+
 class GrDirectContext;
+class SkExecutor;
 class SkImage;
 class SkPixmap;
 class SkWStream;
@@ -27,4 +30,9 @@ sk_sp<SkData> Encode(GrDirectContext*, const SkImage*, const Options&) {
     return nullptr;
 }
 
+std::vector<sk_sp<SkData>> EncodeTiles(const SkPixmap&, SkISize, const Options&, SkExecutor*) {
+    SkDEBUGFAIL("Using encoder stub");
+    return {};
+}
+
 }  // namespace SkWebpEncoder
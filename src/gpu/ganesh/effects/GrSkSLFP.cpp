@@ -51,7 +51,7 @@ class GrSkSLFP::Impl : public ProgramImpl {
 public:
     void emitCode(EmitArgs& args) override {
         const GrSkSLFP& fp            = args.fFp.cast<GrSkSLFP>();
-        const SkSL::Program& program  = *fp.fEffect->fBaseProgram;
+        const SkSL::Program& program  = fp.fEffect->baseProgram();
 
         class FPCallbacks : public SkSL::PipelineStage::Callbacks {
         public:
@@ -46,6 +46,10 @@ GrRecordingContext* SkSurface_Base::onGetRecordingContext() const { return nullp
 
 skgpu::graphite::Recorder* SkSurface_Base::onGetRecorder() const { return nullptr; }
 
+bool SkSurface_Base::onReadPixels(const SkPixmap& dst, int srcX, int srcY) {
+    return this->getCachedCanvas()->readPixels(dst, srcX, srcY);
+}
+
 void SkSurface_Base::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y,
                             const SkSamplingOptions& sampling, const SkPaint* paint) {
     auto image = this->makeImageSnapshot();
@@ -0,0 +1,630 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/image/SkSurface_RasterTiled.h"
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkCapabilities.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkMallocPixelRef.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPixelRef.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSpan.h"
+#include "include/core/SkSurface.h"
+#include "include/core/SkSurfaceProps.h"
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
+#include "include/utils/SkNWayCanvas.h"
+#include "src/core/SkBigPicture.h"
+#include "src/core/SkImagePriv.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecorder.h"
+#include "src/core/SkRecords.h"
+#include "src/core/SkSurfacePriv.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace skia_private;
+
+namespace {
+
+// The canvas handed out by SkSurface_RasterTiled. It forwards everything to the surface's
+// SkRecorder, and tells the surface about each draw so that outstanding snapshots are detached
+// (copy-on-write) just as SkCanvas::predrawNotify() does for a regular raster surface.
+class TiledRecordingCanvas final : public SkNWayCanvas {
+public:
+    explicit TiledRecordingCanvas(SkSurface_RasterTiled* surface)
+            : SkNWayCanvas(surface->width(), surface->height())
+            , fSurface(surface) {
+        this->addCanvas(surface->recorder());
+    }
+
+protected:
+    SkImageInfo onImageInfo() const override { return fSurface->imageInfo(); }
+
+    bool onGetProps(SkSurfaceProps* props, bool) const override {
+        if (props) {
+            *props = fSurface->props();
+        }
+        return true;
+    }
+
+    sk_sp<SkSurface> onNewSurface(const SkImageInfo& info, const SkSurfaceProps& props) override {
+        return SkSurfaces::Raster(info, &props);
+    }
+
+    bool onPeekPixels(SkPixmap* pixmap) override { return fSurface->peekFlushedPixels(pixmap); }
+    bool onAccessTopLayerPixels(SkPixmap* pixmap) override {
+        return fSurface->accessFlushedTopLayerPixels(pixmap);
+    }
+
+    void onDiscard() override {
+        fSurface->notifyContentWillChange(SkSurface::kDiscard_ContentChangeMode);
+    }
+
+    void onDrawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawDRRect(outer, inner, paint);
+    }
+    void onDrawGlyphRunList(const sktext::GlyphRunList& list, const SkPaint& paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawGlyphRunList(list, paint);
+    }
+    void onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
+                        const SkPaint& paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawTextBlob(blob, x, y, paint);
+    }
+    void onDrawSlug(const sktext::gpu::Slug* slug, const SkPaint& paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawSlug(slug, paint);
+    }
+    void onDrawPatch(const SkPoint cubics[12], const SkColor colors[4], const SkPoint texCoords[4],
+                     SkBlendMode mode, const SkPaint& paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawPatch(cubics, colors, texCoords, mode, paint);
+    }
+    void onDrawPaint(const SkPaint& paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawPaint(paint);
+    }
+    void onDrawBehind(const SkPaint& paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawBehind(paint);
+    }
+    void onDrawPoints(PointMode mode, size_t count, const SkPoint pts[],
+                      const SkPaint& paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawPoints(mode, count, pts, paint);
+    }
+    void onDrawRect(const SkRect& rect, const SkPaint& paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawRect(rect, paint);
+    }
+    void onDrawRegion(const SkRegion& region, const SkPaint& paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawRegion(region, paint);
+    }
+    void onDrawOval(const SkRect& rect, const SkPaint& paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawOval(rect, paint);
+    }
+    void onDrawArc(const SkRect& rect, SkScalar startAngle, SkScalar sweepAngle, bool useCenter,
+                   const SkPaint& paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawArc(rect, startAngle, sweepAngle, useCenter, paint);
+    }
+    void onDrawRRect(const SkRRect& rrect, const SkPaint& paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawRRect(rrect, paint);
+    }
+    void onDrawPath(const SkPath& path, const SkPaint& paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawPath(path, paint);
+    }
+    void onDrawImage2(const SkImage* image, SkScalar x, SkScalar y,
+                      const SkSamplingOptions& sampling, const SkPaint* paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawImage2(image, x, y, sampling, paint);
+    }
+    void onDrawImageRect2(const SkImage* image, const SkRect& src, const SkRect& dst,
+                          const SkSamplingOptions& sampling, const SkPaint* paint,
+                          SrcRectConstraint constraint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawImageRect2(image, src, dst, sampling, paint, constraint);
+    }
+    void onDrawImageLattice2(const SkImage* image, const Lattice& lattice, const SkRect& dst,
+                             SkFilterMode filter, const SkPaint* paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawImageLattice2(image, lattice, dst, filter, paint);
+    }
+    void onDrawAtlas2(const SkImage* image, const SkRSXform xform[], const SkRect tex[],
+                      const SkColor colors[], int count, SkBlendMode mode,
+                      const SkSamplingOptions& sampling, const SkRect* cull,
+                      const SkPaint* paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawAtlas2(image, xform, tex, colors, count, mode, sampling, cull,
+                                         paint);
+    }
+    void onDrawVerticesObject(const SkVertices* vertices, SkBlendMode mode,
+                              const SkPaint& paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawVerticesObject(vertices, mode, paint);
+    }
+    void onDrawMesh(const SkMesh& mesh, sk_sp<SkBlender> blender, const SkPaint& paint) override {
+        this->willDraw();
+        fSurface->recorder()->drawMesh(mesh, std::move(blender), paint);
+    }
+    void onDrawShadowRec(const SkPath& path, const SkDrawShadowRec& rec) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawShadowRec(path, rec);
+    }
+    void onDrawPicture(const SkPicture* picture, const SkMatrix* matrix,
+                       const SkPaint* paint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawPicture(picture, matrix, paint);
+    }
+    void onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawDrawable(drawable, matrix);
+    }
+    void onDrawEdgeAAQuad(const SkRect& rect, const SkPoint clip[4], QuadAAFlags aa,
+                          const SkColor4f& color, SkBlendMode mode) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawEdgeAAQuad(rect, clip, aa, color, mode);
+    }
+    void onDrawEdgeAAImageSet2(const ImageSetEntry set[], int count, const SkPoint dstClips[],
+                               const SkMatrix preViewMatrices[], const SkSamplingOptions& sampling,
+                               const SkPaint* paint, SrcRectConstraint constraint) override {
+        this->willDraw();
+        this->SkNWayCanvas::onDrawEdgeAAImageSet2(set, count, dstClips, preViewMatrices, sampling,
+                                                  paint, constraint);
+    }
+
+private:
+    void willDraw() {
+        fSurface->notifyContentWillChange(SkSurface::kRetain_ContentChangeMode);
+    }
+
+    SkSurface_RasterTiled* fSurface;
+};
+
+// What an op does to the canvas state, as far as SkSurface_RasterTiled::flushPendingOps() cares.
+enum class OpKind { kDraw, kControl, kSave, kLayer, kRestore };
+
+struct GetOpKind {
+    template <typename T> OpKind operator()(const T&) {
+        return (T::kTags & SkRecords::kDraw_Tag) ? OpKind::kDraw : OpKind::kControl;
+    }
+    OpKind operator()(const SkRecords::Save&)       { return OpKind::kSave; }
+    OpKind operator()(const SkRecords::SaveLayer&)  { return OpKind::kLayer; }
+    OpKind operator()(const SkRecords::SaveBehind&) { return OpKind::kLayer; }
+    OpKind operator()(const SkRecords::Restore&)    { return OpKind::kRestore; }
+};
+
+// Where and with what an OpQueue draws.
+struct OpTarget {
+    const SkBitmap&         bitmap;
+    const SkSurfaceProps&   props;
+    const SkRecord&         record;
+    SkSpan<const int>       stateOps;  // Flushed ops that set up the canvas state
+    SkPicture const* const* drawablePicts;
+    int                     drawableCount;
+};
+
+// The ops one canvas draws during a flush, in order. The canvas covers the whole bitmap, and is
+// only made once there is something to draw.
+class OpQueue {
+public:
+    void push(int op) { fOps.push_back(op); }
+
+    bool hasOpsBefore(int end) const { return fNext < fOps.size() && fOps[fNext] < end; }
+
+    // Draws the ops before end that have not been drawn yet.
+    void drawOpsBefore(int end, const OpTarget& target) {
+        if (!this->hasOpsBefore(end)) {
+            return;
+        }
+        if (!fCanvas) {
+            fCanvas = std::make_unique<SkCanvas>(target.bitmap, target.props);
+            fDraw = std::make_unique<SkRecords::Draw>(fCanvas.get(), target.drawablePicts,
+                                                      nullptr, target.drawableCount);
+            for (int op : target.stateOps) {
+                target.record.visit(op, *fDraw);
+            }
+        }
+        while (this->hasOpsBefore(end)) {
+            target.record.visit(fOps[fNext++], *fDraw);
+        }
+    }
+
+    const SkCanvas* canvas() const { return fCanvas.get(); }
+
+private:
+    std::vector<int>                 fOps;
+    size_t                           fNext = 0;
+    std::unique_ptr<SkCanvas>        fCanvas;
+    std::unique_ptr<SkRecords::Draw> fDraw;
+};
+
+// Finds the first layer (or save-behind) among the visited ops that has not been restored yet.
+// Ops must be visited in order, starting at firstOp. Restores of saves from before firstOp are
+// ignored.
+class FirstOpenLayer {
+public:
+    explicit FirstOpenLayer(int firstOp) : fIndex(firstOp) {}
+
+    template <typename T> void operator()(const T&) { fIndex++; }
+
+    void operator()(const SkRecords::Save&) { this->push(false); }
+    void operator()(const SkRecords::SaveLayer&) { this->push(true); }
+    void operator()(const SkRecords::SaveBehind&) { this->push(true); }
+    void operator()(const SkRecords::Restore&) {
+        if (!fSaves.empty()) {
+            fSaves.pop_back();
+        }
+        fIndex++;
+    }
+
+    // Returns the index of that layer, or -1 if every visited layer was restored.
+    int index() const {
+        for (const Save& save : fSaves) {
+            if (save.fIsLayer) {
+                return save.fIndex;
+            }
+        }
+        return -1;
+    }
+
+private:
+    struct Save {
+        int  fIndex;
+        bool fIsLayer;
+    };
+
+    void push(bool isLayer) {
+        fSaves.push_back({fIndex, isLayer});
+        fIndex++;
+    }
+
+    int               fIndex;
+    std::vector<Save> fSaves;
+};
+
+}  // namespace
+
+SkSurface_RasterTiled::SkSurface_RasterTiled(const SkImageInfo& info, sk_sp<SkPixelRef> pr,
+                                             SkExecutor* executor, SkISize tileSize,
+                                             const SkSurfaceProps* props)
+        : SkSurface_Base(pr->width(), pr->height(), props)
+        , fExecutor(executor)
+        , fTileSize(tileSize) {
+    fBitmap.setInfo(info, pr->rowBytes());
+    fBitmap.setPixelRef(std::move(pr), 0, 0);
+    this->resetRecording();
+}
+
+SkSurface_RasterTiled::~SkSurface_RasterTiled() = default;
+
+void SkSurface_RasterTiled::resetRecording() {
+    const SkRect bounds = SkRect::Make(fBitmap.dimensions());
+    fRecord = sk_make_sp<SkRecord>();
+    if (fRecorder) {
+        fRecorder->reset(fRecord.get(), bounds);
+    } else {
+        fRecorder = std::make_unique<SkRecorder>(fRecord.get(), bounds);
+    }
+    fFlushedOpCount = 0;
+    fLiveStateOps.clear();
+    fLiveSaves.clear();
+    fFlushedCTM = SkMatrix::I();
+}
+
+void SkSurface_RasterTiled::flushPendingOps() {
+    const int recordCount = fRecord->count();
+    if (recordCount == fFlushedOpCount) {
+        return;
+    }
+
+    // The contents of a layer only reach the pixels when it is restored, and then with its
+    // alpha, blend mode and filters, so the ops from the first layer still open on are left
+    // pending. Ops before fFlushedOpCount have no open layers, as they were flushed.
+    FirstOpenLayer firstOpenLayer(fFlushedOpCount);
+    for (int i = fFlushedOpCount; i < recordCount; ++i) {
+        fRecord->visit(i, firstOpenLayer);
+    }
+    const int firstOp = fFlushedOpCount;
+    const int opCount = firstOpenLayer.index() < 0 ? recordCount : firstOpenLayer.index();
+    if (opCount == firstOp) {
+        return;
+    }
+
+    // Only the pending ops need bounds. They start out with the matrix and saves that the
+    // flushed ops left behind.
+    const SkIRect surfaceBounds = SkIRect::MakeSize(fBitmap.dimensions());
+    AutoTArray<SkRect> opBounds(recordCount - firstOp);
+    AutoTArray<SkBBoxHierarchy::Metadata> meta(recordCount - firstOp);
+    SkRecordFillBounds(SkRect::Make(surfaceBounds), *fRecord, firstOp, fFlushedCTM,
+                       SkToInt(fLiveSaves.size()), opBounds.data(), meta.data());
+
+    const int tileW = fTileSize.width(),
+              tileH = fTileSize.height(),
+              tilesX = (fBitmap.width()  + tileW - 1) / tileW,
+              tilesY = (fBitmap.height() + tileH - 1) / tileH;
+
+    // Finds the tiles holding the pixels an op may touch. Ops are drawn without a tile clip, so
+    // that each one is rasterized exactly as on an untiled surface; allow a pixel around their
+    // bounds for antialiasing.
+    auto findTiles = [&](const SkRect& bounds, SkIRect* tiles) {
+        SkIRect pixels = bounds.roundOut().makeOutset(1, 1);
+        if (bounds.isEmpty() || !pixels.intersect(surfaceBounds)) {
+            return false;
+        }
+        *tiles = SkIRect::MakeLTRB(pixels.fLeft / tileW,
+                                   pixels.fTop / tileH,
+                                   (pixels.fRight - 1) / tileW + 1,
+                                   (pixels.fBottom - 1) / tileH + 1);
+        return true;
+    };
+
+    // An op that only touches one tile is drawn by that tile's task. Every other draw, and every
+    // layer with all its ops, is drawn in order on a single canvas, once the tiles have drawn
+    // everything before it. Each tile also replays the state ops of the save blocks that touch
+    // it, and the single canvas replays them all.
+    std::vector<OpQueue> tileQueues(tilesX * tilesY);
+    OpQueue serialQueue;
+    std::vector<std::pair<int, int>> serialRuns;  // The first and last op of each serial run.
+    bool tilesDrewSinceRun = true;
+    auto drawSerially = [&](int op) {
+        serialQueue.push(op);
+        if (tilesDrewSinceRun) {
+            serialRuns.push_back({op, op});
+            tilesDrewSinceRun = false;
+        } else {
+            serialRuns.back().second = op;
+        }
+    };
+
+    // The state the flushed ops will leave behind for the next flush.
+    std::vector<int> liveStateOps = fLiveStateOps;
+    std::vector<int> liveSaves = fLiveSaves;
+
+    GetOpKind getOpKind;
+    int layerDepth = 0;    // The depth of saves inside the current layer, if any.
+    int pendingSaves = 0;  // Saves, outside of layers, made by the ops from firstOp on.
+    for (int op = firstOp; op < opCount; ++op) {
+        const OpKind kind = fRecord->visit(op, getOpKind);
+        switch (kind) {
+            case OpKind::kSave:
+            case OpKind::kLayer:
+                liveSaves.push_back(SkToInt(liveStateOps.size()));
+                liveStateOps.push_back(op);
+                break;
+            case OpKind::kRestore:
+                SkASSERT(!liveSaves.empty());
+                liveStateOps.resize(liveSaves.back());
+                liveSaves.pop_back();
+                break;
+            case OpKind::kControl:
+                liveStateOps.push_back(op);
+                break;
+            case OpKind::kDraw:
+                break;
+        }
+
+        // Layers may read any pixel of their contents when they are restored.
+        if (layerDepth > 0 || kind == OpKind::kLayer) {
+            if (kind == OpKind::kSave || kind == OpKind::kLayer) {
+                layerDepth++;
+            } else if (kind == OpKind::kRestore) {
+                layerDepth--;
+            }
+            drawSerially(op);
+            continue;
+        }
+
+        SkIRect tiles;
+        if (kind == OpKind::kDraw) {
+            if (findTiles(opBounds[op - firstOp], &tiles)) {
+                if (tiles.width() == 1 && tiles.height() == 1) {
+                    tileQueues[tiles.fTop * tilesX + tiles.fLeft].push(op);
+                    tilesDrewSinceRun = true;
+                } else {
+                    drawSerially(op);
+                }
+            }
+            continue;
+        }
+
+        if (kind == OpKind::kRestore && pendingSaves == 0) {
+            // This balances a save made by a flushed op, which every tile replays.
+            tiles = SkIRect::MakeWH(tilesX, tilesY);
+        } else if (!findTiles(opBounds[op - firstOp], &tiles)) {
+            tiles.setEmpty();
+        }
+        if (kind == OpKind::kSave) {
+            pendingSaves++;
+        } else if (kind == OpKind::kRestore && pendingSaves > 0) {
+            pendingSaves--;
+        }
+        for (int y = tiles.fTop; y < tiles.fBottom; ++y) {
+            for (int x = tiles.fLeft; x < tiles.fRight; ++x) {
+                tileQueues[y * tilesX + x].push(op);
+            }
+        }
+        serialQueue.push(op);
+    }
+
+    // Drawables are not thread safe, so snapshot each one into a picture up front.
+    std::unique_ptr<SkBigPicture::SnapshotArray> drawablePicts;
+    if (SkDrawableList* drawables = fRecorder->getDrawableList()) {
+        drawablePicts.reset(drawables->newDrawableSnapshot());
+    }
+    const OpTarget target = {fBitmap,
+                             this->props(),
+                             *fRecord,
+                             fLiveStateOps,
+                             drawablePicts ? drawablePicts->begin() : nullptr,
+                             drawablePicts ? drawablePicts->count() : 0};
+
+    SkTaskGroup tasks(fExecutor ? *fExecutor : SkExecutor::GetDefault());
+    std::vector<int> busyTiles;
+    auto drawTilesBefore = [&](int end) {
+        busyTiles.clear();
+        for (int i = 0; i < SkToInt(tileQueues.size()); ++i) {
+            if (tileQueues[i].hasOpsBefore(end)) {
+                busyTiles.push_back(i);
+            }
+        }
+        tasks.batch(SkToInt(busyTiles.size()), [&](int i) {
+            tileQueues[busyTiles[i]].drawOpsBefore(end, target);
+        });
+        tasks.wait();
+    };
+    for (const auto& [first, last] : serialRuns) {
+        drawTilesBefore(first);
+        serialQueue.drawOpsBefore(last + 1, target);
+    }
+    drawTilesBefore(opCount);
+    serialQueue.drawOpsBefore(opCount, target);
+
+    // If the canvas is back in its initial state nothing recorded so far can affect future ops,
+    // so we can start over with an empty record.
+    SkCanvas* canvas = this->getCachedCanvas();
+    if (opCount == recordCount &&
+        canvas->getSaveCount() == 1 &&
+        canvas->getTotalMatrix().isIdentity() &&
+        canvas->isClipRect() &&
+        canvas->getDeviceClipBounds() == surfaceBounds) {
+        this->resetRecording();
+        return;
+    }
+    fFlushedOpCount = opCount;
+    fLiveStateOps = std::move(liveStateOps);
+    fLiveSaves = std::move(liveSaves);
+    if (const SkCanvas* serialCanvas = serialQueue.canvas()) {
+        fFlushedCTM = serialCanvas->getTotalMatrix();
+    }
+}
+
+bool SkSurface_RasterTiled::peekFlushedPixels(SkPixmap* pixmap) {
+    this->flushPendingOps();
+    return fBitmap.peekPixels(pixmap);
+}
+
+bool SkSurface_RasterTiled::accessFlushedTopLayerPixels(SkPixmap* pixmap) {
+    this->flushPendingOps();
+    // The pixels of a layer that is still open are not drawn until it is restored.
+    if (fFlushedOpCount != fRecord->count()) {
+        return false;
+    }
+    return fBitmap.peekPixels(pixmap);
+}
+
+SkCanvas* SkSurface_RasterTiled::onNewCanvas() { return new TiledRecordingCanvas(this); }
+
+sk_sp<SkSurface> SkSurface_RasterTiled::onNewSurface(const SkImageInfo& info) {
+    return SkSurfaces::RasterTiled(info, fExecutor, fTileSize, &this->props());
+}
+
+void SkSurface_RasterTiled::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y,
+                                   const SkSamplingOptions& sampling, const SkPaint* paint) {
+    this->flushPendingOps();
+    canvas->drawImage(fBitmap.asImage().get(), x, y, sampling, paint);
+}
+
+sk_sp<SkImage> SkSurface_RasterTiled::onNewImageSnapshot(const SkIRect* subset) {
+    this->flushPendingOps();
+
+    if (subset) {
+        SkASSERT(SkIRect::MakeWH(fBitmap.width(), fBitmap.height()).contains(*subset));
+        SkBitmap dst;
+        dst.allocPixels(fBitmap.info().makeDimensions(subset->size()));
+        SkAssertResult(fBitmap.readPixels(dst.pixmap(), subset->left(), subset->top()));
+        dst.setImmutable();
+        return dst.asImage();
+    }
+
+    // As in SkSurface_Raster, share our pixels with the snapshot until the next draw.
+    if (SkPixelRef* pr = fBitmap.pixelRef()) {
+        pr->setTemporarilyImmutable();
+    }
+    return SkMakeImageFromRasterBitmap(fBitmap, kIfMutable_SkCopyPixelsMode);
+}
+
+void SkSurface_RasterTiled::onWritePixels(const SkPixmap& src, int x, int y) {
+    this->flushPendingOps();
+    fBitmap.writePixels(src, x, y);
+}
+
+bool SkSurface_RasterTiled::onReadPixels(const SkPixmap& dst, int srcX, int srcY) {
+    this->flushPendingOps();
+    return fBitmap.readPixels(dst, srcX, srcY);
+}
+
+void SkSurface_RasterTiled::onRestoreBackingMutability() {
+    SkASSERT(!this->hasCachedImage());  // Shouldn't be any snapshots out there.
+    if (SkPixelRef* pr = fBitmap.pixelRef()) {
+        pr->restoreMutability();
+    }
+}
+
+bool SkSurface_RasterTiled::onCopyOnWrite(ContentChangeMode mode) {
+    sk_sp<SkImage> cached(this->refCachedImage());
+    SkASSERT(cached);
+    if (SkBitmapImageGetPixelRef(cached.get()) == fBitmap.pixelRef()) {
+        // Unlike SkSurface_Raster there is no device to repoint: tiles are drawn through
+        // short-lived canvases wrapping fBitmap, so reallocating it is enough.
+        SkBitmap prev(fBitmap);
+        if (!fBitmap.tryAllocPixels()) {
+            return false;
+        }
+        if (kRetain_ContentChangeMode == mode) {
+            SkASSERT(prev.info() == fBitmap.info());
+            SkASSERT(prev.rowBytes() == fBitmap.rowBytes());
+            memcpy(fBitmap.getPixels(), prev.getPixels(), fBitmap.computeByteSize());
+        }
+    }
+    return true;
+}
+
+sk_sp<const SkCapabilities> SkSurface_RasterTiled::onCapabilities() {
+    return SkCapabilities::RasterBackend();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+namespace SkSurfaces {
+
+sk_sp<SkSurface> RasterTiled(const SkImageInfo& info,
+                             SkExecutor* executor,
+                             SkISize tileSize,
+                             const SkSurfaceProps* props) {
+    if (!SkSurfaceValidateRasterInfo(info) || tileSize.isEmpty()) {
+        return nullptr;
+    }
+
+    sk_sp<SkPixelRef> pr = SkMallocPixelRef::MakeAllocate(info, 0);
+    if (!pr) {
+        return nullptr;
+    }
+    return sk_make_sp<SkSurface_RasterTiled>(info, std::move(pr), executor, tileSize, props);
+}
+
+}  // namespace SkSurfaces
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSurface_RasterTiled_DEFINED
+#define SkSurface_RasterTiled_DEFINED
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkScalar.h"
+#include "include/core/SkSize.h"
+#include "src/image/SkSurface_Base.h"
+
+#include <memory>
+#include <vector>
+
+class SkCanvas;
+class SkCapabilities;
+class SkExecutor;
+class SkImage;
+class SkPaint;
+class SkPixelRef;
+class SkPixmap;
+class SkRecord;
+class SkRecorder;
+class SkSurface;
+class SkSurfaceProps;
+struct SkIRect;
+
+/**
+ *  A raster surface that defers rasterization. Its canvas records into an SkRecord; when the
+ *  pixels are needed the pending ops are sorted by the tiles they touch. Ops that touch a single
+ *  tile are replayed with SkRecords::Draw on that tile's task, while ops that cross tiles, and
+ *  layers, are replayed in order between them. Every op is drawn unclipped onto the full-size
+ *  bitmap with the state it was recorded with, so the pixels are exactly those SkSurface_Raster
+ *  would produce.
+ */
+class SkSurface_RasterTiled : public SkSurface_Base {
+public:
+    SkSurface_RasterTiled(const SkImageInfo&, sk_sp<SkPixelRef>, SkExecutor*, SkISize tileSize,
+                          const SkSurfaceProps*);
+    ~SkSurface_RasterTiled() override;
+
+    // From SkSurface.h
+    SkImageInfo imageInfo() const override { return fBitmap.info(); }
+
+    // From SkSurface_Base.h
+    SkSurface_Base::Type type() const override { return SkSurface_Base::Type::kRaster; }
+
+    SkCanvas* onNewCanvas() override;
+    sk_sp<SkSurface> onNewSurface(const SkImageInfo&) override;
+    sk_sp<SkImage> onNewImageSnapshot(const SkIRect* subset) override;
+    void onWritePixels(const SkPixmap&, int x, int y) override;
+    bool onReadPixels(const SkPixmap&, int srcX, int srcY) override;
+    void onDraw(SkCanvas*, SkScalar, SkScalar, const SkSamplingOptions&, const SkPaint*) override;
+    bool onCopyOnWrite(ContentChangeMode) override;
+    void onRestoreBackingMutability() override;
+    sk_sp<const SkCapabilities> onCapabilities() override;
+
+    // Rasterizes the pending ops into fBitmap. Called before any access to the pixels. Ops from
+    // the first layer that is still open on stay pending, as on a raster surface they would
+    // still be drawing into that layer rather than fBitmap. Save-behinds are treated the same
+    // way, so draws made since one that is still open only show up once it is restored.
+    void flushPendingOps();
+
+    // Returns fBitmap's pixels, after flushing any pending ops. As with a raster canvas, these
+    // are the base layer's pixels even while a layer is open.
+    bool peekFlushedPixels(SkPixmap*);
+
+    // As peekFlushedPixels(), but fails while a layer is open: its pixels are not drawn until
+    // it is restored.
+    bool accessFlushedTopLayerPixels(SkPixmap*);
+
+    SkRecorder* recorder() const { return fRecorder.get(); }
+
+private:
+    void resetRecording();
+
+    SkBitmap                    fBitmap;
+    SkExecutor*                 fExecutor;
+    const SkISize               fTileSize;
+
+    sk_sp<SkRecord>             fRecord;
+    std::unique_ptr<SkRecorder> fRecorder;
+    // Ops before this index have already been rasterized. They are kept only while the canvas
+    // has unbalanced saves, matrices or clips outstanding. None of them is a layer that is still
+    // open.
+    int                         fFlushedOpCount = 0;
+    // The flushed ops that make up the canvas state at fFlushedOpCount: the saves still open and
+    // the matrix and clip changes since, in order. Each canvas drawing pending ops replays these
+    // rather than every flushed op.
+    std::vector<int>            fLiveStateOps;
+    // The index in fLiveStateOps of each save that is still open.
+    std::vector<int>            fLiveSaves;
+    // The matrix at fFlushedOpCount, which the bounds of the pending ops start from.
+    SkMatrix                    fFlushedCTM;
+};
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPngFilter_opts_DEFINED
+#define SkPngFilter_opts_DEFINED
+
+#include "src/base/SkVx.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+namespace SK_OPTS_NS {
+
+// The filters work on 16 bytes at a time, one SSE or NEON register; 32-byte AVX2 vectors measured
+// no faster.
+static constexpr int kPngFilterLanes = 16;
+
+// The PNG filter predictors, given the bytes to the left (a), above (b) and above left (c).
+template <int kType>
+static inline uint8_t png_predict(int a, int b, int c) {
+    if constexpr (kType == 1) {
+        return a;
+    } else if constexpr (kType == 2) {
+        return b;
+    } else if constexpr (kType == 3) {
+        return (a + b) >> 1;
+    } else if constexpr (kType == 4) {
+        int pa = std::abs(b - c),
+            pb = std::abs(a - c),
+            pc = std::abs(a + b - c - c);
+        return pa <= pb && pa <= pc ? a
+             : pb <= pc             ? b
+                                    : c;
+    } else {
+        return 0;
+    }
+}
+
+template <int kType, int N>
+static inline skvx::Vec<N,uint8_t> png_predict(const skvx::Vec<N,uint8_t>& a,
+                                               const skvx::Vec<N,uint8_t>& b,
+                                               const skvx::Vec<N,uint8_t>& c) {
+    if constexpr (kType == 1) {
+        return a;
+    } else if constexpr (kType == 2) {
+        return b;
+    } else if constexpr (kType == 3) {
+        // (a + b) >> 1 without overflowing 8 bits.
+        return (a & b) + ((a ^ b) >> 1);
+    } else if constexpr (kType == 4) {
+        // Paeth, in 8 bits: pa = |b - c| and pb = |a - c| fit, and pc = |(a - c) + (b - c)| is
+        // either pa + pb or |pa - pb|. Saturating pa + pb does not change any comparison, since
+        // pa and pb are at most 255.
+        using U8 = skvx::Vec<N,uint8_t>;
+        U8 pa = max(b, c) - min(b, c),
+           pb = max(a, c) - min(a, c),
+           pc = if_then_else((a >= c) == (b >= c), saturated_add(pa, pb),
+                             max(pa, pb) - min(pa, pb));
+        return if_then_else((pa <= pb) & (pa <= pc), a,
+               if_then_else(pb <= pc, b, c));
+    } else {
+        return 0;
+    }
+}
+
+template <int kType>
+static uint64_t png_filter_row_type(const uint8_t* row, const uint8_t* prev, size_t rowBytes,
+                                    size_t bpp, uint8_t* dst, uint64_t limit) {
+    constexpr int N = kPngFilterLanes;
+    using U8  = skvx::Vec<N,uint8_t>;
+    using U16 = skvx::Vec<N/2,uint16_t>;
+
+    uint64_t sum = 0;
+    size_t i = 0;
+    while (i + N <= rowBytes) {
+        // Each 16-bit lane sums two bytes' absolute values, at most 256 per vector, so 16 vectors
+        // can't overflow it.
+        U16 acc = 0;
+        for (int v = 0; v < 16 && i + N <= rowBytes; v++, i += N) {
+            U8 x = U8::Load(row + i);
+            if constexpr (kType != 0) {
+                x -= png_predict<kType>(U8::Load(row + i - bpp),
+                                        U8::Load(prev + i),
+                                        U8::Load(prev + i - bpp));
+            }
+            x.store(dst + i);
+            U16 mag = sk_bit_cast<U16>(min(x, U8(0) - x));
+            acc += (mag & 0xff) + (mag >> 8);
+        }
+        for (int lane = 0; lane < N/2; lane++) {
+            sum += acc[lane];
+        }
+        if (sum >= limit) {
+            return sum;
+        }
+    }
+    for (; i < rowBytes; i++) {
+        uint8_t x = row[i] - png_predict<kType>(row[i - bpp], prev[i], prev[i - bpp]);
+        dst[i] = x;
+        sum += x < 128 ? x : 256 - x;
+    }
+    return sum;
+}
+
+static uint64_t png_filter_row(int type, const uint8_t* row, const uint8_t* prev,
+                               size_t rowBytes, size_t bpp, uint8_t* dst, uint64_t limit) {
+    switch (type) {
+        case 1:  return png_filter_row_type<1>(row, prev, rowBytes, bpp, dst, limit);
+        case 2:  return png_filter_row_type<2>(row, prev, rowBytes, bpp, dst, limit);
+        case 3:  return png_filter_row_type<3>(row, prev, rowBytes, bpp, dst, limit);
+        case 4:  return png_filter_row_type<4>(row, prev, rowBytes, bpp, dst, limit);
+        default: return png_filter_row_type<0>(row, prev, rowBytes, bpp, dst, limit);
+    }
+}
+
+}  // namespace SK_OPTS_NS
+
+#endif // SkPngFilter_opts_DEFINED
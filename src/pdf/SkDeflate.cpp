@@ -7,16 +7,23 @@
 
 #include "src/pdf/SkDeflate.h"
 
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkRefCnt.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkMalloc.h"
+#include "include/private/base/SkSemaphore.h"
 #include "include/private/base/SkTFitsIn.h"
 #include "include/private/base/SkTo.h"
 #include "src/core/SkTraceEvent.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstring>
+#include <deque>
+#include <vector>
 
 #include "zlib.h"  // NO_G3_REWRITE
 
@@ -67,27 +74,178 @@ static void do_deflate(int flush,
                  : returnValue == Z_OK);
 }
 
+// With an executor, the input is compressed in blocks much as pigz does it: each block is raw
+// deflate data, primed with the last 32KB of the block before it and ended on a byte boundary
+// with Z_SYNC_FLUSH, so the blocks concatenate into one stream. The first block also writes the
+// zlib or gzip header, and the trailer is written from the blocks' combined checksums.
+static constexpr size_t kDeflateWindowBytes = 32 * 1024;
+
+// How many blocks may be waiting to be written before write() compresses or waits for the oldest.
+static constexpr size_t kMaxPendingBlocks = 8;
+
+class SkDeflateWStream::Block final : public SkNVRefCnt<Block> {
+public:
+    Block(sk_sp<SkData> input, size_t size, sk_sp<SkData> previous, const Options& options,
+          bool last)
+            : fInput(std::move(input))
+            , fSize(size)
+            , fPrevious(std::move(previous))
+            , fLevel(options.fCompressionLevel)
+            , fStrategy(options.fFiltered ? Z_FILTERED : Z_DEFAULT_STRATEGY)
+            , fGzip(options.fGzip)
+            , fLast(last) {}
+
+    // Compresses the block, unless another thread already started to.
+    void compress() {
+        if (fClaimed.exchange(true, std::memory_order_relaxed)) {
+            return;
+        }
+        TRACE_EVENT0("skia", TRACE_FUNC);
+        const uint8_t* input = fInput->bytes();
+        z_stream zStream = {};
+        zStream.zalloc = &skia_alloc_func;
+        zStream.zfree = &skia_free_func;
+        // Only the first block writes the zlib or gzip header.
+        const int windowBits = fPrevious ? -15 : fGzip ? 0x1F : 0x0F;
+        SkDEBUGCODE(int r =) deflateInit2(&zStream, fLevel, Z_DEFLATED, windowBits, 8, fStrategy);
+        SkASSERT(Z_OK == r);
+        if (fPrevious) {
+            const size_t dictionarySize = std::min(kDeflateWindowBytes, fPrevious->size());
+            SkDEBUGCODE(r =) deflateSetDictionary(
+                    &zStream, fPrevious->bytes() + fPrevious->size() - dictionarySize,
+                    SkToUInt(dictionarySize));
+            SkASSERT(Z_OK == r);
+        }
+
+        // deflateBound() does not account for the empty stored block that Z_SYNC_FLUSH ends with.
+        fDeflated.resize(deflateBound(&zStream, fSize) + 16);
+        zStream.next_in = const_cast<uint8_t*>(input);
+        zStream.avail_in = SkToUInt(fSize);
+        zStream.next_out = fDeflated.data();
+        zStream.avail_out = SkToUInt(fDeflated.size());
+        SkDEBUGCODE(r =) deflate(&zStream, fLast ? Z_FINISH : Z_SYNC_FLUSH);
+        SkASSERT(fLast ? r == Z_STREAM_END : r == Z_OK);
+        SkASSERT(zStream.avail_in == 0 && zStream.avail_out > 0);
+        fDeflated.resize(zStream.total_out);
+        (void)deflateEnd(&zStream);
+
+        fCheck = fGzip ? crc32(0, input, SkToUInt(fSize)) : adler32(1, input, SkToUInt(fSize));
+        fInput = nullptr;
+        fPrevious = nullptr;
+        fDone.signal();
+    }
+
+    // Returns true if the block is compressed. Once it has, isDone() must not be called again.
+    bool isDone() { return fDone.try_wait(); }
+
+    // Compresses the block on this thread, or waits for the thread that is.
+    void wait() {
+        this->compress();
+        fDone.wait();
+    }
+
+    const std::vector<uint8_t>& deflated() const { return fDeflated; }
+    uLong check() const { return fCheck; }
+    size_t size() const { return fSize; }
+
+private:
+    sk_sp<SkData>        fInput;
+    const size_t         fSize;
+    sk_sp<SkData>        fPrevious;
+    const int            fLevel;
+    const int            fStrategy;
+    const bool           fGzip;
+    const bool           fLast;
+    std::atomic<bool>    fClaimed{false};
+    SkSemaphore          fDone;
+    std::vector<uint8_t> fDeflated;
+    uLong                fCheck = 0;
+};
+
 // Hide all zlib impl details.
 struct SkDeflateWStream::Impl {
     SkWStream* fOut;
     unsigned char fInBuffer[SKDEFLATEWSTREAM_INPUT_BUFFER_SIZE];
     size_t fInBufferIndex;
     z_stream fZStream;
+
+    // Only used with an executor. The block being filled is only compressed once more input
+    // follows it, so input that fits in one block is compressed by fZStream as usual.
+    Options fOptions;
+    sk_sp<SkData> fBlock;
+    size_t fBlockIndex = 0;
+    sk_sp<SkData> fPreviousBlock;
+    std::deque<sk_sp<Block>> fBlocks;
+    uLong fCheck = 0;
+    uint64_t fBlockBytes = 0;
+
+    void submitBlock(bool last) {
+        sk_sp<Block> block = sk_make_sp<Block>(fBlock, fBlockIndex, fPreviousBlock, fOptions,
+                                               last);
+        fPreviousBlock = std::move(fBlock);
+        fBlockIndex = 0;
+        if (!last) {
+            fOptions.fExecutor->add([block] { block->compress(); });
+        }
+        fBlocks.push_back(std::move(block));
+    }
+
+    // Writes out the compressed blocks at the front of fBlocks, waiting for as many as it takes
+    // to leave at most maxPending.
+    void writeBlocks(size_t maxPending) {
+        while (!fBlocks.empty()) {
+            Block* block = fBlocks.front().get();
+            if (fBlocks.size() > maxPending) {
+                block->wait();
+            } else if (!block->isDone()) {
+                return;
+            }
+            fOut->write(block->deflated().data(), block->deflated().size());
+            if (fBlockBytes == 0) {
+                fCheck = block->check();
+            } else if (fOptions.fGzip) {
+                fCheck = crc32_combine(fCheck, block->check(), (z_off_t)block->size());
+            } else {
+                fCheck = adler32_combine(fCheck, block->check(), (z_off_t)block->size());
+            }
+            fBlockBytes += block->size();
+            fBlocks.pop_front();
+        }
+    }
+
+    void writeTrailer() {
+        if (fOptions.fGzip) {
+            const uint32_t inputSize = (uint32_t)fBlockBytes;
+            const uint8_t trailer[] = {(uint8_t)fCheck,         (uint8_t)(fCheck >> 8),
+                                       (uint8_t)(fCheck >> 16), (uint8_t)(fCheck >> 24),
+                                       (uint8_t)inputSize,      (uint8_t)(inputSize >> 8),
+                                       (uint8_t)(inputSize >> 16), (uint8_t)(inputSize >> 24)};
+            fOut->write(trailer, sizeof(trailer));
+        } else {
+            const uint8_t trailer[] = {(uint8_t)(fCheck >> 24), (uint8_t)(fCheck >> 16),
+                                       (uint8_t)(fCheck >> 8),  (uint8_t)fCheck};
+            fOut->write(trailer, sizeof(trailer));
+        }
+    }
 };
 
 SkDeflateWStream::SkDeflateWStream(SkWStream* out,
                                    int compressionLevel,
                                    bool gzip)
+    : SkDeflateWStream(out, Options{compressionLevel, false, gzip, nullptr}) {}
+
+SkDeflateWStream::SkDeflateWStream(SkWStream* out, const Options& options)
     : fImpl(std::make_unique<SkDeflateWStream::Impl>()) {
 
     // There has existed at some point at least one zlib implementation which thought it was being
     // clever by randomizing the compression level. This is actually not entirely incorrect, except
     // for the no-compression level which should always be deterministically pass-through.
     // Users should instead consider the zero compression level broken and handle it themselves.
-    SkASSERT(compressionLevel != 0);
+    SkASSERT(options.fCompressionLevel != 0);
 
     fImpl->fOut = out;
     fImpl->fInBufferIndex = 0;
+    fImpl->fOptions = options;
     if (!fImpl->fOut) {
         return;
     }
@@ -95,10 +253,10 @@ SkDeflateWStream::SkDeflateWStream(SkWStream* out,
     fImpl->fZStream.zalloc = &skia_alloc_func;
     fImpl->fZStream.zfree = &skia_free_func;
     fImpl->fZStream.opaque = nullptr;
-    SkASSERT(compressionLevel <= 9 && compressionLevel >= -1);
-    SkDEBUGCODE(int r =) deflateInit2(&fImpl->fZStream, compressionLevel,
-                                      Z_DEFLATED, gzip ? 0x1F : 0x0F,
-                                      8, Z_DEFAULT_STRATEGY);
+    SkASSERT(options.fCompressionLevel <= 9 && options.fCompressionLevel >= -1);
+    SkDEBUGCODE(int r =) deflateInit2(&fImpl->fZStream, options.fCompressionLevel,
+                                      Z_DEFLATED, options.fGzip ? 0x1F : 0x0F,
+                                      8, options.fFiltered ? Z_FILTERED : Z_DEFAULT_STRATEGY);
     SkASSERT(Z_OK == r);
 }
 
@@ -109,8 +267,19 @@ void SkDeflateWStream::finalize() {
     if (!fImpl->fOut) {
         return;
     }
-    do_deflate(Z_FINISH, &fImpl->fZStream, fImpl->fOut, fImpl->fInBuffer,
-               fImpl->fInBufferIndex);
+    if (fImpl->fOptions.fExecutor && !fImpl->fPreviousBlock) {
+        // Everything fit in one block.
+        do_deflate(Z_FINISH, &fImpl->fZStream, fImpl->fOut,
+                   fImpl->fBlock ? (unsigned char*)fImpl->fBlock->writable_data() : nullptr,
+                   fImpl->fBlockIndex);
+    } else if (fImpl->fOptions.fExecutor) {
+        fImpl->submitBlock(/*last=*/true);
+        fImpl->writeBlocks(0);
+        fImpl->writeTrailer();
+    } else {
+        do_deflate(Z_FINISH, &fImpl->fZStream, fImpl->fOut, fImpl->fInBuffer,
+                   fImpl->fInBufferIndex);
+    }
     (void)deflateEnd(&fImpl->fZStream);
     fImpl->fOut = nullptr;
 }
@@ -121,6 +290,24 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
         return false;
     }
     const char* buffer = (const char*)void_buffer;
+    if (fImpl->fOptions.fExecutor) {
+        while (len > 0) {
+            if (!fImpl->fBlock) {
+                fImpl->fBlock = SkData::MakeUninitialized(kParallelBlockSize);
+            } else if (fImpl->fBlockIndex == kParallelBlockSize) {
+                // Only start compressing a full block once we know it isn't the last one.
+                fImpl->submitBlock(/*last=*/false);
+                fImpl->writeBlocks(kMaxPendingBlocks);
+                fImpl->fBlock = SkData::MakeUninitialized(kParallelBlockSize);
+            }
+            size_t tocopy = std::min(len, kParallelBlockSize - fImpl->fBlockIndex);
+            memcpy((char*)fImpl->fBlock->writable_data() + fImpl->fBlockIndex, buffer, tocopy);
+            len -= tocopy;
+            buffer += tocopy;
+            fImpl->fBlockIndex += tocopy;
+        }
+        return true;
+    }
     while (len > 0) {
         size_t tocopy =
                 std::min(len, sizeof(fImpl->fInBuffer) - fImpl->fInBufferIndex);
@@ -141,5 +328,12 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
 }
 
 size_t SkDeflateWStream::bytesWritten() const {
+    if (fImpl->fOptions.fExecutor) {
+        size_t bytes = fImpl->fBlockBytes + fImpl->fBlockIndex;
+        for (const sk_sp<Block>& block : fImpl->fBlocks) {
+            bytes += block->size();
+        }
+        return bytes;
+    }
     return fImpl->fZStream.total_in + fImpl->fInBufferIndex;
 }
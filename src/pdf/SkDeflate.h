@@ -14,6 +14,8 @@
 
 #include <memory>
 
+class SkExecutor;
+
 /**
   * Wrap a stream in this class to compress the information written to
   * this stream using the Deflate algorithm.
@@ -22,6 +24,29 @@
   */
 class SkDeflateWStream final : public SkWStream {
 public:
+    struct Options {
+        /** 1 is best speed; 9 is best compression. -1 is zlib's Z_DEFAULT_COMPRESSION. */
+        int fCompressionLevel = -1;
+
+        /** Use zlib's Z_FILTERED strategy, which favors literals over short, far matches. */
+        bool fFiltered = false;
+
+        /** Output a gzip file rather than a zlib stream. */
+        bool fGzip = false;
+
+        /** If set, input longer than kParallelBlockSize is split into blocks of that size that
+            are compressed concurrently on this executor, each primed with the end of the block
+            before it. The output is still a single stream, and does not depend on
+            the executor or on how the input was split into write() calls, but it is a little
+            larger than, and not the same as, the output without an executor.
+
+            Shorter inputs are compressed as if there were no executor.
+         */
+        SkExecutor* fExecutor = nullptr;
+    };
+
+    static constexpr size_t kParallelBlockSize = 128 * 1024;
+
     /** Does not take ownership of the stream.
 
         @param compressionLevel 1 is best speed; 9 is best compression.
@@ -37,6 +62,9 @@ public:
                      int compressionLevel,
                      bool gzip = false);
 
+    /** Does not take ownership of the stream or the executor. */
+    SkDeflateWStream(SkWStream*, const Options&);
+
     /** The destructor calls finalize(). */
     ~SkDeflateWStream() override;
 
@@ -50,6 +78,7 @@ public:
 
 private:
     struct Impl;
+    class Block;
     std::unique_ptr<Impl> fImpl;
 };
 
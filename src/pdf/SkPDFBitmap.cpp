@@ -146,7 +146,7 @@ void do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndirectRefe
     SkWStream* stream = &buffer;
     std::optional<SkDeflateWStream> deflateWStream;
     if (format == SkPDFStreamFormat::Flate) {
-        deflateWStream.emplace(&buffer, SkToInt(compressionLevel));
+        deflateWStream.emplace(&buffer, doc->deflateOptions(/*pixels=*/true));
         stream = &*deflateWStream;
     }
     if (kAlpha_8_SkColorType == pm.colorType()) {
@@ -231,7 +231,7 @@ void do_deflated_image(const SkPixmap& pm,
     SkWStream* stream = &buffer;
     std::optional<SkDeflateWStream> deflateWStream;
     if (format == SkPDFStreamFormat::Flate) {
-        deflateWStream.emplace(&buffer, SkToInt(compressionLevel));
+        deflateWStream.emplace(&buffer, doc->deflateOptions(/*pixels=*/true));
         stream = &*deflateWStream;
     }
     SkPDFUnion colorSpace = SkPDFUnion::Name("DeviceGray");
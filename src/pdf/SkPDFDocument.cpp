@@ -158,55 +158,70 @@ static void serialize_footer(const SkPDFOffsetMap& offsetMap,
     wStream->writeText("\n%%EOF\n");
 }
 
+// PDF wants a tree describing all the pages in the document.  We arbitrary
+// choose 8 (kPageTreeNodeSize) as the number of allowed children.  The internal
+// nodes have type "Pages" with an array of children, a parent pointer, and
+// the number of leaves below the node as "Count."  The leaves have type "Page"
+// and need a parent pointer.
+static constexpr size_t kPageTreeNodeSize = 8;
+
+namespace {
+struct PageTreeNode {
+    std::unique_ptr<SkPDFDict> fNode;
+    SkPDFIndirectReference fReservedRef;
+    int fPageObjectDescendantCount;
+
+    static std::vector<PageTreeNode> Layer(std::vector<PageTreeNode> vec, SkPDFDocument* doc) {
+        std::vector<PageTreeNode> result;
+        const size_t n = vec.size();
+        SkASSERT(n >= 1);
+        const size_t result_len = (n - 1) / kPageTreeNodeSize + 1;
+        SkASSERT(result_len >= 1);
+        SkASSERT(n == 1 || result_len < n);
+        result.reserve(result_len);
+        size_t index = 0;
+        for (size_t i = 0; i < result_len; ++i) {
+            if (n != 1 && index + 1 == n) {  // No need to create a new node.
+                result.push_back(std::move(vec[index++]));
+                continue;
+            }
+            SkPDFIndirectReference parent = doc->reserveRef();
+            auto kids_list = SkPDFMakeArray();
+            int descendantCount = 0;
+            for (size_t j = 0; j < kPageTreeNodeSize && index < n; ++j) {
+                PageTreeNode& node = vec[index++];
+                node.fNode->insertRef("Parent", parent);
+                kids_list->appendRef(doc->emit(*node.fNode, node.fReservedRef));
+                descendantCount += node.fPageObjectDescendantCount;
+            }
+            auto next = SkPDFMakeDict("Pages");
+            next->insertInt("Count", descendantCount);
+            next->insertObject("Kids", std::move(kids_list));
+            result.push_back(PageTreeNode{std::move(next), parent, descendantCount});
+        }
+        return result;
+    }
+
+    // Builds the rest of the tree above currentLayer and returns its root.
+    static SkPDFIndirectReference EmitRoot(std::vector<PageTreeNode> currentLayer,
+                                           SkPDFDocument* doc) {
+        while (currentLayer.size() > 1) {
+            currentLayer = Layer(std::move(currentLayer), doc);
+        }
+        SkASSERT(currentLayer.size() == 1);
+        const PageTreeNode& root = currentLayer[0];
+        return doc->emit(*root.fNode, root.fReservedRef);
+    }
+};
+}  // namespace
+
+// Builds the tree bottom up from the page dicts, skipping internal nodes that
+// would have only one child.
 static SkPDFIndirectReference generate_page_tree(
         SkPDFDocument* doc,
         std::vector<std::unique_ptr<SkPDFDict>> pages,
         const std::vector<SkPDFIndirectReference>& pageRefs) {
-    // PDF wants a tree describing all the pages in the document.  We arbitrary
-    // choose 8 (kNodeSize) as the number of allowed children.  The internal
-    // nodes have type "Pages" with an array of children, a parent pointer, and
-    // the number of leaves below the node as "Count."  The leaves are passed
-    // into the method, have type "Page" and need a parent pointer. This method
-    // builds the tree bottom up, skipping internal nodes that would have only
-    // one child.
     SkASSERT(!pages.empty());
-    struct PageTreeNode {
-        std::unique_ptr<SkPDFDict> fNode;
-        SkPDFIndirectReference fReservedRef;
-        int fPageObjectDescendantCount;
-
-        static std::vector<PageTreeNode> Layer(std::vector<PageTreeNode> vec, SkPDFDocument* doc) {
-            std::vector<PageTreeNode> result;
-            static constexpr size_t kMaxNodeSize = 8;
-            const size_t n = vec.size();
-            SkASSERT(n >= 1);
-            const size_t result_len = (n - 1) / kMaxNodeSize + 1;
-            SkASSERT(result_len >= 1);
-            SkASSERT(n == 1 || result_len < n);
-            result.reserve(result_len);
-            size_t index = 0;
-            for (size_t i = 0; i < result_len; ++i) {
-                if (n != 1 && index + 1 == n) {  // No need to create a new node.
-                    result.push_back(std::move(vec[index++]));
-                    continue;
-                }
-                SkPDFIndirectReference parent = doc->reserveRef();
-                auto kids_list = SkPDFMakeArray();
-                int descendantCount = 0;
-                for (size_t j = 0; j < kMaxNodeSize && index < n; ++j) {
-                    PageTreeNode& node = vec[index++];
-                    node.fNode->insertRef("Parent", parent);
-                    kids_list->appendRef(doc->emit(*node.fNode, node.fReservedRef));
-                    descendantCount += node.fPageObjectDescendantCount;
-                }
-                auto next = SkPDFMakeDict("Pages");
-                next->insertInt("Count", descendantCount);
-                next->insertObject("Kids", std::move(kids_list));
-                result.push_back(PageTreeNode{std::move(next), parent, descendantCount});
-            }
-            return result;
-        }
-    };
     std::vector<PageTreeNode> currentLayer;
     currentLayer.reserve(pages.size());
     SkASSERT(pages.size() == pageRefs.size());
@@ -214,12 +229,32 @@ static SkPDFIndirectReference generate_page_tree(
         currentLayer.push_back(PageTreeNode{std::move(pages[i]), pageRefs[i], 1});
     }
     currentLayer = PageTreeNode::Layer(std::move(currentLayer), doc);
-    while (currentLayer.size() > 1) {
-        currentLayer = PageTreeNode::Layer(std::move(currentLayer), doc);
+    return PageTreeNode::EmitRoot(std::move(currentLayer), doc);
+}
+
+// Builds the tree for pages that have already been written, each naming the
+// node leafRefs[pageIndex / kPageTreeNodeSize] as its parent.
+static SkPDFIndirectReference generate_streamed_page_tree(
+        SkPDFDocument* doc,
+        const std::vector<SkPDFIndirectReference>& leafRefs,
+        const std::vector<SkPDFIndirectReference>& pageRefs) {
+    SkASSERT(!leafRefs.empty());
+    SkASSERT(leafRefs.size() == (pageRefs.size() - 1) / kPageTreeNodeSize + 1);
+    std::vector<PageTreeNode> currentLayer;
+    currentLayer.reserve(leafRefs.size());
+    for (size_t i = 0; i < leafRefs.size(); ++i) {
+        auto kids_list = SkPDFMakeArray();
+        size_t end = std::min((i + 1) * kPageTreeNodeSize, pageRefs.size());
+        for (size_t j = i * kPageTreeNodeSize; j < end; ++j) {
+            kids_list->appendRef(pageRefs[j]);
+        }
+        int descendantCount = SkToInt(kids_list->size());
+        auto leaf = SkPDFMakeDict("Pages");
+        leaf->insertInt("Count", descendantCount);
+        leaf->insertObject("Kids", std::move(kids_list));
+        currentLayer.push_back(PageTreeNode{std::move(leaf), leafRefs[i], descendantCount});
     }
-    SkASSERT(currentLayer.size() == 1);
-    const PageTreeNode& root = currentLayer[0];
-    return doc->emit(*root.fNode, root.fReservedRef);
+    return PageTreeNode::EmitRoot(std::move(currentLayer), doc);
 }
 
 template<typename T, typename... Args>
@@ -265,7 +300,7 @@ static SkSize operator*(SkSize u, SkScalar s) { return SkSize{u.width() * s, u.h
 
 SkCanvas* SkPDFDocument::onBeginPage(SkScalar width, SkScalar height) {
     SkASSERT(fCanvas.imageInfo().dimensions().isZero());
-    if (fPages.empty()) {
+    if (fPageRefs.empty()) {
         // if this is the first page if the document.
         {
             SkAutoMutexExclusive autoMutexAcquire(fMutex);
@@ -397,7 +432,16 @@ void SkPDFDocument::onEndPage() {
     // Tabs is PDF 1.5, but setting it checks an accessibility box.
     page->insertName("Tabs", "S");
 
-    fPages.emplace_back(std::move(page));
+    if (fMetadata.fStreamPages) {
+        if (fEndedPageCount % kPageTreeNodeSize == 0) {
+            fPageTreeLeafRefs.push_back(this->reserveRef());
+        }
+        page->insertRef("Parent", fPageTreeLeafRefs.back());
+        this->emit(*page, fPageRefs.back());
+    } else {
+        fPages.emplace_back(std::move(page));
+    }
+    ++fEndedPageCount;
 }
 
 void SkPDFDocument::onAbort() {
@@ -608,7 +652,7 @@ SkString SkPDFDocument::nextFontSubsetTag() {
 
 void SkPDFDocument::onClose(SkWStream* stream) {
     SkASSERT(fCanvas.imageInfo().dimensions().isZero());
-    if (fPages.empty()) {
+    if (fEndedPageCount == 0) {
         this->waitForJobs();
         return;
     }
@@ -621,7 +665,10 @@ void SkPDFDocument::onClose(SkWStream* stream) {
         docCatalog->insertObject("OutputIntents", make_srgb_output_intents(this));
     }
 
-    docCatalog->insertRef("Pages", generate_page_tree(this, std::move(fPages), fPageRefs));
+    docCatalog->insertRef("Pages",
+                          fMetadata.fStreamPages
+                                  ? generate_streamed_page_tree(this, fPageTreeLeafRefs, fPageRefs)
+                                  : generate_page_tree(this, std::move(fPages), fPageRefs));
 
     if (!fNamedDestinations.empty()) {
         docCatalog->insertRef("Dests", append_destinations(this, fNamedDestinations));
@@ -669,6 +716,21 @@ void SkPDFDocument::onClose(SkWStream* stream) {
     }
 }
 
+SkDeflateWStream::Options SkPDFDocument::deflateOptions(bool pixels) const {
+    SkASSERT(fMetadata.fCompressionLevel != SkPDF::Metadata::CompressionLevel::None);
+    SkDeflateWStream::Options options;
+    options.fCompressionLevel = SkToInt(fMetadata.fCompressionLevel);
+    if (fMetadata.fCompressionLevel == SkPDF::Metadata::CompressionLevel::Balanced) {
+        // Content streams are mostly short numbers, which compress better as literals than as
+        // short, far matches. Unpredicted pixels have few long matches for a deeper search to
+        // find, so level 2 comes within a few percent of level 6 in about two thirds the time.
+        options.fCompressionLevel = pixels ? 2 : 4;
+        options.fFiltered = !pixels;
+    }
+    options.fExecutor = fExecutor;
+    return options;
+}
+
 void SkPDFDocument::incrementJobCount() { fJobCount++; }
 
 void SkPDFDocument::signalJobComplete() { fSemaphore.signal(); }
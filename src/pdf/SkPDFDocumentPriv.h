@@ -23,6 +23,7 @@
 #include "include/private/base/SkSemaphore.h"
 #include "src/base/SkUTF.h"
 #include "src/core/SkTHash.h"
+#include "src/pdf/SkDeflate.h"
 #include "src/pdf/SkPDFBitmap.h"
 #include "src/pdf/SkPDFFont.h"
 #include "src/pdf/SkPDFGraphicState.h"
@@ -152,9 +153,12 @@ public:
     SkString nextFontSubsetTag();
 
     SkExecutor* executor() const { return fExecutor; }
+    // How to compress streams, for any fCompressionLevel but None. Image pixels are compressed
+    // differently from everything else, which is mostly text.
+    SkDeflateWStream::Options deflateOptions(bool pixels = false) const;
     void incrementJobCount();
     void signalJobComplete();
-    size_t currentPageIndex() { return fPages.size(); }
+    size_t currentPageIndex() { return fEndedPageCount; }
     size_t pageCount() { return fPageRefs.size(); }
 
     const SkMatrix& currentPageTransform() const;
@@ -192,6 +196,10 @@ private:
     SkCanvas fCanvas;
     std::vector<std::unique_ptr<SkPDFDict>> fPages;
     std::vector<SkPDFIndirectReference> fPageRefs;
+    size_t fEndedPageCount = 0;
+    // With fMetadata.fStreamPages, pages are written as they end and fPages stays empty. Page i
+    // is then a kid of the page tree node fPageTreeLeafRefs[i / 8], which is written on close.
+    std::vector<SkPDFIndirectReference> fPageTreeLeafRefs;
 
     sk_sp<SkPDFDevice> fPageDevice;
     std::atomic<int> fNextObjectNumber = {1};
@@ -558,7 +558,7 @@ static void serialize_stream(SkPDFDict* origDict,
         stream->getLength() > kMinimumSavings)
     {
         SkDynamicMemoryWStream compressedData;
-        SkDeflateWStream deflateWStream(&compressedData,SkToInt(doc->metadata().fCompressionLevel));
+        SkDeflateWStream deflateWStream(&compressedData, doc->deflateOptions());
         SkStreamCopy(&deflateWStream, stream);
         deflateWStream.finalize();
         #ifdef SK_PDF_BASE85_BINARY
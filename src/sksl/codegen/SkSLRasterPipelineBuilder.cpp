@@ -9,12 +9,14 @@
 #include <cstdint>
 #include <optional>
 
+#include "include/core/SkFourByteTag.h"
 #include "include/core/SkStream.h"
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkTFitsIn.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkArenaAlloc.h"
 #include "src/base/SkSafeMath.h"
+#include "src/core/SkChecksum.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkRasterPipelineContextUtils.h"
 #include "src/core/SkRasterPipelineOpContexts.h"
@@ -1412,6 +1414,74 @@ Program::Program(TArray<Instruction> instrs,
 
 Program::~Program() = default;
 
+static constexpr uint32_t kSerializedProgramMagic = SkSetFourByteTag('S', 'K', 'R', 'P');
+
+// Serialized programs store BuilderOps by value, so they are only portable between builds whose
+// op lists match exactly.
+static uint32_t op_list_hash() {
+    static const uint32_t hash = [] {
+        static constexpr char kOpNames[] =
+            #define M(stage) #stage ","
+                SK_RASTER_PIPELINE_OPS_ALL(M)
+                SKRP_EXTENDED_OPS(M)
+            #undef M
+            ;
+        uint32_t h = SkChecksum::Hash32(kOpNames, sizeof(kOpNames));
+        uint32_t count = (uint32_t)BuilderOp::unsupported;
+        return SkChecksum::Hash32(&count, sizeof(count), h);
+    }();
+    return hash;
+}
+
+bool Program::serialize(SkWStream* out) const {
+    static_assert(sizeof(Instruction) == 8 * sizeof(int32_t));
+    if (fDebugTrace) {
+        return false;
+    }
+    return out->write32(kSerializedProgramMagic) &&
+           out->write32(op_list_hash()) &&
+           out->write32(fNumValueSlots) &&
+           out->write32(fNumUniformSlots) &&
+           out->write32(fNumImmutableSlots) &&
+           out->write32(fNumLabels) &&
+           out->write32(fInstructions.size()) &&
+           out->write(fInstructions.data(), fInstructions.size_bytes());
+}
+
+std::unique_ptr<Program> Program::Deserialize(SkStream* in) {
+    uint32_t magic, opListHash;
+    int32_t numValueSlots, numUniformSlots, numImmutableSlots, numLabels, numInstructions;
+    if (!in->readU32(&magic) || magic != kSerializedProgramMagic ||
+        !in->readU32(&opListHash) || opListHash != op_list_hash() ||
+        !in->readS32(&numValueSlots) || numValueSlots < 0 ||
+        !in->readS32(&numUniformSlots) || numUniformSlots < 0 ||
+        !in->readS32(&numImmutableSlots) || numImmutableSlots < 0 ||
+        !in->readS32(&numLabels) || numLabels < 0 ||
+        !in->readS32(&numInstructions) || numInstructions < 0) {
+        return nullptr;
+    }
+    if (in->hasLength() && in->hasPosition() &&
+        in->getLength() - in->getPosition() < (size_t)numInstructions * sizeof(Instruction)) {
+        return nullptr;
+    }
+
+    TArray<Instruction> instrs;
+    instrs.resize_back(numInstructions);
+    if (in->read(instrs.data(), instrs.size_bytes()) != instrs.size_bytes()) {
+        return nullptr;
+    }
+    // Temp stack IDs index into per-stack arrays; the compiler only ever uses a handful of them.
+    static constexpr int kMaxStackID = 1024;
+    for (const Instruction& inst : instrs) {
+        if ((uint32_t)inst.fOp >= (uint32_t)BuilderOp::unsupported ||
+            inst.fStackID < 0 || inst.fStackID > kMaxStackID) {
+            return nullptr;
+        }
+    }
+    return std::make_unique<Program>(std::move(instrs), numValueSlots, numUniformSlots,
+                                     numImmutableSlots, numLabels, /*debugTrace=*/nullptr);
+}
+
 static bool immutable_data_is_splattable(int32_t* immutablePtr, int numSlots) {
     // If every value between `immutablePtr[0]` and `immutablePtr[numSlots]` is bit-identical, we
     // can use a splat.
@@ -23,6 +23,7 @@
 
 class SkArenaAlloc;
 class SkRasterPipeline;
+class SkStream;
 class SkWStream;
 using SkRPOffset = uint32_t;
 
@@ -167,6 +168,15 @@ public:
 
     void dump(SkWStream* out, bool writeInstructionCount = false) const;
 
+    // Writes the program in a form that Deserialize() can read back. The data is only meaningful
+    // to a process built with the same op lists; Deserialize() rejects anything else. Programs
+    // which write to a debug trace can't be serialized, and return false.
+    bool serialize(SkWStream* out) const;
+
+    // Recreates a program written by serialize(), or returns null if the data isn't valid. Only
+    // the framing and op values are checked, so the data must come from a trusted source.
+    static std::unique_ptr<Program> Deserialize(SkStream* in);
+
     int numUniforms() const { return fNumUniformSlots; }
 
 private:
@@ -6,6 +6,7 @@
  */
 
 #include "include/codec/SkAndroidCodec.h"
+#include "include/codec/SkBatchDecoder.h"
 #include "include/codec/SkCodec.h"
 #include "include/codec/SkEncodedImageFormat.h"
 #include "include/codec/SkGifDecoder.h"
@@ -19,6 +20,7 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkImageInfo.h"
@@ -58,6 +60,7 @@
 #include <setjmp.h>
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <initializer_list>
@@ -413,9 +416,10 @@ static void check_subset_decode(skiatest::Reporter* r,
             if (!supportsIncomplete) {
                 REPORTER_ASSERT(r, result == SkCodec::kSuccess);
             }
-            // Webp is the only codec that supports subsets, and it will have modified the subset
-            // to have even left/top.
-            REPORTER_ASSERT(r, SkIsAlign2(subset.fLeft) && SkIsAlign2(subset.fTop));
+            // Webp will have modified the subset to have even left/top.
+            if (SkEncodedImageFormat::kWEBP == codec->getEncodedFormat()) {
+                REPORTER_ASSERT(r, SkIsAlign2(subset.fLeft) && SkIsAlign2(subset.fTop));
+            }
         } else {
             // No subsets will work.
             REPORTER_ASSERT(r, result == SkCodec::kUnimplemented);
@@ -568,22 +572,178 @@ DEF_TEST(Codec_jpg, r) {
 }
 
 DEF_TEST(Codec_png, r) {
-    check(r, "images/arrow.png", SkISize::Make(187, 312), false, false, true, true);
-    check(r, "images/baby_tux.png", SkISize::Make(240, 246), false, false, true, true);
-    check(r, "images/color_wheel.png", SkISize::Make(128, 128), false, false, true, true);
+    check(r, "images/arrow.png", SkISize::Make(187, 312), false, true, true, true);
+    check(r, "images/baby_tux.png", SkISize::Make(240, 246), false, true, true, true);
+    check(r, "images/color_wheel.png", SkISize::Make(128, 128), false, true, true, true);
     // half-transparent-white-pixel.png is too small to test incomplete
-    check(r, "images/half-transparent-white-pixel.png", SkISize::Make(1, 1), false, false, false, true);
-    check(r, "images/mandrill_128.png", SkISize::Make(128, 128), false, false, true, true);
+    check(r, "images/half-transparent-white-pixel.png", SkISize::Make(1, 1), false, true, false, true);
+    check(r, "images/mandrill_128.png", SkISize::Make(128, 128), false, true, true, true);
     // mandrill_16.png is too small (relative to embedded sRGB profile) to test incomplete
-    check(r, "images/mandrill_16.png", SkISize::Make(16, 16), false, false, false, true);
-    check(r, "images/mandrill_256.png", SkISize::Make(256, 256), false, false, true, true);
-    check(r, "images/mandrill_32.png", SkISize::Make(32, 32), false, false, true, true);
-    check(r, "images/mandrill_512.png", SkISize::Make(512, 512), false, false, true, true);
-    check(r, "images/mandrill_64.png", SkISize::Make(64, 64), false, false, true, true);
-    check(r, "images/plane.png", SkISize::Make(250, 126), false, false, true, true);
-    check(r, "images/plane_interlaced.png", SkISize::Make(250, 126), false, false, true, true);
-    check(r, "images/randPixels.png", SkISize::Make(8, 8), false, false, true, true);
-    check(r, "images/yellow_rose.png", SkISize::Make(400, 301), false, false, true, true);
+    check(r, "images/mandrill_16.png", SkISize::Make(16, 16), false, true, false, true);
+    check(r, "images/mandrill_256.png", SkISize::Make(256, 256), false, true, true, true);
+    check(r, "images/mandrill_32.png", SkISize::Make(32, 32), false, true, true, true);
+    check(r, "images/mandrill_512.png", SkISize::Make(512, 512), false, true, true, true);
+    check(r, "images/mandrill_64.png", SkISize::Make(64, 64), false, true, true, true);
+    check(r, "images/plane.png", SkISize::Make(250, 126), false, true, true, true);
+    check(r, "images/plane_interlaced.png", SkISize::Make(250, 126), false, true, true, true);
+    check(r, "images/randPixels.png", SkISize::Make(8, 8), false, true, true, true);
+    check(r, "images/yellow_rose.png", SkISize::Make(400, 301), false, true, true, true);
+}
+
+// A subset decode matches the same pixels of a full decode, without decoding into a buffer the
+// size of the whole image.
+DEF_TEST(Codec_png_subset, r) {
+    auto p3 = SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB, SkNamedGamut::kDisplayP3);
+    for (const char* path : {"images/mandrill_512.png", "images/plane_interlaced.png",
+                             "images/randPixels.png", "images/yellow_rose.png"}) {
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromStream(GetResourceAsStream(path));
+        if (!codec) {
+            ERRORF(r, "Unable to decode '%s'", path);
+            continue;
+        }
+        for (sk_sp<SkColorSpace> colorSpace : {codec->getInfo().refColorSpace(), p3}) {
+            const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType)
+                                                     .makeColorSpace(colorSpace);
+            SkBitmap full;
+            full.allocPixels(info);
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(full.pixmap()));
+
+            const int w = info.width(),
+                      h = info.height();
+            for (SkIRect subset : {SkIRect::MakeWH(w, h), SkIRect::MakeXYWH(w / 3, h / 2, 1, 1),
+                                   SkIRect::MakeLTRB(1, 3, w, h), SkIRect::MakeWH(w / 2, h / 3),
+                                   SkIRect::MakeLTRB(w / 4, h / 4, 3 * w / 4, 3 * h / 4)}) {
+                SkCodec::Options options;
+                options.fSubset = &subset;
+                SkBitmap bm;
+                bm.allocPixels(info.makeDimensions(subset.size()));
+                REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(bm.pixmap(), &options),
+                                "%s", path);
+
+                SkPixmap expected;
+                SkAssertResult(full.pixmap().extractSubset(&expected, subset));
+                REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, bm.pixmap()),
+                                "%s: subset %d %d %d %d", path, subset.fLeft, subset.fTop,
+                                subset.fRight, subset.fBottom);
+            }
+        }
+    }
+}
+
+// A subset of a truncated PNG matches the same pixels of a truncated full decode, rows that were
+// never decoded included. The fill is as wide as the subset, leaving the rest of each row alone.
+DEF_TEST(Codec_png_subset_incomplete, r) {
+    for (const char* path : {"images/mandrill_512.png", "images/plane_interlaced.png",
+                             "images/yellow_rose.png"}) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            ERRORF(r, "Missing resource '%s'", path);
+            continue;
+        }
+        data = SkData::MakeSubset(data.get(), 0, data->size() / 2);
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+        if (!codec) {
+            ERRORF(r, "Unable to decode '%s'", path);
+            continue;
+        }
+        const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType)
+                                                 .makeAlphaType(kPremul_SkAlphaType);
+        SkBitmap full;
+        full.allocPixels(info);
+        REPORTER_ASSERT(r, SkCodec::kIncompleteInput == codec->getPixels(full.pixmap()));
+
+        const int w = info.width(),
+                  h = info.height();
+        for (SkIRect subset : {SkIRect::MakeLTRB(w / 4, h / 8, 3 * w / 4, h),
+                               SkIRect::MakeLTRB(1, h / 3, w / 2, 5 * h / 6)}) {
+            // Each row has room for more pixels than the subset, which must keep their color.
+            constexpr SkColor kUntouched = 0xFF123456;
+            const SkImageInfo subsetInfo = info.makeDimensions(subset.size());
+            SkBitmap bm;
+            bm.allocPixels(subsetInfo.makeWH(subset.width() + 16, subset.height()));
+            bm.eraseColor(kUntouched);
+            SkPixmap actual(subsetInfo, bm.getPixels(), bm.rowBytes());
+
+            SkCodec::Options options;
+            options.fSubset = &subset;
+            REPORTER_ASSERT(r, SkCodec::kIncompleteInput == codec->getPixels(actual, &options),
+                            "%s", path);
+
+            SkPixmap expected;
+            SkAssertResult(full.pixmap().extractSubset(&expected, subset));
+            REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, actual),
+                            "%s: subset %d %d %d %d", path, subset.fLeft, subset.fTop,
+                            subset.fRight, subset.fBottom);
+            for (int y = 0; y < subset.height(); ++y) {
+                for (int x = subset.width(); x < subset.width() + 16; ++x) {
+                    if (*bm.getAddr32(x, y) != SkPreMultiplyColor(kUntouched)) {
+                        ERRORF(r, "%s: pixel %d, %d past the subset was written", path, x, y);
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Decodes PNGs with and without ICC profiles (several sharing one), a JPEG and data that is not an
+// image, full size and resized, checking that SkBatchDecoder matches decoding each one alone.
+DEF_TEST(Codec_batch, r) {
+    const char* paths[] = {"images/mandrill_16.png", "images/color_wheel_with_profile.png",
+                           "images/mandrill_32.png", "images/randPixels.png",
+                           "images/wide-gamut.png",  "images/mandrill_64.png",
+                           "images/color_wheel.jpg", "images/mandrill_16.png"};
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    for (bool resize : {false, true}) {
+        std::vector<SkBitmap> expected, bitmaps;
+        std::vector<SkBatchDecoder::Image> images;
+        for (const char* path : paths) {
+            sk_sp<SkData> data = GetResourceAsData(path);
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+            if (!codec) {
+                ERRORF(r, "Unable to decode '%s'", path);
+                return;
+            }
+            SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType)
+                                               .makeAlphaType(kPremul_SkAlphaType);
+            if (resize) {
+                info = info.makeWH(info.width() / 3 + 1, info.height() / 2 + 1);
+            }
+            expected.emplace_back().allocPixels(info);
+            REPORTER_ASSERT(r, SkCodec::kSuccess ==
+                               codec->getResizedPixels(expected.back().pixmap()));
+            bitmaps.emplace_back().allocPixels(info);
+        }
+        for (size_t i = 0; i < bitmaps.size(); i++) {
+            images.push_back({GetResourceAsData(paths[i]), bitmaps[i].pixmap()});
+        }
+        SkBitmap garbage;
+        garbage.allocN32Pixels(4, 4);
+        images.push_back(
+                {SkData::MakeWithCString("This is not an image, and it is long enough to tell."),
+                 garbage.pixmap()});
+        images.push_back({nullptr, garbage.pixmap()});
+
+        for (SkExecutor* batchExecutor : {(SkExecutor*)nullptr, executor.get()}) {
+            SkBatchDecoder::Options options;
+            options.fExecutor = batchExecutor;
+            SkBatchDecoder decoder(options);
+            // The second batch decodes with profiles remembered from the first.
+            for (int batch = 0; batch < 2; batch++) {
+                for (SkBitmap& bm : bitmaps) {
+                    bm.eraseColor(SK_ColorTRANSPARENT);
+                }
+                decoder.decode(images);
+                for (size_t i = 0; i < bitmaps.size(); i++) {
+                    REPORTER_ASSERT(r, images[i].fResult == SkCodec::kSuccess, "%s", paths[i]);
+                    REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected[i], bitmaps[i]),
+                                    "%s: resize %d, batch %d", paths[i], resize, batch);
+                }
+                REPORTER_ASSERT(r, images[bitmaps.size()].fResult == SkCodec::kUnimplemented);
+                REPORTER_ASSERT(r, images[bitmaps.size() + 1].fResult == SkCodec::kInvalidInput);
+            }
+        }
+    }
 }
 
 // Disable RAW tests for Win32.
@@ -2081,3 +2241,232 @@ DEF_TEST(Codec_jpeg_can_return_data_from_original_stream, r) {
     REPORTER_ASSERT(r, encodedData->size() == expectedBytes);
     REPORTER_ASSERT(r, SkJpegDecoder::IsJpeg(encodedData->data(), encodedData->size()));
 }
+
+static void check_parallel_jpeg_decode(skiatest::Reporter* r, const char* path,
+                                       sk_sp<SkData> data, SkExecutor* executor) {
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+    if (!codec) {
+        ERRORF(r, "Unable to create codec '%s'.", path);
+        return;
+    }
+
+    auto p3 = SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB, SkNamedGamut::kDisplayP3);
+    const std::pair<SkColorType, sk_sp<SkColorSpace>> configs[] = {
+            {kN32_SkColorType, nullptr},
+            {kRGB_565_SkColorType, nullptr},
+            {kN32_SkColorType, p3},
+            {kRGBA_F16_SkColorType, p3},
+    };
+    for (float scale : {1.0f, 0.5f, 0.125f}) {
+        const SkISize dims = codec->getScaledDimensions(scale);
+        for (const auto& [colorType, colorSpace] : configs) {
+            const SkImageInfo info = SkImageInfo::Make(dims, colorType, kOpaque_SkAlphaType,
+                                                       colorSpace);
+            SkBitmap serial, parallel;
+            serial.allocPixels(info);
+            parallel.allocPixels(info);
+            serial.eraseColor(SK_ColorRED);
+            parallel.eraseColor(SK_ColorBLUE);
+
+            SkCodec::Options options;
+            const SkCodec::Result expected = codec->getPixels(serial.pixmap(), &options);
+            options.fExecutor = executor;
+            const SkCodec::Result result = codec->getPixels(parallel.pixmap(), &options);
+            REPORTER_ASSERT(r, result == expected, "%s: %s != %s", path,
+                            SkCodec::ResultToString(result), SkCodec::ResultToString(expected));
+            REPORTER_ASSERT(r, 0 == memcmp(serial.getPixels(), parallel.getPixels(),
+                                           serial.computeByteSize()),
+                            "%s: %dx%d, color type %d", path, dims.width(), dims.height(),
+                            colorType);
+        }
+    }
+}
+
+DEF_TEST(Codec_jpeg_parallelDecode, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(3);
+    // These images have a restart marker at the end of each MCU row.
+    for (const char* path : {"images/iphone_13_pro.jpeg", "images/iphone_15.jpeg"}) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        check_parallel_jpeg_decode(r, path, data, executor.get());
+
+        // Without the end of the image, it is decoded serially.
+        check_parallel_jpeg_decode(r, path, SkData::MakeSubset(data.get(), 0, data->size() / 2),
+                                   executor.get());
+    }
+}
+
+// The smallest size the codec decodes to natively that covers size, which getResizedPixels()
+// decodes at before resampling.
+static SkISize native_size_covering(SkCodec* codec, SkISize size) {
+    SkISize best = codec->dimensions();
+    for (int i = 1; i < 256; i++) {
+        const SkISize native = codec->getScaledDimensions(i / 256.0f);
+        if (native.width() >= size.width() && native.height() >= size.height() &&
+            native.area() < best.area()) {
+            best = native;
+        }
+    }
+    return best;
+}
+
+// Resamples src (premultiplied float RGBA) to dstSize directly in two dimensions, with the
+// Mitchell cubic stretched by the scale factor when downscaling, in doubles.
+static std::vector<float> reference_resize(const SkPixmap& src, SkISize dstSize) {
+    auto weights = [](int srcSize, int dstSize, int i, int* start) {
+        const double scale = (double)srcSize / dstSize,
+                     filterScale = std::max(1.0, scale),
+                     center = (i + 0.5) * scale;
+        std::vector<double> w;
+        double sum = 0;
+        *start = -1;
+        for (int j = 0; j < srcSize; j++) {
+            const double x = std::fabs((j + 0.5 - center) / filterScale);
+            if (x >= 2) {
+                continue;
+            }
+            const double k = x < 1 ? (7 * x * x * x - 12 * x * x + 16.0 / 3) / 6
+                                   : (-7.0 / 3 * x * x * x + 12 * x * x - 20 * x + 32.0 / 3) / 6;
+            if (*start < 0) {
+                *start = j;
+            }
+            w.push_back(k);
+            sum += k;
+        }
+        for (double& k : w) {
+            k /= sum;
+        }
+        return w;
+    };
+
+    std::vector<float> dst((size_t)dstSize.area() * 4);
+    for (int y = 0; y < dstSize.height(); y++) {
+        int startY;
+        std::vector<double> wy = weights(src.height(), dstSize.height(), y, &startY);
+        for (int x = 0; x < dstSize.width(); x++) {
+            int startX;
+            std::vector<double> wx = weights(src.width(), dstSize.width(), x, &startX);
+            double px[4] = {0, 0, 0, 0};
+            for (size_t j = 0; j < wy.size(); j++) {
+                const float* row = (const float*)src.addr(0, startY + (int)j);
+                for (size_t i = 0; i < wx.size(); i++) {
+                    for (int c = 0; c < 4; c++) {
+                        px[c] += wy[j] * wx[i] * row[(startX + i) * 4 + c];
+                    }
+                }
+            }
+            float* out = dst.data() + ((size_t)y * dstSize.width() + x) * 4;
+            out[3] = (float)std::clamp(px[3], 0.0, 1.0);
+            for (int c = 0; c < 3; c++) {
+                out[c] = (float)std::clamp(px[c], 0.0, (double)out[3]);
+            }
+        }
+    }
+    return dst;
+}
+
+// Checks getResizedPixels() against a full decode at the same native size followed by
+// reference_resize(), to within a little more than 8-bit rounding.
+static void check_resized_pixels(skiatest::Reporter* r, const char* name, sk_sp<SkData> data,
+                                 SkISize size) {
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+    REPORTER_ASSERT(r, codec);
+    const SkAlphaType alphaType = kOpaque_SkAlphaType == codec->getInfo().alphaType()
+            ? kOpaque_SkAlphaType
+            : kPremul_SkAlphaType;
+    SkBitmap resized;
+    resized.allocPixels(SkImageInfo::Make(size, kRGBA_8888_SkColorType, alphaType));
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getResizedPixels(resized.pixmap()));
+
+    SkBitmap native;
+    native.allocPixels(SkImageInfo::Make(native_size_covering(codec.get(), size),
+                                         kRGBA_8888_SkColorType, alphaType));
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(native.pixmap()));
+    SkBitmap nativeF32;
+    nativeF32.allocPixels(native.info().makeColorType(kRGBA_F32_SkColorType));
+    REPORTER_ASSERT(r, native.readPixels(nativeF32.pixmap()));
+    const std::vector<float> expected = reference_resize(nativeF32.pixmap(), size);
+
+    for (int y = 0; y < size.height(); y++) {
+        const uint8_t* row = (const uint8_t*)resized.getAddr(0, y);
+        for (int x = 0; x < size.width(); x++) {
+            for (int c = 0; c < 4; c++) {
+                const float want = expected[((size_t)y * size.width() + x) * 4 + c] * 255;
+                if (std::fabs(row[x * 4 + c] - want) > 1.5f) {
+                    ERRORF(r, "%s at %dx%d (decoded at %dx%d): pixel (%d, %d) channel %d is %d,"
+                              " expected %g", name, size.width(), size.height(),
+                              native.width(), native.height(), x, y, c, row[x * 4 + c], want);
+                    return;
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(Codec_getResizedPixels, r) {
+    // A size the codec decodes to natively is decoded as it is.
+    if (sk_sp<SkData> data = GetResourceAsData("images/mandrill_512_q075.jpg")) {
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+        const SkImageInfo info = codec->getInfo().makeWH(256, 256).makeColorType(kN32_SkColorType);
+        SkBitmap resized, scaled;
+        resized.allocPixels(info);
+        scaled.allocPixels(info);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getResizedPixels(resized.pixmap()));
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(scaled.pixmap()));
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(resized, scaled));
+    }
+
+    // Any other size is resampled, which keeps a solid color as it is.
+    SkBitmap solid;
+    solid.allocN32Pixels(37, 23);
+    solid.eraseColor(0xFF2080C0);
+    SkDynamicMemoryWStream stream;
+    REPORTER_ASSERT(r, SkPngEncoder::Encode(&stream, solid.pixmap(), {}));
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(stream.detachAsData());
+    for (SkISize size : {SkISize{10, 7}, SkISize{1, 1}, SkISize{37, 5}, SkISize{80, 50}}) {
+        for (SkColorType colorType : {kN32_SkColorType, kRGBA_F16_SkColorType}) {
+            SkBitmap resized;
+            resized.allocPixels(SkImageInfo::Make(size, colorType, kPremul_SkAlphaType));
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getResizedPixels(resized.pixmap()));
+            for (int y = 0; y < size.height(); y++) {
+                for (int x = 0; x < size.width(); x++) {
+                    if (resized.getColor(x, y) != 0xFF2080C0) {
+                        ERRORF(r, "%dx%d, color type %d: pixel (%d, %d) is %08x", size.width(),
+                               size.height(), colorType, x, y, resized.getColor(x, y));
+                        return;
+                    }
+                }
+            }
+        }
+    }
+    // A translucent texture is resampled as a direct, two-dimensional cubic filter would, up and
+    // down and in either direction alone.
+    SkBitmap texture;
+    texture.allocPixels(SkImageInfo::Make(97, 61, kRGBA_8888_SkColorType, kUnpremul_SkAlphaType));
+    for (int y = 0; y < texture.height(); y++) {
+        for (int x = 0; x < texture.width(); x++) {
+            uint8_t* px = (uint8_t*)texture.getAddr(x, y);
+            px[0] = ((x / 3 + y / 2) & 1) ? 0xF0 : 0x10;
+            px[1] = (x * y) & 0xFF;
+            px[2] = (x * 7 + y * 13) & 0xFF;
+            px[3] = 0x40 + (x * 191) / 96;
+        }
+    }
+    SkDynamicMemoryWStream textureStream;
+    REPORTER_ASSERT(r, SkPngEncoder::Encode(&textureStream, texture.pixmap(), {}));
+    sk_sp<SkData> png = textureStream.detachAsData();
+    for (SkISize size : {SkISize{31, 19}, SkISize{10, 7}, SkISize{150, 100}, SkISize{200, 20},
+                         SkISize{97, 40}}) {
+        check_resized_pixels(r, "texture.png", png, size);
+    }
+
+    // A JPEG is decoded at the smallest native scale that covers the size, then resampled.
+    if (sk_sp<SkData> jpeg = GetResourceAsData("images/mandrill_512_q075.jpg")) {
+        for (SkISize size : {SkISize{200, 150}, SkISize{100, 100}, SkISize{300, 290},
+                             SkISize{61, 500}}) {
+            check_resized_pixels(r, "mandrill_512_q075.jpg", jpeg, size);
+        }
+    }
+}
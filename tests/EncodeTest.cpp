@@ -12,13 +12,17 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorPriv.h"
+#include "include/core/SkColorSpace.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSize.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkTypes.h"
@@ -343,6 +347,111 @@ DEF_TEST(Encode_PngOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm0, bm2, 0));
 }
 
+DEF_TEST(Encode_PngParallel, r) {
+    SkBitmap bitmap;
+    bool success = ToolUtils::GetResourceAsBitmap("images/mandrill_512.png", &bitmap);
+    if (!success) {
+        return;
+    }
+
+    std::unique_ptr<SkExecutor> executor1 = SkExecutor::MakeFIFOThreadPool(1);
+    std::unique_ptr<SkExecutor> executor4 = SkExecutor::MakeFIFOThreadPool(4);
+    for (SkColorType colorType : {kRGBA_8888_SkColorType, kGray_8_SkColorType,
+                                  kRGBA_F16_SkColorType}) {
+        SkBitmap src;
+        src.allocPixels(bitmap.info().makeColorType(colorType));
+        REPORTER_ASSERT(r, bitmap.readPixels(src.pixmap()));
+
+        for (SkPngEncoder::FilterFlag filters : {SkPngEncoder::FilterFlag::kAll,
+                                                 SkPngEncoder::FilterFlag::kNone,
+                                                 SkPngEncoder::FilterFlag::kPaeth}) {
+            for (int zlibLevel : {0, 6}) {
+                SkPngEncoder::Options options;
+                options.fFilterFlags = filters;
+                options.fZLibLevel = zlibLevel;
+                SkDynamicMemoryWStream serial, parallel1, parallel4;
+                REPORTER_ASSERT(r, SkPngEncoder::Encode(&serial, src.pixmap(), options));
+                options.fExecutor = executor1.get();
+                REPORTER_ASSERT(r, SkPngEncoder::Encode(&parallel1, src.pixmap(), options));
+                options.fExecutor = executor4.get();
+                REPORTER_ASSERT(r, SkPngEncoder::Encode(&parallel4, src.pixmap(), options));
+
+                // The output should not depend on the number of threads...
+                sk_sp<SkData> data1 = parallel1.detachAsData();
+                sk_sp<SkData> data4 = parallel4.detachAsData();
+                REPORTER_ASSERT(r, data1->equals(data4.get()));
+
+                // ...and should decode to the same pixels as a serial encode.
+                SkBitmap bm0, bm1;
+                SkImages::DeferredFromEncodedData(serial.detachAsData())->asLegacyBitmap(&bm0);
+                SkImages::DeferredFromEncodedData(data1)->asLegacyBitmap(&bm1);
+                REPORTER_ASSERT(r, almost_equals(bm0, bm1, 0));
+            }
+        }
+    }
+}
+
+// Each tile from EncodeTiles should be exactly what encoding that part of the image gives, with
+// or without an executor, and carry the image's ICC profile.
+DEF_TEST(Encode_Tiles, r) {
+    SkBitmap bitmap;
+    if (!ToolUtils::GetResourceAsBitmap("images/mandrill_512.png", &bitmap)) {
+        return;
+    }
+    SkPixmap src = bitmap.pixmap();
+    src.setColorSpace(SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB, SkNamedGamut::kDisplayP3));
+
+    using EncodeProc = bool (*)(SkWStream*, const SkPixmap&);
+    using EncodeTilesProc = std::vector<sk_sp<SkData>> (*)(const SkPixmap&, SkISize, SkExecutor*);
+    const struct {
+        const char*     fName;
+        EncodeProc      fEncode;
+        EncodeTilesProc fEncodeTiles;
+    } formats[] = {
+        {"jpeg",
+         [](SkWStream* dst, const SkPixmap& pm) {
+             return SkJpegEncoder::Encode(dst, pm, SkJpegEncoder::Options());
+         },
+         [](const SkPixmap& pm, SkISize tileSize, SkExecutor* executor) {
+             return SkJpegEncoder::EncodeTiles(pm, tileSize, SkJpegEncoder::Options(), executor);
+         }},
+        {"webp",
+         [](SkWStream* dst, const SkPixmap& pm) {
+             return SkWebpEncoder::Encode(dst, pm, SkWebpEncoder::Options());
+         },
+         [](const SkPixmap& pm, SkISize tileSize, SkExecutor* executor) {
+             return SkWebpEncoder::EncodeTiles(pm, tileSize, SkWebpEncoder::Options(), executor);
+         }},
+    };
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    const SkISize tileSize = {200, 150};
+    for (const auto& format : formats) {
+        for (SkExecutor* tileExecutor : {(SkExecutor*)nullptr, executor.get()}) {
+            std::vector<sk_sp<SkData>> tiles = format.fEncodeTiles(src, tileSize, tileExecutor);
+            if (tiles.size() != 12) {
+                ERRORF(r, "%s: %zu tiles", format.fName, tiles.size());
+                continue;
+            }
+            for (int i = 0; i < 12; i++) {
+                SkPixmap tile;
+                SkAssertResult(src.extractSubset(&tile, SkIRect::MakeXYWH(i % 3 * 200, i / 3 * 150,
+                                                                          200, 150)));
+                SkDynamicMemoryWStream expected;
+                REPORTER_ASSERT(r, format.fEncode(&expected, tile));
+                REPORTER_ASSERT(r, expected.detachAsData()->equals(tiles[i].get()),
+                                "%s: tile %d", format.fName, i);
+
+                std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(tiles[i]);
+                REPORTER_ASSERT(r, codec && codec->dimensions() == tile.dimensions() &&
+                                   codec->getICCProfile(), "%s: tile %d", format.fName, i);
+            }
+        }
+
+        REPORTER_ASSERT(r, format.fEncodeTiles(src, {0, 256}, nullptr).empty());
+    }
+}
+
 #ifndef SK_BUILD_FOR_GOOGLE3
 DEF_TEST(Encode_WebpQuality, r) {
     SkBitmap bm;
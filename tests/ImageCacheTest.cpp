@@ -14,6 +14,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 namespace {
 static void* gGlobalAddress;
@@ -154,3 +155,45 @@ DEF_TEST(ImageCache_doubleAdd, r) {
     REPORTER_ASSERT(r, cache.find(key, TestingRec::Visitor, &value));
     REPORTER_ASSERT(r, 2 == value || 3 == value);
 }
+
+static void count_testing_recs(const SkResourceCache::Rec& rec, void* context) {
+    if (0 == strcmp(rec.getCategory(), "test_cache")) {
+        *static_cast<int*>(context) += 1;
+    }
+}
+
+// The global cache is split into shards; it should still look like one cache with one budget.
+DEF_SERIAL_TEST(ImageCache_globalShards, r) {
+    const size_t prevLimit = SkResourceCache::GetTotalByteLimit();
+    const size_t limit = 100 * sizeof(TestingRec) + 3;  // Not evenly divisible between shards.
+    SkResourceCache::SetTotalByteLimit(limit);
+    REPORTER_ASSERT(r, SkResourceCache::GetTotalByteLimit() == limit);
+
+    for (int i = 0; i < COUNT; ++i) {
+        SkResourceCache::Add(new TestingRec(TestingKey(i), i));
+    }
+    int found = 0;
+    for (int i = 0; i < COUNT; ++i) {
+        intptr_t value = -1;
+        if (SkResourceCache::Find(TestingKey(i), TestingRec::Visitor, &value)) {
+            REPORTER_ASSERT(r, value == i);
+            found += 1;
+        }
+    }
+    int visited = 0;
+    SkResourceCache::VisitAll(count_testing_recs, &visited);
+    REPORTER_ASSERT(r, visited == found);
+
+    // However the keys land in the shards, the sum of their usage stays within the budget.
+    for (int i = 0; i < COUNT * 100; ++i) {
+        SkResourceCache::Add(new TestingRec(TestingKey(i), i));
+        REPORTER_ASSERT(r, SkResourceCache::GetTotalBytesUsed() <= limit);
+    }
+
+    SkResourceCache::PurgeAll();
+    visited = 0;
+    SkResourceCache::VisitAll(count_testing_recs, &visited);
+    REPORTER_ASSERT(r, visited == 0);
+
+    REPORTER_ASSERT(r, SkResourceCache::SetTotalByteLimit(prevLimit) == limit);
+}
@@ -8,6 +8,8 @@
 #include "include/core/SkTypes.h"
 
 #ifdef SK_SUPPORT_PDF
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
 #include "include/private/base/SkDebug.h"
@@ -41,7 +43,8 @@ void skia_free_func(void*, void* address) { sk_free(address); }
  *  Use the un-deflate compression algorithm to decompress the data in src,
  *  returning the result.  Returns nullptr if an error occurs.
  */
-std::unique_ptr<SkStreamAsset> stream_inflate(skiatest::Reporter* reporter, SkStream* src) {
+std::unique_ptr<SkStreamAsset> stream_inflate(skiatest::Reporter* reporter, SkStream* src,
+                                              bool gzip = false) {
     SkDynamicMemoryWStream decompressedDynamicMemoryWStream;
     SkWStream* dst = &decompressedDynamicMemoryWStream;
 
@@ -57,7 +60,7 @@ std::unique_ptr<SkStreamAsset> stream_inflate(skiatest::Reporter* reporter, SkSt
     flateData.next_out = outputBuffer;
     flateData.avail_out = kBufferSize;
     int rc;
-    rc = inflateInit(&flateData);
+    rc = inflateInit2(&flateData, gzip ? 0x1F : 0x0F);
     if (rc != Z_OK) {
         ERRORF(reporter, "Zlib: inflateInit failed");
         return nullptr;
@@ -177,4 +180,69 @@ DEF_TEST(SkPDF_DeflateWStream, r) {
     REPORTER_ASSERT(r, !emptyDeflateWStream.writeText("FOO"));
 }
 
+static sk_sp<SkData> deflate_data(const SkData& data,
+                                  const SkDeflateWStream::Options& options,
+                                  SkRandom* random) {
+    SkDynamicMemoryWStream compressed;
+    SkDeflateWStream deflateWStream(&compressed, options);
+    for (size_t i = 0; i < data.size();) {
+        size_t writeSize = std::min<size_t>(data.size() - i, random->nextRangeU(1, 100000));
+        deflateWStream.write(data.bytes() + i, writeSize);
+        i += writeSize;
+    }
+    SkASSERT(deflateWStream.bytesWritten() == data.size());
+    deflateWStream.finalize();
+    return compressed.detachAsData();
+}
+
+DEF_TEST(SkPDF_DeflateWStream_parallel, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    constexpr size_t kBlock = SkDeflateWStream::kParallelBlockSize;
+    SkRandom random(654321);
+    for (size_t size : {size_t(0), size_t(1000), kBlock, kBlock + 1, 3 * kBlock,
+                        5 * kBlock + 12345}) {
+        // Something compressible, with matches that reach back across the block boundaries.
+        sk_sp<SkData> data = SkData::MakeUninitialized(size);
+        uint8_t* bytes = (uint8_t*)data->writable_data();
+        for (size_t i = 0; i < size; i++) {
+            bytes[i] = i >= 1000 && random.nextU() % 8 ? bytes[i - 1000 + random.nextU() % 8]
+                                                       : (uint8_t)('a' + random.nextU() % 26);
+        }
+
+        for (bool gzip : {false, true}) {
+            for (bool filtered : {false, true}) {
+                SkDeflateWStream::Options options;
+                options.fCompressionLevel = filtered ? 4 : -1;
+                options.fFiltered = filtered;
+                options.fGzip = gzip;
+                sk_sp<SkData> serial = deflate_data(*data, options, &random);
+                options.fExecutor = executor.get();
+                sk_sp<SkData> parallel = deflate_data(*data, options, &random);
+
+                // Inputs that fit in one block are compressed serially, and the rest do not
+                // depend on how they were written.
+                if (size <= kBlock) {
+                    REPORTER_ASSERT(r, parallel->equals(serial.get()), "size %zu", size);
+                } else {
+                    sk_sp<SkData> rewritten = deflate_data(*data, options, &random);
+                    REPORTER_ASSERT(r, parallel->equals(rewritten.get()), "size %zu", size);
+                }
+
+                SkMemoryStream compressed(parallel);
+                std::unique_ptr<SkStreamAsset> decompressed =
+                        stream_inflate(r, &compressed, gzip);
+                if (!decompressed) {
+                    ERRORF(r, "size %zu, gzip %d, filtered %d: decompression failed",
+                           size, gzip, filtered);
+                    continue;
+                }
+                sk_sp<SkData> roundTrip = SkData::MakeFromStream(decompressed.get(),
+                                                                 decompressed->getLength());
+                REPORTER_ASSERT(r, roundTrip->equals(data.get()),
+                                "size %zu, gzip %d, filtered %d", size, gzip, filtered);
+            }
+        }
+    }
+}
+
 #endif
@@ -25,6 +25,7 @@
 #include <cstdio>
 #include <cstring>
 #include <memory>
+#include <vector>
 
 static void test_empty(skiatest::Reporter* reporter) {
     SkDynamicMemoryWStream stream;
@@ -251,6 +252,45 @@ DEF_TEST(SkPDF_multiple_pages, r) {
     }
 }
 
+static int count(const SkDynamicMemoryWStream& stream, const char needle[]) {
+    std::vector<uint8_t> bytes(stream.bytesWritten());
+    stream.copyTo(bytes.data());
+    size_t len = strlen(needle);
+    int found = 0;
+    for (size_t i = 0; i + len <= bytes.size(); ++i) {
+        if (0 == memcmp(bytes.data() + i, needle, len)) {
+            ++found;
+        }
+    }
+    return found;
+}
+
+// With fStreamPages, each page object should be written when the page ends, and the page tree
+// written on close should still count every page.
+DEF_TEST(SkPDF_stream_pages, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_stream_pages, r);
+    for (bool streamPages : {false, true}) {
+        SkPDF::Metadata metadata;
+        metadata.fStreamPages = streamPages;
+        SkDynamicMemoryWStream wStream;
+        auto doc = SkPDF::MakeDocument(&wStream, metadata);
+        constexpr int kPageCount = 100;
+        for (int i = 0; i < kPageCount; ++i) {
+            doc->beginPage(612, 792)->drawColor(SK_ColorGREEN);
+            doc->endPage();
+            if (i == 19) {
+                // "/Tabs /S" is only written in page objects.
+                REPORTER_ASSERT(r, count(wStream, "/Tabs /S") == (streamPages ? 20 : 0));
+            }
+        }
+        doc->close();
+        REPORTER_ASSERT(r, count(wStream, "/Tabs /S") == kPageCount);
+        REPORTER_ASSERT(r, count(wStream, "/Count 100") == 1);
+        // 13 nodes of up to 8 pages, then 2 nodes over those and the root.
+        REPORTER_ASSERT(r, count(wStream, "/Type /Pages") == 16);
+    }
+}
+
 // Test to make sure that jobs launched by PDF backend don't cause a segfault
 // after calling abort().
 DEF_TEST(SkPDF_abort_jobs, rep) {
@@ -11,6 +11,7 @@
 #include "include/core/SkClipOp.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkFontStyle.h"
 #include "include/core/SkImage.h" // IWYU pragma: keep
@@ -22,11 +23,15 @@
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPixelRef.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSamplingOptions.h"
 #include "include/core/SkScalar.h"
+#include "include/core/SkSerialProcs.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkSurface.h"
+#include "include/core/SkTiledPictureUtils.h"
 #include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
 #include "src/base/SkRandom.h"
@@ -37,7 +42,9 @@
 #include "tools/fonts/FontToolUtils.h"
 
 #include <cstddef>
+#include <cstring>
 #include <memory>
+#include <optional>
 #include <vector>
 
 class SkRRect;
@@ -924,3 +931,184 @@ DEF_TEST(Picture_nested_op_count, r) {
     check(make_pic(10, leaf1),  10,  10);
     check(make_pic(10, leaf10), 10, 100);
 }
+
+DEF_TEST(Picture_RasterizeTiles, r) {
+    auto make_pic = [](SkBBHFactory* factory) {
+        SkPictureRecorder nestedRecorder;
+        nestedRecorder.beginRecording({0, 0, 50, 50})->drawOval({5, 10, 45, 40},
+                                                                SkPaint(SkColors::kYellow));
+        sk_sp<SkPicture> nested = nestedRecorder.finishRecordingAsPicture();
+
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording({0, 0, 300, 200}, factory);
+        SkRandom rand;
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 300; i++) {
+            paint.setColor(rand.nextU() | 0xFF000000);
+            SkRect rect = SkRect::MakeXYWH(rand.nextRangeScalar(-10, 300),
+                                           rand.nextRangeScalar(-10, 200),
+                                           rand.nextRangeScalar(1, 60),
+                                           rand.nextRangeScalar(1, 60));
+            if (i % 2) {
+                canvas->drawOval(rect, paint);
+            } else {
+                canvas->drawRect(rect, paint);
+            }
+            if (i % 50 == 0) {
+                SkMatrix m = SkMatrix::Translate(rect.fLeft, rect.fTop);
+                canvas->drawPicture(nested, &m, nullptr);
+            }
+        }
+        return recorder.finishRecordingAsPicture();
+    };
+
+    const SkIRect bounds = {10, 20, 290, 190};
+    const SkImageInfo tileInfo = SkImageInfo::MakeN32Premul(64, 48);
+    SkRTreeFactory factory;
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(3);
+    for (SkBBHFactory* bbh : {(SkBBHFactory*)&factory, (SkBBHFactory*)nullptr}) {
+        sk_sp<SkPicture> picture = make_pic(bbh);
+
+        for (SkExecutor* exec : {executor.get(), (SkExecutor*)nullptr}) {
+            std::vector<sk_sp<SkSurface>> tiles =
+                    SkTiledPictureUtils::RasterizeTiles(picture.get(), bounds, tileInfo, exec);
+            // 280x170 needs 5 columns and 4 rows of 64x48 tiles.
+            REPORTER_ASSERT(r, tiles.size() == 20);
+            for (int i = 0; i < (int)tiles.size(); i++) {
+                // Each tile should match drawing the whole picture into it directly.
+                SkBitmap expected;
+                expected.allocPixels(tileInfo);
+                expected.eraseColor(SK_ColorTRANSPARENT);
+                SkCanvas canvas(expected);
+                canvas.translate(-(bounds.fLeft + (i % 5) * 64), -(bounds.fTop + (i / 5) * 48));
+                canvas.clipIRect(bounds);
+                canvas.drawPicture(picture);
+
+                SkBitmap tile;
+                tile.allocPixels(tileInfo);
+                REPORTER_ASSERT(r, tiles[i]->readPixels(tile, 0, 0));
+                REPORTER_ASSERT(r, 0 == memcmp(tile.getPixels(), expected.getPixels(),
+                                               tile.computeByteSize()),
+                                "tile %d", i);
+            }
+        }
+    }
+
+    REPORTER_ASSERT(r, SkTiledPictureUtils::RasterizeTiles(make_pic(nullptr).get(), SkIRect{},
+                                                           SkImageInfo::MakeN32Premul(8, 8),
+                                                           nullptr).empty());
+}
+
+DEF_TEST(Picture_MakeFromDataWithoutCopy, r) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(16, 16);
+    bitmap.eraseColor(SK_ColorBLUE);
+    bitmap.erase(SK_ColorRED, {4, 4, 12, 12});
+    bitmap.setImmutable();
+
+    SkPictureRecorder nestedRecorder;
+    SkCanvas* nestedCanvas = nestedRecorder.beginRecording({0, 0, 50, 50});
+    nestedCanvas->drawOval({5, 10, 45, 40}, SkPaint(SkColors::kYellow));
+    nestedCanvas->drawImage(bitmap.asImage(), 30, 30);
+    sk_sp<SkPicture> nested = nestedRecorder.finishRecordingAsPicture();
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording({0, 0, 100, 100});
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    SkPath path;
+    path.moveTo(10, 10);
+    path.cubicTo(90, 0, 0, 90, 90, 90);
+    path.close();
+    canvas->drawPath(path, paint);
+    canvas->drawImage(bitmap.asImage(), 60, 10);
+    canvas->translate(20, 40);
+    canvas->drawPicture(nested);
+    paint.setColor(SK_ColorGREEN);
+    canvas->drawString("skia", 0, 50, ToolUtils::DefaultPortableFont(), paint);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    // Images are serialized as their raw pixels, so that we can see where they are read from.
+    SkSerialProcs serialProcs;
+    serialProcs.fImageProc = [](SkImage* image, void*) -> sk_sp<SkData> {
+        SkPixmap pixmap;
+        return image->peekPixels(&pixmap)
+                       ? SkData::MakeWithCopy(pixmap.addr(), pixmap.computeByteSize())
+                       : nullptr;
+    };
+    struct Context {
+        const SkData* serialized;
+        int imagesInPlace = 0;
+    };
+    SkDeserialProcs deserialProcs;
+    deserialProcs.fImageDataProc = [](sk_sp<SkData> data, std::optional<SkAlphaType>,
+                                      void* ctx) -> sk_sp<SkImage> {
+        auto context = static_cast<Context*>(ctx);
+        const uint8_t* begin = context->serialized->bytes();
+        if (data->bytes() >= begin &&
+            data->bytes() + data->size() <= begin + context->serialized->size()) {
+            context->imagesInPlace++;
+        }
+        return SkImages::RasterFromData(SkImageInfo::MakeN32Premul(16, 16), data, 16 * 4);
+    };
+
+    auto draw = [](const SkPicture* pic) {
+        SkBitmap bm;
+        bm.allocN32Pixels(100, 100);
+        bm.eraseColor(SK_ColorWHITE);
+        SkCanvas(bm).drawPicture(pic);
+        return bm;
+    };
+    auto same = [](const SkBitmap& a, const SkBitmap& b) {
+        return 0 == memcmp(a.getPixels(), b.getPixels(), a.computeByteSize());
+    };
+
+    // By default the sections of a picture are not padded, so loading it only reads the chunks
+    // that happen to be 4-byte aligned in place, and copies the others.
+    sk_sp<SkData> data = picture->serialize(&serialProcs);
+    REPORTER_ASSERT(r, data);
+    Context context = {data.get()};
+    deserialProcs.fImageCtx = &context;
+    sk_sp<SkPicture> mapped = SkPicture::MakeFromDataWithoutCopy(data, &deserialProcs);
+    REPORTER_ASSERT(r, mapped);
+    const SkBitmap unpadded = draw(mapped.get());
+
+    serialProcs.fAlignPictureSections = true;
+    data = picture->serialize(&serialProcs);
+    REPORTER_ASSERT(r, data);
+
+    context = {data.get()};
+    sk_sp<SkPicture> copied = SkPicture::MakeFromData(data.get(), &deserialProcs);
+    REPORTER_ASSERT(r, copied && data->unique());
+    const SkBitmap expected = draw(copied.get());
+    REPORTER_ASSERT(r, context.imagesInPlace == 0);
+    REPORTER_ASSERT(r, same(unpadded, expected));
+
+    // Both images are read in place, and the picture (and its nested picture) keep the data alive.
+    mapped = SkPicture::MakeFromDataWithoutCopy(data, &deserialProcs);
+    REPORTER_ASSERT(r, mapped && !data->unique());
+    REPORTER_ASSERT(r, context.imagesInPlace == 2);
+    REPORTER_ASSERT(r, mapped->cullRect() == picture->cullRect());
+    REPORTER_ASSERT(r, same(draw(mapped.get()), expected));
+    REPORTER_ASSERT(r, same(draw(mapped.get()), expected));
+
+    // Serializing the loaded picture round-trips.
+    sk_sp<SkPicture> reloaded =
+            SkPicture::MakeFromData(mapped->serialize(&serialProcs).get(), &deserialProcs);
+    REPORTER_ASSERT(r, reloaded && same(draw(reloaded.get()), expected));
+
+    mapped.reset();
+    REPORTER_ASSERT(r, data->unique());
+
+    // Data that is not 4-byte aligned is copied where it needs to be, but still loads.
+    sk_sp<SkData> padded = SkData::MakeUninitialized(data->size() + 1);
+    memcpy(static_cast<char*>(padded->writable_data()) + 1, data->data(), data->size());
+    sk_sp<SkData> unaligned = SkData::MakeSubset(padded.get(), 1, data->size());
+    context = {unaligned.get()};
+    mapped = SkPicture::MakeFromDataWithoutCopy(unaligned, &deserialProcs);
+    REPORTER_ASSERT(r, mapped && same(draw(mapped.get()), expected));
+
+    REPORTER_ASSERT(r, !SkPicture::MakeFromDataWithoutCopy(nullptr));
+    REPORTER_ASSERT(r, !SkPicture::MakeFromDataWithoutCopy(SkData::MakeSubset(data.get(), 0, 40)));
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/base/SkRandom.h"
+#include "src/core/SkPngFilter.h"
+#include "tests/Test.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// The filters as written in the PNG specification.
+static uint8_t reference_filter(int type, const uint8_t* row, const uint8_t* prev, size_t i,
+                                size_t bpp) {
+    const int a = i >= bpp ? row[i - bpp] : 0,
+              b = prev[i],
+              c = i >= bpp ? prev[i - bpp] : 0;
+    int predicted = 0;
+    switch (type) {
+        case 1: predicted = a; break;
+        case 2: predicted = b; break;
+        case 3: predicted = (a + b) / 2; break;
+        case 4: {
+            const int p = a + b - c,
+                      pa = std::abs(p - a),
+                      pb = std::abs(p - b),
+                      pc = std::abs(p - c);
+            predicted = pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+            break;
+        }
+    }
+    return (uint8_t)(row[i] - predicted);
+}
+
+DEF_TEST(PngFilter, r) {
+    SkRandom random;
+    for (size_t bpp : {1, 2, 3, 4, 6, 8}) {
+        for (size_t rowBytes : {bpp, 5 * bpp, 16 * bpp, 129 * bpp, 1000 * bpp}) {
+            // Both rows are preceded by bpp zero bytes, as png_filter_row() requires.
+            std::vector<uint8_t> rows(2 * (bpp + rowBytes), 0);
+            uint8_t* prev = rows.data() + bpp;
+            uint8_t* row = prev + rowBytes + bpp;
+            for (size_t i = 0; i < rowBytes; i++) {
+                // Mix smooth runs with noise, so every Paeth predictor gets picked.
+                prev[i] = (uint8_t)(i % 3 ? i : random.nextU());
+                row[i] = (uint8_t)(i % 5 ? prev[i] + i : random.nextU());
+            }
+
+            for (int type = 0; type <= 4; type++) {
+                std::vector<uint8_t> dst(rowBytes);
+                const uint64_t sum =
+                        SkOpts::png_filter_row(type, row, prev, rowBytes, bpp, dst.data(),
+                                               UINT64_MAX);
+                uint64_t expectedSum = 0;
+                for (size_t i = 0; i < rowBytes; i++) {
+                    const uint8_t expected = reference_filter(type, row, prev, i, bpp);
+                    if (dst[i] != expected) {
+                        ERRORF(r, "type %d, bpp %zu, rowBytes %zu: byte %zu is %d, expected %d",
+                               type, bpp, rowBytes, i, dst[i], expected);
+                        break;
+                    }
+                    expectedSum += expected < 128 ? expected : 256 - expected;
+                }
+                REPORTER_ASSERT(r, sum == expectedSum, "type %d, bpp %zu, rowBytes %zu",
+                                type, bpp, rowBytes);
+
+                // Stopping early still reports a sum of at least the limit.
+                if (expectedSum > 0) {
+                    REPORTER_ASSERT(r, SkOpts::png_filter_row(type, row, prev, rowBytes, bpp,
+                                                              dst.data(), expectedSum / 2) >=
+                                       expectedSum / 2);
+                }
+            }
+        }
+    }
+}
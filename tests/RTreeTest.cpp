@@ -9,9 +9,11 @@
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/base/SkRandom.h"
+#include "src/core/SkFlatRTree.h"
 #include "src/core/SkRTree.h"
 #include "tests/Test.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <vector>
@@ -53,7 +55,7 @@ static bool verify_query(SkRect query, SkRect rects[], const std::vector<int>& f
 }
 
 static void run_queries(skiatest::Reporter* reporter, SkRandom& rand, SkRect rects[],
-                        const SkRTree& tree) {
+                        const SkBBoxHierarchy& tree) {
     for (size_t i = 0; i < NUM_QUERIES; ++i) {
         std::vector<int> hits;
         SkRect query = random_rect(rand);
@@ -62,6 +64,19 @@ static void run_queries(skiatest::Reporter* reporter, SkRandom& rand, SkRect rec
     }
 }
 
+static void run_batched_queries(skiatest::Reporter* reporter, SkRandom& rand, SkRect rects[],
+                                const SkBBoxHierarchy& tree) {
+    SkRect queries[NUM_QUERIES];
+    for (size_t i = 0; i < NUM_QUERIES; ++i) {
+        queries[i] = random_rect(rand);
+    }
+    std::vector<int> hits[NUM_QUERIES];
+    tree.searchBatch(queries, hits);
+    for (size_t i = 0; i < NUM_QUERIES; ++i) {
+        REPORTER_ASSERT(reporter, verify_query(queries[i], rects, hits[i]));
+    }
+}
+
 DEF_TEST(RTree, reporter) {
     int expectedDepthMin = -1;
     int tmp = NUM_RECTS;
@@ -92,8 +107,52 @@ DEF_TEST(RTree, reporter) {
         rtree.insert(rects.data(), NUM_RECTS);
 
         run_queries(reporter, rand, rects.data(), rtree);
+        run_batched_queries(reporter, rand, rects.data(), rtree);
         REPORTER_ASSERT(reporter, NUM_RECTS == rtree.getCount());
         REPORTER_ASSERT(reporter, expectedDepthMin <= rtree.getDepth() &&
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+DEF_TEST(FlatRTree, reporter) {
+    SkRandom rand;
+    AutoTArray<SkRect> rects(NUM_RECTS);
+    for (size_t i = 0; i < NUM_ITERATIONS; ++i) {
+        for (int j = 0; j < NUM_RECTS; j++) {
+            rects[j] = random_rect(rand);
+        }
+        // Empty rects are skipped, which must not throw off the op indices of the others.
+        if (i % 2) {
+            for (int j = 0; j < NUM_RECTS; j += 7) {
+                rects[j] = SkRect::MakeXYWH(rects[j].fLeft, rects[j].fTop, 0, 10);
+            }
+        }
+
+        SkFlatRTree tree;
+        tree.insert(rects.data(), NUM_RECTS);
+        run_queries(reporter, rand, rects.data(), tree);
+        run_batched_queries(reporter, rand, rects.data(), tree);
+
+        // 200 rects need 25 leaves, 4 nodes above those, and a root.
+        REPORTER_ASSERT(reporter, 3 == tree.getDepth());
+        if (i == 0) {
+            SkRTree rtree;
+            rtree.insert(rects.data(), NUM_RECTS);
+            REPORTER_ASSERT(reporter, NUM_RECTS == tree.getCount());
+            REPORTER_ASSERT(reporter, tree.bytesUsed() < rtree.bytesUsed());
+        }
+    }
+
+    // Trees that fit in one node, or just overflow one.
+    for (int count : {0, 1, SkFlatRTree::kBranching, SkFlatRTree::kBranching + 1}) {
+        SkFlatRTree tree;
+        tree.insert(rects.data(), count);
+        std::vector<int> hits;
+        tree.search(SkRect::MakeLTRB(-1, -1, 1001, 1001), &hits);
+        REPORTER_ASSERT(reporter, count == (int)hits.size());
+        REPORTER_ASSERT(reporter, std::is_sorted(hits.begin(), hits.end()));
+        hits.clear();
+        tree.search(SkRect::MakeEmpty(), &hits);
+        REPORTER_ASSERT(reporter, hits.empty());
+    }
+}
@@ -0,0 +1,333 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkBlendMode.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkImageFilter.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkSize.h"
+#include "include/core/SkSurface.h"
+#include "include/core/SkTileMode.h"
+#include "include/effects/SkGradientShader.h"
+#include "include/effects/SkImageFilters.h"
+#include "src/base/SkRandom.h"
+#include "tests/Test.h"
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+static constexpr int kW = 500, kH = 300;
+
+static void draw_scene(SkCanvas* canvas) {
+    SkRandom rand;
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 200; ++i) {
+        paint.setColor(rand.nextU() | 0x40000000);
+        SkRect r = SkRect::MakeXYWH(rand.nextRangeScalar(-20, kW),
+                                    rand.nextRangeScalar(-20, kH),
+                                    rand.nextRangeScalar(1, 120),
+                                    rand.nextRangeScalar(1, 120));
+        switch (i % 4) {
+            case 0: canvas->drawRect(r, paint); break;
+            case 1: canvas->drawOval(r, paint); break;
+            case 2: canvas->drawRRect(SkRRect::MakeRectXY(r, 9, 5), paint); break;
+            case 3: canvas->drawLine(r.fLeft, r.fTop, r.fRight, r.fBottom, paint); break;
+        }
+    }
+
+    const SkPoint pts[] = {{0, 0}, {kW, kH}};
+    const SkColor colors[] = {SK_ColorRED, SK_ColorTRANSPARENT, SK_ColorBLUE};
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 3, SkTileMode::kClamp));
+    paint.setBlendMode(SkBlendMode::kMultiply);
+    canvas->save();
+        canvas->rotate(17, kW / 2, kH / 2);
+        canvas->clipPath(SkPath::Circle(kW / 2, kH / 2, kH / 3), true);
+        canvas->drawPaint(paint);
+    canvas->restore();
+
+    // A layer whose filter reads pixels from neighbouring tiles.
+    SkPaint layerPaint;
+    layerPaint.setImageFilter(SkImageFilters::Blur(6, 3, nullptr));
+    canvas->saveLayer(nullptr, &layerPaint);
+        SkPaint stroke;
+        stroke.setAntiAlias(true);
+        stroke.setStyle(SkPaint::kStroke_Style);
+        stroke.setStrokeWidth(7);
+        stroke.setColor(SK_ColorGREEN);
+        canvas->drawCircle(kW / 3, kH / 2, 90, stroke);
+    canvas->restore();
+
+    // Antialiased paths and strokes across the tile edges.
+    SkPath star;
+    for (int i = 0; i < 7; ++i) {
+        const float angle = i * 2 * SK_ScalarPI * 3 / 7;
+        star.lineTo(kW / 2 + 140 * std::cos(angle), kH / 2 + 140 * std::sin(angle));
+    }
+    star.close();
+    SkPaint pathPaint;
+    pathPaint.setAntiAlias(true);
+    pathPaint.setColor(0x8000C0C0);
+    canvas->drawPath(star, pathPaint);
+    pathPaint.setStyle(SkPaint::kStroke_Style);
+    pathPaint.setStrokeWidth(3.5f);
+    pathPaint.setColor(0xC0804000);
+    SkPath curve;
+    curve.moveTo(3.3f, 250.1f);
+    curve.cubicTo(180.7f, -90, 320.2f, 390, 497.5f, 40.6f);
+    canvas->drawPath(curve, pathPaint);
+    pathPaint.setStrokeWidth(0);
+    canvas->drawLine(0.5f, 0.25f, kW - 0.25f, kH - 0.5f, pathPaint);
+
+    // Images sampled across the tile edges.
+    SkBitmap checker;
+    checker.allocN32Pixels(16, 16);
+    for (int y = 0; y < 16; ++y) {
+        for (int x = 0; x < 16; ++x) {
+            *checker.getAddr32(x, y) = ((x ^ y) & 1) ? 0xFF2040F0 : 0xFFF0E020;
+        }
+    }
+    sk_sp<SkImage> image = checker.asImage();
+    canvas->drawImageRect(image, SkRect::MakeXYWH(37.5f, 41.25f, 230, 170),
+                          SkSamplingOptions(SkFilterMode::kLinear));
+    canvas->drawImageRect(image, SkRect::MakeXYWH(250.25f, 90.75f, 190, 150),
+                          SkSamplingOptions(SkCubicResampler::Mitchell()));
+    canvas->save();
+        canvas->rotate(11);
+        canvas->drawImage(image, 180.5f, 60.25f, SkSamplingOptions(SkFilterMode::kLinear));
+    canvas->restore();
+
+    SkPictureRecorder recorder;
+    SkCanvas* pictureCanvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+    pictureCanvas->drawOval({10, 20, 90, 70}, SkPaint(SkColors::kYellow));
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+    for (int i = 0; i < 5; ++i) {
+        SkMatrix m = SkMatrix::Translate(i * 97, i * 41);
+        canvas->drawPicture(picture, &m, nullptr);
+    }
+}
+
+static bool pixels_match(SkSurface* a, SkSurface* b) {
+    SkBitmap bmA, bmB;
+    bmA.allocPixels(a->imageInfo());
+    bmB.allocPixels(b->imageInfo());
+    if (!a->readPixels(bmA, 0, 0) || !b->readPixels(bmB, 0, 0)) {
+        return false;
+    }
+    return 0 == memcmp(bmA.getPixels(), bmB.getPixels(), bmA.computeByteSize());
+}
+
+DEF_TEST(RasterTiledSurface_MatchesRaster, r) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(kW, kH);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    sk_sp<SkSurface> expected = SkSurfaces::Raster(info);
+    draw_scene(expected->getCanvas());
+    for (SkISize tileSize : {SkISize{256, 256}, SkISize{64, 64}, SkISize{100, 37}}) {
+        for (SkExecutor* exec : {executor.get(), (SkExecutor*)nullptr}) {
+            sk_sp<SkSurface> tiled = SkSurfaces::RasterTiled(info, exec, tileSize);
+            REPORTER_ASSERT(r, tiled);
+            draw_scene(tiled->getCanvas());
+            REPORTER_ASSERT(r, pixels_match(expected.get(), tiled.get()),
+                            "tile size %dx%d", tileSize.width(), tileSize.height());
+        }
+    }
+}
+
+DEF_TEST(RasterTiledSurface_Snapshots, r) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(64, 64);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    sk_sp<SkSurface> surface = SkSurfaces::RasterTiled(info, executor.get(), {16, 16});
+
+    surface->getCanvas()->clear(SK_ColorRED);
+    sk_sp<SkImage> red = surface->makeImageSnapshot();
+
+    // Drawing after a snapshot must neither show up in, nor be hidden by, the earlier snapshot.
+    surface->getCanvas()->clear(SK_ColorBLUE);
+    sk_sp<SkImage> blue = surface->makeImageSnapshot();
+    REPORTER_ASSERT(r, red != blue);
+
+    SkPixmap pm;
+    REPORTER_ASSERT(r, red->peekPixels(&pm) && pm.getColor(32, 32) == SK_ColorRED);
+    REPORTER_ASSERT(r, blue->peekPixels(&pm) && pm.getColor(32, 32) == SK_ColorBLUE);
+    REPORTER_ASSERT(r, surface->peekPixels(&pm) && pm.getColor(32, 32) == SK_ColorBLUE);
+}
+
+DEF_TEST(RasterTiledSurface_ReadWithOutstandingState, r) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(kW, kH);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(3);
+
+    // Read back in the middle of a save block, so later draws depend on state from ops that
+    // have already been rasterized.
+    auto draw = [](SkSurface* surface) {
+        SkCanvas* canvas = surface->getCanvas();
+        SkPaint paint(SkColors::kMagenta);
+        paint.setAntiAlias(true);
+        canvas->clear(SK_ColorWHITE);
+        canvas->save();
+            canvas->translate(30, 20);
+            canvas->clipRRect(SkRRect::MakeOval({0, 0, 300, 200}), true);
+            canvas->drawRect({20, 20, 200, 150}, paint);
+            SkBitmap unused;
+            unused.allocPixels(surface->imageInfo());
+            surface->readPixels(unused, 0, 0);
+            paint.setColor(SK_ColorCYAN);
+            canvas->drawCircle(200, 100, 80, paint);
+        canvas->restore();
+        canvas->drawCircle(kW - 50, kH - 50, 60, paint);
+    };
+
+    sk_sp<SkSurface> expected = SkSurfaces::Raster(info);
+    draw(expected.get());
+    sk_sp<SkSurface> tiled = SkSurfaces::RasterTiled(info, executor.get(), {50, 50});
+    draw(tiled.get());
+    REPORTER_ASSERT(r, pixels_match(expected.get(), tiled.get()));
+}
+
+DEF_TEST(RasterTiledSurface_ReadInsideLayers, r) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(kW, kH);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(3);
+
+    SkPaint blur;
+    blur.setImageFilter(SkImageFilters::Blur(5, 5, nullptr));
+    SkPaint blend;
+    blend.setBlendMode(SkBlendMode::kDifference);
+
+    // Reads back (and snapshots) while a layer is open, and again once it has been restored. The
+    // layer must only reach the pixels when it is restored, with its alpha, filter or blend mode.
+    auto draw = [&](SkSurface* surface, int layer, SkBitmap* inside, sk_sp<SkImage>* snapshot) {
+        SkCanvas* canvas = surface->getCanvas();
+        SkPaint paint(SkColors::kMagenta);
+        paint.setAntiAlias(true);
+        canvas->clear(SK_ColorWHITE);
+        canvas->drawRect({10, 10, 200, 150}, paint);
+        canvas->save();
+            canvas->translate(40, 30);
+            switch (layer) {
+                case 0: canvas->saveLayerAlpha(nullptr, 0x60); break;
+                case 1: canvas->saveLayer(nullptr, &blur); break;
+                case 2: canvas->saveLayer(SkRect{50, 50, 400, 250}, &blend); break;
+            }
+                paint.setColor(SK_ColorBLUE);
+                canvas->drawCircle(150, 100, 80, paint);
+                inside->allocPixels(info);
+                surface->readPixels(*inside, 0, 0);
+                *snapshot = surface->makeImageSnapshot();
+                paint.setColor(SK_ColorGREEN);
+                canvas->drawRect({100, 120, 300, 200}, paint);
+            canvas->restore();
+            canvas->drawCircle(0, 0, 30, paint);
+        canvas->restore();
+        canvas->drawCircle(kW - 50, kH - 50, 60, paint);
+    };
+    auto same = [](const SkPixmap& a, const SkPixmap& b) {
+        return 0 == memcmp(a.addr(), b.addr(), a.computeByteSize());
+    };
+
+    for (int layer = 0; layer < 3; ++layer) {
+        sk_sp<SkSurface> expected = SkSurfaces::Raster(info);
+        sk_sp<SkSurface> tiled = SkSurfaces::RasterTiled(info, executor.get(), {64, 64});
+        SkBitmap expectedInside, tiledInside;
+        sk_sp<SkImage> expectedSnapshot, tiledSnapshot;
+        draw(expected.get(), layer, &expectedInside, &expectedSnapshot);
+        draw(tiled.get(), layer, &tiledInside, &tiledSnapshot);
+
+        SkPixmap expectedPixels, tiledPixels;
+        REPORTER_ASSERT(r, same(expectedInside.pixmap(), tiledInside.pixmap()), "layer %d", layer);
+        REPORTER_ASSERT(r, expectedSnapshot->peekPixels(&expectedPixels) &&
+                           tiledSnapshot->peekPixels(&tiledPixels) &&
+                           same(expectedPixels, tiledPixels), "layer %d", layer);
+        REPORTER_ASSERT(r, pixels_match(expected.get(), tiled.get()), "layer %d", layer);
+    }
+
+    // As with a raster canvas, peeking while a layer is open gives the pixels under the layer,
+    // but the layer's own pixels cannot be accessed.
+    sk_sp<SkSurface> raster = SkSurfaces::Raster(info);
+    sk_sp<SkSurface> tiled = SkSurfaces::RasterTiled(info, executor.get(), {64, 64});
+    for (SkSurface* surface : {raster.get(), tiled.get()}) {
+        surface->getCanvas()->clear(SK_ColorWHITE);
+        surface->getCanvas()->saveLayerAlpha(nullptr, 0x80);
+        surface->getCanvas()->drawColor(SK_ColorRED);
+    }
+    SkPixmap rasterPixels, tiledPixels;
+    REPORTER_ASSERT(r, raster->peekPixels(&rasterPixels) && tiled->peekPixels(&tiledPixels) &&
+                       same(rasterPixels, tiledPixels));
+    REPORTER_ASSERT(r, tiledPixels.getColor(0, 0) == SK_ColorWHITE);
+    REPORTER_ASSERT(r, !tiled->getCanvas()->accessTopLayerPixels(nullptr, nullptr));
+    raster->getCanvas()->restore();
+    tiled->getCanvas()->restore();
+    REPORTER_ASSERT(r, tiled->getCanvas()->accessTopLayerPixels(nullptr, nullptr) != nullptr);
+    REPORTER_ASSERT(r, pixels_match(raster.get(), tiled.get()));
+}
+
+DEF_TEST(RasterTiledSurface_ManyReadsInsideSaves, r) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(kW, kH);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(3);
+
+    // Reads back after every draw, inside saves that outlast many of those reads, so each flush
+    // starts from state (matrices, clips and saves) left by ops that were flushed long before.
+    auto draw = [](SkSurface* surface) {
+        SkCanvas* canvas = surface->getCanvas();
+        SkBitmap unused;
+        unused.allocPixels(surface->imageInfo());
+        SkRandom rand;
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        canvas->clear(SK_ColorWHITE);
+        canvas->translate(7.5f, 3.25f);
+        for (int block = 0; block < 6; ++block) {
+            const int saveCount = canvas->save();
+            canvas->rotate(block * 9);
+            canvas->clipRRect(SkRRect::MakeRectXY({20, 10, 460, 280}, 40, 30), block % 2 == 0);
+            for (int i = 0; i < 12; ++i) {
+                paint.setColor(rand.nextU() | 0x60000000);
+                canvas->drawOval(SkRect::MakeXYWH(rand.nextRangeScalar(-20, kW),
+                                                  rand.nextRangeScalar(-20, kH),
+                                                  rand.nextRangeScalar(2, 150),
+                                                  rand.nextRangeScalar(2, 150)), paint);
+                if (i % 4 == 3) {
+                    canvas->save();
+                    canvas->scale(1.5f, 0.75f);
+                }
+                surface->readPixels(unused, 0, 0);
+            }
+            // Even blocks stay open (with their clip) until the next odd one closes them all.
+            if (block % 2 == 0) {
+                canvas->restoreToCount(saveCount + 1);
+            } else {
+                canvas->restoreToCount(1);
+                canvas->translate(-2.25f, 5.5f);
+            }
+            surface->readPixels(unused, 0, 0);
+        }
+    };
+
+    sk_sp<SkSurface> expected = SkSurfaces::Raster(info);
+    draw(expected.get());
+    for (SkISize tileSize : {SkISize{64, 64}, SkISize{100, 37}}) {
+        sk_sp<SkSurface> tiled = SkSurfaces::RasterTiled(info, executor.get(), tileSize);
+        draw(tiled.get());
+        REPORTER_ASSERT(r, pixels_match(expected.get(), tiled.get()),
+                        "tile size %dx%d", tileSize.width(), tileSize.height());
+    }
+}
@@ -14,6 +14,8 @@
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPixmap.h"
@@ -52,11 +54,14 @@
 #include "src/gpu/ganesh/SurfaceFillContext.h"
 #include "src/gpu/ganesh/effects/GrSkSLFP.h"
 #include "src/sksl/SkSLString.h"
+#include "src/sksl/ir/SkSLProgram.h"
+#include "src/utils/SkOSPath.h"
 #include "tests/CtsEnforcement.h"
 #include "tests/Test.h"
 
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <initializer_list>
 #include <memory>
@@ -1676,3 +1681,152 @@ DEF_GANESH_TEST_FOR_RENDERING_CONTEXTS(GrSkSLFP_UniformArray,
         }
     }
 }
+
+DEF_SERIAL_TEST(SkRuntimeEffect_CachedEffects, r) {
+    const int prevLimit = SkGraphics::SetRuntimeEffectCacheCountLimit(2);
+    SkPurgeRuntimeEffectCache();
+
+    auto program = [](int i) {
+        return SkStringPrintf("half4 main(float2 xy) { return half4(%d); }", i);
+    };
+    auto effect0 = SkMakeCachedRuntimeEffect(SkRuntimeEffect::MakeForShader, program(0));
+    SkRuntimeEffectCacheStats before = SkGetRuntimeEffectCacheStats();
+    REPORTER_ASSERT(r, before.fCount == 1);
+    REPORTER_ASSERT(r, before.fCountLimit == 2);
+
+    // A hit returns the same effect without compiling it again.
+    REPORTER_ASSERT(r, effect0 == SkMakeCachedRuntimeEffect(SkRuntimeEffect::MakeForShader,
+                                                            program(0)));
+    SkRuntimeEffectCacheStats after = SkGetRuntimeEffectCacheStats();
+    REPORTER_ASSERT(r, after.fHits == before.fHits + 1);
+    REPORTER_ASSERT(r, after.fMisses == before.fMisses);
+    REPORTER_ASSERT(r, after.fCompileTimeNs == before.fCompileTimeNs);
+
+    // Precompiling more programs than the limit keeps only the most recent ones.
+    const SkString programs[] = {program(1), program(2), program(3)};
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(1);
+    SkPrecompileCachedRuntimeEffects(SkRuntimeEffect::MakeForShader, programs, executor.get());
+    executor.reset();  // Waits for the queued compiles to finish.
+    after = SkGetRuntimeEffectCacheStats();
+    REPORTER_ASSERT(r, after.fCount == 2);
+    REPORTER_ASSERT(r, after.fMisses == before.fMisses + 3);
+    REPORTER_ASSERT(r, after.fCompileTimeNs > before.fCompileTimeNs);
+
+    before = after;
+    SkMakeCachedRuntimeEffect(SkRuntimeEffect::MakeForShader, program(3));
+    SkMakeCachedRuntimeEffect(SkRuntimeEffect::MakeForShader, program(1));
+    after = SkGetRuntimeEffectCacheStats();
+    REPORTER_ASSERT(r, after.fHits == before.fHits + 1);
+    REPORTER_ASSERT(r, after.fMisses == before.fMisses + 1);
+
+    REPORTER_ASSERT(r, SkGraphics::SetRuntimeEffectCacheCountLimit(prevLimit) == 2);
+}
+
+namespace {
+class MemoryPersistentCache : public SkRuntimeEffect::PersistentCache {
+public:
+    sk_sp<SkData> load(const SkData& key) override {
+        fLoads++;
+        for (const auto& [k, v] : fEntries) {
+            if (k->equals(&key)) {
+                return v;
+            }
+        }
+        return nullptr;
+    }
+    void store(const SkData& key, const SkData& data) override {
+        fStores++;
+        for (auto& [k, v] : fEntries) {
+            if (k->equals(&key)) {
+                v = SkData::MakeWithCopy(data.data(), data.size());
+                return;
+            }
+        }
+        fEntries.push_back({SkData::MakeWithCopy(key.data(), key.size()),
+                            SkData::MakeWithCopy(data.data(), data.size())});
+    }
+
+    int fLoads = 0;
+    int fStores = 0;
+    TArray<std::pair<sk_sp<SkData>, sk_sp<SkData>>> fEntries;
+};
+}  // namespace
+
+DEF_SERIAL_TEST(SkRuntimeEffect_PersistentCache, r) {
+    static constexpr char kSkSL[] =
+            "uniform half4 color;"
+            "half4 main(float2 xy) {"
+            "    half4 c = color;"
+            "    for (int i = 0; i < 4; i++) { c.rg = c.gr; }"
+            "    return xy.x < 1 ? c : c.bgra;"
+            "}";
+    const SkColor4f color = {1, 0.5f, 0.25f, 1};
+
+    auto draw = [&](uint32_t pixels[4]) {
+        auto [effect, err] = SkRuntimeEffect::MakeForShader(SkString(kSkSL));
+        REPORTER_ASSERT(r, effect, "%s", err.c_str());
+        SkPaint paint;
+        paint.setShader(effect->makeShader(SkData::MakeWithCopy(&color, sizeof(color)), {}));
+        SkImageInfo info = SkImageInfo::MakeN32Premul(2, 2);
+        sk_sp<SkSurface> surface = SkSurfaces::Raster(info);
+        surface->getCanvas()->drawPaint(paint);
+        REPORTER_ASSERT(r, surface->readPixels(info, pixels, info.minRowBytes(), 0, 0));
+    };
+
+    uint32_t expected[4], actual[4];
+    draw(expected);
+
+    MemoryPersistentCache cache;
+    SkRuntimeEffect::SetPersistentCache(&cache);
+
+    // The first compile misses, and stores its program...
+    draw(actual);
+    REPORTER_ASSERT(r, cache.fLoads == 1 && cache.fStores == 1);
+    REPORTER_ASSERT(r, 0 == memcmp(expected, actual, sizeof(actual)));
+
+    // ... which a new effect with the same source loads instead of compiling.
+    draw(actual);
+    REPORTER_ASSERT(r, cache.fLoads == 2 && cache.fStores == 1);
+    REPORTER_ASSERT(r, 0 == memcmp(expected, actual, sizeof(actual)));
+
+    // An effect loaded from the cache reflects the same uniforms, and parses its source on demand.
+    {
+        sk_sp<SkRuntimeEffect> loaded = SkRuntimeEffect::MakeForShader(SkString(kSkSL)).effect;
+        SkRuntimeEffect::SetPersistentCache(nullptr);
+        sk_sp<SkRuntimeEffect> parsed = SkRuntimeEffect::MakeForShader(SkString(kSkSL)).effect;
+        SkRuntimeEffect::SetPersistentCache(&cache);
+        REPORTER_ASSERT(r, loaded && parsed);
+        REPORTER_ASSERT(r, loaded->source() == kSkSL);
+        REPORTER_ASSERT(r, loaded->uniformSize() == parsed->uniformSize());
+        REPORTER_ASSERT(r, loaded->uniforms().size() == 1 && loaded->findUniform("color") &&
+                           loaded->findUniform("color")->type == parsed->uniforms()[0].type);
+        REPORTER_ASSERT(r, loaded->children().empty());
+        REPORTER_ASSERT(r,
+                        SkRuntimeEffectPriv::Hash(*loaded) == SkRuntimeEffectPriv::Hash(*parsed));
+        REPORTER_ASSERT(r, *SkRuntimeEffectPriv::Program(*loaded).fSource == kSkSL);
+        REPORTER_ASSERT(r, cache.fLoads == 3 && cache.fStores == 1);
+    }
+
+    // Entries that can't be read fall back to compiling, and are replaced.
+    REPORTER_ASSERT(r, cache.fEntries.size() == 1);
+    cache.fEntries[0].second = SkData::MakeWithCString("not a program");
+    draw(actual);
+    REPORTER_ASSERT(r, cache.fLoads == 4 && cache.fStores == 2);
+    REPORTER_ASSERT(r, 0 == memcmp(expected, actual, sizeof(actual)));
+
+    SkRuntimeEffect::SetPersistentCache(nullptr);
+
+    SkString tmpDir = skiatest::GetTmpDir();
+    if (!tmpDir.isEmpty()) {
+        SkString dir = SkOSPath::Join(tmpDir.c_str(), "runtime_effect_cache");
+        std::unique_ptr<SkRuntimeEffect::PersistentCache> fileCache =
+                SkRuntimeEffect::MakeFilePersistentCache(dir.c_str());
+        REPORTER_ASSERT(r, fileCache);
+        sk_sp<SkData> key = SkData::MakeWithCString("key"),
+                      otherKey = SkData::MakeWithCString("other key");
+        fileCache->store(*key, *cache.fEntries[0].second);
+        sk_sp<SkData> loaded = fileCache->load(*key);
+        REPORTER_ASSERT(r, loaded && loaded->equals(cache.fEntries[0].second.get()));
+        REPORTER_ASSERT(r, !fileCache->load(*otherKey));
+    }
+}
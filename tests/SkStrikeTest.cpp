@@ -193,8 +193,61 @@ public:
         SkAutoMutexExclusive m{strike->fStrikeLock};
         return strike->glyph(packedID);
     }
+    static size_t MemoryUsed(SkStrike* strike) {
+        return strike->fMemoryUsed;
+    }
 };
 
+DEF_TEST(SkStrikeMultiThreadLookup, reporter) {
+    SkFont font = ToolUtils::DefaultFont();
+    font.setEdging(SkFont::Edging::kAntiAlias);
+    SkStrikeSpec strikeSpec = SkStrikeSpec::MakeWithNoDevice(font);
+
+    SkGlyphID glyphIDs[200];
+    SkPackedGlyphID packedIDs[200];
+    for (int i = 0; i < 200; i++) {
+        glyphIDs[i] = SkTo<SkGlyphID>(i);
+        packedIDs[i] = SkPackedGlyphID{glyphIDs[i]};
+    }
+
+    static constexpr int kThreadCount = 8;
+    auto executor = SkExecutor::MakeFIFOThreadPool(kThreadCount);
+    for (int tries = 0; tries < 20; tries++) {
+        SkStrikeCache strikeCache;
+        sk_sp<SkStrike> strike = strikeCache.createStrike(strikeSpec);
+
+        // Every thread asks for overlapping glyphs, so some threads find glyphs while others are
+        // still adding and preparing them.
+        const SkGlyph* results[kThreadCount][200];
+        SkTaskGroup(*executor).batch(kThreadCount, [&](int threadIndex) {
+            const int start = threadIndex * 10;
+            const int count = 200 - start;
+            const SkGlyph* scratch[200];
+            for (int i = 0; i < 10; i++) {
+                strike->metrics({glyphIDs + start, (size_t)count}, scratch);
+                strike->prepareImages({packedIDs + start, (size_t)count}, scratch);
+                strike->preparePaths({glyphIDs + start, (size_t)count}, results[threadIndex]);
+            }
+        });
+
+        for (int threadIndex = 0; threadIndex < kThreadCount; threadIndex++) {
+            const int start = threadIndex * 10;
+            for (int i = start; i < 200; i++) {
+                const SkGlyph* glyph = results[threadIndex][i - start];
+                REPORTER_ASSERT(reporter,
+                                glyph == SkStrikeTestingPeer::GetGlyph(strike.get(), packedIDs[i]));
+                REPORTER_ASSERT(reporter, glyph->setImageHasBeenCalled());
+                REPORTER_ASSERT(reporter, glyph->setPathHasBeenCalled());
+            }
+        }
+
+        // All the glyph, image, path and lookup table memory is accounted to the cache.
+        REPORTER_ASSERT(reporter, strikeCache.getTotalMemoryUsed() ==
+                                  SkStrikeTestingPeer::MemoryUsed(strike.get()));
+        REPORTER_ASSERT(reporter, strikeCache.getTotalMemoryUsed() > 200 * sizeof(SkGlyph));
+    }
+}
+
 DEF_TEST(SkStrike_FlattenByType, reporter) {
     std::vector<SkGlyph> imagesToSend;
     std::vector<SkGlyph> pathsToSend;
@@ -10,13 +10,18 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkSwizzle.h"
+#include "include/private/base/SkMath.h"
+#include "src/base/SkRandom.h"
 #include "src/codec/SkSampler.h"
 #include "src/core/SkSwizzlePriv.h"
 #include "tests/Test.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <memory>
+#include <utility>
+#include <vector>
 
 static void check_fill(skiatest::Reporter* r,
                        const SkImageInfo& imageInfo,
@@ -151,6 +156,75 @@ DEF_TEST(SwizzleOpts, r) {
     REPORTER_ASSERT(r, dst == 0xFA04ADCA);
 }
 
+// Checks the 16-bit and palette swizzles against scalar conversions, at every length through a
+// few vectors so each SIMD loop and its tail get covered.
+DEF_TEST(SwizzleOpts_16bitAndIndex, r) {
+    SkRandom rand;
+    uint8_t src[40 * 8];
+    for (uint8_t& byte : src) {
+        byte = rand.nextU() & 0xFF;
+    }
+    uint32_t table[256];
+    for (uint32_t& color : table) {
+        color = rand.nextBool() ? rand.nextU() : 0;
+    }
+
+    auto pack = [](int r, int g, int b, int a, bool swapRB, bool premul) -> uint32_t {
+        if (premul) {
+            r = SkMulDiv255Round(r, a);
+            g = SkMulDiv255Round(g, a);
+            b = SkMulDiv255Round(b, a);
+        }
+        if (swapRB) {
+            std::swap(r, b);
+        }
+        return (uint32_t)a << 24 | (uint32_t)b << 16 | (uint32_t)g << 8 | (uint32_t)r;
+    };
+
+    const struct {
+        SkOpts::Swizzle_8888_u8 fn;
+        int  bpp;
+        bool swapRB, premul;
+    } kRGBA16Swizzles[] = {
+        { SkOpts::RGB16_to_RGB1,  6, false, false },
+        { SkOpts::RGB16_to_BGR1,  6,  true, false },
+        { SkOpts::RGBA16_to_RGBA, 8, false, false },
+        { SkOpts::RGBA16_to_BGRA, 8,  true, false },
+        { SkOpts::RGBA16_to_rgbA, 8, false,  true },
+        { SkOpts::RGBA16_to_bgrA, 8,  true,  true },
+    };
+
+    for (int count = 0; count <= 40; count++) {
+        for (const auto& swizzle : kRGBA16Swizzles) {
+            // The source ends right after the last pixel, so reading past it would be caught by
+            // ASAN.
+            std::vector<uint8_t> row(src, src + count * swizzle.bpp);
+            std::vector<uint32_t> dst(count);
+            swizzle.fn(dst.data(), row.data(), count);
+            for (int i = 0; i < count; i++) {
+                const uint8_t* px = row.data() + i * swizzle.bpp;
+                uint32_t expected = pack(px[0], px[2], px[4], swizzle.bpp == 8 ? px[6] : 0xFF,
+                                         swizzle.swapRB, swizzle.premul);
+                REPORTER_ASSERT(r, dst[i] == expected, "bpp %d, pixel %d of %d: %08x vs %08x",
+                                swizzle.bpp, i, count, dst[i], expected);
+            }
+        }
+
+        std::vector<uint8_t> indices(src, src + count);
+        std::vector<uint32_t> dst(count, 0xDEADBEEF);
+        SkOpts::index_to_8888(dst.data(), indices.data(), table, count);
+        for (int i = 0; i < count; i++) {
+            REPORTER_ASSERT(r, dst[i] == table[indices[i]]);
+        }
+        std::fill(dst.begin(), dst.end(), 0xDEADBEEF);
+        SkOpts::index_to_8888_skipZ(dst.data(), indices.data(), table, count);
+        for (int i = 0; i < count; i++) {
+            uint32_t color = table[indices[i]];
+            REPORTER_ASSERT(r, dst[i] == (color ? color : 0xDEADBEEF));
+        }
+    }
+}
+
 DEF_TEST(PublicSwizzleOpts, r) {
     uint32_t dst, src;
 
@@ -90,6 +90,7 @@ CORE_TESTS = [
     "PictureBBHTest.cpp",
     "PictureShaderTest.cpp",
     "PixelRefTest.cpp",
+    "PngFilterTest.cpp",
     "Point3Test.cpp",
     "PointTest.cpp",
     "PolyUtilsTest.cpp",
@@ -97,6 +98,7 @@ CORE_TESTS = [
     "RRectInPathTest.cpp",
     "RTreeTest.cpp",
     "RandomTest.cpp",
+    "RasterTiledSurfaceTest.cpp",
     "ReadPixelsTest.cpp",
     "RecorderTest.cpp",
     "RecordingXfermodeTest.cpp",
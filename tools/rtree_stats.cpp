@@ -0,0 +1,54 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "src/base/SkRandom.h"
+#include "src/core/SkFlatRTree.h"
+#include "src/core/SkRTree.h"
+
+#include <vector>
+
+// Prints how many bytes SkRTree and SkFlatRTree use per op, for as many ops as small to very
+// large SKPs hold. RTreeBench measures how fast they are built and searched.
+
+// Op bounds spread over a long page, like a scrolled web page recorded into one SKP. One op in
+// skipEvery is empty, as clipped-out or zero-sized draws are; the trees leave those out.
+static std::vector<SkRect> make_ops(int count, int skipEvery) {
+    SkRandom rand;
+    std::vector<SkRect> ops(count);
+    for (int i = 0; i < count; ++i) {
+        if (skipEvery > 0 && i % skipEvery == 0) {
+            ops[i] = SkRect::MakeEmpty();
+            continue;
+        }
+        ops[i] = SkRect::MakeXYWH(rand.nextRangeF(0, 4000), rand.nextRangeF(0, 40000),
+                                  rand.nextRangeF(1, 200), rand.nextRangeF(1, 50));
+    }
+    return ops;
+}
+
+static double bytes_per_op(sk_sp<SkBBoxHierarchy> tree, const std::vector<SkRect>& ops) {
+    tree->insert(ops.data(), (int)ops.size());
+    return (double)tree->bytesUsed() / ops.size();
+}
+
+int main() {
+    SkDebugf("%9s %11s %11s %16s\n", "ops", "empty ops", "rtree B/op", "flat_rtree B/op");
+    for (int count : {1000, 10000, 100000, 1000000}) {
+        for (int skipEvery : {0, 10}) {
+            std::vector<SkRect> ops = make_ops(count, skipEvery);
+            SkDebugf("%9d %11s %11.2f %16.2f\n",
+                     count,
+                     skipEvery ? "1 in 10" : "none",
+                     bytes_per_op(sk_make_sp<SkRTree>(), ops),
+                     bytes_per_op(sk_make_sp<SkFlatRTree>(), ops));
+        }
+    }
+    return 0;
+}
@@ -5,20 +5,28 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkData.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkStream.h"
 #include "include/private/base/SkTo.h"
+#include "src/base/SkTime.h"
 #include "src/core/SkFontDescriptor.h"
 #include "src/core/SkPictureData.h"
 #include "src/core/SkPicturePriv.h"
+#include "tools/ProcStats.h"
 #include "tools/flags/CommandLineFlags.h"
 
+#include <memory>
+
 static DEFINE_string2(input, i, "", "skp on which to report");
 static DEFINE_bool2(version, v, true, "version");
 static DEFINE_bool2(cullRect, c, true, "cullRect");
 static DEFINE_bool2(flags, f, true, "flags");
 static DEFINE_bool2(tags, t, true, "tags");
 static DEFINE_bool2(quiet, q, false, "quiet");
+static DEFINE_bool(load, false, "Load the skp, and report how long that took and the peak RSS");
+static DEFINE_bool(noCopy, false,
+                   "With --load, map the skp and load it with SkPicture::MakeFromDataWithoutCopy");
 
 // This tool can print simple information about an SKP but its main use
 // is just to check if an SKP has been truncated during the recording
@@ -31,6 +39,31 @@ static const int kInvalidTag = 3;
 static const int kMissingInput = 4;
 static const int kIOError = 5;
 
+static int load(const char* path) {
+    const double start = SkTime::GetMSecs();
+    sk_sp<SkPicture> picture;
+    if (FLAGS_noCopy) {
+        if (sk_sp<SkData> data = SkData::MakeFromFileName(path)) {
+            picture = SkPicture::MakeFromDataWithoutCopy(std::move(data));
+        }
+    } else if (std::unique_ptr<SkStreamAsset> stream = SkStream::MakeFromFile(path)) {
+        picture = SkPicture::MakeFromStream(stream.get());
+    }
+    const double elapsed = SkTime::GetMSecs() - start;
+    if (!picture) {
+        if (!FLAGS_quiet) {
+            SkDebugf("Couldn't load picture\n");
+        }
+        return kNotAnSKP;
+    }
+    if (!FLAGS_quiet) {
+        SkDebugf("Load time: %.2fms\n", elapsed);
+        SkDebugf("Peak RSS: %dMB\n", sk_tools::getMaxResidentSetSizeMB());
+        SkDebugf("Approximate bytes used: %zu\n", picture->approximateBytesUsed());
+    }
+    return kSuccess;
+}
+
 int main(int argc, char** argv) {
     CommandLineFlags::SetUsage("Prints information about an skp file");
     CommandLineFlags::Parse(argc, argv);
@@ -42,6 +75,10 @@ int main(int argc, char** argv) {
         return kMissingInput;
     }
 
+    if (FLAGS_load) {
+        return load(FLAGS_input[0]);
+    }
+
     SkFILEStream stream(FLAGS_input[0]);
     if (!stream.isValid()) {
         if (!FLAGS_quiet) {
@@ -67,14 +104,24 @@ int main(int argc, char** argv) {
                  info.fCullRect.fRight, info.fCullRect.fBottom);
     }
 
-    bool hasData;
-    if (!stream.readBool(&hasData)) { return kTruncatedFile; }
+    uint8_t hasData;
+    if (!stream.readU8(&hasData)) { return kTruncatedFile; }
+    const bool aligned = hasData & SkPicturePriv::kAlignedSections_TrailingStreamByteFlag;
+    if (aligned) {
+        if (!FLAGS_quiet) {
+            SkDebugf("Sections are aligned\n");
+        }
+        hasData &= ~SkPicturePriv::kAlignedSections_TrailingStreamByteFlag;
+    }
     if (!hasData) {
         // If we read true there's a picture playback object flattened
         // in the file; if false, there isn't a playback, so we're done
         // reading the file.
         return kSuccess;
     }
+    if (aligned && !stream.move(SkPicturePriv::kAlignedSections_TrailingStreamBytePadding)) {
+        return kTruncatedFile;
+    }
 
     for (;;) {
         uint32_t tag;
@@ -115,6 +162,17 @@ int main(int argc, char** argv) {
             if (FLAGS_tags && !FLAGS_quiet) {
                 SkDebugf("SK_PICT_TYPEFACE_TAG %u\n", chunkSize);
             }
+            if (aligned) {
+                // The typefaces are preceded by their size in bytes, and followed by padding.
+                if (!stream.readU32(&chunkSize)) { return kTruncatedFile; }
+                if (stream.getPosition() + chunkSize > totStreamSize) {
+                    if (!FLAGS_quiet) {
+                        SkDebugf("truncated file\n");
+                    }
+                    return kTruncatedFile;
+                }
+                break;
+            }
 
             const int count = SkToInt(chunkSize);
             for (int i = 0; i < count; i++) {